@@ -13,3 +13,11 @@ IMPLEMENT_GLOBAL_SHADER(FClassicBloomGlareAccumulatePS, "/Plugin/ToneMapFX/Priva
 // Kawase bloom shaders
 IMPLEMENT_GLOBAL_SHADER(FClassicBloomKawaseDownsamplePS, "/Plugin/ToneMapFX/Private/ClassicBloomKawase.usf", "KawaseDownsamplePS", SF_Pixel);
 IMPLEMENT_GLOBAL_SHADER(FClassicBloomKawaseUpsamplePS, "/Plugin/ToneMapFX/Private/ClassicBloomKawase.usf", "KawaseUpsamplePS", SF_Pixel);
+
+// Compute variants of the bloom chain (r.ToneMapFX.AsyncCompute)
+IMPLEMENT_GLOBAL_SHADER(FClassicBloomBrightPassCS, "/Plugin/ToneMapFX/Private/ClassicBloomShaders.usf", "BrightPassCS", SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FClassicBloomBlurCS, "/Plugin/ToneMapFX/Private/ClassicBloomBlur.usf", "GaussianBlurCS", SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FClassicBloomGlareStreakCS, "/Plugin/ToneMapFX/Private/ClassicBloomGlare.usf", "GlareStreakCS", SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FClassicBloomGlareAccumulateCS, "/Plugin/ToneMapFX/Private/ClassicBloomGlare.usf", "GlareAccumulateCS", SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FClassicBloomKawaseDownsampleCS, "/Plugin/ToneMapFX/Private/ClassicBloomKawase.usf", "KawaseDownsampleCS", SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FClassicBloomKawaseUpsampleCS, "/Plugin/ToneMapFX/Private/ClassicBloomKawase.usf", "KawaseUpsampleCS", SF_Compute);
@@ -0,0 +1,262 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapBudgetGovernor.h"
+#include "ToneMapScalability.h"
+#include "ToneMapStats.h"
+#include "HAL/IConsoleManager.h"
+#include "RHICommandList.h"
+#include "ShaderParameterMacros.h"
+
+DEFINE_STAT(STAT_ToneMapFX_GovernedGPUTime);
+DEFINE_STAT(STAT_ToneMapFX_GovernorLevel);
+
+static TAutoConsoleVariable<float> CVarToneMapBudgetMs(
+	TEXT("r.ToneMapFX.BudgetMs"),
+	0.0f,
+	TEXT("GPU budget for the whole ToneMapFX pass in milliseconds (0 = governor off).\n")
+	TEXT("While over budget, Fattal iterations, glare samples, Kawase mips and the lens\n")
+	TEXT("resolution are lowered on the most expensive stage, and restored once there is headroom."),
+	ECVF_RenderThreadSafe | ECVF_Scalability);
+
+static TAutoConsoleVariable<float> CVarToneMapBudgetRecoverFraction(
+	TEXT("r.ToneMapFX.BudgetRecoverFraction"),
+	0.8f,
+	TEXT("Fraction of r.ToneMapFX.BudgetMs the GPU time must stay below before quality is restored."),
+	ECVF_RenderThreadSafe);
+
+// ---------------------------------------------------------------------------
+// Controller
+// ---------------------------------------------------------------------------
+
+static const EToneMapGovernedStage GGovernedStages[] =
+{
+	EToneMapGovernedStage::Bloom,
+	EToneMapGovernedStage::Fattal,
+	EToneMapGovernedStage::LensEffects,
+};
+
+int32 FToneMapGovernorState::GetTotalLevel() const
+{
+	int32 Total = 0;
+	for (const EToneMapGovernedStage Stage : GGovernedStages)
+	{
+		Total += Levels[(int32)Stage];
+	}
+	return Total;
+}
+
+FToneMapGovernorConfig FToneMapBudgetGovernor::GetConfig_RenderThread()
+{
+	FToneMapGovernorConfig Config;
+	Config.BudgetMs        = CVarToneMapBudgetMs.GetValueOnRenderThread();
+	Config.RecoverFraction = FMath::Clamp(CVarToneMapBudgetRecoverFraction.GetValueOnRenderThread(), 0.1f, 1.0f);
+	return Config;
+}
+
+FToneMapGovernorState FToneMapBudgetGovernor::Step(
+	const FToneMapGovernorState& State,
+	const FToneMapStageTimings& Timings,
+	const FToneMapGovernorConfig& Config)
+{
+	if (Config.BudgetMs <= 0.0f)
+	{
+		return FToneMapGovernorState();
+	}
+
+	FToneMapGovernorState Next = State;
+	const float TotalMs = Timings.Ms[(int32)EToneMapGovernedStage::Total];
+
+	if (TotalMs > Config.BudgetMs)
+	{
+		Next.UnderBudgetSamples = 0;
+		if (++Next.OverBudgetSamples < Config.DegradeFrames) return Next;
+
+		// Step down the stage that currently costs the most and still has room
+		int32 Worst = INDEX_NONE;
+		for (const EToneMapGovernedStage Stage : GGovernedStages)
+		{
+			const int32 Index = (int32)Stage;
+			if (Next.Levels[Index] >= Config.MaxLevel || Timings.Ms[Index] <= 0.0f) continue;
+			if (Worst == INDEX_NONE || Timings.Ms[Index] > Timings.Ms[Worst]) Worst = Index;
+		}
+
+		if (Worst != INDEX_NONE)
+		{
+			Next.Levels[Worst]++;
+		}
+		Next.OverBudgetSamples = 0;
+	}
+	else if (TotalMs < Config.BudgetMs * Config.RecoverFraction)
+	{
+		Next.OverBudgetSamples = 0;
+		if (++Next.UnderBudgetSamples < Config.RecoverFrames) return Next;
+
+		// Give back the cheapest degraded stage first — least likely to overshoot again
+		int32 Cheapest = INDEX_NONE;
+		for (const EToneMapGovernedStage Stage : GGovernedStages)
+		{
+			const int32 Index = (int32)Stage;
+			if (Next.Levels[Index] <= 0) continue;
+			if (Cheapest == INDEX_NONE || Timings.Ms[Index] < Timings.Ms[Cheapest]) Cheapest = Index;
+		}
+
+		if (Cheapest != INDEX_NONE)
+		{
+			Next.Levels[Cheapest]--;
+		}
+		Next.UnderBudgetSamples = 0;
+	}
+	else
+	{
+		// Inside the hysteresis band — hold
+		Next.OverBudgetSamples = 0;
+		Next.UnderBudgetSamples = 0;
+	}
+
+	return Next;
+}
+
+void FToneMapBudgetGovernor::Apply(const FToneMapGovernorState& State, FToneMapResolvedQuality& Quality)
+{
+	// Each level costs roughly a quarter of the stage's remaining work
+	auto Scale = [](int32 Level) { return FMath::Pow(0.75f, (float)Level); };
+
+	if (const int32 Level = State.Levels[(int32)EToneMapGovernedStage::Bloom])
+	{
+		Quality.GlareSamples   = FMath::Max(8, FMath::RoundToInt32(Quality.GlareSamples * Scale(Level)));
+		Quality.KawaseMipCount = FMath::Max(3, Quality.KawaseMipCount - Level);
+	}
+
+	if (const int32 Level = State.Levels[(int32)EToneMapGovernedStage::Fattal])
+	{
+		Quality.FattalIterations = FMath::Max(4, FMath::RoundToInt32(Quality.FattalIterations * Scale(Level)));
+	}
+
+	if (const int32 Level = State.Levels[(int32)EToneMapGovernedStage::LensEffects])
+	{
+		// Spike length is in lens-buffer pixels and shrinks with the buffer
+		const float NewScale = FMath::Max(0.25f, Quality.LensResolutionScale * Scale(Level));
+		Quality.CoronaSpikeLength = FMath::Max(1, FMath::RoundToInt32(Quality.CoronaSpikeLength * NewScale / Quality.LensResolutionScale));
+		Quality.LensResolutionScale = NewScale;
+	}
+}
+
+// ---------------------------------------------------------------------------
+// GPU timer
+// ---------------------------------------------------------------------------
+
+void FToneMapStageTimer::BeginFrame(uint64 FrameNumber)
+{
+	if (Frames[CurrentFrame].FrameNumber == FrameNumber) return;
+
+	// Anything still pending in the slot we wrap onto is too old to be useful
+	CurrentFrame = (CurrentFrame + 1) % MaxFramesInFlight;
+	Frames[CurrentFrame].FrameNumber = FrameNumber;
+	Frames[CurrentFrame].Queries.Reset();
+}
+
+BEGIN_SHADER_PARAMETER_STRUCT(FToneMapTimestampParameters, )
+	RDG_TEXTURE_ACCESS(After, ERHIAccess::SRVCompute)
+END_SHADER_PARAMETER_STRUCT()
+
+FRHIRenderQuery* FToneMapStageTimer::AddTimestamp(FRDGBuilder& GraphBuilder, FRHIPooledRenderQuery& OutQuery, FRDGTextureRef After)
+{
+	if (!QueryPool.IsValid())
+	{
+		QueryPool = RHICreateRenderQueryPool(RQT_AbsoluteTime);
+	}
+
+	OutQuery = QueryPool->AllocateQuery();
+	FRHIRenderQuery* Query = OutQuery.GetQuery();
+
+	if (After)
+	{
+		// Reading the texture on the graphics queue makes RDG wait for the
+		// async compute pass that wrote it before the stamp is written
+		auto* Parameters = GraphBuilder.AllocParameters<FToneMapTimestampParameters>();
+		Parameters->After = After;
+
+		GraphBuilder.AddPass(
+			RDG_EVENT_NAME("ToneMapFX_Timestamp"),
+			Parameters,
+			ERDGPassFlags::Compute | ERDGPassFlags::NeverCull,
+			[Query](FRHICommandListImmediate& RHICmdList)
+			{
+				RHICmdList.EndRenderQuery(Query);
+			});
+		return Query;
+	}
+
+	GraphBuilder.AddPass(
+		RDG_EVENT_NAME("ToneMapFX_Timestamp"),
+		ERDGPassFlags::NeverCull,
+		[Query](FRHICommandListImmediate& RHICmdList)
+		{
+			RHICmdList.EndRenderQuery(Query);
+		});
+
+	return Query;
+}
+
+void FToneMapStageTimer::Begin(FRDGBuilder& GraphBuilder, EToneMapGovernedStage Stage)
+{
+	FStageQuery& Entry = Frames[CurrentFrame].Queries.AddDefaulted_GetRef();
+	Entry.Stage = Stage;
+	AddTimestamp(GraphBuilder, Entry.BeginQuery);
+}
+
+void FToneMapStageTimer::End(FRDGBuilder& GraphBuilder, EToneMapGovernedStage Stage, FRDGTextureRef Output)
+{
+	// Innermost open query of this stage
+	TArray<FStageQuery>& Queries = Frames[CurrentFrame].Queries;
+	for (int32 Index = Queries.Num() - 1; Index >= 0; --Index)
+	{
+		if (Queries[Index].Stage == Stage && !Queries[Index].EndQuery.IsValid())
+		{
+			AddTimestamp(GraphBuilder, Queries[Index].EndQuery, Output);
+			return;
+		}
+	}
+}
+
+bool FToneMapStageTimer::Poll(FToneMapStageTimings& OutTimings)
+{
+	// Oldest frame first, never the one still being recorded
+	for (int32 Age = MaxFramesInFlight - 1; Age > 0; --Age)
+	{
+		FFrameRecord& Record = Frames[(CurrentFrame + MaxFramesInFlight - Age) % MaxFramesInFlight];
+		if (Record.Queries.Num() == 0) continue;
+
+		FToneMapStageTimings Timings;
+		bool bReady = true;
+
+		for (FStageQuery& Entry : Record.Queries)
+		{
+			uint64 BeginMicroseconds = 0;
+			uint64 EndMicroseconds = 0;
+			if (!Entry.EndQuery.IsValid() ||
+				!RHIGetRenderQueryResult(Entry.BeginQuery.GetQuery(), BeginMicroseconds, false) ||
+				!RHIGetRenderQueryResult(Entry.EndQuery.GetQuery(), EndMicroseconds, false))
+			{
+				bReady = false;
+				break;
+			}
+
+			// Several views per frame add up
+			if (EndMicroseconds > BeginMicroseconds)
+			{
+				Timings.Ms[(int32)Entry.Stage] += (float)(EndMicroseconds - BeginMicroseconds) / 1000.0f;
+			}
+		}
+
+		if (!bReady) continue;
+
+		Record.Queries.Reset();
+		OutTimings = Timings;
+
+		SET_FLOAT_STAT(STAT_ToneMapFX_GovernedGPUTime, Timings.Ms[(int32)EToneMapGovernedStage::Total]);
+		return true;
+	}
+
+	return false;
+}
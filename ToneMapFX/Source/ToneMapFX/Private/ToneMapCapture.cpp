@@ -0,0 +1,450 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapCapture.h"
+#include "ToneMapComponent.h"
+#include "SceneRendering.h"
+#include "RHIGPUReadback.h"
+#include "RenderGraphUtils.h"
+#include "RenderTargetPool.h"
+#include "ImageCore.h"
+#include "ImageUtils.h"
+#include "Tasks/Task.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+
+// ---------------------------------------------------------------------------
+// View parameters
+// ---------------------------------------------------------------------------
+
+FString FToneMapCaptureView::ToString() const
+{
+	TArray<FString> Lines;
+	Lines.Add(TEXT("# ToneMapFX capture view"));
+	Lines.Add(FString::Printf(TEXT("Width=%d"), ViewSize.X));
+	Lines.Add(FString::Printf(TEXT("Height=%d"), ViewSize.Y));
+	Lines.Add(FString::Printf(TEXT("PreExposure=%.9g"), PreExposure));
+	Lines.Add(FString::Printf(TEXT("EyeAdaptationExposure=%.9g"), EyeAdaptationExposure));
+	Lines.Add(FString::Printf(TEXT("AdaptedLuminance=%.9g"), AdaptedLuminance));
+	Lines.Add(FString::Printf(TEXT("DeltaTime=%.9g"), DeltaTime));
+	Lines.Add(FString::Printf(TEXT("QualityLevel=%d"), QualityLevel));
+	Lines.Add(FString::Printf(TEXT("GlareSamples=%d"), Quality.GlareSamples));
+	Lines.Add(FString::Printf(TEXT("KawaseMipCount=%d"), Quality.KawaseMipCount));
+	Lines.Add(FString::Printf(TEXT("FattalIterations=%d"), Quality.FattalIterations));
+	Lines.Add(FString::Printf(TEXT("CoronaSpikeLength=%d"), Quality.CoronaSpikeLength));
+	Lines.Add(FString::Printf(TEXT("HaloAngularSamples=%d"), Quality.HaloAngularSamples));
+	Lines.Add(FString::Printf(TEXT("BloomBlurPasses=%d"), Quality.BloomBlurPasses));
+	Lines.Add(FString::Printf(TEXT("ClarityRadius=%.9g"), Quality.ClarityRadius));
+	Lines.Add(FString::Printf(TEXT("BloomDownsampleScale=%.9g"), Quality.BloomDownsampleScale));
+	Lines.Add(FString::Printf(TEXT("LensResolutionScale=%.9g"), Quality.LensResolutionScale));
+	Lines.Add(FString::Printf(TEXT("FrameNumber=%llu"), FrameNumber));
+	Lines.Add(FString::Printf(TEXT("ReplaceTonemap=%d"), bReplaceTonemap ? 1 : 0));
+	Lines.Add(FString::Printf(TEXT("EngineBloom=%d"), bEngineBloom ? 1 : 0));
+	Lines.Add(FString::Printf(TEXT("HalfPrecision=%d"), bHalfPrecision ? 1 : 0));
+	Lines.Add(FString::Printf(TEXT("ShaderPlatform=%s"), *ShaderPlatform));
+	return FString::Join(Lines, TEXT("\n")) + TEXT("\n");
+}
+
+bool FToneMapCaptureView::Parse(const FString& Text)
+{
+	const TCHAR* Stream = *Text;
+	if (!FParse::Value(Stream, TEXT("Width="), ViewSize.X) || !FParse::Value(Stream, TEXT("Height="), ViewSize.Y))
+	{
+		return false;
+	}
+
+	int32 ReplaceTonemap = 0, EngineBloom = 0, HalfPrecision = 0;
+	FParse::Value(Stream, TEXT("PreExposure="), PreExposure);
+	FParse::Value(Stream, TEXT("EyeAdaptationExposure="), EyeAdaptationExposure);
+	FParse::Value(Stream, TEXT("AdaptedLuminance="), AdaptedLuminance);
+	FParse::Value(Stream, TEXT("DeltaTime="), DeltaTime);
+	FParse::Value(Stream, TEXT("QualityLevel="), QualityLevel);
+	FParse::Value(Stream, TEXT("GlareSamples="), Quality.GlareSamples);
+	FParse::Value(Stream, TEXT("KawaseMipCount="), Quality.KawaseMipCount);
+	FParse::Value(Stream, TEXT("FattalIterations="), Quality.FattalIterations);
+	FParse::Value(Stream, TEXT("CoronaSpikeLength="), Quality.CoronaSpikeLength);
+	FParse::Value(Stream, TEXT("HaloAngularSamples="), Quality.HaloAngularSamples);
+	FParse::Value(Stream, TEXT("BloomBlurPasses="), Quality.BloomBlurPasses);
+	FParse::Value(Stream, TEXT("ClarityRadius="), Quality.ClarityRadius);
+	FParse::Value(Stream, TEXT("BloomDownsampleScale="), Quality.BloomDownsampleScale);
+	FParse::Value(Stream, TEXT("LensResolutionScale="), Quality.LensResolutionScale);
+	FParse::Value(Stream, TEXT("FrameNumber="), FrameNumber);
+	FParse::Value(Stream, TEXT("ReplaceTonemap="), ReplaceTonemap);
+	FParse::Value(Stream, TEXT("EngineBloom="), EngineBloom);
+	FParse::Value(Stream, TEXT("HalfPrecision="), HalfPrecision);
+	FParse::Value(Stream, TEXT("ShaderPlatform="), ShaderPlatform);
+
+	bReplaceTonemap = ReplaceTonemap != 0;
+	bEngineBloom = EngineBloom != 0;
+	bHalfPrecision = HalfPrecision != 0;
+	return ViewSize.X > 0 && ViewSize.Y > 0;
+}
+
+// ---------------------------------------------------------------------------
+// Image files
+// ---------------------------------------------------------------------------
+
+static bool ToneMapCaptureSaveImage(const FString& Path, const FImage& Image)
+{
+	if (!FImageUtils::SaveImageByExtension(*Path, Image))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: could not write %s"), *Path);
+		return false;
+	}
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// Capture
+// ---------------------------------------------------------------------------
+
+// Game thread only — set by the console command, claimed in SetupView
+static bool GToneMapCaptureRequested = false;
+static FString GToneMapCaptureName;
+
+struct FToneMapFrameCapture::FPending
+{
+	FString Directory;
+	FToneMapCaptureView View;
+	TUniquePtr<FRHIGPUTextureReadback> SceneColor;
+	TUniquePtr<FRHIGPUTextureReadback> Bloom;
+	TUniquePtr<FRHIGPUTextureReadback> AdaptedLum;
+
+	bool IsReady() const
+	{
+		return SceneColor->IsReady()
+			&& (!Bloom || Bloom->IsReady())
+			&& (!AdaptedLum || AdaptedLum->IsReady());
+	}
+};
+
+FToneMapFrameCapture::FToneMapFrameCapture() = default;
+FToneMapFrameCapture::~FToneMapFrameCapture() = default;
+
+void FToneMapFrameCapture::Request(const FString& Name)
+{
+	GToneMapCaptureRequested = true;
+	GToneMapCaptureName = Name.IsEmpty() ? FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S")) : Name;
+}
+
+FString FToneMapFrameCapture::GetCaptureRoot()
+{
+	return FPaths::Combine(UToneMapComponent::GetPresetDirectory(), TEXT("Captures"));
+}
+
+FString FToneMapFrameCapture::BeginCapture_GameThread(const UToneMapComponent& Settings)
+{
+	if (!GToneMapCaptureRequested)
+	{
+		return FString();
+	}
+	GToneMapCaptureRequested = false;
+
+	const FString Directory = FPaths::Combine(GetCaptureRoot(), GToneMapCaptureName);
+	IFileManager::Get().MakeDirectory(*Directory, true);
+	if (!Settings.SavePresetToPath(FPaths::Combine(Directory, TEXT("Settings.txt"))))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: capture %s abandoned, could not write its settings"), *Directory);
+		return FString();
+	}
+	return Directory;
+}
+
+// Draw Source into an RGBA32F texture of Size (any input format, resampled
+// to Size) and queue its copy into a new readback
+static TUniquePtr<FRHIGPUTextureReadback> ToneMapCaptureAddReadback(
+	FRDGBuilder& GraphBuilder, const FViewInfo& View, FScreenPassTexture Source, FIntPoint Size, const TCHAR* Name)
+{
+	FRDGTextureRef Float = GraphBuilder.CreateTexture(
+		FRDGTextureDesc::Create2D(Size, PF_A32B32G32R32F, FClearValueBinding::None, TexCreate_ShaderResource | TexCreate_RenderTargetable),
+		Name);
+	AddDrawTexturePass(GraphBuilder, View, Source,
+		FScreenPassRenderTarget(Float, FIntRect(FIntPoint::ZeroValue, Size), ERenderTargetLoadAction::ENoAction));
+
+	TUniquePtr<FRHIGPUTextureReadback> Readback = MakeUnique<FRHIGPUTextureReadback>(Name);
+	AddEnqueueCopyPass(GraphBuilder, Readback.Get(), Float);
+	return Readback;
+}
+
+void FToneMapFrameCapture::AddPasses(
+	FRDGBuilder& GraphBuilder,
+	const FViewInfo& View,
+	const FString& Directory,
+	const FToneMapCaptureView& CaptureView,
+	FScreenPassTexture SceneColor,
+	FScreenPassTexture Bloom,
+	FRDGTextureRef AdaptedLum)
+{
+	RDG_EVENT_SCOPE(GraphBuilder, "ToneMap_Capture");
+
+	TUniquePtr<FPending> Capture = MakeUnique<FPending>();
+	Capture->Directory = Directory;
+	Capture->View = CaptureView;
+	Capture->View.bEngineBloom = Bloom.IsValid();
+
+	Capture->SceneColor = ToneMapCaptureAddReadback(GraphBuilder, View, SceneColor, CaptureView.ViewSize, TEXT("ToneMap.CaptureSceneColor"));
+	if (Bloom.IsValid())
+	{
+		Capture->Bloom = ToneMapCaptureAddReadback(GraphBuilder, View, Bloom, CaptureView.ViewSize, TEXT("ToneMap.CaptureBloom"));
+	}
+	if (AdaptedLum)
+	{
+		Capture->AdaptedLum = ToneMapCaptureAddReadback(GraphBuilder, View,
+			FScreenPassTexture(AdaptedLum), FIntPoint(1, 1), TEXT("ToneMap.CaptureAdaptedLum"));
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("ToneMapFX: capturing frame %llu into %s"), CaptureView.FrameNumber, *Directory);
+	Pending.Add(MoveTemp(Capture));
+}
+
+// Copy a landed RGBA32F readback into an image, row by row (the readback is pitched)
+static void ToneMapCaptureReadImage(FRHIGPUTextureReadback& Readback, FIntPoint Size, FImage& OutImage)
+{
+	OutImage.Init(Size.X, Size.Y, ERawImageFormat::RGBA32F, EGammaSpace::Linear);
+
+	int32 RowPitchInPixels = 0;
+	const FLinearColor* Source = static_cast<const FLinearColor*>(Readback.Lock(RowPitchInPixels));
+	const TArrayView64<FLinearColor> Dest = OutImage.AsRGBA32F();
+	for (int32 Y = 0; Y < Size.Y; ++Y)
+	{
+		FMemory::Memcpy(&Dest[(int64)Y * Size.X], Source + (int64)Y * RowPitchInPixels, Size.X * sizeof(FLinearColor));
+	}
+	Readback.Unlock();
+}
+
+void FToneMapFrameCapture::Poll_RenderThread()
+{
+	for (int32 Index = 0; Index < Pending.Num(); ++Index)
+	{
+		if (!Pending[Index]->IsReady())
+		{
+			continue;
+		}
+		TUniquePtr<FPending> Capture = MoveTemp(Pending[Index]);
+		Pending.RemoveAt(Index--);
+
+		FImage SceneColor;
+		ToneMapCaptureReadImage(*Capture->SceneColor, Capture->View.ViewSize, SceneColor);
+
+		FImage Bloom;
+		if (Capture->Bloom)
+		{
+			ToneMapCaptureReadImage(*Capture->Bloom, Capture->View.ViewSize, Bloom);
+		}
+		if (Capture->AdaptedLum)
+		{
+			FImage AdaptedLum;
+			ToneMapCaptureReadImage(*Capture->AdaptedLum, FIntPoint(1, 1), AdaptedLum);
+			Capture->View.AdaptedLuminance = AdaptedLum.AsRGBA32F()[0].R;
+		}
+
+		// EXR encoding takes far longer than a frame — keep it off the render thread
+		UE::Tasks::Launch(UE_SOURCE_LOCATION,
+			[Directory = Capture->Directory, View = Capture->View, SceneColor = MoveTemp(SceneColor), Bloom = MoveTemp(Bloom)]()
+			{
+				bool bWritten = ToneMapCaptureSaveImage(FPaths::Combine(Directory, TEXT("SceneColor.exr")), SceneColor);
+				if (View.bEngineBloom)
+				{
+					bWritten &= ToneMapCaptureSaveImage(FPaths::Combine(Directory, TEXT("Bloom.exr")), Bloom);
+				}
+				bWritten &= FFileHelper::SaveStringToFile(View.ToString(), *FPaths::Combine(Directory, TEXT("View.txt")));
+
+				UE_LOG(LogTemp, Log, TEXT("ToneMapFX: capture %s %s"), *Directory, bWritten ? TEXT("written") : TEXT("incomplete"));
+			});
+	}
+}
+
+static FAutoConsoleCommand CmdToneMapCapture(
+	TEXT("r.ToneMapFX.Capture"),
+	TEXT("Capture the next ToneMapFX frame (scene colour, engine bloom, exposure, settings snapshot, view parameters)\n")
+	TEXT("into Saved/ToneMapFX/Captures/<Name>.  Name defaults to a timestamp.  Replay with r.ToneMapFX.Replay."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		FToneMapFrameCapture::Request(Args.Num() > 0 ? Args[0] : FString());
+	}));
+
+// ---------------------------------------------------------------------------
+// GPU replay
+// ---------------------------------------------------------------------------
+
+// Governed-stage samples dropped before averaging — the stage timer's ring
+// depth, so every sample kept was issued by an injected frame
+static constexpr int32 GToneMapReplayWarmupSamples = 4;
+
+static const TCHAR* const GToneMapGovernedStageNames[] = { TEXT("Total"), TEXT("Bloom"), TEXT("Fattal"), TEXT("LensEffects") };
+static_assert(UE_ARRAY_COUNT(GToneMapGovernedStageNames) == (int32)EToneMapGovernedStage::Num, "Stage names out of sync");
+
+FToneMapGPUReplay::FToneMapGPUReplay(const FToneMapCaptureData& Capture, int32 InNumFrames)
+	: Directory(Capture.Directory)
+	, ViewSize(Capture.View.ViewSize)
+	, NumFrames(FMath::Max(InNumFrames, 1))
+{
+	Pixels.SetNumUninitialized(Capture.SceneColor.Pixels.Num());
+	for (int32 i = 0; i < Pixels.Num(); ++i)
+	{
+		const ToneMapColorMath::float3& C = Capture.SceneColor.Pixels[i];
+		Pixels[i] = FLinearColor(C.x, C.y, C.z, 1.0f);
+	}
+}
+
+bool FToneMapGPUReplay::Inject_RenderThread(FRDGBuilder& GraphBuilder, const FViewInfo& View, FScreenPassTexture& InOutSceneColor)
+{
+	if (IsFinished())
+	{
+		return false;
+	}
+	if (InOutSceneColor.ViewRect.Size() != ViewSize)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: GPU replay of %s stopped, the view is %dx%d but the capture %dx%d"),
+			*Directory, InOutSceneColor.ViewRect.Width(), InOutSceneColor.ViewRect.Height(), ViewSize.X, ViewSize.Y);
+		Finish_RenderThread();
+		return false;
+	}
+
+	if (!SceneColorRT.IsValid())
+	{
+		const FRHITextureCreateDesc Desc = FRHITextureCreateDesc::Create2D(TEXT("ToneMap.ReplaySceneColor"), ViewSize, PF_A32B32G32R32F)
+			.SetFlags(ETextureCreateFlags::ShaderResource);
+		FTextureRHIRef Texture = RHICreateTexture(Desc);
+		GraphBuilder.RHICmdList.UpdateTexture2D(Texture, 0,
+			FUpdateTextureRegion2D(0, 0, 0, 0, ViewSize.X, ViewSize.Y), ViewSize.X * sizeof(FLinearColor), (const uint8*)Pixels.GetData());
+		SceneColorRT = CreateRenderTarget(Texture, TEXT("ToneMap.ReplaySceneColor"));
+		Pixels.Empty();
+	}
+
+	// Same extent, format and rect as the view's scene colour, so the cached
+	// view setup and every later stage see the frame they expect
+	const FRDGTextureDesc& SceneDesc = InOutSceneColor.Texture->Desc;
+	FRDGTextureRef Injected = GraphBuilder.CreateTexture(
+		FRDGTextureDesc::Create2D(SceneDesc.Extent, SceneDesc.Format, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_RenderTargetable),
+		TEXT("ToneMap.ReplaySceneColor"));
+	AddDrawTexturePass(GraphBuilder, View,
+		FScreenPassTexture(GraphBuilder.RegisterExternalTexture(SceneColorRT), FIntRect(FIntPoint::ZeroValue, ViewSize)),
+		FScreenPassRenderTarget(Injected, InOutSceneColor.ViewRect, ERenderTargetLoadAction::EClear));
+
+	InOutSceneColor = FScreenPassTexture(Injected, InOutSceneColor.ViewRect);
+	++NumInjected;
+	return true;
+}
+
+void FToneMapGPUReplay::AddTimings_RenderThread(const FToneMapStageTimings& Timings)
+{
+	if (IsFinished() || NumInjected <= GToneMapReplayWarmupSamples)
+	{
+		return;
+	}
+
+	for (int32 Stage = 0; Stage < (int32)EToneMapGovernedStage::Num; ++Stage)
+	{
+		Sum.Ms[Stage] += Timings.Ms[Stage];
+	}
+	if (++NumSamples >= NumFrames)
+	{
+		Finish_RenderThread();
+	}
+}
+
+void FToneMapGPUReplay::Finish_RenderThread()
+{
+	bFinished.store(true, std::memory_order_release);
+	SceneColorRT.SafeRelease();
+	if (NumSamples == 0)
+	{
+		return;
+	}
+
+	TArray<FString> Entries;
+	UE_LOG(LogTemp, Log, TEXT("ToneMapFX: GPU replay of %s, %d frame(s), %dx%d"), *Directory, NumSamples, ViewSize.X, ViewSize.Y);
+	for (int32 Stage = 0; Stage < (int32)EToneMapGovernedStage::Num; ++Stage)
+	{
+		const float Ms = Sum.Ms[Stage] / (float)NumSamples;
+		UE_LOG(LogTemp, Log, TEXT("ToneMapFX:   %-12s %8.3f ms"), GToneMapGovernedStageNames[Stage], Ms);
+		Entries.Add(FString::Printf(TEXT("    \"%s\": %.4f"), GToneMapGovernedStageNames[Stage], Ms));
+	}
+
+	const FString Json = FString::Printf(TEXT("{\n  \"width\": %d,\n  \"height\": %d,\n  \"frames\": %d,\n  \"gpuMs\": {\n%s\n  }\n}\n"),
+		ViewSize.X, ViewSize.Y, NumSamples, *FString::Join(Entries, TEXT(",\n")));
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [Path = FPaths::Combine(Directory, TEXT("GPUReplayTimings.json")), Json]()
+	{
+		if (!FFileHelper::SaveStringToFile(Json, *Path))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: could not write %s"), *Path);
+		}
+	});
+}
+
+// ---------------------------------------------------------------------------
+// Replay
+// ---------------------------------------------------------------------------
+
+FString FToneMapReplay::ResolveCaptureDirectory(const FString& NameOrPath)
+{
+	const FString UnderRoot = FPaths::Combine(FToneMapFrameCapture::GetCaptureRoot(), NameOrPath);
+	return IFileManager::Get().DirectoryExists(*UnderRoot) ? UnderRoot : NameOrPath;
+}
+
+bool FToneMapReplay::Load(const FString& Directory, FToneMapCaptureData& OutCapture)
+{
+	OutCapture.Directory = Directory;
+
+	FString ViewText;
+	if (!FFileHelper::LoadFileToString(ViewText, *FPaths::Combine(Directory, TEXT("View.txt"))) || !OutCapture.View.Parse(ViewText))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: %s is not a complete capture (View.txt missing or malformed)"), *Directory);
+		return false;
+	}
+
+	OutCapture.Settings.Reset(NewObject<UToneMapComponent>(GetTransientPackage()));
+	if (!OutCapture.Settings->LoadPresetFromPath(FPaths::Combine(Directory, TEXT("Settings.txt"))))
+	{
+		return false;
+	}
+
+	if (!OutCapture.SceneColor.LoadFromFile(FPaths::Combine(Directory, TEXT("SceneColor.exr"))))
+	{
+		return false;
+	}
+	if (OutCapture.View.bEngineBloom && !OutCapture.Bloom.LoadFromFile(FPaths::Combine(Directory, TEXT("Bloom.exr"))))
+	{
+		return false;
+	}
+
+	if (OutCapture.SceneColor.Width != OutCapture.View.ViewSize.X || OutCapture.SceneColor.Height != OutCapture.View.ViewSize.Y
+		|| (OutCapture.View.bEngineBloom && OutCapture.Bloom.Pixels.Num() != OutCapture.SceneColor.Pixels.Num()))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: capture %s images do not match its %dx%d view"),
+			*Directory, OutCapture.View.ViewSize.X, OutCapture.View.ViewSize.Y);
+		return false;
+	}
+	return true;
+}
+
+// Game thread only — set by RequestGPU, claimed in SetupView
+static FString GToneMapGPUReplayDirectory;
+static int32 GToneMapGPUReplayFrames = 0;
+
+bool FToneMapReplay::RequestGPU(const FString& Directory, int32 NumFrames)
+{
+	if (!IFileManager::Get().FileExists(*FPaths::Combine(Directory, TEXT("View.txt"))))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: %s is not a capture"), *Directory);
+		return false;
+	}
+	GToneMapGPUReplayDirectory = Directory;
+	GToneMapGPUReplayFrames = FMath::Max(NumFrames, 1);
+	return true;
+}
+
+bool FToneMapReplay::ClaimGPURequest_GameThread(FString& OutDirectory, int32& OutNumFrames)
+{
+	if (GToneMapGPUReplayDirectory.IsEmpty())
+	{
+		return false;
+	}
+	OutDirectory = MoveTemp(GToneMapGPUReplayDirectory);
+	OutNumFrames = GToneMapGPUReplayFrames;
+	GToneMapGPUReplayDirectory.Reset();
+	return true;
+}
@@ -0,0 +1,101 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapColorAverage.h"
+#include "ToneMapTransientTextures.h"
+#include "ToneMapPSOPrecache.h"
+#include "HAL/IConsoleManager.h"
+#include "RenderGraphUtils.h"
+
+IMPLEMENT_GLOBAL_SHADER(FToneMapColorAverageReduceCS,  "/Plugin/ToneMapFX/Private/ToneMapColorAverage.usf", "ColorAverageReduceCS",  SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FToneMapColorAverageResolveCS, "/Plugin/ToneMapFX/Private/ToneMapColorAverage.usf", "ColorAverageResolveCS", SF_Compute);
+
+static TAutoConsoleVariable<int32> CVarToneMapGlobalColorCast(
+	TEXT("r.ToneMapFX.GlobalColorCast"),
+	1,
+	TEXT("Reference colour for Correct Color Cast.\n")
+	TEXT(" 0: local radius-32 blur (coarse Dynamic Contrast blur)\n")
+	TEXT(" 1: frame mean colour from a GPU reduction (default)\n")
+	TEXT(" 2: luma-weighted frame mean, each pixel weighted by 1 / (1 + luma)"),
+	ECVF_RenderThreadSafe | ECVF_Scalability);
+
+static TAutoConsoleVariable<float> CVarToneMapColorCastAdaptSpeed(
+	TEXT("r.ToneMapFX.ColorCastAdaptSpeed"),
+	2.0f,
+	TEXT("Temporal smoothing rate (1/s) of the frame-average colour used by Correct Color Cast.\n")
+	TEXT("0 uses each frame's average directly."),
+	ECVF_RenderThreadSafe);
+
+bool FToneMapColorAverage::UseGlobal_RenderThread()
+{
+	return CVarToneMapGlobalColorCast.GetValueOnRenderThread() != 0;
+}
+
+FRDGTextureRef FToneMapColorAverage::AddPasses(
+	FRDGBuilder& GraphBuilder,
+	const FGlobalShaderMap* ShaderMap,
+	FToneMapTransientTextures& Transients,
+	FRDGTextureRef SceneColor,
+	const FIntRect& SceneRect,
+	TRefCountPtr<IPooledRenderTarget>& History,
+	float DeltaTime)
+{
+	RDG_EVENT_SCOPE(GraphBuilder, "ToneMap_ColorAverage");
+
+	// --- Step 1: per-group partial sums (each group covers 2·GroupSize texels square) ---
+	const int32 GroupTexels = FToneMapColorAverageReduceCS::GroupSize * 2;
+	const FIntPoint NumGroups(
+		FMath::DivideAndRoundUp(SceneRect.Width(), GroupTexels),
+		FMath::DivideAndRoundUp(SceneRect.Height(), GroupTexels));
+	const int32 NumPartials = NumGroups.X * NumGroups.Y;
+
+	FRDGBufferRef PartialSums = Transients.CreateBuffer(
+		FRDGBufferDesc::CreateStructuredDesc(sizeof(FVector4f), NumPartials),
+		TEXT("ToneMap.ColorAveragePartials"));
+	{
+		const FIntPoint Extent = SceneColor->Desc.Extent;
+
+		auto* P = GraphBuilder.AllocParameters<FToneMapColorAverageReduceCS::FParameters>();
+		P->SceneColorTexture   = SceneColor;
+		P->SceneColorSampler   = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+		P->SceneColorRect      = FIntVector4(SceneRect.Min.X, SceneRect.Min.Y, SceneRect.Max.X, SceneRect.Max.Y);
+		P->SceneColorExtentInv = FVector2f(1.0f / Extent.X, 1.0f / Extent.Y);
+		P->LumaWeighting       = CVarToneMapGlobalColorCast.GetValueOnRenderThread() == 2 ? 1.0f : 0.0f;
+		P->PartialSums         = GraphBuilder.CreateUAV(PartialSums);
+
+		TShaderMapRef<FToneMapColorAverageReduceCS> ComputeShader(ShaderMap);
+		AddToneMapComputePass(
+			GraphBuilder, RDG_EVENT_NAME("ToneMap_ColorAverageReduce"), ERDGPassFlags::Compute,
+			ComputeShader, P, FIntVector(NumGroups.X, NumGroups.Y, 1));
+	}
+
+	// --- Step 2: sum partials, blend with history (→ 1x1 persistent texture) ---
+	FRDGTextureRef Average = GraphBuilder.CreateTexture(
+		FRDGTextureDesc::Create2D(FIntPoint(1, 1), PF_A32B32G32R32F, FClearValueBinding::None,
+			TexCreate_ShaderResource | TexCreate_UAV),
+		TEXT("ToneMap.ColorAverage"));
+	{
+		const bool bHasHistory = History.IsValid();
+
+		auto* P = GraphBuilder.AllocParameters<FToneMapColorAverageResolveCS::FParameters>();
+		P->PartialSumsSRV     = GraphBuilder.CreateSRV(PartialSums);
+		P->NumPartials        = (uint32)NumPartials;
+		// Without history the shader ignores the texture; scene colour keeps the slot valid
+		P->PrevAverageTexture = bHasHistory
+			? GraphBuilder.RegisterExternalTexture(History, TEXT("ToneMap.PrevColorAverage"))
+			: SceneColor;
+		P->bHasPrevAverage    = bHasHistory ? 1.0f : 0.0f;
+		P->AdaptSpeed         = FMath::Max(CVarToneMapColorCastAdaptSpeed.GetValueOnRenderThread(), 0.0f);
+		P->DeltaTime          = FMath::Max(DeltaTime, 0.001f);
+		P->AverageOutput      = GraphBuilder.CreateUAV(Average);
+
+		TShaderMapRef<FToneMapColorAverageResolveCS> ComputeShader(ShaderMap);
+		AddToneMapComputePass(
+			GraphBuilder, RDG_EVENT_NAME("ToneMap_ColorAverageResolve (%d partials)", NumPartials), ERDGPassFlags::Compute,
+			ComputeShader, P, FIntVector(1, 1, 1));
+	}
+	Transients.Release(PartialSums);
+
+	// Extract for next frame's temporal blending
+	GraphBuilder.QueueTextureExtraction(Average, &History);
+	return Average;
+}
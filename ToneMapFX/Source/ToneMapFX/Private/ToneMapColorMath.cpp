@@ -0,0 +1,163 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapColorMath.h"
+
+// ---------------------------------------------------------------------------
+// Golden operators — fixed, non-neutral parameters so every branch is hit
+// ---------------------------------------------------------------------------
+
+static const TCHAR* GColorMathOperatorNames[] =
+{
+	TEXT("WhiteBalance"),
+	TEXT("Exposure"),
+	TEXT("ToneAdjustments"),
+	TEXT("Contrast"),
+	TEXT("Clarity"),
+	TEXT("DynamicContrast"),
+	TEXT("CorrectContrast"),
+	TEXT("CorrectColorCast"),
+	TEXT("RGBToHSL"),
+	TEXT("HSLRoundTrip"),
+	TEXT("HSL"),
+	TEXT("Vibrance"),
+	TEXT("Saturation"),
+	TEXT("ToneCurve"),
+	TEXT("Hable"),
+	TEXT("ReinhardLuminance"),
+	TEXT("ReinhardJodie"),
+	TEXT("ReinhardStandard"),
+	TEXT("AgX"),
+	TEXT("AgXPunchy"),
+	TEXT("AgXGolden"),
+	TEXT("LinearToSRGB"),
+};
+
+static const float GColorMathLatticeLevels[FToneMapColorMath::LatticeLevels] = { 0.0f, 0.02f, 0.18f, 0.5f, 1.0f, 4.0f };
+
+int32 FToneMapColorMath::GetNumOperators()
+{
+	return UE_ARRAY_COUNT(GColorMathOperatorNames);
+}
+
+const TCHAR* FToneMapColorMath::GetOperatorName(int32 Operator)
+{
+	return (Operator >= 0 && Operator < GetNumOperators()) ? GColorMathOperatorNames[Operator] : TEXT("?");
+}
+
+ToneMapColorMath::float3 FToneMapColorMath::GetLatticeColor(int32 Index)
+{
+	return ToneMapColorMath::float3(
+		GColorMathLatticeLevels[Index % LatticeLevels],
+		GColorMathLatticeLevels[(Index / LatticeLevels) % LatticeLevels],
+		GColorMathLatticeLevels[Index / (LatticeLevels * LatticeLevels)]);
+}
+
+// Operators with a min16float overload (everything but the film curves), on
+// float or on ToneMapColorMath::Half.  R / R3 / R4 play TM_REAL's role so
+// both builds see the same parameters.
+template<typename R, typename R3, typename R4>
+static R3 EvaluateGradingOperator(int32 Operator, const R3& Color)
+{
+	using namespace ToneMapColorMath;
+
+	// Stand-ins for the spatial inputs (blurs, scene average)
+	const R3 BlurFine   = Color * R(0.8f);
+	const R3 BlurMed    = Color * R(0.6f);
+	const R3 BlurCoarse = Color * R(0.5f) + R(0.05f);
+	const R3 SceneAvg(R(0.30f), R(0.25f), R(0.20f));
+
+	switch (Operator)
+	{
+	case 0:  return ApplyWhiteBalance(Color, R(40.0f), R(-25.0f));
+	case 1:  return ApplyExposure(Color, R(1.5f));
+	case 2:  return ApplyToneAdjustments(Color, R(30.0f), R(-20.0f), R(15.0f), R(-10.0f), R(50.0f));
+	case 3:  return ApplyContrast(Color, R(35.0f), R(0.18f));
+	case 4:  return ApplyClarity(Color, Color * R(0.5f) + R(0.1f), R(60.0f));
+	case 5:  return ApplyDynamicContrast(Color, BlurFine, BlurMed, BlurCoarse, R(70.0f));
+	case 6:  return ApplyCorrectContrast(Color, SceneAvg, R(50.0f));
+	case 7:  return ApplyCorrectColorCast(Color, SceneAvg, R(60.0f));
+	case 8:  return RGBToHSL(saturate(Color));
+	case 9:  return HSLToRGB(RGBToHSL(saturate(Color)));
+	case 10: return ApplyHSL(Color,
+				R4(R(20.0f), R(-10.0f), R(15.0f), R(-30.0f)), R4(R(25.0f), R(-20.0f), R(10.0f), R(-5.0f)),
+				R4(R(30.0f), R(-40.0f), R(20.0f), R(10.0f)), R4(R(-15.0f), R(35.0f), R(-25.0f), R(5.0f)),
+				R4(R(-10.0f), R(15.0f), R(25.0f), R(-20.0f)), R4(R(10.0f), R(-5.0f), R(30.0f), R(-35.0f)),
+				R(40.0f));
+	case 11: return ApplyVibrance(Color, R(40.0f));
+	case 12: return ApplySaturation(Color, R(-30.0f));
+	case 13: return ApplyToneCurve(saturate(Color), R4(R(20.0f), R(-10.0f), R(15.0f), R(-25.0f)));
+	case 21: return LinearToSRGB(saturate(Color));
+	default: return Color;
+	}
+}
+
+bool FToneMapColorMath::HasHalfVariant(int32 Operator)
+{
+	// 14..20 are Hable, the Reinhards and AgX
+	return (Operator >= 0 && Operator < 14) || Operator == 21;
+}
+
+ToneMapColorMath::float3 FToneMapColorMath::EvaluateOperator(int32 Operator, const ToneMapColorMath::float3& Color)
+{
+	using namespace ToneMapColorMath;
+
+	if (HasHalfVariant(Operator))
+	{
+		return EvaluateGradingOperator<float, float3, float4>(Operator, Color);
+	}
+
+	// Component defaults for the film curves
+	const float4 HableParams1(0.15f, 0.50f, 0.10f, 0.20f);
+	const float4 HableParams2(0.02f, 0.30f, 11.2f, 0.0f);
+	const float  ReinhardWP = 4.0f;
+
+	switch (Operator)
+	{
+	case 14: return ApplyFilmCurve(Color, 0.0f, HableParams1, HableParams2, ReinhardWP, float4(0.0f));
+	case 15: return ApplyFilmCurve(Color, 1.0f, HableParams1, HableParams2, ReinhardWP, float4(0.0f));
+	case 16: return ApplyFilmCurve(Color, 2.0f, HableParams1, HableParams2, ReinhardWP, float4(0.0f));
+	case 17: return ApplyFilmCurve(Color, 3.0f, HableParams1, HableParams2, ReinhardWP, float4(0.0f));
+	case 18: return AgXToneMap(Color, float4(-10.0f, 6.5f, 0.0f, 0.0f));
+	case 19: return AgXToneMap(Color, float4(-10.0f, 6.5f, 1.0f, 0.0f));
+	case 20: return AgXToneMap(Color, float4(-10.0f, 6.5f, 2.0f, 0.0f));
+	default: return Color;
+	}
+}
+
+ToneMapColorMath::float3 FToneMapColorMath::EvaluateOperatorHalf(int32 Operator, const ToneMapColorMath::float3& Color)
+{
+	using namespace ToneMapColorMath::Half;
+
+	if (!HasHalfVariant(Operator))
+	{
+		return EvaluateOperator(Operator, Color);
+	}
+	return EvaluateGradingOperator<half, half3, half4>(Operator, half3(Color)).ToFloat();
+}
+
+void FToneMapColorMath::MeasureHalfPrecisionError(int32 Operator, float& OutMaxErrorLDR, float& OutMaxErrorHDR)
+{
+	using namespace ToneMapColorMath;
+
+	OutMaxErrorLDR = 0.0f;
+	OutMaxErrorHDR = 0.0f;
+	if (!HasHalfVariant(Operator))
+	{
+		return;
+	}
+
+	for (int32 Index = 0; Index < LatticeSize; ++Index)
+	{
+		const float3 Input = GetLatticeColor(Index);
+		const float3 Expected = EvaluateOperator(Operator, Input);
+		const float3 Actual = EvaluateOperatorHalf(Operator, Input);
+
+		const float3 Diff = abs(Actual - Expected);
+		const float3 Relative = Diff / max(abs(Expected), 1.0f);
+		OutMaxErrorHDR = FMath::Max(OutMaxErrorHDR, FMath::Max3(Relative.x, Relative.y, Relative.z));
+		if (FMath::Max3(Input.x, Input.y, Input.z) <= 1.0f)
+		{
+			OutMaxErrorLDR = FMath::Max(OutMaxErrorLDR, FMath::Max3(Diff.x, Diff.y, Diff.z));
+		}
+	}
+}
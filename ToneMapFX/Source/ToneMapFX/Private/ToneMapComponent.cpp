@@ -2,6 +2,9 @@
 
 #include "ToneMapComponent.h"
 #include "ToneMapSubsystem.h"
+#include "ToneMapPresetAsset.h"
+#include "ToneMapVolumes.h"
+#include "Engine/AssetManager.h"
 #include "Engine/World.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
@@ -16,7 +19,10 @@
 
 UToneMapComponent::UToneMapComponent()
 {
-	PrimaryComponentTick.bCanEverTick = false;
+	// Ticks only while a preset transition is running
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	bTickInEditor = true;
 	bAutoActivate = true;
 }
 
@@ -48,6 +54,24 @@ void UToneMapComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 	Super::EndPlay(EndPlayReason);
 }
 
+void UToneMapComponent::OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	Super::OnUpdateTransform(UpdateTransformFlags, Teleport);
+	if (!bUnbound)
+	{
+		MarkVolumeDirty();
+	}
+}
+
+FBoxSphereBounds UToneMapComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+	if (bUnbound)
+	{
+		return Super::CalcBounds(LocalToWorld);
+	}
+	return FBoxSphereBounds(FBox(-BoxExtent.GetAbs(), BoxExtent.GetAbs())).TransformBy(LocalToWorld);
+}
+
 // ---------------------------------------------------------------------------
 // Subsystem registration
 // ---------------------------------------------------------------------------
@@ -74,6 +98,53 @@ void UToneMapComponent::UnregisterFromSubsystem()
 	}
 }
 
+FToneMapExposureStats UToneMapComponent::GetLastMeasuredExposure() const
+{
+	if (UWorld* World = GetWorld())
+	{
+		if (const UToneMapSubsystem* Subsystem = World->GetSubsystem<UToneMapSubsystem>())
+		{
+			return Subsystem->GetLastExposureStats();
+		}
+	}
+	return FToneMapExposureStats();
+}
+
+void UToneMapComponent::MarkVolumeDirty()
+{
+	if (UWorld* World = GetWorld())
+	{
+		if (UToneMapSubsystem* Subsystem = World->GetSubsystem<UToneMapSubsystem>())
+		{
+			Subsystem->MarkVolumesDirty();
+		}
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Volume
+// ---------------------------------------------------------------------------
+
+void UToneMapComponent::SetUnbound(bool bInUnbound)
+{
+	bUnbound = bInUnbound;
+	UpdateBounds();
+	MarkVolumeDirty();
+}
+
+void UToneMapComponent::SetBoxExtent(FVector InBoxExtent)
+{
+	BoxExtent = InBoxExtent;
+	UpdateBounds();
+	MarkVolumeDirty();
+}
+
+void UToneMapComponent::SetBlendRadius(float InBlendRadius)
+{
+	BlendRadius = FMath::Max(InBlendRadius, 0.0f);
+	MarkVolumeDirty();
+}
+
 // ---------------------------------------------------------------------------
 // Helpers
 // ---------------------------------------------------------------------------
@@ -90,8 +161,59 @@ static const TSet<FString> GPresetSkipProperties = {
 	TEXT("AssetUserData"),
 	TEXT("bReplicates"),
 	TEXT("bNetAddressable"),
+	// Volume placement belongs to the level, not to the look
+	TEXT("bUnbound"),
+	TEXT("BoxExtent"),
+	TEXT("BlendRadius"),
+	TEXT("BlendWeight"),
+	TEXT("Priority"),
+};
+
+// Preset property table — the component layout is fixed for the session, so
+// reflection is walked once instead of on every save / load / asset apply.
+struct FToneMapPresetPropertyCache
+{
+	TArray<FProperty*> Properties;
+	TMap<FName, FProperty*> ByName;
+
+	FToneMapPresetPropertyCache()
+	{
+		for (TFieldIterator<FProperty> It(UToneMapComponent::StaticClass()); It; ++It)
+		{
+			FProperty* Prop = *It;
+			if (!Prop) continue;
+
+			// Only properties declared on UToneMapComponent (not inherited USceneComponent ones)
+			if (Prop->GetOwnerClass() != UToneMapComponent::StaticClass()) continue;
+			if (GPresetSkipProperties.Contains(Prop->GetName())) continue;
+
+			// Events are bindings, not settings; transient members are runtime state
+			if (Prop->IsA<FMulticastDelegateProperty>()) continue;
+			if (Prop->HasAnyPropertyFlags(CPF_Transient)) continue;
+
+			Properties.Add(Prop);
+			ByName.Add(Prop->GetFName(), Prop);
+		}
+	}
 };
 
+static const FToneMapPresetPropertyCache& GetPresetPropertyCache()
+{
+	static const FToneMapPresetPropertyCache Cache;
+	return Cache;
+}
+
+const TArray<FProperty*>& UToneMapComponent::GetPresetProperties()
+{
+	return GetPresetPropertyCache().Properties;
+}
+
+FProperty* UToneMapComponent::FindPresetProperty(FName PropertyName)
+{
+	FProperty* const* Found = GetPresetPropertyCache().ByName.Find(PropertyName);
+	return Found ? *Found : nullptr;
+}
+
 FString UToneMapComponent::GetPresetDirectory()
 {
 	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ToneMapFX"));
@@ -167,20 +289,11 @@ bool UToneMapComponent::SavePresetToPath(const FString& FilePath) const
 	Lines.Add(FString::Printf(TEXT("# Saved: %s"), *FDateTime::Now().ToString()));
 	Lines.Add(TEXT("# --------------------------------------------------------"));
 
-	// Iterate every UPROPERTY on this class via UE reflection
-	for (TFieldIterator<FProperty> It(GetClass()); It; ++It)
+	// Iterate every preset UPROPERTY via UE reflection
+	for (FProperty* Prop : GetPresetProperties())
 	{
-		FProperty* Prop = *It;
-		if (!Prop) continue;
-
 		const FString PropName = Prop->GetName();
 
-		// Skip internal / engine properties
-		if (GPresetSkipProperties.Contains(PropName)) continue;
-
-		// Only serialise properties declared on UToneMapComponent (not inherited USceneComponent ones)
-		if (Prop->GetOwnerClass() != UToneMapComponent::StaticClass()) continue;
-
 		// Export value to string using UE's built-in text export
 		FString ValueStr;
 		const void* ValuePtr = Prop->ContainerPtrToValuePtr<void>(this);
@@ -214,17 +327,6 @@ bool UToneMapComponent::LoadPresetFromPath(const FString& FilePath)
 		return false;
 	}
 
-	// Build a lookup map: property name → FProperty*
-	TMap<FString, FProperty*> PropMap;
-	for (TFieldIterator<FProperty> It(GetClass()); It; ++It)
-	{
-		FProperty* Prop = *It;
-		if (Prop && Prop->GetOwnerClass() == UToneMapComponent::StaticClass())
-		{
-			PropMap.Add(Prop->GetName(), Prop);
-		}
-	}
-
 	int32 Applied = 0;
 	int32 Skipped = 0;
 
@@ -245,8 +347,8 @@ bool UToneMapComponent::LoadPresetFromPath(const FString& FilePath)
 		Key.TrimStartAndEndInline();
 		Value.TrimStartAndEndInline();
 
-		FProperty** FoundProp = PropMap.Find(Key);
-		if (!FoundProp || !(*FoundProp))
+		FProperty* Prop = FindPresetProperty(FName(*Key, FNAME_Find));
+		if (!Prop)
 		{
 			// Property may have been removed in a newer/older version — skip gracefully
 			UE_LOG(LogTemp, Verbose, TEXT("ToneMapFX: Preset key '%s' not found on component, skipping"), *Key);
@@ -254,7 +356,6 @@ bool UToneMapComponent::LoadPresetFromPath(const FString& FilePath)
 			continue;
 		}
 
-		FProperty* Prop = *FoundProp;
 		void* ValuePtr = Prop->ContainerPtrToValuePtr<void>(this);
 
 		// Import value from string using UE's built-in text import
@@ -282,6 +383,145 @@ bool UToneMapComponent::LoadPresetFromPath(const FString& FilePath)
 	return Applied > 0;
 }
 
+bool UToneMapComponent::ApplyPreset(const UToneMapPresetAsset* Preset)
+{
+	if (!Preset || Preset->Settings.IsEmpty())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: ApplyPreset called with an empty preset asset"));
+		return false;
+	}
+
+	const int32 Applied = Preset->Settings.ApplyTo(*this);
+	UE_LOG(LogTemp, Verbose, TEXT("ToneMapFX: Preset asset applied ← %s (%d properties)"), *Preset->GetName(), Applied);
+
+#if WITH_EDITOR
+	FPropertyChangedEvent ChangedEvent(nullptr, EPropertyChangeType::ValueSet);
+	PostEditChangeProperty(ChangedEvent);
+#endif
+
+	return Applied > 0;
+}
+
+void UToneMapComponent::LoadPresetAsync(TSoftObjectPtr<UToneMapPresetAsset> Preset)
+{
+	// Only the most recent request wins
+	if (PresetLoadHandle.IsValid())
+	{
+		if (PresetLoadHandle->IsLoadingInProgress())
+		{
+			PresetLoadHandle->CancelHandle();
+		}
+		PresetLoadHandle.Reset();
+	}
+
+	if (Preset.IsNull()) return;
+
+	// Already resident (e.g. referenced by the level) — no streaming round-trip
+	if (UToneMapPresetAsset* Loaded = Preset.Get())
+	{
+		ApplyPreset(Loaded);
+		OnPresetLoaded.Broadcast(Loaded);
+		return;
+	}
+
+	// The handle is kept after completion so the preset stays resident for re-use
+	PresetLoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		Preset.ToSoftObjectPath(),
+		FStreamableDelegate::CreateWeakLambda(this, [this, Preset]()
+		{
+			UToneMapPresetAsset* Loaded = Preset.Get();
+			if (!Loaded)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: Failed to stream preset asset %s"), *Preset.ToString());
+				return;
+			}
+
+			ApplyPreset(Loaded);
+			OnPresetLoaded.Broadcast(Loaded);
+		}));
+}
+
+// ---------------------------------------------------------------------------
+// Preset transitions
+// ---------------------------------------------------------------------------
+
+void UToneMapComponent::TransitionToPreset(const UToneMapPresetAsset* Preset, float Duration, EToneMapTransitionCurve Curve)
+{
+	if (!Preset || Preset->Settings.IsEmpty())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: TransitionToPreset called with an empty preset asset"));
+		return;
+	}
+
+	if (Duration <= 0.0f)
+	{
+		bTransitioning = false;
+		SetComponentTickEnabled(false);
+		ApplyPreset(Preset);
+		return;
+	}
+
+	if (!TransitionFrom)
+	{
+		TransitionFrom = NewObject<UToneMapComponent>(GetTransientPackage(), NAME_None, RF_Transient);
+		TransitionTo   = NewObject<UToneMapComponent>(GetTransientPackage(), NAME_None, RF_Transient);
+	}
+
+	// Start from whatever is showing now (possibly mid-way through another transition)
+	FToneMapSettingsBlend::Copy(*TransitionFrom, *this);
+	FToneMapSettingsBlend::Copy(*TransitionTo, *this);
+	Preset->Settings.ApplyTo(*TransitionTo);
+
+	TransitionElapsed  = 0.0f;
+	TransitionDuration = Duration;
+	TransitionCurve    = Curve;
+	bTransitioning     = true;
+	SetComponentTickEnabled(true);
+
+	UE_LOG(LogTemp, Verbose, TEXT("ToneMapFX: Transition to %s over %.2fs"), *Preset->GetName(), Duration);
+}
+
+float UToneMapComponent::GetTransitionAlpha() const
+{
+	if (!bTransitioning) return 1.0f;
+
+	const float T = FMath::Clamp(TransitionElapsed / FMath::Max(TransitionDuration, UE_KINDA_SMALL_NUMBER), 0.0f, 1.0f);
+	switch (TransitionCurve)
+	{
+	case EToneMapTransitionCurve::EaseIn:    return T * T;
+	case EToneMapTransitionCurve::EaseOut:   return 1.0f - (1.0f - T) * (1.0f - T);
+	case EToneMapTransitionCurve::EaseInOut: return T * T * (3.0f - 2.0f * T);
+	default:                                 return T;
+	}
+}
+
+void UToneMapComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (!bTransitioning || !TransitionFrom || !TransitionTo)
+	{
+		bTransitioning = false;
+		SetComponentTickEnabled(false);
+		return;
+	}
+
+	TransitionElapsed += DeltaTime;
+
+	if (TransitionElapsed >= TransitionDuration)
+	{
+		FToneMapSettingsBlend::Copy(*this, *TransitionTo);
+		bTransitioning = false;
+		SetComponentTickEnabled(false);
+		return;
+	}
+
+	// Interpolated settings drive the spatial passes; the LUT path cross-fades
+	// the two baked end points instead (see UToneMapSubsystem::ResolveForView)
+	FToneMapSettingsBlend::Copy(*this, *TransitionFrom);
+	FToneMapSettingsBlend::Lerp(*this, *TransitionTo, GetTransitionAlpha());
+}
+
 // ---------------------------------------------------------------------------
 // Helpers
 // ---------------------------------------------------------------------------
@@ -327,5 +567,15 @@ void UToneMapComponent::PostEditChangeProperty(FPropertyChangedEvent& PropertyCh
 			BloomBlendMode = EBloomBlendMode::SoftLight;
 		}
 	}
+
+	// Volume shape changed — the subsystem's spatial index must be rebuilt
+	const FName PropertyName = PropertyChangedEvent.GetPropertyName();
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(UToneMapComponent, bUnbound) ||
+		PropertyName == GET_MEMBER_NAME_CHECKED(UToneMapComponent, BoxExtent) ||
+		PropertyName == GET_MEMBER_NAME_CHECKED(UToneMapComponent, BlendRadius))
+	{
+		UpdateBounds();
+		MarkVolumeDirty();
+	}
 }
 #endif
@@ -0,0 +1,33 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapComputeStage.h"
+#include "HAL/IConsoleManager.h"
+#include "PixelFormat.h"
+#include "RHIGlobals.h"
+
+static TAutoConsoleVariable<int32> CVarToneMapAsyncCompute(
+	TEXT("r.ToneMapFX.AsyncCompute"),
+	1,
+	TEXT("How the ToneMapFX bloom and lens-effect chains are executed.\n")
+	TEXT(" 0: pixel shaders on the graphics queue\n")
+	TEXT(" 1: compute shaders on the async compute queue where the RHI supports it efficiently,\n")
+	TEXT("    otherwise on the graphics queue (default)\n")
+	TEXT(" 2: compute shaders on the graphics queue"),
+	ECVF_RenderThreadSafe | ECVF_Scalability);
+
+EToneMapStageQueue FToneMapComputeStage::GetQueue_RenderThread(EPixelFormat OutputFormat)
+{
+	const int32 Mode = CVarToneMapAsyncCompute.GetValueOnRenderThread();
+	if (Mode <= 0) return EToneMapStageQueue::Raster;
+
+	if (!UE::PixelFormat::HasCapabilities(OutputFormat, EPixelFormatCapabilities::TypedUAVStore))
+	{
+		return EToneMapStageQueue::Raster;
+	}
+
+	if (Mode == 1 && GSupportsEfficientAsyncCompute)
+	{
+		return EToneMapStageQueue::AsyncCompute;
+	}
+	return EToneMapStageQueue::Compute;
+}
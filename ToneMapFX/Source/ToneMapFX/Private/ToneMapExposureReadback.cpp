@@ -0,0 +1,129 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapExposureReadback.h"
+#include "ToneMapTransientTextures.h"
+#include "ToneMapPSOPrecache.h"
+#include "HAL/IConsoleManager.h"
+#include "RHIGPUReadback.h"
+#include "RenderGraphUtils.h"
+#include "SystemTextures.h"
+
+IMPLEMENT_GLOBAL_SHADER(FToneMapExposureStatsPackCS, "/Plugin/ToneMapFX/Private/ToneMapExposureStats.usf", "ExposureStatsPackCS", SF_Compute);
+
+static TAutoConsoleVariable<int32> CVarToneMapExposureReadback(
+	TEXT("r.ToneMapFX.ExposureReadback"),
+	1,
+	TEXT("Read Krawczyk exposure statistics back to the game thread (UToneMapComponent::GetLastMeasuredExposure,\n")
+	TEXT("OnExposureMeasured).  Results are a few frames late; the render thread never waits for them.\n")
+	TEXT(" 0: off\n")
+	TEXT(" 1: on (default)"),
+	ECVF_RenderThreadSafe);
+
+FToneMapExposureReadback::FToneMapExposureReadback()
+	: Results(MaxFramesInFlight * 2)
+{
+}
+
+FToneMapExposureReadback::~FToneMapExposureReadback() = default;
+
+bool FToneMapExposureReadback::IsEnabled_RenderThread()
+{
+	return CVarToneMapExposureReadback.GetValueOnRenderThread() != 0;
+}
+
+void FToneMapExposureReadback::Poll_RenderThread()
+{
+	// Oldest first, so samples reach the game thread in frame order
+	for (int32 Age = MaxFramesInFlight; Age > 0; --Age)
+	{
+		FSlot& Slot = Slots[(NextSlot + MaxFramesInFlight - Age) % MaxFramesInFlight];
+		if (!Slot.bPending || !Slot.Readback->IsReady()) continue;
+
+		const uint32* Stats = static_cast<const uint32*>(Slot.Readback->Lock(NumStats * sizeof(uint32)));
+
+		FToneMapExposureSample Sample;
+		Sample.FrameNumber       = Slot.FrameNumber;
+		Sample.AdaptedLuminance  = FMath::BitCast<float>(Stats[0]);
+		Sample.MeasuredLuminance = FMath::BitCast<float>(Stats[1]);
+		Sample.AutoExposure      = FMath::BitCast<float>(Stats[2]);
+
+		uint64 Total = 0;
+		for (int32 Bin = 0; Bin < FToneMapHistogramMetering::NumBins; ++Bin)
+		{
+			Total += Stats[4 + Bin];
+		}
+		if (Total > 0)
+		{
+			for (int32 Bin = 0; Bin < FToneMapHistogramMetering::NumBins; ++Bin)
+			{
+				Sample.Histogram[Bin] = (float)((double)Stats[4 + Bin] / (double)Total);
+			}
+		}
+
+		Slot.Readback->Unlock();
+		Slot.bPending = false;
+
+		// A full queue means nobody is draining it — drop rather than wait
+		Results.Enqueue(Sample);
+	}
+}
+
+void FToneMapExposureReadback::AddPasses(
+	FRDGBuilder& GraphBuilder,
+	const FGlobalShaderMap* ShaderMap,
+	FToneMapTransientTextures& Transients,
+	FRDGTextureRef AdaptedLum,
+	FRDGTextureRef MeasuredLum,
+	FRDGBufferRef Histogram,
+	float MinAutoExposure,
+	float MaxAutoExposure)
+{
+	const uint64 Frame = GFrameCounterRenderThread;
+	if (Frame == LastQueuedFrame) return;
+
+	// CPU-visible staging, one copy per frame in flight
+	Transients.AddExternalBytes((uint64)MaxFramesInFlight * NumStats * sizeof(uint32));
+
+	Poll_RenderThread();
+
+	// Still in flight after MaxFramesInFlight frames — skip this frame's sample
+	FSlot& Slot = Slots[NextSlot];
+	if (Slot.bPending) return;
+
+	LastQueuedFrame = Frame;
+	NextSlot = (NextSlot + 1) % MaxFramesInFlight;
+
+	RDG_EVENT_SCOPE(GraphBuilder, "ToneMap_ExposureReadback");
+
+	FRDGBufferRef StatsBuffer = Transients.CreateBuffer(
+		FRDGBufferDesc::CreateBufferDesc(sizeof(uint32), NumStats),
+		TEXT("ToneMap.ExposureStats"));
+	{
+		// Without histogram metering a default buffer keeps the SRV slot valid
+		FRDGBufferRef HistogramSource = Histogram ? Histogram : GSystemTextures.GetDefaultBuffer(GraphBuilder, sizeof(uint32), 0u);
+
+		auto* P = GraphBuilder.AllocParameters<FToneMapExposureStatsPackCS::FParameters>();
+		P->AdaptedLumTexture  = AdaptedLum;
+		P->MeasuredLumTexture = MeasuredLum;
+		P->HistogramInput     = GraphBuilder.CreateSRV(HistogramSource, PF_R32_UINT);
+		P->bHasHistogram      = Histogram ? 1u : 0u;
+		P->MinAutoExposure    = MinAutoExposure;
+		P->MaxAutoExposure    = MaxAutoExposure;
+		P->StatsOutput        = GraphBuilder.CreateUAV(StatsBuffer, PF_R32_UINT);
+
+		TShaderMapRef<FToneMapExposureStatsPackCS> ComputeShader(ShaderMap);
+		AddToneMapComputePass(
+			GraphBuilder, RDG_EVENT_NAME("ToneMap_ExposureStatsPack"), ERDGPassFlags::Compute,
+			ComputeShader, P, FIntVector(1, 1, 1));
+	}
+
+	if (!Slot.Readback)
+	{
+		Slot.Readback = MakeUnique<FRHIGPUBufferReadback>(TEXT("ToneMap.ExposureStatsReadback"));
+	}
+	AddEnqueueCopyPass(GraphBuilder, Slot.Readback.Get(), StatsBuffer, NumStats * sizeof(uint32));
+	Transients.Release(StatsBuffer);
+
+	Slot.FrameNumber = Frame;
+	Slot.bPending = true;
+}
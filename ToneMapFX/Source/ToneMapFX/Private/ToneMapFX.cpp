@@ -1,6 +1,8 @@
 // Licensed under the zlib License. See LICENSE file in the project root.
 
 #include "ToneMapFX.h"
+#include "ToneMapScalability.h"
+#include "ToneMapStage.h"
 #include "Interfaces/IPluginManager.h"
 #include "Misc/Paths.h"
 #include "ShaderCore.h"
@@ -13,10 +15,14 @@ void FToneMapFXModule::StartupModule()
 		IPluginManager::Get().FindPlugin(TEXT("ToneMapFX"))->GetBaseDir(),
 		TEXT("Shaders"));
 	AddShaderSourceDirectoryMapping(TEXT("/Plugin/ToneMapFX"), PluginShaderDir);
+
+	FToneMapScalability::LoadConfig();
+	FToneMapStageRegistry::RegisterBuiltInStages();
 }
 
 void FToneMapFXModule::ShutdownModule()
 {
+	FToneMapStageRegistry::Reset();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,267 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapFXSettings.h"
+#include "ToneMapDurand.h"
+#include "ToneMapFattal.h"
+#include "ToneMapLensEffects.h"
+#include "ClassicBloomShaders.h"
+#include "DataDrivenShaderPlatformInfo.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/ScopeLock.h"
+
+UToneMapFXSettings::UToneMapFXSettings()
+{
+	CategoryName = TEXT("Plugins");
+	SectionName = TEXT("Tone Map FX");
+}
+
+#if WITH_EDITOR
+void UToneMapFXSettings::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	FToneMapShaderStripping::Invalidate();
+}
+#endif
+
+// ---------------------------------------------------------------------------
+// Feature table
+// ---------------------------------------------------------------------------
+
+static const TCHAR* GToneMapSettingsSection = TEXT("/Script/ToneMapFX.ToneMapFXSettings");
+
+const TCHAR* FToneMapShaderStripping::GetFeatureName(EToneMapShaderFeature Feature)
+{
+	switch (Feature)
+	{
+	case EToneMapShaderFeature::Durand:           return TEXT("Durand");
+	case EToneMapShaderFeature::Fattal:           return TEXT("Fattal");
+	case EToneMapShaderFeature::Bloom:            return TEXT("Bloom");
+	case EToneMapShaderFeature::DirectionalGlare: return TEXT("Directional Glare");
+	case EToneMapShaderFeature::Kawase:           return TEXT("Kawase");
+	case EToneMapShaderFeature::LensEffects:      return TEXT("Lens Effects");
+	case EToneMapShaderFeature::CiliaryCorona:    return TEXT("Ciliary Corona");
+	case EToneMapShaderFeature::LenticularHalo:   return TEXT("Lenticular Halo");
+	default:                                      return TEXT("Unknown");
+	}
+}
+
+// Shader types gated by each feature, for the report
+static TArray<FShaderType*> GetFeatureShaders(EToneMapShaderFeature Feature)
+{
+	switch (Feature)
+	{
+	case EToneMapShaderFeature::Durand:
+		return { &FToneMapDurandLogLumPS::GetStaticType(), &FToneMapDurandBilateralPS::GetStaticType(),
+			&FToneMapDurandReconstructPS::GetStaticType() };
+	case EToneMapShaderFeature::Fattal:
+		return { &FToneMapFattalLogLumPS::GetStaticType(), &FToneMapFattalGradientPS::GetStaticType(),
+			&FToneMapFattalDivergencePS::GetStaticType(), &FToneMapFattalJacobiPS::GetStaticType(),
+			&FToneMapFattalReconstructPS::GetStaticType() };
+	case EToneMapShaderFeature::Bloom:
+		return { &FClassicBloomBrightPassPS::GetStaticType(), &FClassicBloomBrightPassCS::GetStaticType(),
+			&FClassicBloomBlurPS::GetStaticType(), &FClassicBloomBlurCS::GetStaticType(),
+			&FClassicBloomCompositePS::GetStaticType() };
+	case EToneMapShaderFeature::DirectionalGlare:
+		return { &FClassicBloomGlareStreakPS::GetStaticType(), &FClassicBloomGlareStreakCS::GetStaticType(),
+			&FClassicBloomGlareAccumulatePS::GetStaticType(), &FClassicBloomGlareAccumulateCS::GetStaticType() };
+	case EToneMapShaderFeature::Kawase:
+		return { &FClassicBloomKawaseDownsamplePS::GetStaticType(), &FClassicBloomKawaseDownsampleCS::GetStaticType(),
+			&FClassicBloomKawaseUpsamplePS::GetStaticType(), &FClassicBloomKawaseUpsampleCS::GetStaticType() };
+	case EToneMapShaderFeature::LensEffects:
+		return { &FToneMapLensBrightPassPS::GetStaticType(), &FToneMapLensBrightPassCS::GetStaticType(),
+			&FToneMapLensCompositePS::GetStaticType() };
+	case EToneMapShaderFeature::CiliaryCorona:
+		return { &FToneMapCoronaStreakPS::GetStaticType(), &FToneMapCoronaStreakCS::GetStaticType() };
+	case EToneMapShaderFeature::LenticularHalo:
+		return { &FToneMapHaloRingPS::GetStaticType(), &FToneMapHaloRingCS::GetStaticType() };
+	default:
+		return {};
+	}
+}
+
+static constexpr uint32 FeatureBit(EToneMapShaderFeature Feature)
+{
+	return 1u << static_cast<uint32>(Feature);
+}
+
+// ---------------------------------------------------------------------------
+// Per-platform settings
+// ---------------------------------------------------------------------------
+
+static FCriticalSection GStrippingLock;
+static TMap<EShaderPlatform, uint32> GCompiledFeatures;   // current settings: cook and report, reset on edit
+static TMap<EShaderPlatform, uint32> GStartupFeatures;    // first read per platform: what the shader map holds
+
+static uint32 ReadCompiledFeatures(EShaderPlatform Platform)
+{
+	bool bDurand = true;
+	bool bFattal = true;
+	bool bBloom = true;
+	bool bDirectionalGlare = true;
+	bool bKawase = true;
+	bool bCiliaryCorona = true;
+	bool bLenticularHalo = true;
+
+	FConfigCacheIni* Config = GConfig;
+#if WITH_EDITOR
+	// Cooking for another platform: read that platform's Engine.ini hierarchy
+	if (FConfigCacheIni* PlatformConfig = FConfigCacheIni::ForPlatform(FDataDrivenShaderPlatformInfo::GetPlatformName(Platform)))
+	{
+		Config = PlatformConfig;
+	}
+#endif
+
+	// Missing keys keep their defaults — everything compiled
+	if (Config)
+	{
+		Config->GetBool(GToneMapSettingsSection, TEXT("bDurand"),           bDurand,           GEngineIni);
+		Config->GetBool(GToneMapSettingsSection, TEXT("bFattal"),           bFattal,           GEngineIni);
+		Config->GetBool(GToneMapSettingsSection, TEXT("bBloom"),            bBloom,            GEngineIni);
+		Config->GetBool(GToneMapSettingsSection, TEXT("bDirectionalGlare"), bDirectionalGlare, GEngineIni);
+		Config->GetBool(GToneMapSettingsSection, TEXT("bKawase"),           bKawase,           GEngineIni);
+		Config->GetBool(GToneMapSettingsSection, TEXT("bCiliaryCorona"),    bCiliaryCorona,    GEngineIni);
+		Config->GetBool(GToneMapSettingsSection, TEXT("bLenticularHalo"),   bLenticularHalo,   GEngineIni);
+	}
+
+	uint32 Mask = 0;
+	if (bDurand)                      Mask |= FeatureBit(EToneMapShaderFeature::Durand);
+	if (bFattal)                      Mask |= FeatureBit(EToneMapShaderFeature::Fattal);
+	if (bBloom)                       Mask |= FeatureBit(EToneMapShaderFeature::Bloom);
+	if (bBloom && bDirectionalGlare)  Mask |= FeatureBit(EToneMapShaderFeature::DirectionalGlare);
+	if (bBloom && bKawase)            Mask |= FeatureBit(EToneMapShaderFeature::Kawase);
+	if (bCiliaryCorona)               Mask |= FeatureBit(EToneMapShaderFeature::CiliaryCorona);
+	if (bLenticularHalo)              Mask |= FeatureBit(EToneMapShaderFeature::LenticularHalo);
+	if (bCiliaryCorona || bLenticularHalo) Mask |= FeatureBit(EToneMapShaderFeature::LensEffects);
+	return Mask;
+}
+
+static void ReportPlatform(EShaderPlatform Platform, uint32 Mask)
+{
+	const FName PlatformName = FDataDrivenShaderPlatformInfo::GetName(Platform);
+
+	int32 NumStrippedShaders = 0;
+	int32 NumStrippedPermutations = 0;
+	for (uint32 Index = 0; Index < static_cast<uint32>(EToneMapShaderFeature::Num); ++Index)
+	{
+		const EToneMapShaderFeature Feature = static_cast<EToneMapShaderFeature>(Index);
+		if (Mask & FeatureBit(Feature))
+		{
+			continue;
+		}
+
+		FString Names;
+		for (const FShaderType* Type : GetFeatureShaders(Feature))
+		{
+			Names += Names.IsEmpty() ? Type->GetName() : FString(TEXT(", ")) + Type->GetName();
+			++NumStrippedShaders;
+			NumStrippedPermutations += Type->GetPermutationCount();
+		}
+		UE_LOG(LogTemp, Log, TEXT("ToneMapFX: [%s] stripped %s: %s"), *PlatformName.ToString(), GetFeatureName(Feature), *Names);
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("ToneMapFX: [%s] shader stripping removed %d shader types (%d permutations)"),
+		*PlatformName.ToString(), NumStrippedShaders, NumStrippedPermutations);
+}
+
+static uint32 GetCompiledFeatures(EShaderPlatform Platform)
+{
+	FScopeLock Lock(&GStrippingLock);
+	if (const uint32* Cached = GCompiledFeatures.Find(Platform))
+	{
+		return *Cached;
+	}
+
+	const uint32 Mask = ReadCompiledFeatures(Platform);
+	GCompiledFeatures.Add(Platform, Mask);
+	if (!GStartupFeatures.Contains(Platform))
+	{
+		GStartupFeatures.Add(Platform, Mask);
+	}
+
+	// The cook evaluates each target platform once: leave a record of what it left out
+	if (IsRunningCookCommandlet())
+	{
+		ReportPlatform(Platform, Mask);
+	}
+	return Mask;
+}
+
+bool FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature Feature, EShaderPlatform Platform)
+{
+	return (GetCompiledFeatures(Platform) & FeatureBit(Feature)) != 0;
+}
+
+// The global shaders of the running platform are compiled at startup, so the
+// first read is what they were built with; a settings edit only takes effect
+// after a restart and must not change what the runtime dispatches
+static uint32 GetStartupFeatures(EShaderPlatform Platform)
+{
+	{
+		FScopeLock Lock(&GStrippingLock);
+		if (const uint32* Startup = GStartupFeatures.Find(Platform))
+		{
+			return *Startup;
+		}
+	}
+	GetCompiledFeatures(Platform);
+
+	FScopeLock Lock(&GStrippingLock);
+	return GStartupFeatures.FindChecked(Platform);
+}
+
+bool FToneMapShaderStripping::IsCompiled(EToneMapShaderFeature Feature, EShaderPlatform Platform)
+{
+	return (GetStartupFeatures(Platform) & FeatureBit(Feature)) != 0;
+}
+
+bool FToneMapShaderStripping::IsAvailable_RenderThread(EToneMapShaderFeature Feature, EShaderPlatform Platform)
+{
+	if (IsCompiled(Feature, Platform))
+	{
+		return true;
+	}
+
+	static bool bWarned[static_cast<uint32>(EToneMapShaderFeature::Num)] = {};
+	bool& bFeatureWarned = bWarned[static_cast<uint32>(Feature)];
+	if (!bFeatureWarned)
+	{
+		bFeatureWarned = true;
+		UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: %s is stripped in Project Settings > Plugins > Tone Map FX — skipped"),
+			GetFeatureName(Feature));
+	}
+	return false;
+}
+
+void FToneMapShaderStripping::Report()
+{
+	FScopeLock Lock(&GStrippingLock);
+	if (GCompiledFeatures.IsEmpty())
+	{
+		UE_LOG(LogTemp, Log, TEXT("ToneMapFX: no shader platform evaluated yet"));
+	}
+	for (const TPair<EShaderPlatform, uint32>& Entry : GCompiledFeatures)
+	{
+		ReportPlatform(Entry.Key, Entry.Value);
+
+		const uint32* Startup = GStartupFeatures.Find(Entry.Key);
+		if (Startup && *Startup != Entry.Value)
+		{
+			UE_LOG(LogTemp, Log, TEXT("ToneMapFX: [%s] the running shaders still follow the settings at startup until a restart"),
+				*FDataDrivenShaderPlatformInfo::GetName(Entry.Key).ToString());
+		}
+	}
+}
+
+void FToneMapShaderStripping::Invalidate()
+{
+	FScopeLock Lock(&GStrippingLock);
+	GCompiledFeatures.Reset();
+	UE_LOG(LogTemp, Log, TEXT("ToneMapFX: shader stripping settings changed — restart the editor to recompile the global shaders"));
+}
+
+static FAutoConsoleCommand CmdToneMapShaderStrippingReport(
+	TEXT("r.ToneMapFX.ShaderStrippingReport"),
+	TEXT("Log the ToneMapFX operators and bloom / lens modes stripped by Project Settings > Plugins > Tone Map FX,\n")
+	TEXT("with the shader types each one removes, for every shader platform evaluated so far."),
+	FConsoleCommandDelegate::CreateStatic(&FToneMapShaderStripping::Report));
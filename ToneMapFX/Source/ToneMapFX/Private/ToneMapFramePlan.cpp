@@ -0,0 +1,949 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapFramePlan.h"
+#include "ToneMapComponent.h"
+#include "ToneMapFXSettings.h"
+#include "ToneMapColorAverage.h"
+#include "ToneMapGaussianBlur.h"
+#include "ToneMapGuidedFilter.h"
+#include "ToneMapHistogramMetering.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+#include "RHI.h"
+#include "UObject/Package.h"
+
+// ---------------------------------------------------------------------------
+// Inputs
+// ---------------------------------------------------------------------------
+
+static bool GetConsoleVariableBool(const TCHAR* Name, bool bDefault)
+{
+	const IConsoleVariable* CVar = IConsoleManager::Get().FindConsoleVariable(Name);
+	return CVar ? CVar->GetInt() != 0 : bDefault;
+}
+
+static int32 GetConsoleVariableInt(const TCHAR* Name, int32 Default)
+{
+	const IConsoleVariable* CVar = IConsoleManager::Get().FindConsoleVariable(Name);
+	return CVar ? CVar->GetInt() : Default;
+}
+
+FToneMapPlanInputs FToneMapPlanInputs::Make(const UToneMapComponent& Settings, FIntPoint InViewportSize, int32 QualityLevel)
+{
+	FToneMapPlanInputs Inputs;
+	Inputs.ViewportSize = FIntPoint(FMath::Max(InViewportSize.X, 1), FMath::Max(InViewportSize.Y, 1));
+	Inputs.Quality = FToneMapScalability::Resolve(Settings, FToneMapScalability::GetTier(QualityLevel));
+
+	// The display is unknown offline — a preset asking for HDR output is planned on an HDR display
+	Inputs.bReplaceTonemap = Settings.Mode == EToneMapMode::ReplaceTonemap;
+	Inputs.bHDREncode = Inputs.bReplaceTonemap && Settings.bHDROutput;
+
+	Inputs.bReducedPrecision  = GetConsoleVariableBool(TEXT("r.ToneMapFX.ReducedPrecisionIntermediates"), true);
+	Inputs.bLumaLocalContrast = GetConsoleVariableBool(TEXT("r.ToneMapFX.LumaLocalContrast"), true);
+	Inputs.bGlobalColorCast   = GetConsoleVariableBool(TEXT("r.ToneMapFX.GlobalColorCast"), true);
+	Inputs.bHistogramMetering = GetConsoleVariableBool(TEXT("r.ToneMapFX.HistogramMetering"), true);
+	Inputs.bGuidedFilter      = FToneMapGuidedFilter::IsSupported();
+
+	// What GetMethod_RenderThread and GetQueue_RenderThread read on the render thread
+	const EPixelFormat BloomFormat = Inputs.bReducedPrecision ? PF_FloatR11G11B10 : PF_FloatRGBA;
+	Inputs.bTiledBlur       = GetConsoleVariableBool(TEXT("r.ToneMapFX.TiledBlur"), true);
+	Inputs.RecursiveBlur    = GetConsoleVariableInt(TEXT("r.ToneMapFX.RecursiveBlur"), 0);
+	Inputs.bComputeViewBlur = FToneMapGaussianBlur::SupportsComputeViewBlur();
+	Inputs.bComputeBloom    = GetConsoleVariableInt(TEXT("r.ToneMapFX.AsyncCompute"), 1) > 0
+		&& FToneMapGaussianBlur::SupportsComputeOutput(BloomFormat);
+
+	Inputs.CompiledFeatures = 0;
+	for (uint32 Feature = 0; Feature < (uint32)EToneMapShaderFeature::Num; ++Feature)
+	{
+		if (FToneMapShaderStripping::IsCompiled((EToneMapShaderFeature)Feature, GMaxRHIShaderPlatform))
+		{
+			Inputs.CompiledFeatures |= 1u << Feature;
+		}
+	}
+
+	return Inputs;
+}
+
+EToneMapBlurMethod FToneMapPlanInputs::GetBlurMethod(float Sigma, bool bComputeOutput) const
+{
+	return FToneMapGaussianBlur::GetMethod(Sigma, bComputeOutput, bTiledBlur, RecursiveBlur);
+}
+
+// ---------------------------------------------------------------------------
+// Stage selection — the settings half of every built-in IsActive
+// ---------------------------------------------------------------------------
+
+bool FToneMapFramePlanner::WantsStage(EToneMapPlanStage Stage, const UToneMapComponent& Settings, const FToneMapPlanInputs& Inputs)
+{
+	switch (Stage)
+	{
+	case EToneMapPlanStage::Bloom:
+		return Settings.bEnableBloom && Settings.BloomIntensity > 0.0f
+			&& Inputs.ViewportSize.X > 0 && Inputs.ViewportSize.Y > 0;
+	case EToneMapPlanStage::Exposure:
+		return Inputs.bReplaceTonemap && Settings.AutoExposureMode == EToneMapAutoExposure::Krawczyk;
+	case EToneMapPlanStage::LocalContrast:
+		return FMath::Abs(Settings.Clarity) > 0.01f
+			|| Settings.DynamicContrast > 0.01f
+			|| Settings.CorrectContrast > 0.01f
+			|| Settings.CorrectColorCast > 0.01f;
+	case EToneMapPlanStage::Durand:
+		return Inputs.bReplaceTonemap && Settings.FilmCurve == EToneMapFilmCurve::Durand;
+	case EToneMapPlanStage::Fattal:
+		return Inputs.bReplaceTonemap && Settings.FilmCurve == EToneMapFilmCurve::Fattal;
+	case EToneMapPlanStage::Lens:
+		return Settings.bEnableCiliaryCorona || Settings.bEnableLenticularHalo;
+	case EToneMapPlanStage::Process:
+		return true;
+	case EToneMapPlanStage::Sharpen:
+		return Settings.bEnableSharpening && Settings.SharpenAmount > 0.01f;
+	case EToneMapPlanStage::LUT:
+		return Settings.bEnableLUT && Settings.LUTTexture != nullptr && Settings.LUTIntensity > 0.001f;
+	case EToneMapPlanStage::Vignette:
+		return Settings.bEnableVignette && FMath::Abs(Settings.VignetteIntensity) > 0.01f;
+	case EToneMapPlanStage::HDREncode:
+		return Inputs.bHDREncode;
+	default:
+		return false;
+	}
+}
+
+const TCHAR* FToneMapFramePlanner::GetStageName(EToneMapPlanStage Stage)
+{
+	static const TCHAR* const Names[] =
+	{
+		TEXT("Bloom"), TEXT("Exposure"), TEXT("LocalContrast"), TEXT("Durand"), TEXT("Fattal"), TEXT("Lens"),
+		TEXT("Process"), TEXT("Sharpen"), TEXT("LUT"), TEXT("Vignette"), TEXT("HDREncode"),
+	};
+	static_assert(UE_ARRAY_COUNT(Names) == (int32)EToneMapPlanStage::Num, "Stage names out of sync");
+
+	return Stage < EToneMapPlanStage::Num ? Names[(int32)Stage] : TEXT("Unknown");
+}
+
+int32 FToneMapFramePlanner::GetBytesPerPixel(EToneMapIntermediate Usage, bool bReducedPrecision)
+{
+	// Mirrors FToneMapTransientTextures::GetFormat below the transient budget
+	switch (Usage)
+	{
+	case EToneMapIntermediate::Color:        return 8;                             // RGBA16F
+	case EToneMapIntermediate::BlurScratch:  return bReducedPrecision ? 4 : 8;     // R11G11B10F / RGBA16F
+	case EToneMapIntermediate::LogLuminance: return bReducedPrecision ? 2 : 4;     // R16F / R32F
+	case EToneMapIntermediate::Scalar:       return 4;                             // R32F
+	case EToneMapIntermediate::Vector2:      return 8;                             // G32R32F
+	case EToneMapIntermediate::Luminance:    return 2;                             // R16F
+	default:                                 return 8;
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Builder
+// ---------------------------------------------------------------------------
+
+namespace ToneMapFramePlan
+{
+	// Half width of FToneMapGaussianKernel: 3σ, truncated at 48 texels
+	static int32 GetGaussianHalfSize(float Sigma)
+	{
+		return FMath::Min(FMath::CeilToInt32(3.0f * FMath::Max(Sigma, 0.5f)), FToneMapGaussianKernel::MaxHalfSize);
+	}
+
+	struct FBuilder
+	{
+		FToneMapFramePlan& Plan;
+		EToneMapPlanStage Stage = EToneMapPlanStage::Process;
+
+		explicit FBuilder(FToneMapFramePlan& InPlan) : Plan(InPlan) {}
+
+		int32 AddTexture(const TCHAR* Name, FIntPoint Extent, int32 BytesPerPixel, bool bTransient = true)
+		{
+			FToneMapPlanTexture& Texture = Plan.Textures.AddDefaulted_GetRef();
+			Texture.Name = Name;
+			Texture.Extent = Extent;
+			Texture.BytesPerPixel = BytesPerPixel;
+			Texture.bTransient = bTransient;
+			return Plan.Textures.Num() - 1;
+		}
+
+		int32 AddTexture(const TCHAR* Name, FIntPoint Extent, EToneMapIntermediate Usage)
+		{
+			return AddTexture(Name, Extent, FToneMapFramePlanner::GetBytesPerPixel(Usage, Plan.Inputs.bReducedPrecision));
+		}
+
+		// Kept across frames (adapted luminance, colour average, baked LUTs)
+		int32 AddPersistentTexture(const TCHAR* Name, FIntPoint Extent, int32 BytesPerPixel)
+		{
+			const int32 Index = AddTexture(Name, Extent, BytesPerPixel, false);
+			Plan.PersistentBytes += Plan.Textures[Index].GetBytes();
+			return Index;
+		}
+
+		int32 AddPass(const TCHAR* Name, FIntPoint Extent, int32 FetchesPerPixel, int32 ALUPerPixel,
+			std::initializer_list<int32> Reads, int32 Write, bool bCachedAcrossFrames = false)
+		{
+			const int32 PassIndex = Plan.Passes.Num();
+			FToneMapPlanPass& Pass = Plan.Passes.AddDefaulted_GetRef();
+			Pass.Name = Name;
+			Pass.Stage = Stage;
+			Pass.Extent = Extent;
+			Pass.FetchesPerPixel = FetchesPerPixel;
+			Pass.ALUPerPixel = ALUPerPixel;
+			Pass.bCachedAcrossFrames = bCachedAcrossFrames;
+			Pass.Write = Write;
+
+			for (const int32 Read : Reads)
+			{
+				if (Read != INDEX_NONE)
+				{
+					Pass.Reads.Add(Read);
+					Plan.Textures[Read].LastPass = FMath::Max(Plan.Textures[Read].LastPass, PassIndex);
+				}
+			}
+
+			FToneMapPlanTexture& Output = Plan.Textures[Write];
+			if (Output.FirstPass == INDEX_NONE)
+			{
+				Output.FirstPass = PassIndex;
+			}
+			Output.LastPass = FMath::Max(Output.LastPass, PassIndex);
+
+			FToneMapPlanStageCost& Cost = Plan.Stages[(int32)Stage];
+			++Cost.NumPasses;
+			if (!bCachedAcrossFrames)
+			{
+				Cost.Fetches += Pass.GetFetches();
+				Cost.ALU += Pass.GetALU();
+			}
+			return Write;
+		}
+	};
+
+	// One separable Gaussian direction with the method the stage picks at runtime
+	static int32 AddBlurDirection(FBuilder& B, const TCHAR* Name, FIntPoint Extent, float Sigma, bool bComputeOutput, int32 Source, int32 Output)
+	{
+		const int32 HalfSize = GetGaussianHalfSize(Sigma);
+		switch (B.Plan.Inputs.GetBlurMethod(Sigma, bComputeOutput))
+		{
+		case EToneMapBlurMethod::Tiled:
+		{
+			// Tile + apron loaded once per group, 2h+1 groupshared reads per texel
+			constexpr int32 TileSize = FToneMapGaussianBlurTiledCS::TileSize;
+			const int32 Fetches = FMath::DivideAndRoundUp(TileSize + 2 * HalfSize, TileSize);
+			return B.AddPass(Name, Extent, Fetches, 2 * (2 * HalfSize + 1), { Source }, Output);
+		}
+		case EToneMapBlurMethod::Recursive:
+		{
+			// Causal scan into a scratch in the output's format, then the anti-causal
+			// scan — one fetch per texel each, for any sigma
+			const int32 BytesPerPixel = B.Plan.Textures[Output].BytesPerPixel;
+			const int32 Causal = B.AddPass(Name, Extent, 1, 16,
+				{ Source }, B.AddTexture(TEXT("ToneMap.RecursiveBlurCausal"), Extent, BytesPerPixel));
+			return B.AddPass(TEXT("ToneMap_RecursiveBlurAntiCausal"), Extent, 1, 16, { Causal }, Output);
+		}
+		default:
+		{
+			// Bilinear pairs: 1 + 2·ceil(h/2) fetches
+			const int32 Fetches = 1 + 2 * FMath::DivideAndRoundUp(HalfSize, 2);
+			return B.AddPass(Name, Extent, Fetches, 2 * Fetches, { Source }, Output);
+		}
+		}
+	}
+
+	// Textures the stages hand to each other, as FToneMapStageContext carries them
+	struct FChain
+	{
+		int32 SceneColor = INDEX_NONE;
+		int32 AdaptedLum = INDEX_NONE;
+		int32 Blurred = INDEX_NONE;
+		int32 BlurredFine = INDEX_NONE;
+		int32 BlurredCoarse = INDEX_NONE;
+		int32 SceneAverageColor = INDEX_NONE;
+		int32 PreToneMapped = INDEX_NONE;
+		int32 Output = INDEX_NONE;                   // latest display-referred image
+	};
+
+	// ALU weights are rough per-pixel instruction counts read off the shaders —
+	// comparable between passes, not cycles
+
+	static void AddBloom(FBuilder& B, FChain& Chain, const UToneMapComponent& Settings)
+	{
+		const FToneMapPlanInputs& In = B.Plan.Inputs;
+		const FToneMapResolvedQuality& Quality = In.Quality;
+		const int32 Divisor = FMath::Max(1, FMath::RoundToInt(2.0f / FMath::Max(Quality.BloomDownsampleScale, 0.01f)));
+		const FIntPoint BloomExtent = FIntPoint::DivideAndRoundUp(In.ViewportSize, Divisor);
+		const EToneMapIntermediate Usage = EToneMapIntermediate::BlurScratch;
+
+		const int32 BrightPass = B.AddPass(TEXT("BrightPass"), BloomExtent, 1, 8,
+			{ Chain.SceneColor }, B.AddTexture(TEXT("ClassicBloom.BrightPass"), BloomExtent, Usage));
+
+		auto AddBlurPair = [&](const TCHAR* NameH, const TCHAR* NameV, float Sigma, int32 Source, int32 Temp, int32 Output)
+		{
+			AddBlurDirection(B, NameH, BloomExtent, Sigma, In.bComputeBloom, Source, Temp);
+			AddBlurDirection(B, NameV, BloomExtent, Sigma, In.bComputeBloom, Temp, Output);
+		};
+
+		int32 Blurred = INDEX_NONE;
+
+		if (Settings.BloomMode == EBloomMode::DirectionalGlare && In.IsFeatureCompiled(EToneMapShaderFeature::DirectionalGlare))
+		{
+			const int32 NumStreaks = FMath::Clamp(Settings.GlareStreakCount, 2, 16);
+			const int32 StreakFetches = 1 + 2 * Quality.GlareSamples;
+
+			TArray<int32, TInlineAllocator<16>> Streaks;
+			for (int32 i = 0; i < NumStreaks; ++i)
+			{
+				Streaks.Add(B.AddPass(TEXT("GlareStreak"), BloomExtent, StreakFetches, 6 * StreakFetches,
+					{ BrightPass }, B.AddTexture(TEXT("ClassicBloom.GlareStreak"), BloomExtent, Usage)));
+			}
+
+			auto StreakAt = [&Streaks](int32 i) { return Streaks.IsValidIndex(i) ? Streaks[i] : INDEX_NONE; };
+
+			int32 Accum = B.AddPass(TEXT("GlareAccumulate"), BloomExtent, FMath::Min(NumStreaks, 4), 4,
+				{ StreakAt(0), StreakAt(1), StreakAt(2), StreakAt(3) },
+				B.AddTexture(TEXT("ClassicBloom.GlareAccum"), BloomExtent, Usage));
+
+			for (int32 BatchStart = 4; BatchStart < NumStreaks; BatchStart += 3)
+			{
+				const int32 BatchCount = FMath::Min(3, NumStreaks - BatchStart);
+				Accum = B.AddPass(TEXT("GlareAccumulate"), BloomExtent, 1 + BatchCount, 4,
+					{ Accum, StreakAt(BatchStart), StreakAt(BatchStart + 1), StreakAt(BatchStart + 2) },
+					B.AddTexture(TEXT("ClassicBloom.GlareAccum"), BloomExtent, Usage));
+			}
+
+			Blurred = B.AddTexture(TEXT("ClassicBloom.GlareBlurred"), BloomExtent, Usage);
+			AddBlurPair(TEXT("GlareBlurH"), TEXT("GlareBlurV"), Settings.BloomSize * 0.05f,
+				Accum, B.AddTexture(TEXT("ClassicBloom.GlareBlurTemp"), BloomExtent, Usage), Blurred);
+		}
+
+		if (Settings.BloomMode == EBloomMode::Kawase && Blurred == INDEX_NONE && In.IsFeatureCompiled(EToneMapShaderFeature::Kawase))
+		{
+			TArray<int32, TInlineAllocator<8>> Mips;
+			TArray<FIntPoint, TInlineAllocator<8>> MipExtents;
+			FIntPoint Extent = BloomExtent;
+			int32 Source = Chain.SceneColor;
+			for (int32 Mip = 0; Mip < Quality.KawaseMipCount; ++Mip)
+			{
+				Extent = FIntPoint(FMath::Max(FMath::DivideAndRoundUp(Extent.X, 2), 1), FMath::Max(FMath::DivideAndRoundUp(Extent.Y, 2), 1));
+				Source = B.AddPass(TEXT("KawaseDownsample"), Extent, 13, 30,
+					{ Source }, B.AddTexture(TEXT("ClassicBloom.KawaseMip"), Extent, Usage));
+				Mips.Add(Source);
+				MipExtents.Add(Extent);
+			}
+
+			int32 Upsample = Mips.Num() > 0 ? Mips.Last() : INDEX_NONE;
+			for (int32 Mip = Mips.Num() - 2; Mip >= 0; --Mip)
+			{
+				Upsample = B.AddPass(TEXT("KawaseUpsample"), MipExtents[Mip], 9, 20,
+					{ Upsample, Mips[Mip] }, B.AddTexture(TEXT("ClassicBloom.KawaseUpsample"), MipExtents[Mip], Usage));
+			}
+
+			if (Mips.Num() > 1)
+			{
+				Blurred = B.AddPass(TEXT("KawaseUpsample_Final"), BloomExtent, 9, 20,
+					{ Upsample, Mips[0] }, B.AddTexture(TEXT("ClassicBloom.KawaseBlurred"), BloomExtent, Usage));
+			}
+			else
+			{
+				Blurred = Mips.Num() > 0 ? Mips[0] : BrightPass;
+			}
+		}
+
+		// Standard / SoftFocus, and the fallback for stripped modes
+		if (Blurred == INDEX_NONE)
+		{
+			const int32 Temp = B.AddTexture(TEXT("ClassicBloom.BlurTemp"), BloomExtent, Usage);
+			Blurred = B.AddTexture(TEXT("ClassicBloom.Blurred"), BloomExtent, Usage);
+
+			int32 Source = BrightPass;
+			for (int32 PassIndex = 0; PassIndex < Quality.BloomBlurPasses; ++PassIndex)
+			{
+				AddBlurPair(TEXT("BlurHorizontal"), TEXT("BlurVertical"), Settings.BloomSize * 0.1f, Source, Temp, Blurred);
+				Source = Blurred;
+			}
+
+			if (Quality.BloomBlurPasses <= 0)
+			{
+				Blurred = BrightPass;
+			}
+		}
+
+		Chain.SceneColor = B.AddPass(TEXT("CompositeBloom"), In.ViewportSize, 2, 10,
+			{ Chain.SceneColor, Blurred },
+			B.AddTexture(TEXT("ClassicBloom.Composite"), In.ViewportSize, In.SceneColorBytesPerPixel));
+	}
+
+	static void AddExposure(FBuilder& B, FChain& Chain)
+	{
+		const FToneMapPlanInputs& In = B.Plan.Inputs;
+		const FIntPoint One(1, 1);
+
+		int32 Measured = INDEX_NONE;
+		if (In.bHistogramMetering)
+		{
+			const FIntPoint Samples = FIntPoint::DivideAndRoundUp(In.ViewportSize, FToneMapHistogramMetering::SampleStride);
+			const int32 Histogram = B.AddPass(TEXT("ToneMap_HistogramBuild"), Samples, 1, 20,
+				{ Chain.SceneColor }, B.AddTexture(TEXT("ToneMap.MeteringHistogram"), FIntPoint(FToneMapHistogramMetering::NumBins, 1), 4));
+			Measured = B.AddPass(TEXT("ToneMap_HistogramResolve"), One, FToneMapHistogramMetering::NumBins, 4 * FToneMapHistogramMetering::NumBins,
+				{ Histogram }, B.AddTexture(TEXT("ToneMap.MeasuredLum"), One, 4));
+		}
+		else
+		{
+			Measured = B.AddPass(TEXT("ToneMap_LuminanceMeasure"), One, 256, 4 * 256,
+				{ Chain.SceneColor }, B.AddTexture(TEXT("ToneMap.MeasuredLum"), One, 4));
+		}
+
+		Chain.AdaptedLum = Measured;
+		if (In.bPreviousAdaptedLuminance)
+		{
+			const int32 Previous = B.AddTexture(TEXT("ToneMap.PrevAdaptedLum"), One, 4, false);
+			Chain.AdaptedLum = B.AddPass(TEXT("ToneMap_LuminanceAdapt"), One, 2, 10,
+				{ Previous, Measured }, B.AddPersistentTexture(TEXT("ToneMap.AdaptedLum"), One, 4));
+		}
+	}
+
+	static void AddLocalContrast(FBuilder& B, FChain& Chain, const UToneMapComponent& Settings)
+	{
+		const FToneMapPlanInputs& In = B.Plan.Inputs;
+		const FIntPoint WS = In.ViewportSize;
+
+		const bool bGlobalColorCast = Settings.CorrectColorCast > 0.01f && In.bGlobalColorCast;
+		const bool bLocalColorCast  = Settings.CorrectColorCast > 0.01f && !bGlobalColorCast;
+		const bool bNeedFineBlur    = Settings.DynamicContrast > 0.01f;
+		const bool bNeedCoarseBlur  = bNeedFineBlur || Settings.CorrectContrast > 0.01f || bLocalColorCast;
+		const bool bClarity         = FMath::Abs(Settings.Clarity) > 0.01f;
+		const bool bGuidedClarity   = bClarity && Settings.ClarityMode == EToneMapClarityMode::GuidedFilter && In.bGuidedFilter;
+
+		const bool bLumaClarity = bClarity && !bGuidedClarity && In.bLumaLocalContrast;
+		const bool bLumaFine    = bNeedFineBlur && In.bLumaLocalContrast;
+		const bool bLumaCoarse  = bNeedCoarseBlur && In.bLumaLocalContrast && !bLocalColorCast;
+
+		int32 Luma = INDEX_NONE;
+		auto GetLuma = [&]()
+		{
+			if (Luma == INDEX_NONE)
+			{
+				Luma = B.AddPass(TEXT("ToneMap_LocalContrastLuma"), WS, 1, 4,
+					{ Chain.SceneColor }, B.AddTexture(TEXT("ToneMap.LocalContrastLuma"), WS, EToneMapIntermediate::Luminance));
+			}
+			return Luma;
+		};
+
+		auto AddBlurPair = [&](const TCHAR* NameH, const TCHAR* NameV, const TCHAR* TexNameH, const TCHAR* TexNameV,
+			float Sigma, int32 Source, EToneMapIntermediate Usage)
+		{
+			const int32 H = AddBlurDirection(B, NameH, WS, Sigma, In.bComputeViewBlur, Source, B.AddTexture(TexNameH, WS, Usage));
+			return AddBlurDirection(B, NameV, WS, Sigma, In.bComputeViewBlur, H, B.AddTexture(TexNameV, WS, Usage));
+		};
+
+		if (bGuidedClarity)
+		{
+			// Log luma once, then tiled prefix-sum boxes of (I, I²) and of (a, b) —
+			// each texel is loaded by its tile and, at most twice more, by the aprons
+			// of its neighbours: constant cost for any radius
+			const int32 LogLuma = B.AddPass(TEXT("ToneMap_GuidedLogLuma"), WS, 1, 6,
+				{ Chain.SceneColor }, B.AddTexture(TEXT("ToneMap.GuidedLogLuma"), WS, EToneMapIntermediate::LogLuminance));
+			const int32 BoxRows = B.AddPass(TEXT("ToneMap_GuidedBoxRows"), WS, 3, 16,
+				{ LogLuma }, B.AddTexture(TEXT("ToneMap.GuidedBoxRows"), WS, EToneMapIntermediate::Vector2));
+			const int32 Coeffs = B.AddPass(TEXT("ToneMap_GuidedCoeffColumns"), WS, 3, 20,
+				{ BoxRows }, B.AddTexture(TEXT("ToneMap.GuidedCoeffs"), WS, EToneMapIntermediate::Vector2));
+			const int32 CoeffRows = B.AddPass(TEXT("ToneMap_GuidedCoeffRows"), WS, 3, 14,
+				{ Coeffs }, B.AddTexture(TEXT("ToneMap.GuidedCoeffRows"), WS, EToneMapIntermediate::Vector2));
+			Chain.Blurred = B.AddPass(TEXT("ToneMap_GuidedBaseColumns"), WS, 4, 24,
+				{ CoeffRows, Chain.SceneColor }, B.AddTexture(TEXT("ToneMap.GuidedBase"), WS, EToneMapIntermediate::Color));
+		}
+		else if (bClarity)
+		{
+			Chain.Blurred = AddBlurPair(TEXT("ToneMap_HBlur"), TEXT("ToneMap_VBlur"), TEXT("ToneMap.HBlur"), TEXT("ToneMap.VBlur"),
+				In.Quality.ClarityRadius, bLumaClarity ? GetLuma() : Chain.SceneColor,
+				bLumaClarity ? EToneMapIntermediate::Luminance : EToneMapIntermediate::Color);
+		}
+
+		if (bGlobalColorCast)
+		{
+			const int32 GroupTexels = FToneMapColorAverageReduceCS::GroupSize * 2;
+			const FIntPoint NumGroups = FIntPoint::DivideAndRoundUp(WS, GroupTexels);
+			const int32 Partials = B.AddPass(TEXT("ToneMap_ColorAverageReduce"), WS, 1, 4,
+				{ Chain.SceneColor }, B.AddTexture(TEXT("ToneMap.ColorAveragePartials"), FIntPoint(NumGroups.X * NumGroups.Y, 1), 16));
+			Chain.SceneAverageColor = B.AddPass(TEXT("ToneMap_ColorAverageResolve"), FIntPoint(1, 1), NumGroups.X * NumGroups.Y, 4 * NumGroups.X * NumGroups.Y,
+				{ Partials }, B.AddPersistentTexture(TEXT("ToneMap.ColorAverage"), FIntPoint(1, 1), 16));
+		}
+
+		if (bNeedFineBlur)
+		{
+			Chain.BlurredFine = AddBlurPair(TEXT("ToneMap_DynamicContrast_FineH"), TEXT("ToneMap_DynamicContrast_FineV"),
+				TEXT("ToneMap.DynamicContrast.FineH"), TEXT("ToneMap.DynamicContrast.FineV"),
+				2.0f, bLumaFine ? GetLuma() : Chain.SceneColor,
+				bLumaFine ? EToneMapIntermediate::Luminance : EToneMapIntermediate::Color);
+		}
+
+		if (bNeedCoarseBlur)
+		{
+			Chain.BlurredCoarse = AddBlurPair(TEXT("ToneMap_DynamicContrast_CoarseH"), TEXT("ToneMap_DynamicContrast_CoarseV"),
+				TEXT("ToneMap.DynamicContrast.CoarseH"), TEXT("ToneMap.DynamicContrast.CoarseV"),
+				32.0f, bLumaCoarse ? GetLuma() : Chain.SceneColor,
+				bLumaCoarse ? EToneMapIntermediate::Luminance : EToneMapIntermediate::BlurScratch);
+		}
+	}
+
+	static void AddDurand(FBuilder& B, FChain& Chain, const UToneMapComponent& Settings)
+	{
+		const FIntPoint WS = B.Plan.Inputs.ViewportSize;
+		const int32 HalfKernel = FMath::Clamp(FMath::RoundToInt32(3.0f * Settings.DurandSpatialSigma), 1, 32);
+		const int32 BilateralFetches = 2 * (2 * HalfKernel + 1) + 1;
+
+		const int32 LogLum = B.AddPass(TEXT("DurandLogLum"), WS, 1, 6,
+			{ Chain.SceneColor }, B.AddTexture(TEXT("ToneMapDurand.LogLum"), WS, EToneMapIntermediate::LogLuminance));
+		const int32 BasePing = B.AddPass(TEXT("DurandBilateralH"), WS, BilateralFetches, 6 * BilateralFetches,
+			{ LogLum }, B.AddTexture(TEXT("ToneMapDurand.BasePing"), WS, EToneMapIntermediate::LogLuminance));
+		const int32 BasePong = B.AddPass(TEXT("DurandBilateralV"), WS, BilateralFetches, 6 * BilateralFetches,
+			{ BasePing, LogLum }, B.AddTexture(TEXT("ToneMapDurand.BasePong"), WS, EToneMapIntermediate::LogLuminance));
+		Chain.PreToneMapped = B.AddPass(TEXT("DurandReconstruct"), WS, 3, 20,
+			{ Chain.SceneColor, LogLum, BasePong }, B.AddTexture(TEXT("ToneMapDurand.Result"), WS, EToneMapIntermediate::Color));
+	}
+
+	static void AddFattal(FBuilder& B, FChain& Chain)
+	{
+		const FToneMapPlanInputs& In = B.Plan.Inputs;
+		const FIntPoint WS = In.ViewportSize;
+
+		const int32 LogLum = B.AddPass(TEXT("FattalLogLum"), WS, 1, 6,
+			{ Chain.SceneColor }, B.AddTexture(TEXT("ToneMapFattal.LogLum"), WS, EToneMapIntermediate::LogLuminance));
+		const int32 Gradient = B.AddPass(TEXT("FattalGradient"), WS, 5, 40,
+			{ LogLum }, B.AddTexture(TEXT("ToneMapFattal.Gradient"), WS, EToneMapIntermediate::Vector2));
+		const int32 DivH = B.AddPass(TEXT("FattalDivergence"), WS, 3, 8,
+			{ Gradient }, B.AddTexture(TEXT("ToneMapFattal.DivH"), WS, EToneMapIntermediate::Scalar));
+
+		// Seeded with the log luminance, then ping-pong
+		int32 Current = LogLum;
+		int32 Ping = INDEX_NONE;
+		int32 Pong = INDEX_NONE;
+		for (int32 It = 0; It < In.Quality.FattalIterations; ++It)
+		{
+			int32& Out = (It % 2 == 0) ? Ping : Pong;
+			if (Out == INDEX_NONE)
+			{
+				Out = B.AddTexture((It % 2 == 0) ? TEXT("ToneMapFattal.JPing") : TEXT("ToneMapFattal.JPong"), WS, EToneMapIntermediate::Scalar);
+			}
+			Current = B.AddPass(TEXT("FattalJacobi"), WS, 5, 8, { Current, DivH }, Out);
+		}
+
+		Chain.PreToneMapped = B.AddPass(TEXT("FattalReconstruct"), WS, 2, 20,
+			{ Chain.SceneColor, Current }, B.AddTexture(TEXT("ToneMapFattal.Result"), WS, EToneMapIntermediate::Color));
+	}
+
+	static void AddLens(FBuilder& B, FChain& Chain, const UToneMapComponent& Settings)
+	{
+		const FToneMapPlanInputs& In = B.Plan.Inputs;
+		const FIntPoint WS = In.ViewportSize;
+		const FIntPoint LS(
+			FMath::Max(1, FMath::RoundToInt32(WS.X * In.Quality.LensResolutionScale)),
+			FMath::Max(1, FMath::RoundToInt32(WS.Y * In.Quality.LensResolutionScale)));
+
+		const int32 BrightPass = B.AddPass(TEXT("LensBrightPass"), LS, 1, 8,
+			{ Chain.SceneColor }, B.AddTexture(TEXT("ToneMapLens.BrightPass"), LS, EToneMapIntermediate::BlurScratch));
+
+		int32 Corona = INDEX_NONE;
+		if (Settings.bEnableCiliaryCorona && In.IsFeatureCompiled(EToneMapShaderFeature::CiliaryCorona))
+		{
+			const int32 Fetches = 1 + 2 * FMath::Max(Settings.CoronaSpikeCount / 2, 1) * FMath::Min(In.Quality.CoronaSpikeLength, 200);
+			Corona = B.AddPass(TEXT("CoronaStreaks"), LS, Fetches, 3 * Fetches,
+				{ BrightPass }, B.AddTexture(TEXT("ToneMapLens.Corona"), LS, EToneMapIntermediate::BlurScratch));
+		}
+
+		int32 Halo = INDEX_NONE;
+		if (Settings.bEnableLenticularHalo && In.IsFeatureCompiled(EToneMapShaderFeature::LenticularHalo))
+		{
+			const int32 Fetches = In.Quality.HaloAngularSamples * 5;
+			Halo = B.AddPass(TEXT("HaloRing"), LS, Fetches, 4 * Fetches,
+				{ BrightPass }, B.AddTexture(TEXT("ToneMapLens.Halo"), LS, EToneMapIntermediate::BlurScratch));
+		}
+
+		Chain.SceneColor = B.AddPass(TEXT("LensEffectsComposite"), WS, 3, 12,
+			{ Chain.SceneColor, Corona, Halo },
+			B.AddTexture(TEXT("ToneMapLens.Composite"), WS, In.SceneColorBytesPerPixel));
+	}
+
+	static void AddProcess(FBuilder& B, FChain& Chain, const UToneMapComponent& Settings, bool bStagesAfter)
+	{
+		const FToneMapPlanInputs& In = B.Plan.Inputs;
+		const FIntPoint WS = In.ViewportSize;
+
+		const int32 Target = bStagesAfter
+			? B.AddTexture(TEXT("ToneMap.PrePostPasses"), WS, EToneMapIntermediate::Color)
+			: B.Plan.OutputTexture;
+
+		// Scene colour plus whatever the scene-referred stages left on the context
+		const int32 NumSpatialReads = 1
+			+ (Chain.Blurred != INDEX_NONE) + (Chain.BlurredFine != INDEX_NONE) + (Chain.BlurredCoarse != INDEX_NONE)
+			+ (Chain.SceneAverageColor != INDEX_NONE) + (Chain.AdaptedLum != INDEX_NONE) + (Chain.PreToneMapped != INDEX_NONE);
+
+		if (Settings.ProcessingPath != EToneMapProcessingPath::LUT)
+		{
+			Chain.Output = B.AddPass(TEXT("ToneMapProcess"), WS, NumSpatialReads, 250,
+				{ Chain.SceneColor, Chain.Blurred, Chain.BlurredFine, Chain.BlurredCoarse,
+				  Chain.SceneAverageColor, Chain.AdaptedLum, Chain.PreToneMapped }, Target);
+			return;
+		}
+
+		// 32³ LUT as a 1024x32 strip, only rebaked when its inputs change
+		const FIntPoint LUTExtent(1024, 32);
+		const bool bBlend = Settings.LUTBlend.From && Settings.LUTBlend.To;
+		const int32 BakedLUT = B.AddPass(TEXT("ToneMapCombineLUT"), LUTExtent, 0, 200,
+			{}, B.AddPersistentTexture(bBlend ? TEXT("ToneMap.TransitionLUTFrom") : TEXT("ToneMap.BakedLUT"), LUTExtent, 8), true);
+		const int32 BlendLUT = bBlend
+			? B.AddPass(TEXT("ToneMapCombineLUT"), LUTExtent, 0, 200,
+				{}, B.AddPersistentTexture(TEXT("ToneMap.TransitionLUTTo"), LUTExtent, 8), true)
+			: INDEX_NONE;
+
+		Chain.Output = B.AddPass(TEXT("ToneMapApplyLUT"), WS, NumSpatialReads + (bBlend ? 4 : 2), 60,
+			{ Chain.SceneColor, Chain.Blurred, Chain.BlurredFine, Chain.BlurredCoarse,
+			  Chain.SceneAverageColor, Chain.AdaptedLum, Chain.PreToneMapped, BakedLUT, BlendLUT }, Target);
+	}
+
+	// One display-referred pass: reads the chain's latest image, writes the next
+	static void AddChainPass(FBuilder& B, FChain& Chain, const TCHAR* PassName, const TCHAR* TargetName,
+		int32 FetchesPerPixel, int32 ALUPerPixel, bool bStagesAfter)
+	{
+		const FIntPoint WS = B.Plan.Inputs.ViewportSize;
+		const int32 Target = bStagesAfter
+			? B.AddTexture(TargetName, WS, EToneMapIntermediate::Color)
+			: B.Plan.OutputTexture;
+		Chain.Output = B.AddPass(PassName, WS, FetchesPerPixel, ALUPerPixel, { Chain.Output }, Target);
+	}
+
+	static bool IsStageActive(EToneMapPlanStage Stage, const UToneMapComponent& Settings, const FToneMapPlanInputs& Inputs)
+	{
+		if (!FToneMapFramePlanner::WantsStage(Stage, Settings, Inputs))
+		{
+			return false;
+		}
+
+		// What IsAvailable_RenderThread culls at runtime
+		switch (Stage)
+		{
+		case EToneMapPlanStage::Bloom:
+			return Inputs.IsFeatureCompiled(EToneMapShaderFeature::Bloom);
+		case EToneMapPlanStage::Durand:
+			return Inputs.IsFeatureCompiled(EToneMapShaderFeature::Durand);
+		case EToneMapPlanStage::Fattal:
+			return Inputs.IsFeatureCompiled(EToneMapShaderFeature::Fattal);
+		case EToneMapPlanStage::Lens:
+			return (Settings.bEnableCiliaryCorona && Inputs.IsFeatureCompiled(EToneMapShaderFeature::CiliaryCorona))
+				|| (Settings.bEnableLenticularHalo && Inputs.IsFeatureCompiled(EToneMapShaderFeature::LenticularHalo));
+		default:
+			return true;
+		}
+	}
+
+	// Sum of the transient textures alive during each pass
+	static void ComputePeak(const FToneMapFramePlan& Plan, uint64& OutPeak, int32& OutPeakPass)
+	{
+		OutPeak = 0;
+		OutPeakPass = INDEX_NONE;
+		for (int32 PassIndex = 0; PassIndex < Plan.Passes.Num(); ++PassIndex)
+		{
+			uint64 Live = 0;
+			for (const FToneMapPlanTexture& Texture : Plan.Textures)
+			{
+				if (Texture.bTransient && Texture.FirstPass <= PassIndex && PassIndex <= Texture.LastPass)
+				{
+					Live += Texture.GetBytes();
+				}
+			}
+			if (Live > OutPeak)
+			{
+				OutPeak = Live;
+				OutPeakPass = PassIndex;
+			}
+		}
+	}
+}
+
+FToneMapFramePlan FToneMapFramePlanner::Build(const UToneMapComponent& Settings, const FToneMapPlanInputs& Inputs)
+{
+	using namespace ToneMapFramePlan;
+
+	FToneMapFramePlan Plan;
+	Plan.Inputs = Inputs;
+	Plan.Inputs.ViewportSize = FIntPoint(FMath::Max(Inputs.ViewportSize.X, 1), FMath::Max(Inputs.ViewportSize.Y, 1));
+	const FIntPoint WS = Plan.Inputs.ViewportSize;
+
+	FBuilder B(Plan);
+	FChain Chain;
+
+	// Owned by the engine: the scene colour handed in and the texture handed back
+	Chain.SceneColor = B.AddTexture(TEXT("SceneColor"), WS, Inputs.SceneColorBytesPerPixel, false);
+	Plan.OutputTexture = B.AddTexture(
+		(Inputs.bReplaceTonemap && Inputs.bOverrideOutput) ? TEXT("OverrideOutput") : TEXT("ToneMap.Output"), WS, 8, false);
+
+	bool bActive[(int32)EToneMapPlanStage::Num];
+	for (int32 StageIndex = 0; StageIndex < (int32)EToneMapPlanStage::Num; ++StageIndex)
+	{
+		bActive[StageIndex] = IsStageActive((EToneMapPlanStage)StageIndex, Settings, Plan.Inputs);
+		Plan.Stages[StageIndex].bActive = bActive[StageIndex];
+	}
+
+	auto HasStagesAfter = [&bActive](EToneMapPlanStage Stage)
+	{
+		for (int32 StageIndex = (int32)Stage + 1; StageIndex < (int32)EToneMapPlanStage::Num; ++StageIndex)
+		{
+			if (bActive[StageIndex])
+			{
+				return true;
+			}
+		}
+		return false;
+	};
+
+	for (int32 StageIndex = 0; StageIndex < (int32)EToneMapPlanStage::Num; ++StageIndex)
+	{
+		if (!bActive[StageIndex])
+		{
+			continue;
+		}
+
+		const EToneMapPlanStage Stage = (EToneMapPlanStage)StageIndex;
+		const bool bStagesAfter = HasStagesAfter(Stage);
+		B.Stage = Stage;
+
+		switch (Stage)
+		{
+		case EToneMapPlanStage::Bloom:         AddBloom(B, Chain, Settings); break;
+		case EToneMapPlanStage::Exposure:      AddExposure(B, Chain); break;
+		case EToneMapPlanStage::LocalContrast: AddLocalContrast(B, Chain, Settings); break;
+		case EToneMapPlanStage::Durand:        AddDurand(B, Chain, Settings); break;
+		case EToneMapPlanStage::Fattal:        AddFattal(B, Chain); break;
+		case EToneMapPlanStage::Lens:          AddLens(B, Chain, Settings); break;
+		case EToneMapPlanStage::Process:       AddProcess(B, Chain, Settings, bStagesAfter); break;
+		case EToneMapPlanStage::Sharpen:       AddChainPass(B, Chain, TEXT("ToneMapSharpen"), TEXT("ToneMap.PreLUT"), 5, 20, bStagesAfter); break;
+		case EToneMapPlanStage::LUT:           AddChainPass(B, Chain, TEXT("ToneMapLUT"), TEXT("ToneMap.PreVignette"), 3, 16, bStagesAfter); break;
+		case EToneMapPlanStage::Vignette:      AddChainPass(B, Chain, TEXT("ToneMapVignette"), TEXT("ToneMap.PreHDREncode"), 1, 12, bStagesAfter); break;
+		case EToneMapPlanStage::HDREncode:     AddChainPass(B, Chain, TEXT("HDREncode"), TEXT("ToneMap.PostHDREncode"), 1, 30, bStagesAfter); break;
+		default: break;
+		}
+	}
+
+	// Nothing reads an unread texture after its writer
+	for (FToneMapPlanTexture& Texture : Plan.Textures)
+	{
+		if (Texture.FirstPass != INDEX_NONE && Texture.LastPass < Texture.FirstPass)
+		{
+			Texture.LastPass = Texture.FirstPass;
+		}
+	}
+
+	ComputePeak(Plan, Plan.PeakTransientBytes, Plan.PeakPass);
+	return Plan;
+}
+
+// ---------------------------------------------------------------------------
+// FToneMapFramePlan
+// ---------------------------------------------------------------------------
+
+uint64 FToneMapFramePlan::GetTotalFetches() const
+{
+	uint64 Total = 0;
+	for (const FToneMapPlanPass& Pass : Passes)
+	{
+		Total += Pass.bCachedAcrossFrames ? 0 : Pass.GetFetches();
+	}
+	return Total;
+}
+
+uint64 FToneMapFramePlan::GetTotalALU() const
+{
+	uint64 Total = 0;
+	for (const FToneMapPlanPass& Pass : Passes)
+	{
+		Total += Pass.bCachedAcrossFrames ? 0 : Pass.GetALU();
+	}
+	return Total;
+}
+
+bool FToneMapFramePlan::Validate(FString* OutError) const
+{
+	auto Fail = [OutError](FString&& Message)
+	{
+		if (OutError)
+		{
+			*OutError = MoveTemp(Message);
+		}
+		return false;
+	};
+
+	for (int32 PassIndex = 0; PassIndex < Passes.Num(); ++PassIndex)
+	{
+		const FToneMapPlanPass& Pass = Passes[PassIndex];
+		if (!Textures.IsValidIndex(Pass.Write))
+		{
+			return Fail(FString::Printf(TEXT("pass %d (%s) writes no texture"), PassIndex, Pass.Name));
+		}
+		if (Pass.Extent.X <= 0 || Pass.Extent.Y <= 0)
+		{
+			return Fail(FString::Printf(TEXT("pass %d (%s) has an empty extent"), PassIndex, Pass.Name));
+		}
+		if (!Stages[(int32)Pass.Stage].bActive)
+		{
+			return Fail(FString::Printf(TEXT("pass %d (%s) belongs to culled stage %s"),
+				PassIndex, Pass.Name, FToneMapFramePlanner::GetStageName(Pass.Stage)));
+		}
+		if (PassIndex > 0 && Pass.Stage < Passes[PassIndex - 1].Stage)
+		{
+			return Fail(FString::Printf(TEXT("pass %d (%s) runs out of stage order"), PassIndex, Pass.Name));
+		}
+
+		for (const int32 Read : Pass.Reads)
+		{
+			if (!Textures.IsValidIndex(Read))
+			{
+				return Fail(FString::Printf(TEXT("pass %d (%s) reads an unknown texture"), PassIndex, Pass.Name));
+			}
+			const FToneMapPlanTexture& Texture = Textures[Read];
+			if (Read == Pass.Write)
+			{
+				return Fail(FString::Printf(TEXT("pass %d (%s) reads its own target %s"), PassIndex, Pass.Name, Texture.Name));
+			}
+			if (Texture.bTransient && (Texture.FirstPass == INDEX_NONE || Texture.FirstPass >= PassIndex))
+			{
+				return Fail(FString::Printf(TEXT("pass %d (%s) reads %s before it is written"), PassIndex, Pass.Name, Texture.Name));
+			}
+			if (Texture.LastPass < PassIndex)
+			{
+				return Fail(FString::Printf(TEXT("%s is read by pass %d after its lifetime ends"), Texture.Name, PassIndex));
+			}
+		}
+	}
+
+	for (const FToneMapPlanTexture& Texture : Textures)
+	{
+		if (Texture.bTransient && (Texture.FirstPass == INDEX_NONE || Texture.LastPass < Texture.FirstPass
+			|| !Passes.IsValidIndex(Texture.LastPass)))
+		{
+			return Fail(FString::Printf(TEXT("%s has an invalid lifetime [%d, %d]"), Texture.Name, Texture.FirstPass, Texture.LastPass));
+		}
+	}
+
+	if (Passes.Num() == 0 || Passes.Last().Write != OutputTexture)
+	{
+		return Fail(TEXT("the chain does not end in the output"));
+	}
+
+	for (int32 StageIndex = 0; StageIndex < (int32)EToneMapPlanStage::Num; ++StageIndex)
+	{
+		if (!Stages[StageIndex].bActive && Stages[StageIndex].NumPasses > 0)
+		{
+			return Fail(FString::Printf(TEXT("culled stage %s has passes"), FToneMapFramePlanner::GetStageName((EToneMapPlanStage)StageIndex)));
+		}
+	}
+
+	uint64 Peak = 0;
+	int32 PeakAt = INDEX_NONE;
+	ToneMapFramePlan::ComputePeak(*this, Peak, PeakAt);
+	if (Peak != PeakTransientBytes)
+	{
+		return Fail(FString::Printf(TEXT("peak %llu bytes does not match the lifetimes (%llu)"), PeakTransientBytes, Peak));
+	}
+	for (const FToneMapPlanTexture& Texture : Textures)
+	{
+		if (Texture.bTransient && Texture.GetBytes() > PeakTransientBytes)
+		{
+			return Fail(FString::Printf(TEXT("%s is larger than the peak"), Texture.Name));
+		}
+	}
+
+	return true;
+}
+
+void FToneMapFramePlan::Log() const
+{
+	const double ToMB = 1.0 / (1024.0 * 1024.0);
+
+	UE_LOG(LogTemp, Log, TEXT("ToneMapFX: Frame plan %dx%d — %d passes, %d textures, peak transient %.2f MB (at %s), persistent %.2f MB, %.1f M fetches, %.1f M ALU"),
+		Inputs.ViewportSize.X, Inputs.ViewportSize.Y, Passes.Num(), Textures.Num(),
+		PeakTransientBytes * ToMB, Passes.IsValidIndex(PeakPass) ? Passes[PeakPass].Name : TEXT("-"),
+		PersistentBytes * ToMB, GetTotalFetches() / 1.0e6, GetTotalALU() / 1.0e6);
+
+	UE_LOG(LogTemp, Log, TEXT("ToneMapFX:   Stage           Passes  MFetches      MALU"));
+	for (int32 StageIndex = 0; StageIndex < (int32)EToneMapPlanStage::Num; ++StageIndex)
+	{
+		const FToneMapPlanStageCost& Cost = Stages[StageIndex];
+		if (Cost.bActive)
+		{
+			UE_LOG(LogTemp, Log, TEXT("ToneMapFX:   %-14s %7d %9.2f %9.2f"),
+				FToneMapFramePlanner::GetStageName((EToneMapPlanStage)StageIndex), Cost.NumPasses, Cost.Fetches / 1.0e6, Cost.ALU / 1.0e6);
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("ToneMapFX:   Pass                               Extent     Fetch/px  ALU/px  Writes"));
+	for (int32 PassIndex = 0; PassIndex < Passes.Num(); ++PassIndex)
+	{
+		const FToneMapPlanPass& Pass = Passes[PassIndex];
+		UE_LOG(LogTemp, Log, TEXT("ToneMapFX:   %3d %-30s %5dx%-5d %8d %7d  %s%s"),
+			PassIndex, Pass.Name, Pass.Extent.X, Pass.Extent.Y, Pass.FetchesPerPixel, Pass.ALUPerPixel,
+			Textures[Pass.Write].Name, Pass.bCachedAcrossFrames ? TEXT(" (cached)") : TEXT(""));
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("ToneMapFX:   Texture                             Extent        KB  Lifetime"));
+	for (const FToneMapPlanTexture& Texture : Textures)
+	{
+		UE_LOG(LogTemp, Log, TEXT("ToneMapFX:   %-34s %5dx%-5d %8llu  [%d, %d]%s"),
+			Texture.Name, Texture.Extent.X, Texture.Extent.Y, Texture.GetBytes() / 1024,
+			Texture.FirstPass, Texture.LastPass, Texture.bTransient ? TEXT("") : TEXT(" external"));
+	}
+}
+
+// ---------------------------------------------------------------------------
+// r.ToneMapFX.DumpPlan
+// ---------------------------------------------------------------------------
+
+static void DumpPlan(const TArray<FString>& Args)
+{
+	// [preset.txt] [Width Height] [Quality] — defaults: component defaults, 1920x1080, r.ToneMapFX.Quality
+	const UToneMapComponent* Settings = GetDefault<UToneMapComponent>();
+	int32 ArgIndex = 0;
+
+	if (Args.IsValidIndex(ArgIndex) && !Args[ArgIndex].IsNumeric())
+	{
+		FString Path = Args[ArgIndex++];
+		if (FPaths::IsRelative(Path))
+		{
+			Path = UToneMapComponent::GetPresetDirectory() / Path;
+		}
+
+		UToneMapComponent* Loaded = NewObject<UToneMapComponent>(GetTransientPackage());
+		if (!Loaded->LoadPresetFromPath(Path))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: DumpPlan could not load preset '%s'"), *Path);
+			return;
+		}
+		Settings = Loaded;
+	}
+
+	FIntPoint ViewportSize(1920, 1080);
+	if (Args.IsValidIndex(ArgIndex + 1))
+	{
+		ViewportSize = FIntPoint(FCString::Atoi(*Args[ArgIndex]), FCString::Atoi(*Args[ArgIndex + 1]));
+		ArgIndex += 2;
+	}
+
+	const IConsoleVariable* QualityCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("r.ToneMapFX.Quality"));
+	int32 Quality = QualityCVar ? QualityCVar->GetInt() : FToneMapScalability::NumTiers - 1;
+	if (Args.IsValidIndex(ArgIndex))
+	{
+		Quality = FCString::Atoi(*Args[ArgIndex]);
+	}
+
+	const FToneMapFramePlan Plan = FToneMapFramePlanner::Build(*Settings, FToneMapPlanInputs::Make(*Settings, ViewportSize, Quality));
+	Plan.Log();
+
+	FString Error;
+	if (!Plan.Validate(&Error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("ToneMapFX: Invalid plan: %s"), *Error);
+	}
+}
+
+static FAutoConsoleCommand CmdToneMapDumpPlan(
+	TEXT("r.ToneMapFX.DumpPlan"),
+	TEXT("Log the passes, textures, peak memory and estimated cost of a preset without rendering.\n")
+	TEXT("Usage: r.ToneMapFX.DumpPlan [preset.txt] [Width Height] [Quality]  (default: component defaults, 1920x1080, r.ToneMapFX.Quality)"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&DumpPlan));
@@ -0,0 +1,370 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapGaussianBlur.h"
+#include "ToneMapShaders.h"
+#include "ToneMapTransientTextures.h"
+#include "ToneMapPSOPrecache.h"
+#include "HAL/IConsoleManager.h"
+#include "PixelFormat.h"
+#include "RenderGraphUtils.h"
+
+IMPLEMENT_GLOBAL_SHADER(FToneMapGaussianBlurTiledCS, "/Plugin/ToneMapFX/Private/ToneMapGaussianTiled.usf", "GaussianBlurTiledCS", SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FToneMapGaussianRecursiveCS, "/Plugin/ToneMapFX/Private/ToneMapGaussianRecursive.usf", "RecursiveGaussianCS", SF_Compute);
+
+static TAutoConsoleVariable<int32> CVarToneMapTiledBlur(
+	TEXT("r.ToneMapFX.TiledBlur"),
+	1,
+	TEXT("Use the LDS-tiled compute Gaussian blur for Clarity, Dynamic Contrast and the bloom blur.\n")
+	TEXT(" 0: pixel shaders (linear-sampling tap pairs)\n")
+	TEXT(" 1: tiled compute where the output format supports typed UAV stores (default)"),
+	ECVF_RenderThreadSafe | ECVF_Scalability);
+
+static TAutoConsoleVariable<int32> CVarToneMapRecursiveBlur(
+	TEXT("r.ToneMapFX.RecursiveBlur"),
+	0,
+	TEXT("Use the recursive (Young-van Vliet IIR) Gaussian, whose cost does not depend on the radius.\n")
+	TEXT("It runs one thread per row / column, so a pass is only a few dozen groups wide.\n")
+	TEXT(" 0: never — wide kernels are truncated to 48 texels (default)\n")
+	TEXT(" 1: when the kernel would be truncated, sigma > 16\n")
+	TEXT(" 2: always\n")
+	TEXT("Needs an output format with typed UAV stores; otherwise the pixel shader is used."),
+	ECVF_RenderThreadSafe | ECVF_Scalability);
+
+static_assert(FToneMapGaussianKernel::MaxHalfSize / 4 + 1 == 13, "KernelWeights size must match ToneMapGaussianKernel.ush");
+static_assert((FToneMapGaussianKernel::MaxPairs + 1) / 2 == 12, "KernelPairs size must match ToneMapGaussianKernel.ush");
+
+// ---------------------------------------------------------------------------
+// Kernel
+// ---------------------------------------------------------------------------
+
+FToneMapGaussianKernel FToneMapGaussianKernel::Build(float Sigma)
+{
+	FToneMapGaussianKernel Kernel;
+
+	Sigma = FMath::Max(Sigma, 0.5f);
+	Kernel.Sigma = Sigma;
+	Kernel.HalfSize = FMath::Min(FMath::CeilToInt32(3.0f * Sigma), MaxHalfSize);
+
+	const float InvTwoSigmaSq = -0.5f / (Sigma * Sigma);
+	float Total = 0.0f;
+	for (int32 i = 0; i <= Kernel.HalfSize; ++i)
+	{
+		Kernel.Weights[i] = FMath::Exp((float)(i * i) * InvTwoSigmaSq);
+		Total += (i == 0) ? Kernel.Weights[i] : 2.0f * Kernel.Weights[i];
+	}
+	for (int32 i = 0; i <= Kernel.HalfSize; ++i)
+	{
+		Kernel.Weights[i] /= Total;
+	}
+
+	// Taps (1,2), (3,4), … merge into one bilinear fetch; an odd last tap stands alone
+	for (int32 i = 1; i <= Kernel.HalfSize; i += 2)
+	{
+		const float W0 = Kernel.Weights[i];
+		const float W1 = (i + 1 <= Kernel.HalfSize) ? Kernel.Weights[i + 1] : 0.0f;
+		const float W = W0 + W1;
+		const float Offset = (W > 0.0f) ? ((float)i * W0 + (float)(i + 1) * W1) / W : (float)i;
+		Kernel.Pairs[Kernel.NumPairs++] = FVector2f(Offset, W);
+	}
+
+	return Kernel;
+}
+
+void FToneMapGaussianKernel::SetParameters(FToneMapGaussianKernelParameters& OutParameters) const
+{
+	for (int32 i = 0; i <= MaxHalfSize; ++i)
+	{
+		OutParameters.KernelWeights[i / 4][i % 4] = (i <= HalfSize) ? Weights[i] : 0.0f;
+	}
+	for (int32 i = 0; i < MaxPairs; ++i)
+	{
+		const FVector2f Pair = (i < NumPairs) ? Pairs[i] : FVector2f::ZeroVector;
+		OutParameters.KernelPairs[i / 2][(i % 2) * 2 + 0] = Pair.X;
+		OutParameters.KernelPairs[i / 2][(i % 2) * 2 + 1] = Pair.Y;
+	}
+	OutParameters.KernelHalfSize = HalfSize;
+	OutParameters.KernelNumPairs = NumPairs;
+}
+
+// ---------------------------------------------------------------------------
+// Method selection
+// ---------------------------------------------------------------------------
+
+bool FToneMapGaussianBlur::SupportsComputeOutput(EPixelFormat OutputFormat)
+{
+	return UE::PixelFormat::HasCapabilities(OutputFormat, EPixelFormatCapabilities::TypedUAVStore);
+}
+
+bool FToneMapGaussianBlur::SupportsComputeViewBlur()
+{
+	return SupportsComputeOutput(PF_FloatRGBA)
+		&& SupportsComputeOutput(PF_FloatR11G11B10)
+		&& SupportsComputeOutput(PF_R16F);
+}
+
+EToneMapBlurMethod FToneMapGaussianBlur::GetMethod(float Sigma, bool bComputeOutput, bool bTiled, int32 RecursiveMode)
+{
+	if (!bComputeOutput) return EToneMapBlurMethod::PixelShader;
+
+	const bool bTruncated = FMath::CeilToInt32(3.0f * FMath::Max(Sigma, 0.5f)) > FToneMapGaussianKernel::MaxHalfSize;
+	if (RecursiveMode >= 2 || (RecursiveMode == 1 && bTruncated))
+	{
+		return EToneMapBlurMethod::Recursive;
+	}
+
+	return bTiled ? EToneMapBlurMethod::Tiled : EToneMapBlurMethod::PixelShader;
+}
+
+EToneMapBlurMethod FToneMapGaussianBlur::GetMethod_RenderThread(float Sigma, bool bComputeOutput)
+{
+	return GetMethod(Sigma, bComputeOutput, IsTiledEnabled_RenderThread(), GetRecursiveMode_RenderThread());
+}
+
+bool FToneMapGaussianBlur::IsTiledEnabled_RenderThread()
+{
+	return CVarToneMapTiledBlur.GetValueOnRenderThread() != 0;
+}
+
+int32 FToneMapGaussianBlur::GetRecursiveMode_RenderThread()
+{
+	return CVarToneMapRecursiveBlur.GetValueOnRenderThread();
+}
+
+void FToneMapGaussianBlur::AddComputePass(
+	FRDGBuilder& GraphBuilder,
+	const FGlobalShaderMap* ShaderMap,
+	FToneMapTransientTextures& Transients,
+	FRDGEventName&& PassName,
+	ERDGPassFlags PassFlags,
+	EToneMapBlurMethod Method,
+	const FToneMapGaussianKernel& Kernel,
+	bool bVertical,
+	FRDGTextureRef Source,
+	FIntPoint SourceOrigin,
+	FRDGTextureRef Output,
+	FIntPoint OutputSize)
+{
+	check(Method != EToneMapBlurMethod::PixelShader);
+
+	if (Method == EToneMapBlurMethod::Recursive)
+	{
+		AddRecursivePass(GraphBuilder, ShaderMap, Transients, MoveTemp(PassName), PassFlags,
+			Kernel.Sigma, bVertical, Source, SourceOrigin, Output, OutputSize);
+	}
+	else
+	{
+		AddTiledPass(GraphBuilder, ShaderMap, MoveTemp(PassName), PassFlags,
+			Kernel, bVertical, Source, SourceOrigin, Output, OutputSize);
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Pixel shader pass
+// ---------------------------------------------------------------------------
+
+void FToneMapGaussianBlur::AddPixelShaderPass(
+	FRDGBuilder& GraphBuilder,
+	const FGlobalShaderMap* ShaderMap,
+	FRDGEventName&& PassName,
+	const FToneMapGaussianKernel& Kernel,
+	bool bVertical,
+	FRDGTextureRef Source,
+	const FIntRect& SourceRect,
+	FRDGTextureRef Output,
+	FIntPoint OutputSize,
+	const TUniformBufferRef<FViewUniformShaderParameters>& ViewUniformBuffer)
+{
+	const FIntPoint SourceExt = Source->Desc.Extent;
+
+	auto* P = GraphBuilder.AllocParameters<FToneMapBlurPS::FParameters>();
+	P->View            = ViewUniformBuffer;
+	P->SourceTexture   = Source;
+	P->SourceSampler   = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+	P->BufferSizeAndInvSize = FVector4f(
+		OutputSize.X, OutputSize.Y,
+		1.0f / OutputSize.X, 1.0f / OutputSize.Y);
+	P->BlurDirection   = bVertical ? FVector2f(0.0f, 1.0f) : FVector2f(1.0f, 0.0f);
+	P->SourceViewportRect = FVector4f(
+		(float)SourceRect.Min.X, (float)SourceRect.Min.Y,
+		(float)SourceRect.Max.X, (float)SourceRect.Max.Y);
+	P->SourceExtentInv = FVector4f(
+		1.0f / SourceExt.X, 1.0f / SourceExt.Y, 0.0f, 0.0f);
+	Kernel.SetParameters(P->Kernel);
+	P->RenderTargets[0] = FRenderTargetBinding(Output, ERenderTargetLoadAction::ENoAction);
+
+	TShaderMapRef<FToneMapBlurPS> BlurShader(ShaderMap);
+	AddToneMapFullscreenPass(
+		GraphBuilder, ShaderMap,
+		MoveTemp(PassName), BlurShader, P,
+		FIntRect(0, 0, OutputSize.X, OutputSize.Y));
+}
+
+// ---------------------------------------------------------------------------
+// Tiled compute pass
+// ---------------------------------------------------------------------------
+
+void FToneMapGaussianBlur::AddTiledPass(
+	FRDGBuilder& GraphBuilder,
+	const FGlobalShaderMap* ShaderMap,
+	FRDGEventName&& PassName,
+	ERDGPassFlags PassFlags,
+	const FToneMapGaussianKernel& Kernel,
+	bool bVertical,
+	FRDGTextureRef Source,
+	FIntPoint SourceOrigin,
+	FRDGTextureRef Output,
+	FIntPoint OutputSize)
+{
+	auto* P = GraphBuilder.AllocParameters<FToneMapGaussianBlurTiledCS::FParameters>();
+	Kernel.SetParameters(P->Kernel);
+	P->SourceTexture  = Source;
+	P->BlurOutput     = GraphBuilder.CreateUAV(Output);
+	P->SourceOrigin   = SourceOrigin;
+	P->SourceClampMax = Source->Desc.Extent - FIntPoint(1, 1);
+	P->OutputSize     = FUintVector2(OutputSize.X, OutputSize.Y);
+
+	FToneMapGaussianBlurTiledCS::FPermutationDomain Permutation;
+	Permutation.Set<FToneMapGaussianBlurTiledCS::FVerticalDim>(bVertical);
+	TShaderMapRef<FToneMapGaussianBlurTiledCS> ComputeShader(ShaderMap, Permutation);
+
+	// One group per TileSize run of a row (H) or column (V)
+	const int32 Along  = bVertical ? OutputSize.Y : OutputSize.X;
+	const int32 Across = bVertical ? OutputSize.X : OutputSize.Y;
+	AddToneMapComputePass(
+		GraphBuilder, MoveTemp(PassName), PassFlags, ComputeShader, P,
+		FIntVector(FMath::DivideAndRoundUp(Along, FToneMapGaussianBlurTiledCS::TileSize), Across, 1));
+}
+
+// ---------------------------------------------------------------------------
+// Recursive (IIR) pass
+// ---------------------------------------------------------------------------
+
+FVector4f FToneMapGaussianBlur::GetRecursiveCoefficients(float Sigma)
+{
+	// Young & van Vliet, "Recursive implementation of the Gaussian filter" (1995)
+	Sigma = FMath::Max(Sigma, 0.5f);
+	const float Q = (Sigma >= 2.5f)
+		? 0.98711f * Sigma - 0.96330f
+		: 3.97156f - 4.14554f * FMath::Sqrt(1.0f - 0.26891f * Sigma);
+
+	const float Q2 = Q * Q;
+	const float Q3 = Q2 * Q;
+	const float B0 = 1.57825f + 2.44413f * Q + 1.4281f * Q2 + 0.422205f * Q3;
+	const float B1 = 2.44413f * Q + 2.85619f * Q2 + 1.26661f * Q3;
+	const float B2 = -(1.4281f * Q2 + 1.26661f * Q3);
+	const float B3 = 0.422205f * Q3;
+
+	// B from the feedback taps as they are rounded, not from the b's: at large
+	// sigma 1 - (b1 + b2 + b3) / b0 cancels in float (B is about 4e-6 at sigma
+	// 100) and the DC gain drifts by a few percent
+	FVector4f Coefficients(0.0f, B1 / B0, B2 / B0, B3 / B0);
+	Coefficients.X = (float)(1.0 - ((double)Coefficients.Y + (double)Coefficients.Z + (double)Coefficients.W));
+	return Coefficients;
+}
+
+void FToneMapGaussianBlur::AddRecursivePass(
+	FRDGBuilder& GraphBuilder,
+	const FGlobalShaderMap* ShaderMap,
+	FToneMapTransientTextures& Transients,
+	FRDGEventName&& PassName,
+	ERDGPassFlags PassFlags,
+	float Sigma,
+	bool bVertical,
+	FRDGTextureRef Source,
+	FIntPoint SourceOrigin,
+	FRDGTextureRef Output,
+	FIntPoint OutputSize)
+{
+	const int32 NumLines = bVertical ? OutputSize.X : OutputSize.Y;
+	const FVector4f Coefficients = GetRecursiveCoefficients(Sigma);
+
+	// Causal scan results in the output's own format (R16F for a luma blur);
+	// the anti-causal scan reads them as an ordinary texture
+	FRDGTextureRef Causal = Transients.CreateFromDesc(Output->Desc, TEXT("ToneMap.RecursiveBlurCausal"));
+
+	auto AddScan = [&](FRDGEventName&& ScanName, bool bReverse, FRDGTextureRef ScanSource, FIntPoint ScanOrigin, FRDGTextureRef ScanOutput)
+	{
+		auto* P = GraphBuilder.AllocParameters<FToneMapGaussianRecursiveCS::FParameters>();
+		P->SourceTexture   = ScanSource;
+		P->BlurOutput      = GraphBuilder.CreateUAV(ScanOutput);
+		P->SourceOrigin    = ScanOrigin;
+		P->SourceClampMax  = ScanSource->Desc.Extent - FIntPoint(1, 1);
+		P->OutputSize      = FUintVector2(OutputSize.X, OutputSize.Y);
+		P->RecursiveCoeffs = Coefficients;
+
+		FToneMapGaussianRecursiveCS::FPermutationDomain Permutation;
+		Permutation.Set<FToneMapGaussianRecursiveCS::FVerticalDim>(bVertical);
+		Permutation.Set<FToneMapGaussianRecursiveCS::FReverseDim>(bReverse);
+		TShaderMapRef<FToneMapGaussianRecursiveCS> ComputeShader(ShaderMap, Permutation);
+
+		// One thread per row (H) or column (V)
+		AddToneMapComputePass(
+			GraphBuilder, MoveTemp(ScanName), PassFlags, ComputeShader, P,
+			FIntVector(FMath::DivideAndRoundUp(NumLines, FToneMapGaussianRecursiveCS::GroupSize), 1, 1));
+	};
+
+	AddScan(MoveTemp(PassName), false, Source, SourceOrigin, Causal);
+	AddScan(RDG_EVENT_NAME("ToneMap_RecursiveBlurAntiCausal"), true, Causal, FIntPoint::ZeroValue, Output);
+
+	Transients.Release(Causal);
+}
+
+// ---------------------------------------------------------------------------
+// CPU references
+// ---------------------------------------------------------------------------
+
+void FToneMapGaussianBlur::FilterRecursive(TConstArrayView<float> Input, TArrayView<float> Output, float Sigma)
+{
+	check(Input.Num() == Output.Num());
+	const int32 Length = Input.Num();
+	if (Length == 0) return;
+
+	// Same recursion and edge seeding as ToneMapGaussianRecursive.usf
+	const FVector4f C = GetRecursiveCoefficients(Sigma);
+
+	float W1 = Input[0], W2 = W1, W3 = W1;
+	for (int32 i = 0; i < Length; ++i)
+	{
+		const float W = C.X * Input[i] + C.Y * W1 + C.Z * W2 + C.W * W3;
+		Output[i] = W;
+		W3 = W2; W2 = W1; W1 = W;
+	}
+
+	float Y1 = W1, Y2 = W1, Y3 = W1;
+	for (int32 i = Length - 1; i >= 0; --i)
+	{
+		const float Y = C.X * Output[i] + C.Y * Y1 + C.Z * Y2 + C.W * Y3;
+		Output[i] = Y;
+		Y3 = Y2; Y2 = Y1; Y1 = Y;
+	}
+}
+
+void FToneMapGaussianBlur::FilterGaussian(TConstArrayView<float> Input, TArrayView<float> Output, float Sigma)
+{
+	check(Input.Num() == Output.Num());
+	const int32 Length = Input.Num();
+
+	// Direct convolution out to 4 sigma, no 48-texel cap
+	Sigma = FMath::Max(Sigma, 0.5f);
+	const int32 HalfSize = FMath::CeilToInt32(4.0f * Sigma);
+	const float InvTwoSigmaSq = -0.5f / (Sigma * Sigma);
+
+	TArray<float> Weights;
+	Weights.SetNumUninitialized(HalfSize + 1);
+	float Total = 0.0f;
+	for (int32 k = 0; k <= HalfSize; ++k)
+	{
+		Weights[k] = FMath::Exp((float)(k * k) * InvTwoSigmaSq);
+		Total += (k == 0) ? Weights[k] : 2.0f * Weights[k];
+	}
+
+	for (int32 i = 0; i < Length; ++i)
+	{
+		float Sum = 0.0f;
+		for (int32 k = -HalfSize; k <= HalfSize; ++k)
+		{
+			Sum += Input[FMath::Clamp(i + k, 0, Length - 1)] * Weights[FMath::Abs(k)];
+		}
+		Output[i] = Sum / Total;
+	}
+}
@@ -0,0 +1,167 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapGradingParameters.h"
+#include "ToneMapComponent.h"
+#include "ToneMapStats.h"
+
+IMPLEMENT_GLOBAL_SHADER_PARAMETER_STRUCT(FToneMapGradingUniformParameters, "ToneMapGrading");
+
+DEFINE_STAT(STAT_ToneMapFX_GradingBufferUpdates);
+
+// Camera exposure compensation relative to f/5.6, 1/125 s, ISO 100
+static float GetCameraEV(const UToneMapComponent& Settings)
+{
+	if (!Settings.bUseCameraExposure)
+	{
+		return 0.0f;
+	}
+
+	const float N = FMath::Max(Settings.Aperture, 1.0f);
+	const float t = 1.0f / FMath::Max(Settings.ShutterSpeedDenominator, 1.0f); // 1/X seconds
+	const float S = FMath::Max(Settings.CameraISO, 1.0f);
+	const float EV100 = FMath::Log2(N * N / t) + FMath::Log2(100.0f / S);
+	const float ReferenceEV = FMath::Log2(5.6f * 5.6f / (1.0f / 125.0f)) + FMath::Log2(100.0f / 100.0f);
+	// Negate: higher ISO / wider aperture / slower shutter = more light = positive compensation
+	return ReferenceEV - EV100;
+}
+
+void FToneMapGradingParameters::Fill(
+	FToneMapGradingUniformParameters& Out,
+	const UToneMapComponent& Settings,
+	bool bReplaceTonemap,
+	bool bPreToneMapped)
+{
+	// Padding included — GetHash reads the whole struct
+	FMemory::Memzero(&Out, sizeof(Out));
+
+	Out.bReplaceTonemap = bReplaceTonemap ? 1.0f : 0.0f;
+	Out.bPreToneMapped  = bPreToneMapped ? 1.0f : 0.0f;
+
+	// Film Curve
+	Out.FilmCurveMode = (float)static_cast<uint8>(Settings.FilmCurve);
+	Out.ReinhardWhitePoint = Settings.ReinhardWhitePoint;
+	Out.HableParams1 = FVector4f(
+		Settings.HableShoulderStrength,
+		Settings.HableLinearStrength,
+		Settings.HableLinearAngle,
+		Settings.HableToeStrength);
+	Out.HableParams2 = FVector4f(
+		Settings.HableToeNumerator,
+		Settings.HableToeDenominator,
+		Settings.HableWhitePoint,
+		0.0f);
+	Out.AgXParams = FVector4f(
+		Settings.AgXMinEV,
+		Settings.AgXMaxEV,
+		(float)static_cast<uint8>(Settings.AgXLook),
+		0.0f);
+	Out.HDRColorBalance = FVector3f(
+		Settings.HDRColorBalance.R,
+		Settings.HDRColorBalance.G,
+		Settings.HDRColorBalance.B);
+	Out.HDRSaturation = Settings.HDRSaturation;
+
+	// White Balance
+	Out.Temperature = Settings.bEnableWhiteBalance ? Settings.Temperature : 0.0f;
+	Out.Tint        = Settings.bEnableWhiteBalance ? Settings.Tint : 0.0f;
+
+	// Exposure
+	Out.ExposureValue      = Settings.Exposure;
+	Out.CameraEV           = GetCameraEV(Settings);
+	Out.bUseCameraExposure = Settings.bUseCameraExposure ? 1.0f : 0.0f;
+
+	// Auto-Exposure
+	Out.AutoExposureMode = (float)static_cast<uint8>(Settings.AutoExposureMode);
+	Out.MinAutoExposure  = Settings.MinAutoExposure;
+	Out.MaxAutoExposure  = Settings.MaxAutoExposure;
+
+	// Tone
+	Out.Contrast        = Settings.Contrast;
+	Out.HighlightsValue = Settings.bEnableToneAdjustments ? Settings.Highlights : 0.0f;
+	Out.ShadowsValue    = Settings.bEnableToneAdjustments ? Settings.Shadows : 0.0f;
+	Out.WhitesValue     = Settings.bEnableToneAdjustments ? Settings.Whites : 0.0f;
+	Out.BlacksValue     = Settings.bEnableToneAdjustments ? Settings.Blacks : 0.0f;
+	Out.ToneSmoothingValue = Settings.ToneSmoothing;
+	Out.ContrastMidpoint   = Settings.ContrastMidpoint;
+
+	// Presence
+	Out.ClarityStrength    = Settings.Clarity;
+	Out.VibranceStrength   = Settings.Vibrance;
+	Out.SaturationStrength = Settings.Saturation;
+
+	// Dynamic Contrast
+	Out.DynamicContrastStrength  = Settings.DynamicContrast;
+	Out.CorrectContrastStrength  = Settings.CorrectContrast;
+	Out.CorrectColorCastStrength = Settings.CorrectColorCast;
+
+	// Tone Curve
+	Out.ToneCurveParams = FVector4f(
+		Settings.CurveHighlights,
+		Settings.CurveLights,
+		Settings.CurveDarks,
+		Settings.CurveShadows);
+
+	// HSL
+	Out.HueShift1 = FVector4f(Settings.HueReds,   Settings.HueOranges, Settings.HueYellows, Settings.HueGreens);
+	Out.HueShift2 = FVector4f(Settings.HueAquas,  Settings.HueBlues,   Settings.HuePurples, Settings.HueMagentas);
+	Out.SatAdj1   = FVector4f(Settings.SatReds,   Settings.SatOranges, Settings.SatYellows, Settings.SatGreens);
+	Out.SatAdj2   = FVector4f(Settings.SatAquas,  Settings.SatBlues,   Settings.SatPurples, Settings.SatMagentas);
+	Out.LumAdj1   = FVector4f(Settings.LumReds,   Settings.LumOranges, Settings.LumYellows, Settings.LumGreens);
+	Out.LumAdj2   = FVector4f(Settings.LumAquas,  Settings.LumBlues,   Settings.LumPurples, Settings.LumMagentas);
+	Out.HSLSmoothing = Settings.HSLSmoothing;
+
+	// Feature toggles
+	Out.bEnableHSL    = Settings.IsAnyHSLActive()   ? 1.0f : 0.0f;
+	Out.bEnableCurves = Settings.IsAnyCurveActive() ? 1.0f : 0.0f;
+}
+
+uint32 FToneMapGradingParameters::GetHash(const FToneMapGradingUniformParameters& Parameters)
+{
+	return FCrc::MemCrc32(&Parameters, sizeof(Parameters));
+}
+
+uint32 FToneMapGradingParameters::GetBakeHash(const FToneMapGradingUniformParameters& Parameters)
+{
+	FToneMapGradingUniformParameters Baked = Parameters;
+	Baked.AutoExposureMode = 0.0f;
+	Baked.MinAutoExposure = 0.0f;
+	Baked.MaxAutoExposure = 0.0f;
+	Baked.ClarityStrength = 0.0f;
+	Baked.DynamicContrastStrength = 0.0f;
+	Baked.CorrectContrastStrength = 0.0f;
+	Baked.CorrectColorCastStrength = 0.0f;
+	return GetHash(Baked);
+}
+
+const FToneMapGradingUniformBufferRef& FToneMapGradingBuffer::Update_RenderThread(
+	const UToneMapComponent& Settings,
+	uint32 SettingsHash,
+	bool bReplaceTonemap,
+	bool bPreToneMapped)
+{
+	check(IsInRenderingThread());
+
+	// Fill reads the preset properties and the two flags only, so an unchanged
+	// snapshot hash means unchanged parameters
+	const uint32 Key = HashCombine(SettingsHash, (bReplaceTonemap ? 1u : 0u) | (bPreToneMapped ? 2u : 0u));
+	if (Buffer.IsValid() && SettingsKey == Key)
+	{
+		return Buffer;
+	}
+
+	FToneMapGradingParameters::Fill(Parameters, Settings, bReplaceTonemap, bPreToneMapped);
+	SettingsKey = Key;
+
+	// A new snapshot can still produce the same constants (a blend that settled,
+	// a property Fill does not read) — keep the buffer and the baked LUT then
+	const uint32 NewHash = FToneMapGradingParameters::GetHash(Parameters);
+	if (!Buffer.IsValid() || Hash != NewHash)
+	{
+		// Passes still in flight keep their reference to the previous buffer
+		Buffer = FToneMapGradingUniformBufferRef::CreateUniformBufferImmediate(Parameters, UniformBuffer_MultiFrame);
+		Hash = NewHash;
+		BakeHash = FToneMapGradingParameters::GetBakeHash(Parameters);
+		INC_DWORD_STAT(STAT_ToneMapFX_GradingBufferUpdates);
+	}
+	return Buffer;
+}
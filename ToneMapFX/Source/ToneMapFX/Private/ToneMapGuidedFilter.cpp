@@ -0,0 +1,137 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapGuidedFilter.h"
+#include "ToneMapTransientTextures.h"
+#include "ToneMapPSOPrecache.h"
+#include "PixelFormat.h"
+#include "RenderGraphUtils.h"
+
+IMPLEMENT_GLOBAL_SHADER(FToneMapGuidedLogLumaCS,      "/Plugin/ToneMapFX/Private/ToneMapGuidedFilter.usf", "GuidedLogLumaCS",      SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FToneMapGuidedBoxRowsCS,      "/Plugin/ToneMapFX/Private/ToneMapGuidedFilter.usf", "GuidedBoxRowsCS",      SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FToneMapGuidedCoeffColumnsCS, "/Plugin/ToneMapFX/Private/ToneMapGuidedFilter.usf", "GuidedCoeffColumnsCS", SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FToneMapGuidedCoeffRowsCS,    "/Plugin/ToneMapFX/Private/ToneMapGuidedFilter.usf", "GuidedCoeffRowsCS",    SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FToneMapGuidedBaseColumnsCS,  "/Plugin/ToneMapFX/Private/ToneMapGuidedFilter.usf", "GuidedBaseColumnsCS",  SF_Compute);
+
+bool FToneMapGuidedFilter::IsSupported()
+{
+	const EPixelFormat Formats[] = { PF_R16F, PF_R32_FLOAT, PF_G32R32F, PF_FloatRGBA };
+	for (const EPixelFormat Format : Formats)
+	{
+		if (!UE::PixelFormat::HasCapabilities(Format, EPixelFormatCapabilities::TypedUAVStore))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+int32 FToneMapGuidedFilter::GetBoxRadius(float Sigma)
+{
+	// A (2r+1)-wide box has variance ((2r+1)² - 1) / 12 = r(r+1)/3
+	const int32 Radius = FMath::RoundToInt32(0.5f * (FMath::Sqrt(1.0f + 12.0f * Sigma * Sigma) - 1.0f));
+	return FMath::Clamp(Radius, 1, MaxBoxRadius);
+}
+
+void FToneMapGuidedFilter::ModifyCompilationEnvironment(FShaderCompilerEnvironment& OutEnvironment)
+{
+	OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZE"), GroupSize);
+	OutEnvironment.SetDefine(TEXT("MAX_BOX_RADIUS"), MaxBoxRadius);
+}
+
+FRDGTextureRef FToneMapGuidedFilter::AddClarityBasePasses(
+	FRDGBuilder& GraphBuilder,
+	const FGlobalShaderMap* ShaderMap,
+	FToneMapTransientTextures& Transients,
+	FRDGTextureRef Source,
+	const FIntRect& SourceRect,
+	FIntPoint OutputSize,
+	float Sigma,
+	float EdgeThreshold)
+{
+	FToneMapGuidedFilterParameters Guided;
+	Guided.SceneColorTexture = Source;
+	Guided.SourceOrigin      = SourceRect.Min;
+	Guided.SourceClampMax    = Source->Desc.Extent - FIntPoint(1, 1);
+	Guided.OutputSize        = FUintVector2(OutputSize.X, OutputSize.Y);
+	Guided.BoxRadius         = GetBoxRadius(Sigma);
+	Guided.EdgeEpsilon       = FMath::Max(EdgeThreshold * EdgeThreshold, 1e-4f);
+
+	// One group per tile of a row (column); rows / columns along Y
+	const FIntVector RowGroups(FMath::DivideAndRoundUp(OutputSize.X, GroupSize), OutputSize.Y, 1);
+	const FIntVector ColumnGroups(FMath::DivideAndRoundUp(OutputSize.Y, GroupSize), OutputSize.X, 1);
+
+	// Pass 1: log2 luminance, read once per texel by the row boxes
+	FRDGTextureRef LogLuma = Transients.Create(OutputSize, EToneMapIntermediate::LogLuminance, TEXT("ToneMap.GuidedLogLuma"), TexCreate_UAV);
+	{
+		auto* P = GraphBuilder.AllocParameters<FToneMapGuidedLogLumaCS::FParameters>();
+		P->Guided        = Guided;
+		P->LogLumaOutput = GraphBuilder.CreateUAV(LogLuma);
+
+		TShaderMapRef<FToneMapGuidedLogLumaCS> ComputeShader(ShaderMap);
+		AddToneMapComputePass(
+			GraphBuilder, RDG_EVENT_NAME("ToneMap_GuidedLogLuma"), ERDGPassFlags::Compute,
+			ComputeShader, P, RowGroups);
+	}
+
+	// Pass 2: window means of (I, I²) along each row
+	FRDGTextureRef BoxRows = Transients.Create(OutputSize, EToneMapIntermediate::Vector2, TEXT("ToneMap.GuidedBoxRows"), TexCreate_UAV);
+	{
+		auto* P = GraphBuilder.AllocParameters<FToneMapGuidedBoxRowsCS::FParameters>();
+		P->Guided         = Guided;
+		P->LogLumaTexture = LogLuma;
+		P->BoxOutput      = GraphBuilder.CreateUAV(BoxRows);
+
+		TShaderMapRef<FToneMapGuidedBoxRowsCS> ComputeShader(ShaderMap);
+		AddToneMapComputePass(
+			GraphBuilder, RDG_EVENT_NAME("ToneMap_GuidedBoxRows (r=%d)", Guided.BoxRadius), ERDGPassFlags::Compute,
+			ComputeShader, P, RowGroups);
+	}
+	Transients.Release(LogLuma);
+
+	// Pass 3: column window → per-window coefficients (a, b)
+	FRDGTextureRef Coeffs = Transients.Create(OutputSize, EToneMapIntermediate::Vector2, TEXT("ToneMap.GuidedCoeffs"), TexCreate_UAV);
+	{
+		auto* P = GraphBuilder.AllocParameters<FToneMapGuidedCoeffColumnsCS::FParameters>();
+		P->Guided          = Guided;
+		P->BoxInputTexture = BoxRows;
+		P->CoeffOutput     = GraphBuilder.CreateUAV(Coeffs);
+
+		TShaderMapRef<FToneMapGuidedCoeffColumnsCS> ComputeShader(ShaderMap);
+		AddToneMapComputePass(
+			GraphBuilder, RDG_EVENT_NAME("ToneMap_GuidedCoeffColumns"), ERDGPassFlags::Compute,
+			ComputeShader, P, ColumnGroups);
+	}
+	Transients.Release(BoxRows);
+
+	// Pass 4: window means of (a, b) along each row
+	FRDGTextureRef CoeffRows = Transients.Create(OutputSize, EToneMapIntermediate::Vector2, TEXT("ToneMap.GuidedCoeffRows"), TexCreate_UAV);
+	{
+		auto* P = GraphBuilder.AllocParameters<FToneMapGuidedCoeffRowsCS::FParameters>();
+		P->Guided          = Guided;
+		P->BoxInputTexture = Coeffs;
+		P->BoxOutput       = GraphBuilder.CreateUAV(CoeffRows);
+
+		TShaderMapRef<FToneMapGuidedCoeffRowsCS> ComputeShader(ShaderMap);
+		AddToneMapComputePass(
+			GraphBuilder, RDG_EVENT_NAME("ToneMap_GuidedCoeffRows"), ERDGPassFlags::Compute,
+			ComputeShader, P, RowGroups);
+	}
+	Transients.Release(Coeffs);
+
+	// Pass 5: column window of (a, b), q = mean_a·I + mean_b, base colour
+	FRDGTextureRef Base = Transients.Create(OutputSize, EToneMapIntermediate::Color, TEXT("ToneMap.GuidedBase"), TexCreate_UAV);
+	{
+		auto* P = GraphBuilder.AllocParameters<FToneMapGuidedBaseColumnsCS::FParameters>();
+		P->Guided          = Guided;
+		P->BoxInputTexture = CoeffRows;
+		P->BaseOutput      = GraphBuilder.CreateUAV(Base);
+
+		TShaderMapRef<FToneMapGuidedBaseColumnsCS> ComputeShader(ShaderMap);
+		AddToneMapComputePass(
+			GraphBuilder, RDG_EVENT_NAME("ToneMap_GuidedBaseColumns"), ERDGPassFlags::Compute,
+			ComputeShader, P, ColumnGroups);
+	}
+
+	Transients.Release(CoeffRows);
+	return Base;
+}
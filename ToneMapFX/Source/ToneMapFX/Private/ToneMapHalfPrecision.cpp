@@ -0,0 +1,60 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapHalfPrecision.h"
+#include "ToneMapColorMath.h"
+#include "HAL/IConsoleManager.h"
+#include "RHIGlobals.h"
+
+static TAutoConsoleVariable<int32> CVarToneMapHalfPrecision(
+	TEXT("r.ToneMapFX.HalfPrecision"),
+	0,
+	TEXT("Run the display-referred ToneMapFX passes (Process, Apply LUT, Sharpen, Vignette) in min16float.\n")
+	TEXT(" 0: fp32 everywhere (default)\n")
+	TEXT(" 1: half permutation on RHIs with native 16-bit ALUs; HDR grading and film curves stay fp32.\n")
+	TEXT("    r.ToneMapFX.HalfPrecisionError reports the error per operator."),
+	ECVF_RenderThreadSafe | ECVF_Scalability);
+
+bool FToneMapHalfPrecision::IsEnabled_RenderThread(EShaderPlatform Platform)
+{
+	if (CVarToneMapHalfPrecision.GetValueOnRenderThread() == 0)
+	{
+		return false;
+	}
+
+	switch (FDataDrivenShaderPlatformInfo::GetSupportsRealTypes(Platform))
+	{
+	case ERHIFeatureSupport::RuntimeGuaranteed: return true;
+	case ERHIFeatureSupport::RuntimeDependent:  return GRHIGlobals.SupportsNative16BitOps;
+	default:                                    return false;
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Error report — emulated fp16 (ToneMapColorMath::Half) against the fp32 build
+// ---------------------------------------------------------------------------
+
+static void ReportHalfPrecisionError()
+{
+	UE_LOG(LogTemp, Log, TEXT("ToneMapFX: half precision vs fp32 — operators on the %d-colour lattice"), FToneMapColorMath::LatticeSize);
+	for (int32 Operator = 0; Operator < FToneMapColorMath::GetNumOperators(); ++Operator)
+	{
+		if (!FToneMapColorMath::HasHalfVariant(Operator))
+		{
+			UE_LOG(LogTemp, Log, TEXT("ToneMapFX:   %-18s fp32 (film curve)"), FToneMapColorMath::GetOperatorName(Operator));
+			continue;
+		}
+
+		float ErrorLDR = 0.0f;
+		float ErrorHDR = 0.0f;
+		FToneMapColorMath::MeasureHalfPrecisionError(Operator, ErrorLDR, ErrorHDR);
+		UE_LOG(LogTemp, Log, TEXT("ToneMapFX:   %-18s LDR %.2e (%.2f LSB at 8 bit), HDR relative %.2e"),
+			FToneMapColorMath::GetOperatorName(Operator), ErrorLDR, ErrorLDR * 255.0f, ErrorHDR);
+	}
+}
+
+static FAutoConsoleCommand CmdToneMapHalfPrecisionError(
+	TEXT("r.ToneMapFX.HalfPrecisionError"),
+	TEXT("Measure the r.ToneMapFX.HalfPrecision permutation on the CPU: worst half-vs-fp32 error of every\n")
+	TEXT("ToneMapColorMath.ush operator on the golden lattice.  ToneMapFX.Reference.HalfPrecision covers the\n")
+	TEXT("reference suite end to end."),
+	FConsoleCommandDelegate::CreateStatic(&ReportHalfPrecisionError));
@@ -0,0 +1,196 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapHistogramMetering.h"
+#include "ToneMapPSOPrecache.h"
+#include "HAL/IConsoleManager.h"
+#include "RenderGraphUtils.h"
+#include "RenderUtils.h"
+
+IMPLEMENT_GLOBAL_SHADER(FToneMapHistogramBuildCS,   "/Plugin/ToneMapFX/Private/ToneMapHistogramMetering.usf", "HistogramBuildCS",   SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FToneMapHistogramResolveCS, "/Plugin/ToneMapFX/Private/ToneMapHistogramMetering.usf", "HistogramResolveCS", SF_Compute);
+
+static TAutoConsoleVariable<int32> CVarToneMapHistogramMetering(
+	TEXT("r.ToneMapFX.HistogramMetering"),
+	1,
+	TEXT("Scene luminance measurement for Krawczyk auto-exposure.\n")
+	TEXT(" 0: geometric mean of a 16x16 grid (metering mode and percentiles ignored)\n")
+	TEXT(" 1: weighted log-luminance histogram with percentile rejection (default)"),
+	ECVF_RenderThreadSafe | ECVF_Scalability);
+
+void FToneMapHistogramBuildCS::ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+{
+	FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+	OutEnvironment.SetDefine(TEXT("GROUP_SIZE"), GroupSize);
+	OutEnvironment.SetDefine(TEXT("NUM_BINS"), FToneMapHistogramMetering::NumBins);
+	OutEnvironment.SetDefine(TEXT("SAMPLE_STRIDE"), FToneMapHistogramMetering::SampleStride);
+}
+
+void FToneMapHistogramResolveCS::ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+{
+	FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+	OutEnvironment.SetDefine(TEXT("NUM_BINS"), FToneMapHistogramMetering::NumBins);
+}
+
+static FVector2f GetHistogramLog2Range()
+{
+	return FVector2f(
+		FToneMapHistogramMetering::MinLog2Luminance,
+		1.0f / (FToneMapHistogramMetering::MaxLog2Luminance - FToneMapHistogramMetering::MinLog2Luminance));
+}
+
+bool FToneMapHistogramMetering::IsEnabled_RenderThread()
+{
+	return CVarToneMapHistogramMetering.GetValueOnRenderThread() != 0;
+}
+
+FRDGTextureRef FToneMapHistogramMetering::AddPasses(
+	FRDGBuilder& GraphBuilder,
+	const FGlobalShaderMap* ShaderMap,
+	FToneMapTransientTextures& Transients,
+	FRDGTextureRef SceneColor,
+	const FIntRect& SceneRect,
+	float OneOverPreExposure,
+	const FToneMapMeteringSettings& Settings,
+	FRDGBufferRef* OutHistogram)
+{
+	RDG_EVENT_SCOPE(GraphBuilder, "ToneMap_HistogramMetering");
+
+	const FVector2f Log2Range = GetHistogramLog2Range();
+
+	FRDGBufferRef Histogram = Transients.CreateBuffer(
+		FRDGBufferDesc::CreateBufferDesc(sizeof(uint32), NumBins),
+		TEXT("ToneMap.LumHistogram"));
+	FRDGBufferUAVRef HistogramUAV = GraphBuilder.CreateUAV(Histogram, PF_R32_UINT);
+	AddClearUAVPass(GraphBuilder, HistogramUAV, 0u);
+
+	// --- Step 1: weighted log2-luminance histogram (single dispatch) ---
+	{
+		const FIntPoint Extent = SceneColor->Desc.Extent;
+		const FIntPoint NumSamples(
+			FMath::DivideAndRoundUp(SceneRect.Width(), SampleStride),
+			FMath::DivideAndRoundUp(SceneRect.Height(), SampleStride));
+
+		FRHITexture* MaskRHI = (Settings.MaskTexture != nullptr) ? Settings.MaskTexture : GWhiteTexture->TextureRHI.GetReference();
+
+		auto* P = GraphBuilder.AllocParameters<FToneMapHistogramBuildCS::FParameters>();
+		P->HistogramLog2Range  = Log2Range;
+		P->SceneColorTexture   = SceneColor;
+		P->SceneColorSampler   = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+		P->SceneColorRect      = FIntVector4(SceneRect.Min.X, SceneRect.Min.Y, SceneRect.Max.X, SceneRect.Max.Y);
+		P->SceneColorExtentInv = FVector2f(1.0f / Extent.X, 1.0f / Extent.Y);
+		P->OneOverPreExposure  = OneOverPreExposure;
+		P->MeteringMode        = Settings.Mode;
+		P->SpotRadius          = FMath::Max(Settings.SpotRadius, 0.01f);
+		P->MeteringMaskTexture = MaskRHI;
+		P->MeteringMaskSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+		P->HistogramOutput     = HistogramUAV;
+
+		TShaderMapRef<FToneMapHistogramBuildCS> ComputeShader(ShaderMap);
+		AddToneMapComputePass(
+			GraphBuilder, RDG_EVENT_NAME("ToneMap_HistogramBuild %dx%d", NumSamples.X, NumSamples.Y), ERDGPassFlags::Compute,
+			ComputeShader, P, FComputeShaderUtils::GetGroupCount(NumSamples, FToneMapHistogramBuildCS::GroupSize));
+	}
+
+	// --- Step 2: percentile-trimmed mean (→ 1x1) ---
+	FRDGTextureRef MeasuredLum = Transients.CreateFromDesc(
+		FRDGTextureDesc::Create2D(FIntPoint(1, 1), PF_R32_FLOAT, FClearValueBinding::None,
+			TexCreate_ShaderResource | TexCreate_UAV),
+		TEXT("ToneMap.MeasuredLum"));
+	{
+		const float Low  = FMath::Clamp(Settings.LowPercent, 0.0f, 100.0f);
+		const float High = FMath::Clamp(Settings.HighPercent, Low, 100.0f);
+
+		auto* P = GraphBuilder.AllocParameters<FToneMapHistogramResolveCS::FParameters>();
+		P->HistogramLog2Range  = Log2Range;
+		P->HistogramInput      = GraphBuilder.CreateSRV(Histogram, PF_R32_UINT);
+		P->MeteringPercentiles = FVector2f(Low * 0.01f, High * 0.01f);
+		P->MeasuredLumOutput   = GraphBuilder.CreateUAV(MeasuredLum);
+
+		TShaderMapRef<FToneMapHistogramResolveCS> ComputeShader(ShaderMap);
+		AddToneMapComputePass(
+			GraphBuilder, RDG_EVENT_NAME("ToneMap_HistogramResolve"), ERDGPassFlags::Compute,
+			ComputeShader, P, FIntVector(1, 1, 1));
+	}
+
+	// The caller releases the histogram once the readback has copied it
+	if (OutHistogram)
+	{
+		*OutHistogram = Histogram;
+	}
+	else
+	{
+		Transients.Release(Histogram);
+	}
+	return MeasuredLum;
+}
+
+// ---------------------------------------------------------------------------
+// CPU reference — mirrors HistogramBuildCS / HistogramResolveCS
+// ---------------------------------------------------------------------------
+
+void FToneMapHistogramMetering::BuildHistogram(TConstArrayView<float> Luminance, TConstArrayView<float> Weights, TArrayView<uint32> OutBins)
+{
+	check(OutBins.Num() == NumBins);
+	check(Weights.Num() == 0 || Weights.Num() == Luminance.Num());
+
+	const FVector2f Log2Range = GetHistogramLog2Range();
+	for (uint32& Bin : OutBins)
+	{
+		Bin = 0;
+	}
+
+	for (int32 i = 0; i < Luminance.Num(); ++i)
+	{
+		const float Weight01 = Weights.Num() > 0 ? FMath::Clamp(Weights[i], 0.0f, 1.0f) : 1.0f;
+		const uint32 Weight = (uint32)(Weight01 * WeightScale + 0.5f);
+		if (Weight == 0)
+		{
+			continue;
+		}
+
+		const float T = (FMath::Log2(FMath::Max(Luminance[i], 1e-6f)) - Log2Range.X) * Log2Range.Y;
+		const int32 Bin = (int32)FMath::Clamp(T * NumBins, 0.0f, NumBins - 1.0f);
+		OutBins[Bin] += Weight;
+	}
+}
+
+float FToneMapHistogramMetering::ResolveHistogram(TConstArrayView<uint32> Bins, float LowPercent, float HighPercent)
+{
+	check(Bins.Num() == NumBins);
+
+	const FVector2f Log2Range = GetHistogramLog2Range();
+
+	float Total = 0.0f;
+	for (const uint32 Count : Bins)
+	{
+		Total += (float)Count;
+	}
+
+	float Log2Lum = FMath::Log2(0.18f);
+	if (Total > 0.0f)
+	{
+		const float LowFraction  = FMath::Clamp(LowPercent, 0.0f, 100.0f) * 0.01f;
+		const float HighFraction = FMath::Clamp(HighPercent, LowPercent, 100.0f) * 0.01f;
+		const float Low  = Total * LowFraction;
+		const float High = FMath::Max(Total * HighFraction, Low + 1.0f);
+		const float BinWidth = 1.0f / (Log2Range.Y * NumBins);
+
+		float Below = 0.0f;
+		float SumWeight = 0.0f;
+		float SumLog2 = 0.0f;
+		for (int32 i = 0; i < NumBins; ++i)
+		{
+			const float Count = (float)Bins[i];
+			const float Kept  = FMath::Max(FMath::Min(Below + Count, High) - FMath::Max(Below, Low), 0.0f);
+			SumWeight += Kept;
+			SumLog2   += Kept * (Log2Range.X + (i + 0.5f) * BinWidth);
+			Below     += Count;
+		}
+		if (SumWeight > 0.0f)
+		{
+			Log2Lum = SumLog2 / SumWeight;
+		}
+	}
+
+	return FMath::Exp2(Log2Lum);
+}
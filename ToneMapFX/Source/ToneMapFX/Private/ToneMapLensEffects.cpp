@@ -6,3 +6,7 @@ IMPLEMENT_GLOBAL_SHADER(FToneMapLensBrightPassPS, "/Plugin/ToneMapFX/Private/Ton
 IMPLEMENT_GLOBAL_SHADER(FToneMapCoronaStreakPS,   "/Plugin/ToneMapFX/Private/ToneMapLensCorona.usf",    "CoronaStreakPS",   SF_Pixel);
 IMPLEMENT_GLOBAL_SHADER(FToneMapHaloRingPS,       "/Plugin/ToneMapFX/Private/ToneMapLensHalo.usf",      "HaloRingPS",       SF_Pixel);
 IMPLEMENT_GLOBAL_SHADER(FToneMapLensCompositePS,  "/Plugin/ToneMapFX/Private/ToneMapLensComposite.usf", "LensCompositePS",  SF_Pixel);
+
+IMPLEMENT_GLOBAL_SHADER(FToneMapLensBrightPassCS, "/Plugin/ToneMapFX/Private/ToneMapLensBrightPass.usf", "LensBrightPassCS", SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FToneMapCoronaStreakCS,   "/Plugin/ToneMapFX/Private/ToneMapLensCorona.usf",    "CoronaStreakCS",   SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FToneMapHaloRingCS,       "/Plugin/ToneMapFX/Private/ToneMapLensHalo.usf",      "HaloRingCS",       SF_Compute);
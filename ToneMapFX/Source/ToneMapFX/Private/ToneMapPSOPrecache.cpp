@@ -0,0 +1,392 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapPSOPrecache.h"
+#include "ToneMapShaders.h"
+#include "ToneMapCombineLUTShaders.h"
+#include "ToneMapLUTShaders.h"
+#include "ToneMapSharpenShaders.h"
+#include "ToneMapVignetteShaders.h"
+#include "ToneMapHDREncode.h"
+#include "ToneMapDurand.h"
+#include "ToneMapFattal.h"
+#include "ToneMapLensEffects.h"
+#include "ClassicBloomShaders.h"
+#include "ToneMapGaussianBlur.h"
+#include "ToneMapGuidedFilter.h"
+#include "ToneMapHistogramMetering.h"
+#include "ToneMapColorAverage.h"
+#include "ToneMapExposureReadback.h"
+#include "ToneMapStats.h"
+#include "CommonRenderResources.h"
+#include "PipelineStateCache.h"
+#include "PSOPrecache.h"
+#include "RHIStaticStates.h"
+#include "SceneTexturesConfig.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+
+DEFINE_STAT(STAT_ToneMapFX_OnDemandPSOs);
+
+static TAutoConsoleVariable<int32> CVarToneMapPSOPrecache(
+	TEXT("r.ToneMapFX.PSOPrecache"),
+	1,
+	TEXT("Register the ToneMapFX pipelines with the global PSO collector and report pipelines\n")
+	TEXT("created on demand at draw time (log + 'On-Demand PSOs' in stat ToneMapFX).\n")
+	TEXT(" 0: off\n")
+	TEXT(" 1: on (default)"),
+	ECVF_RenderThreadSafe);
+
+// ---------------------------------------------------------------------------
+// Pipeline table
+// ---------------------------------------------------------------------------
+
+// Formats follow FToneMapTransientTextures::GetFormat under either precision
+// setting and either budget state — the CVars can change at runtime.
+static const EPixelFormat GColorFormats[]        = { PF_FloatRGBA, PF_FloatR11G11B10 };
+static const EPixelFormat GBlurFormats[]         = { PF_FloatRGBA, PF_FloatR11G11B10, PF_R16F };
+static const EPixelFormat GLuminanceFormats[]    = { PF_R16F };
+static const EPixelFormat GLogLuminanceFormats[] = { PF_R16F, PF_R32_FLOAT };
+static const EPixelFormat GScalarFormats[]       = { PF_R32_FLOAT, PF_R16F };
+static const EPixelFormat GVector2Formats[]      = { PF_G32R32F, PF_G16R16F };
+static const EPixelFormat GSingleTexelFormats[]  = { PF_R32_FLOAT };
+static const EPixelFormat GLUTFormats[]          = { PF_FloatRGBA };
+
+// Display-referred chain: intermediates, ToneMap.Output, or the back buffer
+// when replacing the tonemapper (8-bit, 10-bit HDR10, scRGB)
+static const EPixelFormat GOutputFormats[]       = { PF_FloatRGBA, PF_FloatR11G11B10, PF_B8G8R8A8, PF_A2B10G10R10 };
+
+struct FToneMapPipelineEntry
+{
+	FShaderType* Type;
+	TArrayView<const EPixelFormat> Formats;
+	bool bSceneColor;   // also writes a copy of scene colour (composites)
+};
+
+static TArray<FToneMapPipelineEntry> GetPixelPipelines()
+{
+	return {
+		// Main chain
+		{ &FToneMapCombineLUTPS::GetStaticType(),        GLUTFormats,          false },
+		{ &FToneMapProcessPS::GetStaticType(),           GOutputFormats,       false },
+		{ &FToneMapApplyLUTPS::GetStaticType(),          GOutputFormats,       false },
+		{ &FToneMapSharpenPS::GetStaticType(),           GOutputFormats,       false },
+		{ &FToneMapLUTPS::GetStaticType(),               GOutputFormats,       false },
+		{ &FToneMapVignettePS::GetStaticType(),          GOutputFormats,       false },
+		{ &FToneMapHDREncodePS::GetStaticType(),         GOutputFormats,       false },
+
+		// Local contrast and exposure
+		{ &FToneMapBlurPS::GetStaticType(),              GBlurFormats,         false },
+		{ &FToneMapLocalContrastLumaPS::GetStaticType(), GLuminanceFormats,    false },
+		{ &FToneMapLumMeasurePS::GetStaticType(),        GSingleTexelFormats,  false },
+		{ &FToneMapLumAdaptPS::GetStaticType(),          GSingleTexelFormats,  false },
+
+		// Durand / Fattal
+		{ &FToneMapDurandLogLumPS::GetStaticType(),      GLogLuminanceFormats, false },
+		{ &FToneMapDurandBilateralPS::GetStaticType(),   GLogLuminanceFormats, false },
+		{ &FToneMapDurandReconstructPS::GetStaticType(), GColorFormats,        false },
+		{ &FToneMapFattalLogLumPS::GetStaticType(),      GLogLuminanceFormats, false },
+		{ &FToneMapFattalGradientPS::GetStaticType(),    GVector2Formats,      false },
+		{ &FToneMapFattalDivergencePS::GetStaticType(),  GScalarFormats,       false },
+		{ &FToneMapFattalJacobiPS::GetStaticType(),      GScalarFormats,       false },
+		{ &FToneMapFattalReconstructPS::GetStaticType(), GColorFormats,        false },
+
+		// Bloom
+		{ &FClassicBloomBrightPassPS::GetStaticType(),       GColorFormats,    false },
+		{ &FClassicBloomBlurPS::GetStaticType(),             GColorFormats,    false },
+		{ &FClassicBloomGlareStreakPS::GetStaticType(),      GColorFormats,    false },
+		{ &FClassicBloomGlareAccumulatePS::GetStaticType(),  GColorFormats,    false },
+		{ &FClassicBloomKawaseDownsamplePS::GetStaticType(), GColorFormats,    false },
+		{ &FClassicBloomKawaseUpsamplePS::GetStaticType(),   GColorFormats,    false },
+		{ &FClassicBloomCompositePS::GetStaticType(),        {},               true  },
+
+		// Lens effects
+		{ &FToneMapLensBrightPassPS::GetStaticType(),    GColorFormats,        false },
+		{ &FToneMapCoronaStreakPS::GetStaticType(),      GColorFormats,        false },
+		{ &FToneMapHaloRingPS::GetStaticType(),          GColorFormats,        false },
+		{ &FToneMapLensCompositePS::GetStaticType(),     {},                   true  },
+	};
+}
+
+static TArray<FShaderType*> GetComputePipelines()
+{
+	return {
+		// Local contrast blurs (r.ToneMapFX.TiledBlur, r.ToneMapFX.RecursiveBlur)
+		// and the guided clarity base
+		&FToneMapGaussianBlurTiledCS::GetStaticType(),
+		&FToneMapGaussianRecursiveCS::GetStaticType(),
+		&FToneMapGuidedLogLumaCS::GetStaticType(),
+		&FToneMapGuidedBoxRowsCS::GetStaticType(),
+		&FToneMapGuidedCoeffColumnsCS::GetStaticType(),
+		&FToneMapGuidedCoeffRowsCS::GetStaticType(),
+		&FToneMapGuidedBaseColumnsCS::GetStaticType(),
+
+		// Metering, global colour cast, exposure readback
+		&FToneMapHistogramBuildCS::GetStaticType(),
+		&FToneMapHistogramResolveCS::GetStaticType(),
+		&FToneMapColorAverageReduceCS::GetStaticType(),
+		&FToneMapColorAverageResolveCS::GetStaticType(),
+		&FToneMapExposureStatsPackCS::GetStaticType(),
+
+		// Compute twins of the bloom / lens stages (r.ToneMapFX.AsyncCompute)
+		&FClassicBloomBrightPassCS::GetStaticType(),
+		&FClassicBloomBlurCS::GetStaticType(),
+		&FClassicBloomGlareStreakCS::GetStaticType(),
+		&FClassicBloomGlareAccumulateCS::GetStaticType(),
+		&FClassicBloomKawaseDownsampleCS::GetStaticType(),
+		&FClassicBloomKawaseUpsampleCS::GetStaticType(),
+		&FToneMapLensBrightPassCS::GetStaticType(),
+		&FToneMapCoronaStreakCS::GetStaticType(),
+		&FToneMapHaloRingCS::GetStaticType(),
+	};
+}
+
+// Visit every compiled permutation of the table for this shader map
+static void ForEachPipeline(
+	const FGlobalShaderMap* ShaderMap,
+	EPixelFormat SceneColorFormat,
+	TFunctionRef<void(const TShaderRef<FShader>&, EPixelFormat)> GraphicsFunc,
+	TFunctionRef<void(const TShaderRef<FShader>&)> ComputeFunc)
+{
+	for (const FToneMapPipelineEntry& Entry : GetPixelPipelines())
+	{
+		for (int32 PermutationId = 0; PermutationId < Entry.Type->GetPermutationCount(); ++PermutationId)
+		{
+			// Permutations culled for this platform (e.g. half precision) are simply absent
+			const TShaderRef<FShader> PixelShader = ShaderMap->GetShader(Entry.Type, PermutationId);
+			if (!PixelShader.IsValid())
+			{
+				continue;
+			}
+
+			for (const EPixelFormat Format : Entry.Formats)
+			{
+				GraphicsFunc(PixelShader, Format);
+			}
+			if (Entry.bSceneColor)
+			{
+				GraphicsFunc(PixelShader, SceneColorFormat);
+			}
+		}
+	}
+
+	for (FShaderType* Type : GetComputePipelines())
+	{
+		// Every permutation — the recursive blur has one per direction and scan order
+		for (int32 PermutationId = 0; PermutationId < Type->GetPermutationCount(); ++PermutationId)
+		{
+			const TShaderRef<FShader> ComputeShader = ShaderMap->GetShader(Type, PermutationId);
+			if (ComputeShader.IsValid())
+			{
+				ComputeFunc(ComputeShader);
+			}
+		}
+	}
+}
+
+// Mirrors FPixelShaderUtils::InitFullscreenPipelineState with an explicit target
+static FGraphicsPipelineStateInitializer MakeFullscreenPipeline(
+	const FGlobalShaderMap* ShaderMap, const TShaderRef<FShader>& PixelShader, EPixelFormat Format)
+{
+	TShaderMapRef<FScreenVertexShaderVS> VertexShader(ShaderMap);
+
+	FGraphicsPipelineStateInitializer Initializer;
+	Initializer.BlendState = TStaticBlendState<>::GetRHI();
+	Initializer.RasterizerState = TStaticRasterizerState<>::GetRHI();
+	Initializer.DepthStencilState = TStaticDepthStencilState<false, CF_Always>::GetRHI();
+	Initializer.BoundShaderState.VertexDeclarationRHI = GFilterVertexDeclaration.VertexDeclarationRHI;
+	Initializer.BoundShaderState.VertexShaderRHI = VertexShader.GetVertexShader();
+	Initializer.BoundShaderState.PixelShaderRHI = PixelShader.GetPixelShader();
+	Initializer.PrimitiveType = PT_TriangleList;
+
+	FGraphicsPipelineRenderTargetsInfo RenderTargetsInfo;
+	RenderTargetsInfo.NumSamples = 1;
+	AddRenderTargetInfo(Format, TexCreate_RenderTargetable | TexCreate_ShaderResource, RenderTargetsInfo);
+	Initializer.StatePrecachePSOHash = RHIComputeStatePrecachePSOHash(Initializer);
+	ApplyTargetsInfo(Initializer, RenderTargetsInfo);
+	return Initializer;
+}
+
+static EPixelFormat GetSceneColorFormat(EPixelFormat ConfiguredFormat)
+{
+	return ConfiguredFormat != PF_Unknown ? ConfiguredFormat : PF_FloatRGBA;
+}
+
+// ---------------------------------------------------------------------------
+// Known pipelines — collected, prewarmed or already reported
+// ---------------------------------------------------------------------------
+
+using FToneMapPipelineKey = TTuple<const FRHIShader*, EPixelFormat>;
+
+static FCriticalSection GKnownPipelinesLock;
+static TSet<FToneMapPipelineKey> GKnownPipelines;
+static int32 GNumOnDemandPipelines = 0;
+
+static void MarkKnown(TConstArrayView<FToneMapPipelineKey> Keys)
+{
+	FScopeLock Lock(&GKnownPipelinesLock);
+	GKnownPipelines.Append(Keys);
+}
+
+static void ReportIfOnDemand(const TShaderRef<FShader>& Shader, const FRHIShader* RHIShader, EPixelFormat Format)
+{
+	if (!RHIShader || CVarToneMapPSOPrecache.GetValueOnRenderThread() == 0)
+	{
+		return;
+	}
+
+	int32 NumOnDemand = 0;
+	{
+		FScopeLock Lock(&GKnownPipelinesLock);
+		bool bAlreadyKnown = false;
+		GKnownPipelines.Add(FToneMapPipelineKey(RHIShader, Format), &bAlreadyKnown);
+		if (bAlreadyKnown)
+		{
+			return;
+		}
+		NumOnDemand = ++GNumOnDemandPipelines;
+	}
+
+	INC_DWORD_STAT(STAT_ToneMapFX_OnDemandPSOs);
+	UE_LOG(LogTemp, Log, TEXT("ToneMapFX: pipeline created on demand (#%d): %s permutation %d -> %s. ")
+		TEXT("Call FToneMapPSOPrecache::PrewarmPipelines() while loading, or enable r.PSOPrecaching."),
+		NumOnDemand, Shader.GetType()->GetName(), Shader->GetPermutationId(),
+		Format != PF_Unknown ? GetPixelFormatString(Format) : TEXT("compute"));
+}
+
+void FToneMapPSOPrecache::TrackGraphics_RenderThread(const TShaderRef<FShader>& PixelShader, EPixelFormat RenderTargetFormat)
+{
+	if (PixelShader.IsValid())
+	{
+		ReportIfOnDemand(PixelShader, PixelShader.GetPixelShader(), RenderTargetFormat);
+	}
+}
+
+void FToneMapPSOPrecache::TrackCompute_RenderThread(const TShaderRef<FShader>& ComputeShader)
+{
+	if (ComputeShader.IsValid())
+	{
+		ReportIfOnDemand(ComputeShader, ComputeShader.GetComputeShader(), PF_Unknown);
+	}
+}
+
+int32 FToneMapPSOPrecache::GetNumOnDemand()
+{
+	FScopeLock Lock(&GKnownPipelinesLock);
+	return GNumOnDemandPipelines;
+}
+
+// ---------------------------------------------------------------------------
+// Global PSO collector — runs with the engine's r.PSOPrecaching pass
+// ---------------------------------------------------------------------------
+
+static void CollectToneMapPSOInitializers(
+	const FSceneTexturesConfig& SceneTexturesConfig,
+	int32 GlobalPSOCollectorIndex,
+	TArray<FPSOPrecacheData>& PSOInitializers)
+{
+	if (CVarToneMapPSOPrecache.GetValueOnAnyThread() == 0)
+	{
+		return;
+	}
+
+	const FGlobalShaderMap* ShaderMap = GetGlobalShaderMap(SceneTexturesConfig.FeatureLevel);
+	if (!ShaderMap)
+	{
+		return;
+	}
+
+	TArray<FToneMapPipelineKey> Keys;
+	ForEachPipeline(ShaderMap, GetSceneColorFormat(SceneTexturesConfig.ColorFormat),
+		[&](const TShaderRef<FShader>& PixelShader, EPixelFormat Format)
+		{
+			FPSOPrecacheData Data;
+			Data.bRequired = true;
+			Data.Type = FPSOPrecacheData::EType::Graphics;
+			Data.GraphicsPSOInitializer = MakeFullscreenPipeline(ShaderMap, PixelShader, Format);
+#if PSO_PRECACHING_VALIDATE
+			Data.PSOCollectorIndex = GlobalPSOCollectorIndex;
+			Data.VertexFactoryType = nullptr;
+#endif
+			PSOInitializers.Add(MoveTemp(Data));
+			Keys.Emplace(PixelShader.GetPixelShader(), Format);
+		},
+		[&](const TShaderRef<FShader>& ComputeShader)
+		{
+			FPSOPrecacheData Data;
+			Data.bRequired = true;
+			Data.Type = FPSOPrecacheData::EType::Compute;
+			Data.ComputeShader = ComputeShader.GetComputeShader();
+#if PSO_PRECACHING_VALIDATE
+			Data.PSOCollectorIndex = GlobalPSOCollectorIndex;
+			Data.VertexFactoryType = nullptr;
+#endif
+			PSOInitializers.Add(MoveTemp(Data));
+			Keys.Emplace(ComputeShader.GetComputeShader(), PF_Unknown);
+		});
+
+	MarkKnown(Keys);
+}
+
+static FRegisterGlobalPSOCollectorFunction RegisterToneMapPSOCollector(&CollectToneMapPSOInitializers, TEXT("ToneMapFX"));
+
+// ---------------------------------------------------------------------------
+// Explicit prewarm
+// ---------------------------------------------------------------------------
+
+void FToneMapPSOPrecache::PrewarmPipelines(ERHIFeatureLevel::Type FeatureLevel)
+{
+	ENQUEUE_RENDER_COMMAND(ToneMapFXPrewarmPipelines)(
+		[FeatureLevel](FRHICommandListImmediate& RHICmdList)
+		{
+			const FGlobalShaderMap* ShaderMap = GetGlobalShaderMap(FeatureLevel);
+			if (!ShaderMap)
+			{
+				return;
+			}
+
+			// Precaching compiles on background tasks; without it, create the
+			// pipelines here so the cost lands on this (loading) frame
+			const bool bPrecache = PipelineStateCache::IsPSOPrecachingEnabled();
+
+			TArray<FToneMapPipelineKey> Keys;
+			int32 NumGraphics = 0;
+			int32 NumCompute = 0;
+			ForEachPipeline(ShaderMap, GetSceneColorFormat(FSceneTexturesConfig::Get().ColorFormat),
+				[&](const TShaderRef<FShader>& PixelShader, EPixelFormat Format)
+				{
+					const FGraphicsPipelineStateInitializer Initializer = MakeFullscreenPipeline(ShaderMap, PixelShader, Format);
+					if (bPrecache)
+					{
+						PipelineStateCache::PrecacheGraphicsPipelineState(Initializer);
+					}
+					else
+					{
+						PipelineStateCache::GetAndOrCreateGraphicsPipelineState(RHICmdList, Initializer, EApplyRendertargetOption::DoNothing);
+					}
+					Keys.Emplace(PixelShader.GetPixelShader(), Format);
+					++NumGraphics;
+				},
+				[&](const TShaderRef<FShader>& ComputeShader)
+				{
+					if (bPrecache)
+					{
+						PipelineStateCache::PrecacheComputePipelineState(ComputeShader.GetComputeShader());
+					}
+					else
+					{
+						PipelineStateCache::GetAndOrCreateComputePipelineState(RHICmdList, ComputeShader.GetComputeShader(), false);
+					}
+					Keys.Emplace(ComputeShader.GetComputeShader(), PF_Unknown);
+					++NumCompute;
+				});
+
+			MarkKnown(Keys);
+			UE_LOG(LogTemp, Log, TEXT("ToneMapFX: prewarmed %d graphics and %d compute pipelines (%s)"),
+				NumGraphics, NumCompute, bPrecache ? TEXT("precaching") : TEXT("created synchronously"));
+		});
+}
+
+static FAutoConsoleCommand CmdToneMapPrewarmPipelines(
+	TEXT("r.ToneMapFX.PrewarmPipelines"),
+	TEXT("Create or precache every ToneMapFX pipeline (all passes, permutations and target formats) now."),
+	FConsoleCommandDelegate::CreateLambda([]() { FToneMapPSOPrecache::PrewarmPipelines(); }));
@@ -0,0 +1,110 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapPlanAuditCommandlet.h"
+#include "ToneMapFramePlan.h"
+#include "ToneMapComponent.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+
+UToneMapFXPlanAuditCommandlet::UToneMapFXPlanAuditCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UToneMapFXPlanAuditCommandlet::Main(const FString& Params)
+{
+	FString Directory = UToneMapComponent::GetPresetDirectory();
+	FString CSVPath = FPaths::ProjectSavedDir() / TEXT("ToneMapFX") / TEXT("PlanAudit.csv");
+	FIntPoint ViewportSize(1920, 1080);
+	int32 Quality = 3;
+	int32 BudgetMB = 0;
+
+	FParse::Value(*Params, TEXT("dir="), Directory);
+	FParse::Value(*Params, TEXT("csv="), CSVPath);
+	FParse::Value(*Params, TEXT("width="), ViewportSize.X);
+	FParse::Value(*Params, TEXT("height="), ViewportSize.Y);
+	FParse::Value(*Params, TEXT("quality="), Quality);
+	FParse::Value(*Params, TEXT("budgetmb="), BudgetMB);
+
+	int32 NumFailures = 0;
+	if (FParse::Param(*Params, TEXT("selftest")))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: -selftest was removed — run 'Automation RunTests ToneMapFX.FramePlan' to test the planner"));
+	}
+
+	TArray<FString> Presets;
+	IFileManager::Get().FindFiles(Presets, *(Directory / TEXT("*.txt")), true, false);
+	Presets.Sort();
+
+	TArray<FString> Rows;
+	Rows.Add(TEXT("Preset,Width,Height,Quality,Passes,Textures,PeakTransientMB,PersistentMB,MFetches,MALU,ActiveStages,Valid"));
+
+	const uint64 BudgetBytes = (uint64)FMath::Max(BudgetMB, 0) * 1024 * 1024;
+
+	for (const FString& Preset : Presets)
+	{
+		UToneMapComponent* Settings = NewObject<UToneMapComponent>(GetTransientPackage());
+		if (!Settings->LoadPresetFromPath(Directory / Preset))
+		{
+			UE_LOG(LogTemp, Error, TEXT("ToneMapFX: could not load preset %s"), *Preset);
+			++NumFailures;
+			continue;
+		}
+
+		const FToneMapFramePlan Plan = FToneMapFramePlanner::Build(*Settings, FToneMapPlanInputs::Make(*Settings, ViewportSize, Quality));
+
+		UE_LOG(LogTemp, Display, TEXT("ToneMapFX: --- %s ---"), *Preset);
+		Plan.Log();
+
+		FString Error;
+		const bool bValid = Plan.Validate(&Error);
+		if (!bValid)
+		{
+			UE_LOG(LogTemp, Error, TEXT("ToneMapFX: %s has an invalid plan: %s"), *Preset, *Error);
+			++NumFailures;
+		}
+		if (BudgetBytes > 0 && Plan.PeakTransientBytes > BudgetBytes)
+		{
+			UE_LOG(LogTemp, Error, TEXT("ToneMapFX: %s peaks at %.1f MB, over the %d MB budget"),
+				*Preset, Plan.PeakTransientBytes / (1024.0 * 1024.0), BudgetMB);
+			++NumFailures;
+		}
+
+		FString ActiveStages;
+		for (int32 StageIndex = 0; StageIndex < (int32)EToneMapPlanStage::Num; ++StageIndex)
+		{
+			if (Plan.Stages[StageIndex].bActive)
+			{
+				ActiveStages += ActiveStages.IsEmpty() ? TEXT("") : TEXT("|");
+				ActiveStages += FToneMapFramePlanner::GetStageName((EToneMapPlanStage)StageIndex);
+			}
+		}
+
+		Rows.Add(FString::Printf(TEXT("%s,%d,%d,%d,%d,%d,%.3f,%.3f,%.2f,%.2f,%s,%d"),
+			*Preset, Plan.Inputs.ViewportSize.X, Plan.Inputs.ViewportSize.Y, Quality,
+			Plan.Passes.Num(), Plan.Textures.Num(),
+			Plan.PeakTransientBytes / (1024.0 * 1024.0), Plan.PersistentBytes / (1024.0 * 1024.0),
+			Plan.GetTotalFetches() / 1.0e6, Plan.GetTotalALU() / 1.0e6,
+			*ActiveStages, bValid ? 1 : 0));
+	}
+
+	if (!FFileHelper::SaveStringArrayToFile(Rows, *CSVPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("ToneMapFX: could not write %s"), *CSVPath);
+		return 1;
+	}
+
+	if (NumFailures != 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("ToneMapFX: plan audit of %d presets FAILED (%d)"), Presets.Num(), NumFailures);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("ToneMapFX: audited %d presets in %s, results in %s"), Presets.Num(), *Directory, *CSVPath);
+	return 0;
+}
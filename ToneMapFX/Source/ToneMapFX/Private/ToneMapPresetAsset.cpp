@@ -0,0 +1,196 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapPresetAsset.h"
+#include "ToneMapComponent.h"
+#include "UObject/Package.h"
+#include "UObject/UnrealType.h"
+
+#if WITH_EDITOR
+#include "DesktopPlatformModule.h"
+#include "Framework/Application/SlateApplication.h"
+#endif
+
+// ---------------------------------------------------------------------------
+// FToneMapPresetData — pack / unpack
+// ---------------------------------------------------------------------------
+
+void FToneMapPresetData::CaptureFrom(const UToneMapComponent& Component)
+{
+	Layout.Reset();
+	Values.Reset();
+	ObjectValues.Reset();
+	ResolvedProperties.Reset();
+
+	for (FProperty* Prop : UToneMapComponent::GetPresetProperties())
+	{
+		FToneMapPackedProperty& Entry = Layout.AddDefaulted_GetRef();
+		Entry.Name     = Prop->GetFName();
+		Entry.TypeName = Prop->GetClass()->GetFName();
+
+		const void* ValuePtr = Prop->ContainerPtrToValuePtr<void>(&Component);
+
+		if (const FObjectPropertyBase* ObjProp = CastField<FObjectPropertyBase>(Prop))
+		{
+			Entry.Offset = ObjectValues.Add(ObjProp->GetObjectPropertyValue(ValuePtr));
+			Entry.Size   = 0;
+		}
+		else
+		{
+			// Keep each value naturally aligned so structs (FLinearColor) copy safely
+			const int32 Alignment = FMath::Max(Prop->GetMinAlignment(), 1);
+			Entry.Offset = Align(Values.Num(), Alignment);
+			Entry.Size   = Prop->GetElementSize();
+
+			Values.SetNumZeroed(Entry.Offset + Entry.Size);
+			Prop->CopySingleValue(Values.GetData() + Entry.Offset, ValuePtr);
+		}
+	}
+}
+
+void FToneMapPresetData::ResolveLayout() const
+{
+	ResolvedProperties.SetNumZeroed(Layout.Num());
+
+	for (int32 Index = 0; Index < Layout.Num(); ++Index)
+	{
+		const FToneMapPackedProperty& Entry = Layout[Index];
+		FProperty* Prop = UToneMapComponent::FindPresetProperty(Entry.Name);
+
+		// Property may have been removed or changed type in a newer/older version — skip gracefully
+		if (!Prop || Prop->GetClass()->GetFName() != Entry.TypeName)
+		{
+			UE_LOG(LogTemp, Verbose, TEXT("ToneMapFX: Preset asset key '%s' no longer matches the component, skipping"),
+				*Entry.Name.ToString());
+			continue;
+		}
+
+		const bool bIsObject = Prop->IsA<FObjectPropertyBase>();
+		const bool bValid = bIsObject
+			? ObjectValues.IsValidIndex(Entry.Offset)
+			: (Entry.Size == Prop->GetElementSize() && Entry.Offset >= 0 && Entry.Offset + Entry.Size <= Values.Num());
+
+		ResolvedProperties[Index] = bValid ? Prop : nullptr;
+	}
+}
+
+int32 FToneMapPresetData::ApplyTo(UToneMapComponent& Component) const
+{
+	if (ResolvedProperties.Num() != Layout.Num())
+	{
+		ResolveLayout();
+	}
+
+	int32 Applied = 0;
+
+	for (int32 Index = 0; Index < Layout.Num(); ++Index)
+	{
+		FProperty* Prop = ResolvedProperties[Index];
+		if (!Prop) continue;
+
+		void* ValuePtr = Prop->ContainerPtrToValuePtr<void>(&Component);
+
+		if (const FObjectPropertyBase* ObjProp = CastField<FObjectPropertyBase>(Prop))
+		{
+			UObject* Object = ObjectValues[Layout[Index].Offset];
+			// A texture of the wrong class (asset replaced since packing) is dropped, not forced
+			if (Object && !Object->IsA(ObjProp->PropertyClass)) continue;
+			ObjProp->SetObjectPropertyValue(ValuePtr, Object);
+		}
+		else
+		{
+			Prop->CopySingleValue(ValuePtr, Values.GetData() + Layout[Index].Offset);
+		}
+
+		Applied++;
+	}
+
+	return Applied;
+}
+
+// ---------------------------------------------------------------------------
+// UToneMapPresetAsset
+// ---------------------------------------------------------------------------
+
+void UToneMapPresetAsset::CaptureFromComponent(const UToneMapComponent* Component)
+{
+	if (!Component) return;
+
+	Modify();
+	Settings.CaptureFrom(*Component);
+	MarkPackageDirty();
+}
+
+bool UToneMapPresetAsset::ImportFromTextPath(const FString& FilePath)
+{
+	// Parse through a scratch component so the text format stays defined in one place
+	UToneMapComponent* Scratch = NewObject<UToneMapComponent>(GetTransientPackage(), NAME_None, RF_Transient);
+	if (!Scratch->LoadPresetFromPath(FilePath))
+	{
+		return false;
+	}
+
+	CaptureFromComponent(Scratch);
+	UE_LOG(LogTemp, Log, TEXT("ToneMapFX: Preset asset %s imported ← %s (%d properties)"),
+		*GetName(), *FilePath, Settings.Layout.Num());
+	return true;
+}
+
+bool UToneMapPresetAsset::ExportToTextPath(const FString& FilePath) const
+{
+	UToneMapComponent* Scratch = NewObject<UToneMapComponent>(GetTransientPackage(), NAME_None, RF_Transient);
+	Settings.ApplyTo(*Scratch);
+	return Scratch->SavePresetToPath(FilePath);
+}
+
+#if WITH_EDITOR
+void UToneMapPresetAsset::ImportFromTextFile()
+{
+	IDesktopPlatform* DesktopPlatform = FDesktopPlatformModule::Get();
+	if (!DesktopPlatform) return;
+
+	const void* ParentWindow = FSlateApplication::Get().FindBestParentWindowHandleForDialogs(nullptr);
+
+	TArray<FString> OutFiles;
+	bool bPicked = DesktopPlatform->OpenFileDialog(
+		ParentWindow,
+		TEXT("Import ToneMapFX Preset"),
+		UToneMapComponent::GetPresetDirectory(),
+		TEXT(""),
+		TEXT("ToneMapFX Preset (*.txt)|*.txt|All Files (*.*)|*.*"),
+		0,
+		OutFiles);
+
+	if (bPicked && OutFiles.Num() > 0)
+	{
+		ImportFromTextPath(OutFiles[0]);
+	}
+}
+
+void UToneMapPresetAsset::ExportToTextFile()
+{
+	IDesktopPlatform* DesktopPlatform = FDesktopPlatformModule::Get();
+	if (!DesktopPlatform) return;
+
+	const void* ParentWindow = FSlateApplication::Get().FindBestParentWindowHandleForDialogs(nullptr);
+
+	TArray<FString> OutFiles;
+	bool bPicked = DesktopPlatform->SaveFileDialog(
+		ParentWindow,
+		TEXT("Export ToneMapFX Preset"),
+		UToneMapComponent::GetPresetDirectory(),
+		GetName() + TEXT(".txt"),
+		TEXT("ToneMapFX Preset (*.txt)|*.txt|All Files (*.*)|*.*"),
+		0,
+		OutFiles);
+
+	if (bPicked && OutFiles.Num() > 0)
+	{
+		FString ChosenPath = OutFiles[0];
+		if (!ChosenPath.EndsWith(TEXT(".txt")))
+		{
+			ChosenPath += TEXT(".txt");
+		}
+		ExportToTextPath(ChosenPath);
+	}
+}
+#endif
@@ -0,0 +1,72 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapReferenceImage.h"
+#include "ImageCore.h"
+#include "ImageUtils.h"
+
+void FToneMapReferenceImage::Init(int32 InWidth, int32 InHeight)
+{
+	Width = FMath::Max(InWidth, 1);
+	Height = FMath::Max(InHeight, 1);
+	Pixels.SetNumZeroed(Width * Height);
+}
+
+const ToneMapColorMath::float3& FToneMapReferenceImage::Load(int32 X, int32 Y) const
+{
+	return At(FMath::Clamp(X, 0, Width - 1), FMath::Clamp(Y, 0, Height - 1));
+}
+
+ToneMapColorMath::float3 FToneMapReferenceImage::Sample(float U, float V) const
+{
+	using namespace ToneMapColorMath;
+
+	const float X = U * (float)Width - 0.5f;
+	const float Y = V * (float)Height - 0.5f;
+	const float X0 = FMath::FloorToFloat(X);
+	const float Y0 = FMath::FloorToFloat(Y);
+	const int32 IX = (int32)X0;
+	const int32 IY = (int32)Y0;
+
+	const float3 Top    = lerp(Load(IX, IY),     Load(IX + 1, IY),     X - X0);
+	const float3 Bottom = lerp(Load(IX, IY + 1), Load(IX + 1, IY + 1), X - X0);
+	return lerp(Top, Bottom, Y - Y0);
+}
+
+bool FToneMapReferenceImage::LoadFromFile(const FString& Path)
+{
+	FImage Image;
+	if (!FImageUtils::LoadImage(*Path, Image))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: could not read %s"), *Path);
+		return false;
+	}
+	Image.ChangeFormat(ERawImageFormat::RGBA32F, EGammaSpace::Linear);
+
+	const TArrayView64<FLinearColor> Source = Image.AsRGBA32F();
+	Init(Image.SizeX, Image.SizeY);
+	for (int32 i = 0; i < Pixels.Num(); ++i)
+	{
+		Pixels[i] = ToneMapColorMath::float3(Source[i].R, Source[i].G, Source[i].B);
+	}
+	return true;
+}
+
+bool FToneMapReferenceImage::SaveToFile(const FString& Path) const
+{
+	FImage Image;
+	Image.Init(Width, Height, ERawImageFormat::RGBA32F, EGammaSpace::Linear);
+
+	const TArrayView64<FLinearColor> Dest = Image.AsRGBA32F();
+	for (int32 i = 0; i < Pixels.Num(); ++i)
+	{
+		const ToneMapColorMath::float3& C = Pixels[i];
+		Dest[i] = FLinearColor(C.x, C.y, C.z, 1.0f);
+	}
+
+	if (!FImageUtils::SaveImageByExtension(*Path, Image))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: could not write %s"), *Path);
+		return false;
+	}
+	return true;
+}
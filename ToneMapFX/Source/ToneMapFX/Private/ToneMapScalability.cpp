@@ -0,0 +1,160 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapScalability.h"
+#include "ToneMapComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ConfigCacheIni.h"
+
+static TAutoConsoleVariable<int32> CVarToneMapQuality(
+	TEXT("r.ToneMapFX.Quality"),
+	3,
+	TEXT("ToneMapFX quality tier, normally driven by sg.PostProcessQuality.\n")
+	TEXT(" 0: Low  1: Medium  2: High  3: Epic (default)  4: Cinematic\n")
+	TEXT("Each tier caps sample / iteration counts and scales the lens-effect resolution;\n")
+	TEXT("per-tier values live in the [ToneMapFXQuality@N] sections of Scalability.ini."),
+	ECVF_RenderThreadSafe | ECVF_Scalability);
+
+// Compiled-in defaults — Epic and Cinematic leave every setting uncapped
+FToneMapQualityTier FToneMapScalability::GetDefaultTier(int32 QualityLevel)
+{
+	FToneMapQualityTier Tier;
+	switch (QualityLevel)
+	{
+	case 0:
+		Tier.MaxGlareSamples         = 8;
+		Tier.MaxKawaseMipCount       = 4;
+		Tier.MaxFattalIterations     = 8;
+		Tier.MaxCoronaSpikeLength    = 40;
+		Tier.HaloAngularSamples      = 8;
+		Tier.MaxBloomBlurPasses      = 1;
+		Tier.MaxClarityRadius        = 4.0f;
+		Tier.MaxBloomDownsampleScale = 0.5f;
+		Tier.LensResolutionScale     = 0.5f;
+		break;
+	case 1:
+		Tier.MaxGlareSamples         = 16;
+		Tier.MaxKawaseMipCount       = 5;
+		Tier.MaxFattalIterations     = 16;
+		Tier.MaxCoronaSpikeLength    = 80;
+		Tier.HaloAngularSamples      = 16;
+		Tier.MaxBloomBlurPasses      = 2;
+		Tier.MaxClarityRadius        = 8.0f;
+		Tier.MaxBloomDownsampleScale = 1.0f;
+		Tier.LensResolutionScale     = 0.5f;
+		break;
+	case 2:
+		Tier.MaxGlareSamples         = 32;
+		Tier.MaxKawaseMipCount       = 6;
+		Tier.MaxFattalIterations     = 30;
+		Tier.MaxCoronaSpikeLength    = 160;
+		Tier.HaloAngularSamples      = 24;
+		Tier.MaxBloomBlurPasses      = 3;
+		Tier.MaxClarityRadius        = 16.0f;
+		Tier.MaxBloomDownsampleScale = 1.0f;
+		Tier.LensResolutionScale     = 0.75f;
+		break;
+	default:
+		break;
+	}
+	return Tier;
+}
+
+FToneMapQualityTier FToneMapScalability::Tiers[FToneMapScalability::NumTiers] =
+{
+	GetDefaultTier(0), GetDefaultTier(1), GetDefaultTier(2), GetDefaultTier(3), GetDefaultTier(4),
+};
+
+void FToneMapScalability::LoadConfig()
+{
+	if (!GConfig) return;
+
+	for (int32 Level = 0; Level < NumTiers; ++Level)
+	{
+		FToneMapQualityTier& Tier = Tiers[Level];
+		Tier = GetDefaultTier(Level);
+
+		// Missing keys keep their defaults — GetInt / GetFloat leave the value untouched
+		const FString Section = FString::Printf(TEXT("ToneMapFXQuality@%d"), Level);
+		GConfig->GetInt(*Section,   TEXT("MaxGlareSamples"),         Tier.MaxGlareSamples,         GScalabilityIni);
+		GConfig->GetInt(*Section,   TEXT("MaxKawaseMipCount"),       Tier.MaxKawaseMipCount,       GScalabilityIni);
+		GConfig->GetInt(*Section,   TEXT("MaxFattalIterations"),     Tier.MaxFattalIterations,     GScalabilityIni);
+		GConfig->GetInt(*Section,   TEXT("MaxCoronaSpikeLength"),    Tier.MaxCoronaSpikeLength,    GScalabilityIni);
+		GConfig->GetInt(*Section,   TEXT("HaloAngularSamples"),      Tier.HaloAngularSamples,      GScalabilityIni);
+		GConfig->GetInt(*Section,   TEXT("MaxBloomBlurPasses"),      Tier.MaxBloomBlurPasses,      GScalabilityIni);
+		GConfig->GetFloat(*Section, TEXT("MaxClarityRadius"),        Tier.MaxClarityRadius,        GScalabilityIni);
+		GConfig->GetFloat(*Section, TEXT("MaxBloomDownsampleScale"), Tier.MaxBloomDownsampleScale, GScalabilityIni);
+		GConfig->GetFloat(*Section, TEXT("LensResolutionScale"),     Tier.LensResolutionScale,     GScalabilityIni);
+
+		// Keep the values inside what the shaders can handle
+		Tier.HaloAngularSamples  = FMath::Clamp(Tier.HaloAngularSamples, 4, 32);
+		Tier.LensResolutionScale = FMath::Clamp(Tier.LensResolutionScale, 0.25f, 1.0f);
+	}
+}
+
+int32 FToneMapScalability::GetQualityLevel_RenderThread()
+{
+	return FMath::Clamp(CVarToneMapQuality.GetValueOnRenderThread(), 0, NumTiers - 1);
+}
+
+const FToneMapQualityTier& FToneMapScalability::GetTier(int32 QualityLevel)
+{
+	return Tiers[FMath::Clamp(QualityLevel, 0, NumTiers - 1)];
+}
+
+// ---------------------------------------------------------------------------
+// Tier application
+// ---------------------------------------------------------------------------
+
+FToneMapResolvedQuality FToneMapScalability::Resolve(const UToneMapComponent& Settings, const FToneMapQualityTier& Tier)
+{
+	FToneMapResolvedQuality Q;
+	Q.GlareSamples         = FMath::Clamp(FMath::Min(Settings.GlareSamples, Tier.MaxGlareSamples), 8, 64);
+	Q.KawaseMipCount       = FMath::Clamp(FMath::Min(Settings.KawaseMipCount, Tier.MaxKawaseMipCount), 3, 8);
+	Q.FattalIterations     = FMath::Clamp(FMath::Min(Settings.FattalJacobiIterations, Tier.MaxFattalIterations), 1, 200);
+	Q.HaloAngularSamples   = Tier.HaloAngularSamples;
+	Q.BloomBlurPasses      = FMath::Clamp(FMath::Min(Settings.BlurPasses, Tier.MaxBloomBlurPasses), 1, 4);
+	Q.ClarityRadius        = FMath::Min(Settings.ClarityRadius, Tier.MaxClarityRadius);
+	Q.BloomDownsampleScale = FMath::Clamp(FMath::Min(Settings.DownsampleScale, Tier.MaxBloomDownsampleScale), 0.25f, 2.0f);
+	Q.LensResolutionScale  = Tier.LensResolutionScale;
+
+	// Spike length is authored in full-resolution pixels; the lens buffer may be smaller
+	const int32 SpikeLength = FMath::Min(Settings.CoronaSpikeLength, Tier.MaxCoronaSpikeLength);
+	Q.CoronaSpikeLength = FMath::Max(1, FMath::RoundToInt32(SpikeLength * Q.LensResolutionScale));
+
+	return Q;
+}
+
+bool FToneMapScalability::ValidateTiers(const UToneMapComponent& Settings)
+{
+	bool bMonotonic = true;
+	FToneMapResolvedQuality Prev;
+
+	for (int32 Level = 0; Level < NumTiers; ++Level)
+	{
+		const FToneMapResolvedQuality Q = Resolve(Settings, GetTier(Level));
+
+		UE_LOG(LogTemp, Log, TEXT("ToneMapFX: Quality %d — Glare %d, Kawase mips %d, Fattal iters %d, Corona spike %d, Halo samples %d, Bloom passes %d, Clarity radius %.1f, Bloom scale %.2f, Lens scale %.2f"),
+			Level, Q.GlareSamples, Q.KawaseMipCount, Q.FattalIterations, Q.CoronaSpikeLength, Q.HaloAngularSamples,
+			Q.BloomBlurPasses, Q.ClarityRadius, Q.BloomDownsampleScale, Q.LensResolutionScale);
+
+		if (Level > 0)
+		{
+			const bool bCheaper =
+				Q.GlareSamples < Prev.GlareSamples || Q.KawaseMipCount < Prev.KawaseMipCount ||
+				Q.FattalIterations < Prev.FattalIterations || Q.CoronaSpikeLength < Prev.CoronaSpikeLength ||
+				Q.HaloAngularSamples < Prev.HaloAngularSamples || Q.BloomBlurPasses < Prev.BloomBlurPasses ||
+				Q.ClarityRadius < Prev.ClarityRadius || Q.BloomDownsampleScale < Prev.BloomDownsampleScale ||
+				Q.LensResolutionScale < Prev.LensResolutionScale;
+
+			if (bCheaper)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: Quality %d is cheaper than quality %d in at least one setting — check [ToneMapFXQuality@%d]"),
+					Level, Level - 1, Level);
+				bMonotonic = false;
+			}
+		}
+		Prev = Q;
+	}
+
+	return bMonotonic;
+}
@@ -0,0 +1,542 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapShaderReportCommandlet.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#if WITH_EDITOR
+#include "GlobalShader.h"
+#include "ShaderCompiler.h"
+#include "DataDrivenShaderPlatformInfo.h"
+#include "RHIStrings.h"
+#include "Interfaces/ITargetPlatformManagerModule.h"
+#include "Misc/Compression.h"
+#endif
+
+UToneMapFXShaderReportCommandlet::UToneMapFXShaderReportCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+#if WITH_EDITOR
+
+// ---------------------------------------------------------------------------
+// Report rows
+// ---------------------------------------------------------------------------
+
+static const TCHAR* GShaderReportHeader = TEXT("Format,Shader,Frequency,PermutationId,Compiled,Instructions,TempRegisters,TextureFetches,TextureSamplers,CodeBytes");
+
+// The metrics compared against a baseline, by CSV column name
+static const TCHAR* GShaderReportMetrics[] = { TEXT("Instructions"), TEXT("TempRegisters"), TEXT("TextureFetches") };
+
+struct FToneMapShaderReportRow
+{
+	FString Format;
+	FString Shader;
+	FString Frequency;
+	int32 PermutationId = 0;
+	bool bCompiled = false;
+
+	// -1 when the format does not report it
+	int32 Instructions = -1;
+	int32 TempRegisters = -1;
+	int32 TextureFetches = -1;
+	int32 TextureSamplers = -1;
+	int32 CodeBytes = -1;
+
+	FString GetKey() const { return FString::Printf(TEXT("%s,%s,%d"), *Format, *Shader, PermutationId); }
+
+	FString ToCSV() const
+	{
+		auto Column = [](int32 Value) { return Value >= 0 ? FString::FromInt(Value) : FString(); };
+		return FString::Printf(TEXT("%s,%s,%s,%d,%d,%s,%s,%s,%s,%s"),
+			*Format, *Shader, *Frequency, PermutationId, bCompiled ? 1 : 0,
+			*Column(Instructions), *Column(TempRegisters), *Column(TextureFetches),
+			*Column(TextureSamplers), *Column(CodeBytes));
+	}
+};
+
+// ---------------------------------------------------------------------------
+// Bytecode statistics
+// ---------------------------------------------------------------------------
+
+static uint32 ReadWord(const uint8* Data)
+{
+	uint32 Word;
+	FMemory::Memcpy(&Word, Data, sizeof(Word));
+	return Word;
+}
+
+// The platform's code blob may carry a header and optional data around the
+// bytecode and may be compressed; the containers are found by their magic.
+static TArray<uint8> GetUncompressedCode(const FShaderCode& Code)
+{
+	const TConstArrayView<uint8> Stored = Code.GetReadView();
+	TArray<uint8> Result;
+	if (!Code.IsCompressed())
+	{
+		Result.Append(Stored.GetData(), Stored.Num());
+		return Result;
+	}
+
+	Result.SetNumUninitialized(Code.GetUncompressedSize());
+	if (!FCompression::UncompressMemory(Code.GetCompressionFormat(), Result.GetData(), Result.Num(), Stored.GetData(), Stored.Num()))
+	{
+		Result.Reset();
+	}
+	return Result;
+}
+
+// DXBC container: 'DXBC', 16-byte digest, version, total size, part count and
+// part offsets; each part is a fourCC, a size and the data.  SM5 bytecode
+// carries its statistics in the STAT part (the D3D11_SHADER_DESC counts); a
+// DXIL container's STAT part is the debug module instead.
+static bool ReadDXBCStats(TConstArrayView<uint8> Code, FToneMapShaderReportRow& Row)
+{
+	for (int32 Offset = 0; Offset + 32 <= Code.Num(); ++Offset)
+	{
+		const uint8* Container = Code.GetData() + Offset;
+		if (FMemory::Memcmp(Container, "DXBC", 4) != 0)
+		{
+			continue;
+		}
+
+		const uint32 Size = ReadWord(Container + 24);
+		const uint32 NumParts = ReadWord(Container + 28);
+		if (Size > (uint32)(Code.Num() - Offset) || NumParts > 64 || 32 + NumParts * 4 > Size)
+		{
+			continue;
+		}
+
+		const uint8* Stat = nullptr;
+		uint32 StatSize = 0;
+		bool bDXIL = false;
+		for (uint32 Part = 0; Part < NumParts; ++Part)
+		{
+			const uint32 PartOffset = ReadWord(Container + 32 + Part * 4);
+			if (PartOffset + 8 > Size)
+			{
+				continue;
+			}
+			const uint8* Header = Container + PartOffset;
+			const uint32 PartSize = FMath::Min(ReadWord(Header + 4), Size - PartOffset - 8);
+			if (FMemory::Memcmp(Header, "DXIL", 4) == 0)
+			{
+				bDXIL = true;
+			}
+			else if (FMemory::Memcmp(Header, "STAT", 4) == 0)
+			{
+				Stat = Header + 8;
+				StatSize = PartSize;
+			}
+		}
+
+		// Words: instructions, temps, -, defs, dcls, float, int, uint, static
+		// flow, dynamic flow, -, temp arrays, array, cut, emit, then the
+		// normal / load / comparison / bias / gradient texture instructions
+		if (!bDXIL && Stat && StatSize >= 20 * 4)
+		{
+			if (Row.Instructions < 0)
+			{
+				Row.Instructions = (int32)ReadWord(Stat);
+			}
+			Row.TempRegisters = (int32)ReadWord(Stat + 1 * 4);
+			Row.TextureFetches = 0;
+			for (int32 Word = 15; Word <= 19; ++Word)
+			{
+				Row.TextureFetches += (int32)ReadWord(Stat + Word * 4);
+			}
+		}
+		return true;
+	}
+	return false;
+}
+
+// SPIR-V: a 5-word header, then instructions whose first word holds the word
+// count (high 16 bits) and the opcode
+static bool ReadSPIRVStats(TConstArrayView<uint8> Code, FToneMapShaderReportRow& Row)
+{
+	constexpr uint32 SpvMagic = 0x07230203;
+	for (int32 Offset = 0; Offset + 20 <= Code.Num(); ++Offset)
+	{
+		if (ReadWord(Code.GetData() + Offset) != SpvMagic)
+		{
+			continue;
+		}
+
+		const int32 NumWords = (Code.Num() - Offset) / 4;
+		int32 Fetches = 0;
+		for (int32 Word = 5; Word < NumWords;)
+		{
+			const uint32 Instruction = ReadWord(Code.GetData() + Offset + Word * 4);
+			const uint32 WordCount = Instruction >> 16;
+			const uint32 Opcode = Instruction & 0xFFFF;
+			if (WordCount == 0 || Word + (int32)WordCount > NumWords)
+			{
+				break;     // end of the module; optional data follows
+			}
+
+			// OpImageSample* .. OpImageRead (87-98) and their sparse variants (305-320)
+			if ((Opcode >= 87 && Opcode <= 98) || (Opcode >= 305 && Opcode <= 320))
+			{
+				++Fetches;
+			}
+			Word += WordCount;
+		}
+		Row.TextureFetches = Fetches;
+		return true;
+	}
+	return false;
+}
+
+static void ReadCompilerOutput(const FShaderCompilerOutput& Output, FToneMapShaderReportRow& Row)
+{
+	Row.bCompiled = Output.bSucceeded;
+	if (!Output.bSucceeded)
+	{
+		return;
+	}
+
+	Row.Instructions = Output.NumInstructions > 0 ? (int32)Output.NumInstructions : -1;
+	Row.TextureSamplers = (int32)Output.NumTextureSamplers;
+
+	// Backends that run a register allocator report it among their statistics
+	for (const FGenericShaderStat& Stat : Output.ShaderStatistics)
+	{
+		const FString Name = Stat.StatName.ToString();
+		if (Name.Contains(TEXT("GPR")) || Name.Contains(TEXT("Register")))
+		{
+			FString Value;
+			Visit([&Value](const auto& StatValue) { Value = LexToString(StatValue); }, Stat.Value);
+			Row.TempRegisters = FMath::Max(Row.TempRegisters, FCString::Atoi(*Value));
+		}
+	}
+
+	const TArray<uint8> Code = GetUncompressedCode(Output.ShaderCode);
+	Row.CodeBytes = Code.Num();
+	if (!ReadDXBCStats(Code, Row))
+	{
+		ReadSPIRVStats(Code, Row);
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Compilation
+// ---------------------------------------------------------------------------
+
+static bool IsToneMapFXShader(const FShaderType* Type, const FString& NameFilter)
+{
+	return Type->GetGlobalShaderType()
+		&& FString(Type->GetShaderFilename()).StartsWith(TEXT("/Plugin/ToneMapFX/"))
+		&& (NameFilter.IsEmpty() || FString(Type->GetName()).Contains(NameFilter));
+}
+
+static const TCHAR* GetFrequencyName(EShaderFrequency Frequency)
+{
+	switch (Frequency)
+	{
+	case SF_Vertex:  return TEXT("VS");
+	case SF_Pixel:   return TEXT("PS");
+	case SF_Compute: return TEXT("CS");
+	default:         return TEXT("Other");
+	}
+}
+
+struct FToneMapShaderReportJob
+{
+	FToneMapShaderReportRow Row;
+	FShaderCompileJob* Job = nullptr;
+};
+
+// Same steps as FGlobalShaderTypeCompiler::BeginCompileShader, under a job
+// id of our own so the results stay out of the global shader map
+static FShaderCompileJob* BeginCompile(uint32 JobId, const FGlobalShaderType* Type, int32 PermutationId, EShaderPlatform Platform)
+{
+	FShaderCompileJob* Job = GShaderCompilingManager->PrepareShaderCompileJob(JobId, FShaderCompileJobKey(Type, nullptr, PermutationId), EShaderCompileJobPriority::Normal);
+	if (!Job)
+	{
+		return nullptr;
+	}
+
+	const FGlobalShaderPermutationParameters Parameters(Type->GetFName(), Platform, PermutationId);
+	Type->ModifyCompilationEnvironment(Parameters, Job->Input.Environment);
+
+	GlobalBeginCompileShader(
+		TEXT("ToneMapFXShaderReport"),
+		nullptr,
+		Type,
+		nullptr,
+		PermutationId,
+		Type->GetShaderFilename(),
+		Type->GetFunctionName(),
+		FShaderTarget(Type->GetFrequency(), Platform),
+		Job->Input);
+	return Job;
+}
+
+static void CompileReport(const TArray<FName>& Formats, const FString& NameFilter, TArray<FToneMapShaderReportRow>& OutRows)
+{
+	const uint32 JobId = FShaderCommonCompileJob::GetNextJobId();
+	TArray<FShaderCommonCompileJobPtr> Jobs;
+	TArray<FToneMapShaderReportJob> Pending;
+
+	for (const FName& Format : Formats)
+	{
+		if (!GetTargetPlatformManagerRef().FindShaderFormat(Format))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: shader format %s is not available on this host, skipped"), *Format.ToString());
+			continue;
+		}
+		const EShaderPlatform Platform = ShaderFormatToLegacyShaderPlatform(Format);
+		if (Platform == SP_NumPlatforms)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: %s is not a shader platform format, skipped"), *Format.ToString());
+			continue;
+		}
+
+		for (TLinkedList<FShaderType*>::TIterator It(FShaderType::GetTypeList()); It; It.Next())
+		{
+			const FGlobalShaderType* Type = It->GetGlobalShaderType();
+			if (!IsToneMapFXShader(*It, NameFilter))
+			{
+				continue;
+			}
+
+			for (int32 PermutationId = 0; PermutationId < Type->GetPermutationCount(); ++PermutationId)
+			{
+				// Stripped features and unsupported platforms are not cooked either
+				if (!Type->ShouldCompilePermutation(FGlobalShaderPermutationParameters(Type->GetFName(), Platform, PermutationId)))
+				{
+					continue;
+				}
+
+				FToneMapShaderReportJob& Entry = Pending.AddDefaulted_GetRef();
+				Entry.Row.Format = Format.ToString();
+				Entry.Row.Shader = Type->GetName();
+				Entry.Row.Frequency = GetFrequencyName(Type->GetFrequency());
+				Entry.Row.PermutationId = PermutationId;
+				Entry.Job = BeginCompile(JobId, Type, PermutationId, Platform);
+				if (Entry.Job)
+				{
+					Jobs.Add(FShaderCommonCompileJobPtr(Entry.Job));
+				}
+			}
+		}
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("ToneMapFX: compiling %d shader permutations"), Jobs.Num());
+	GShaderCompilingManager->SubmitJobs(Jobs, FString(), FString());
+	GShaderCompilingManager->FinishCompilation(TEXT("ToneMapFX shader report"), { (int32)JobId });
+
+	for (FToneMapShaderReportJob& Entry : Pending)
+	{
+		if (Entry.Job)
+		{
+			ReadCompilerOutput(Entry.Job->Output, Entry.Row);
+			for (const FShaderCompilerError& Error : Entry.Job->Output.Errors)
+			{
+				UE_LOG(LogTemp, Error, TEXT("ToneMapFX: [%s] %s permutation %d: %s"),
+					*Entry.Row.Format, *Entry.Row.Shader, Entry.Row.PermutationId, *Error.GetErrorStringWithLineMarker());
+			}
+		}
+		OutRows.Add(MoveTemp(Entry.Row));
+	}
+
+	OutRows.Sort([](const FToneMapShaderReportRow& A, const FToneMapShaderReportRow& B)
+	{
+		if (A.Format != B.Format) return A.Format < B.Format;
+		if (A.Shader != B.Shader) return A.Shader < B.Shader;
+		return A.PermutationId < B.PermutationId;
+	});
+}
+
+// ---------------------------------------------------------------------------
+// Baseline diff
+// ---------------------------------------------------------------------------
+
+// Metric values of a report CSV by row key (Format,Shader,PermutationId);
+// columns are found by name so older reports with fewer columns still load
+static bool LoadBaseline(const FString& Path, TMap<FString, TArray<FString>>& OutRows, TArray<int32>& OutMetricColumns)
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *Path) || Lines.Num() == 0)
+	{
+		return false;
+	}
+
+	TArray<FString> Header;
+	Lines[0].ParseIntoArray(Header, TEXT(","), false);
+	const int32 FormatColumn = Header.IndexOfByKey(TEXT("Format"));
+	const int32 ShaderColumn = Header.IndexOfByKey(TEXT("Shader"));
+	const int32 PermutationColumn = Header.IndexOfByKey(TEXT("PermutationId"));
+	if (FormatColumn == INDEX_NONE || ShaderColumn == INDEX_NONE || PermutationColumn == INDEX_NONE)
+	{
+		return false;
+	}
+	for (const TCHAR* Metric : GShaderReportMetrics)
+	{
+		OutMetricColumns.Add(Header.IndexOfByKey(Metric));
+	}
+
+	for (int32 LineIndex = 1; LineIndex < Lines.Num(); ++LineIndex)
+	{
+		TArray<FString> Columns;
+		Lines[LineIndex].ParseIntoArray(Columns, TEXT(","), false);
+		if (Columns.Num() == Header.Num())
+		{
+			OutRows.Add(Columns[FormatColumn] + TEXT(",") + Columns[ShaderColumn] + TEXT(",") + Columns[PermutationColumn], MoveTemp(Columns));
+		}
+	}
+	return true;
+}
+
+// Writes the differences to DiffPath; returns the number of metrics that grew
+// by more than MaxGrowthPercent (negative: none counted)
+static int32 DiffAgainstBaseline(const TArray<FToneMapShaderReportRow>& Rows, const FString& BaselinePath, const FString& DiffPath, float MaxGrowthPercent, bool& bOutLoaded)
+{
+	TMap<FString, TArray<FString>> Baseline;
+	TArray<int32> MetricColumns;
+	bOutLoaded = LoadBaseline(BaselinePath, Baseline, MetricColumns);
+	if (!bOutLoaded)
+	{
+		UE_LOG(LogTemp, Error, TEXT("ToneMapFX: could not read baseline %s"), *BaselinePath);
+		return 0;
+	}
+
+	TArray<FString> Lines;
+	Lines.Add(TEXT("Format,Shader,PermutationId,Metric,Baseline,Current,Delta,DeltaPercent"));
+
+	int32 NumRegressions = 0;
+	TSet<FString> Seen;
+	for (const FToneMapShaderReportRow& Row : Rows)
+	{
+		const FString Key = Row.GetKey();
+		Seen.Add(Key);
+
+		const TArray<FString>* Old = Baseline.Find(Key);
+		if (!Old)
+		{
+			Lines.Add(Key + TEXT(",Added,,,,"));
+			continue;
+		}
+
+		const int32 Current[] = { Row.Instructions, Row.TempRegisters, Row.TextureFetches };
+		for (int32 Metric = 0; Metric < UE_ARRAY_COUNT(GShaderReportMetrics); ++Metric)
+		{
+			const int32 Column = MetricColumns[Metric];
+			if (Column == INDEX_NONE || (*Old)[Column].IsEmpty() || Current[Metric] < 0)
+			{
+				continue;
+			}
+
+			const int32 Before = FCString::Atoi(*(*Old)[Column]);
+			const int32 Delta = Current[Metric] - Before;
+			if (Delta == 0)
+			{
+				continue;
+			}
+
+			const float Percent = Before > 0 ? 100.0f * Delta / Before : 100.0f;
+			Lines.Add(FString::Printf(TEXT("%s,%s,%d,%d,%+d,%+.1f"), *Key, GShaderReportMetrics[Metric], Before, Current[Metric], Delta, Percent));
+
+			const bool bRegression = MaxGrowthPercent >= 0.0f && Delta > 0 && Percent > MaxGrowthPercent;
+			UE_LOG(LogTemp, Display, TEXT("ToneMapFX: %s %s %d -> %d (%+.1f%%)%s"),
+				*Key, GShaderReportMetrics[Metric], Before, Current[Metric], Percent, bRegression ? TEXT(" over budget") : TEXT(""));
+			NumRegressions += bRegression ? 1 : 0;
+		}
+	}
+
+	for (const TPair<FString, TArray<FString>>& Old : Baseline)
+	{
+		if (!Seen.Contains(Old.Key))
+		{
+			Lines.Add(Old.Key + TEXT(",Removed,,,,"));
+		}
+	}
+
+	if (!FFileHelper::SaveStringArrayToFile(Lines, *DiffPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("ToneMapFX: could not write %s"), *DiffPath);
+	}
+	UE_LOG(LogTemp, Display, TEXT("ToneMapFX: %d differences against %s, written to %s"), Lines.Num() - 1, *BaselinePath, *DiffPath);
+	return NumRegressions;
+}
+
+#endif // WITH_EDITOR
+
+int32 UToneMapFXShaderReportCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	FString FormatList = TEXT("PCD3D_SM5+PCD3D_SM6+SF_VULKAN_SM5");
+	FString NameFilter;
+	FString CSVPath = FPaths::ProjectSavedDir() / TEXT("ToneMapFX") / TEXT("ShaderReport.csv");
+	FString BaselinePath;
+	float MaxGrowthPercent = -1.0f;
+
+	FParse::Value(*Params, TEXT("formats="), FormatList);
+	FParse::Value(*Params, TEXT("shader="), NameFilter);
+	FParse::Value(*Params, TEXT("csv="), CSVPath);
+	FParse::Value(*Params, TEXT("baseline="), BaselinePath);
+	FParse::Value(*Params, TEXT("maxgrowth="), MaxGrowthPercent);
+
+	if (!GShaderCompilingManager)
+	{
+		UE_LOG(LogTemp, Error, TEXT("ToneMapFX: the shader compiling manager is not available"));
+		return 1;
+	}
+
+	TArray<FString> FormatNames;
+	FormatList.ParseIntoArray(FormatNames, TEXT("+"));
+	TArray<FName> Formats;
+	for (const FString& Name : FormatNames)
+	{
+		Formats.Add(FName(*Name));
+	}
+
+	TArray<FToneMapShaderReportRow> Rows;
+	CompileReport(Formats, NameFilter, Rows);
+
+	TArray<FString> Lines;
+	Lines.Add(GShaderReportHeader);
+	int32 NumFailures = 0;
+	for (const FToneMapShaderReportRow& Row : Rows)
+	{
+		Lines.Add(Row.ToCSV());
+		NumFailures += Row.bCompiled ? 0 : 1;
+	}
+
+	if (!FFileHelper::SaveStringArrayToFile(Lines, *CSVPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("ToneMapFX: could not write %s"), *CSVPath);
+		return 1;
+	}
+	UE_LOG(LogTemp, Display, TEXT("ToneMapFX: %d shader permutations reported in %s"), Rows.Num(), *CSVPath);
+
+	if (!BaselinePath.IsEmpty())
+	{
+		bool bLoaded = false;
+		const FString DiffPath = FPaths::GetPath(CSVPath) / TEXT("ShaderReportDiff.csv");
+		const int32 NumRegressions = DiffAgainstBaseline(Rows, BaselinePath, DiffPath, MaxGrowthPercent, bLoaded);
+		NumFailures += bLoaded ? NumRegressions : 1;
+	}
+
+	if (Rows.Num() == 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("ToneMapFX: no shader permutation was compiled"));
+		return 1;
+	}
+
+	if (NumFailures != 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("ToneMapFX: shader report FAILED (%d)"), NumFailures);
+		return 1;
+	}
+	return 0;
+#else
+	UE_LOG(LogTemp, Error, TEXT("ToneMapFX: the shader report needs an editor build"));
+	return 1;
+#endif
+}
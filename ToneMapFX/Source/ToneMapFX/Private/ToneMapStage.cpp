@@ -0,0 +1,181 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapStage.h"
+#include "ToneMapHalfPrecision.h"
+#include "ToneMapStats.h"
+#include "SceneRendering.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+
+DEFINE_STAT(STAT_ToneMapFX_PlanStages);
+DEFINE_STAT(STAT_ToneMapFX_ActiveStages);
+DEFINE_STAT(STAT_ToneMapFX_CulledStages);
+DEFINE_STAT(STAT_ToneMapFX_DeclaredStageMemory);
+
+uint64 FToneMapStageResources::GetBytes() const
+{
+	uint64 Bytes = 0;
+	for (const FTexture& Texture : Textures)
+	{
+		Bytes += FToneMapTransientTextures::GetTextureBytes(Texture.Extent, Texture.Format);
+	}
+	return Bytes;
+}
+
+// ---------------------------------------------------------------------------
+// FToneMapStageContext
+// ---------------------------------------------------------------------------
+
+FToneMapStageContext::FToneMapStageContext(
+	FRDGBuilder& InGraphBuilder,
+	const FSceneView& InView,
+	const FPostProcessMaterialInputs& InInputs,
+	const UToneMapComponent& InSettings,
+	FToneMapViewSetup& InSetup,
+	FToneMapTransientTextures& InTransients)
+	: GraphBuilder(InGraphBuilder)
+	, View(InView)
+	, ViewInfo(static_cast<const FViewInfo&>(InView))
+	, Inputs(InInputs)
+	, Settings(InSettings)
+	, Setup(InSetup)
+	, Transients(InTransients)
+{
+	ShaderPlatform = ViewInfo.GetShaderPlatform();
+	bHalfPrecision = FToneMapHalfPrecision::IsEnabled_RenderThread(ShaderPlatform);
+}
+
+FScreenPassRenderTarget FToneMapStageContext::CreateChainTarget(const TCHAR* Name)
+{
+	if (!HasStagesAfter())
+	{
+		return FinalOutputTarget;
+	}
+
+	return FScreenPassRenderTarget(
+		Transients.Create(ViewportSize, EToneMapIntermediate::Color, Name),
+		FIntRect(0, 0, ViewportSize.X, ViewportSize.Y),
+		ERenderTargetLoadAction::ENoAction);
+}
+
+void FToneMapStageContext::AdvanceChain(const FScreenPassRenderTarget& Target)
+{
+	// The previous intermediate is free for the next stage to ping-pong into
+	Transients.Release(OutputTarget.Texture);
+	OutputTarget = Target;
+}
+
+// ---------------------------------------------------------------------------
+// Registry
+// ---------------------------------------------------------------------------
+
+static FCriticalSection GStageRegistryLock;
+static FToneMapStagePlan GRegisteredStages;
+
+void FToneMapStageRegistry::Register(TSharedRef<IToneMapStage, ESPMode::ThreadSafe> Stage, int32 Order)
+{
+	Unregister(Stage->GetName());
+
+	FToneMapRegisteredStage Entry;
+	Entry.Stage = Stage;
+	Entry.Order = Order;
+#if STATS
+	Entry.StatId = FDynamicStats::CreateStatId<FStatGroup_STATGROUP_ToneMapFX>(
+		FString::Printf(TEXT("Stage: %s"), Stage->GetName()));
+#endif
+
+	FScopeLock Lock(&GStageRegistryLock);
+	int32 Index = 0;
+	while (Index < GRegisteredStages.Num() && GRegisteredStages[Index].Order <= Order)
+	{
+		++Index;
+	}
+	GRegisteredStages.Insert(MoveTemp(Entry), Index);
+}
+
+void FToneMapStageRegistry::Unregister(const TCHAR* StageName)
+{
+	FScopeLock Lock(&GStageRegistryLock);
+	GRegisteredStages.RemoveAll([StageName](const FToneMapRegisteredStage& Entry)
+	{
+		return FCString::Strcmp(Entry.Stage->GetName(), StageName) == 0;
+	});
+}
+
+void FToneMapStageRegistry::Reset()
+{
+	FScopeLock Lock(&GStageRegistryLock);
+	GRegisteredStages.Reset();
+}
+
+void FToneMapStageRegistry::GetStages(FToneMapStagePlan& OutStages)
+{
+	FScopeLock Lock(&GStageRegistryLock);
+	OutStages = GRegisteredStages;
+}
+
+void FToneMapStageRegistry::Dump()
+{
+	FToneMapStagePlan Stages;
+	GetStages(Stages);
+
+	UE_LOG(LogTemp, Log, TEXT("ToneMapFX: %d registered stages"), Stages.Num());
+	for (const FToneMapRegisteredStage& Entry : Stages)
+	{
+		UE_LOG(LogTemp, Log, TEXT("ToneMapFX:   %5d  %s"), Entry.Order, Entry.Stage->GetName());
+	}
+}
+
+static FAutoConsoleCommand CmdToneMapListStages(
+	TEXT("r.ToneMapFX.ListStages"),
+	TEXT("Log the registered ToneMapFX stages (built-in and project) in execution order."),
+	FConsoleCommandDelegate::CreateStatic(&FToneMapStageRegistry::Dump));
+
+// ---------------------------------------------------------------------------
+// Planner
+// ---------------------------------------------------------------------------
+
+void FToneMapStagePlanner::Plan(const FToneMapStageContext& Context, FToneMapStagePlan& OutPlan)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ToneMapFX_PlanStages);
+
+	FToneMapStageRegistry::GetStages(OutPlan);
+	const int32 NumRegistered = OutPlan.Num();
+
+	OutPlan.RemoveAll([&Context](const FToneMapRegisteredStage& Entry)
+	{
+		return !Entry.Stage->IsActive(Context);
+	});
+
+	SET_DWORD_STAT(STAT_ToneMapFX_ActiveStages, OutPlan.Num());
+	SET_DWORD_STAT(STAT_ToneMapFX_CulledStages, NumRegistered - OutPlan.Num());
+}
+
+void FToneMapStagePlanner::Execute(FToneMapStageContext& Context, const FToneMapStagePlan& Plan)
+{
+	Context.Plan = Plan;
+
+#if STATS
+	FToneMapStageResources Resources;
+#endif
+
+	for (int32 Index = 0; Index < Plan.Num(); ++Index)
+	{
+		const FToneMapRegisteredStage& Entry = Plan[Index];
+		Context.StageIndex = Index;
+
+		FScopeCycleCounter StageCycles(Entry.StatId);
+#if STATS
+		Entry.Stage->DeclareResources(Context, Resources);
+#endif
+		Entry.Stage->AddPasses(Context);
+	}
+
+#if STATS
+	// Sum of every declaration — the tracker's peak shows what aliasing saves
+	SET_MEMORY_STAT(STAT_ToneMapFX_DeclaredStageMemory, Resources.GetBytes());
+#endif
+
+	Context.Plan = TConstArrayView<FToneMapRegisteredStage>();
+	Context.StageIndex = INDEX_NONE;
+}
@@ -0,0 +1,2251 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapStage.h"
+#include "ToneMapComponent.h"
+#include "ToneMapShaders.h"
+#include "ClassicBloomShaders.h"
+#include "ToneMapDurand.h"
+#include "ToneMapFattal.h"
+#include "ToneMapLensEffects.h"
+#include "ToneMapComputeStage.h"
+#include "ToneMapGaussianBlur.h"
+#include "ToneMapGuidedFilter.h"
+#include "ToneMapColorAverage.h"
+#include "ToneMapHistogramMetering.h"
+#include "ToneMapExposureReadback.h"
+#include "ToneMapBudgetGovernor.h"
+#include "ToneMapVignetteShaders.h"
+#include "ToneMapSharpenShaders.h"
+#include "ToneMapLUTShaders.h"
+#include "ToneMapCombineLUTShaders.h"
+#include "ToneMapHDREncode.h"
+#include "ToneMapFXSettings.h"
+#include "ToneMapPSOPrecache.h"
+#include "ToneMapViewSetup.h"
+#include "SceneView.h"
+#include "SceneRendering.h"
+#include "ScreenPass.h"
+#include "PostProcess/PostProcessMaterialInputs.h"
+#include "RenderGraphUtils.h"
+#include "PixelShaderUtils.h"
+
+static TAutoConsoleVariable<int32> CVarToneMapLumaLocalContrast(
+	TEXT("r.ToneMapFX.LumaLocalContrast"),
+	1,
+	TEXT("Blur luminance only (R16F) for Clarity and Dynamic Contrast; colour is rebuilt from\n")
+	TEXT("per-pixel ratios in the main pass. The coarse blur stays RGB while Correct Color Cast uses the local blur.\n")
+	TEXT(" 0: blur full RGB copies of scene colour\n")
+	TEXT(" 1: luma-only blurs, ~4x less blur bandwidth (default)"),
+	ECVF_RenderThreadSafe | ECVF_Scalability);
+
+// Display-referred stages write a working-size intermediate unless they are last
+static void DeclareChainTarget(const FToneMapStageContext& Context, const TCHAR* Name, FToneMapStageResources& OutResources)
+{
+	if (Context.HasStagesAfter())
+	{
+		OutResources.Add(Name, Context.ViewportSize, EToneMapIntermediate::Color);
+	}
+}
+
+// A recursive Gaussian's causal scan writes a scratch in the output's format;
+// the transient pool hands the horizontal one on to the vertical scan
+static void DeclareBlurScratch(const FToneMapStageContext& Context, float Sigma, bool bComputeOutput,
+	FIntPoint Extent, EToneMapIntermediate Usage, FToneMapStageResources& OutResources)
+{
+	if (Context.PlanInputs.GetBlurMethod(Sigma, bComputeOutput) == EToneMapBlurMethod::Recursive)
+	{
+		OutResources.Add(TEXT("ToneMap.RecursiveBlurCausal"), Extent, Usage);
+	}
+}
+
+// =============================================================================
+// ClassicBloom — runs BEFORE tonemapping
+// In ReplaceTonemap mode: operates on HDR scene color
+// In PostProcess mode:   operates on LDR scene color
+// =============================================================================
+
+class FToneMapBloomStage final : public IToneMapStage
+{
+public:
+	virtual const TCHAR* GetName() const override { return TEXT("Bloom"); }
+
+	virtual bool IsActive(const FToneMapStageContext& Context) const override
+	{
+		// Operators and modes stripped in Project Settings > Plugins > Tone Map FX have
+		// no shaders in the map — skip them (Durand / Fattal fall back to Reinhard)
+		return FToneMapFramePlanner::WantsStage(EToneMapPlanStage::Bloom, Context.Settings, Context.PlanInputs)
+			&& FToneMapShaderStripping::IsAvailable_RenderThread(EToneMapShaderFeature::Bloom, Context.ShaderPlatform);
+	}
+
+	virtual void DeclareResources(const FToneMapStageContext& Context, FToneMapStageResources& OutResources) const override
+	{
+		const FPasses Passes = GetPasses(Context);
+		if (!Passes.bDownsampledRect)
+		{
+			return;
+		}
+
+		const UToneMapComponent& Settings = Context.Settings;
+		const FToneMapViewSetup& Setup = Context.Setup;
+		const FIntPoint Extent = Setup.BloomExtent;
+		const EToneMapIntermediate Usage = EToneMapIntermediate::BlurScratch;
+
+		OutResources.Add(TEXT("ClassicBloom.BrightPass"), Extent, Usage);
+
+		if (Passes.Blur == EBloomMode::DirectionalGlare)
+		{
+			const int32 NumStreaks = FMath::Clamp(Settings.GlareStreakCount, 2, 16);
+			for (int32 i = 0; i < NumStreaks; ++i)
+			{
+				OutResources.Add(FToneMapPassNames::GetTextureName(EToneMapIndexedName::GlareStreak, i), Extent, Usage);
+			}
+			OutResources.Add(TEXT("ClassicBloom.GlareAccum"), Extent, Usage);
+			for (int32 BatchStart = 4; BatchStart < NumStreaks; BatchStart += 3)
+			{
+				OutResources.Add(FToneMapPassNames::GetTextureName(EToneMapIndexedName::GlareAccum, BatchStart), Extent, Usage);
+			}
+			OutResources.Add(TEXT("ClassicBloom.GlareBlurTemp"), Extent, Usage);
+			OutResources.Add(TEXT("ClassicBloom.GlareBlurred"), Extent, Usage);
+			DeclareBlurScratch(Context, Settings.BloomSize * 0.05f, Context.PlanInputs.bComputeBloom, Extent, Usage, OutResources);
+		}
+		else if (Passes.Blur == EBloomMode::Kawase)
+		{
+			const int32 MipCount = Setup.KawaseMips.Num();
+			for (int32 Mip = 0; Mip < MipCount; ++Mip)
+			{
+				OutResources.Add(FToneMapPassNames::GetTextureName(EToneMapIndexedName::KawaseMip, Mip), Setup.KawaseMips[Mip].Extent, Usage);
+			}
+			for (int32 Mip = MipCount - 2; Mip >= 0; --Mip)
+			{
+				OutResources.Add(FToneMapPassNames::GetTextureName(EToneMapIndexedName::KawaseUpsample, Mip), Setup.KawaseMips[Mip].Extent, Usage);
+			}
+			if (MipCount > 1)
+			{
+				OutResources.Add(TEXT("ClassicBloom.KawaseBlurred"), Extent, Usage);
+			}
+		}
+		else
+		{
+			OutResources.Add(TEXT("ClassicBloom.BlurTemp"), Extent, Usage);
+			OutResources.Add(TEXT("ClassicBloom.Blurred"), Extent, Usage);
+			if (Context.Quality.BloomBlurPasses > 0)
+			{
+				DeclareBlurScratch(Context, Settings.BloomSize * 0.1f, Context.PlanInputs.bComputeBloom, Extent, Usage, OutResources);
+			}
+		}
+
+		const FRDGTextureDesc& SceneColorDesc = Context.SceneColor.Texture->Desc;
+		OutResources.Add(TEXT("ClassicBloom.Composite"), SceneColorDesc.Extent, SceneColorDesc.Format);
+	}
+
+	virtual void AddPasses(FToneMapStageContext& Context) const override
+	{
+		FRDGBuilder& GraphBuilder = Context.GraphBuilder;
+		const FSceneView& View = Context.View;
+		const FViewInfo& ViewInfo = Context.ViewInfo;
+		const UToneMapComponent& Settings = Context.Settings;
+		const FToneMapResolvedQuality& Quality = Context.Quality;
+		const FToneMapViewSetup& Setup = Context.Setup;
+		FToneMapTransientTextures& Transients = Context.Transients;
+		FScreenPassTexture& SceneColor = Context.SceneColor;
+		const FPasses Passes = GetPasses(Context);
+
+		const FIntPoint SceneColorExtent = SceneColor.Texture->Desc.Extent;
+
+		RDG_EVENT_SCOPE(GraphBuilder, "ClassicBloom");
+		FToneMapScopedStageTimer BloomTimer(GraphBuilder, Context.StageTimer, EToneMapGovernedStage::Bloom);
+
+		// Step 1: Downsample size (from the view setup)
+		const int32 Divisor = Setup.Key.BloomDivisor;
+		const FIntPoint DownsampledExtent = Setup.BloomExtent;
+		const FIntRect DownsampledRect = Setup.BloomRect;
+
+		if (Passes.bDownsampledRect)
+		{
+			// Chain stages run as compute (optionally async) unless r.ToneMapFX.AsyncCompute=0
+			const EToneMapStageQueue BloomQueue = FToneMapComputeStage::GetQueue_RenderThread(
+				Transients.GetFormatForUsage(EToneMapIntermediate::BlurScratch));
+
+			// Separable Gaussian — tiled or recursive compute on the chain's queue when it runs as compute
+			auto AddBloomBlurPass = [&](FRDGEventName&& PassName, const FToneMapGaussianKernel& Kernel, bool bVertical, FRDGTextureRef Source, FRDGTextureRef Output)
+			{
+				const EToneMapBlurMethod Method = Context.PlanInputs.GetBlurMethod(Kernel.Sigma, BloomQueue != EToneMapStageQueue::Raster);
+				if (Method != EToneMapBlurMethod::PixelShader)
+				{
+					FToneMapGaussianBlur::AddComputePass(GraphBuilder, ViewInfo.ShaderMap, Transients, MoveTemp(PassName),
+						BloomQueue == EToneMapStageQueue::AsyncCompute ? ERDGPassFlags::AsyncCompute : ERDGPassFlags::Compute,
+						Method, Kernel, bVertical, Source, FIntPoint::ZeroValue, Output, DownsampledExtent);
+					return;
+				}
+
+				FClassicBloomBlurParameters BlurParams;
+				BlurParams.View = View.ViewUniformBuffer;
+				BlurParams.SourceTexture = Source;
+				BlurParams.SourceSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+				BlurParams.BufferSizeAndInvSize = Setup.BloomBufferSizeAndInvSize;
+				BlurParams.BlurDirection = bVertical ? FVector2f(0.0f, 1.0f) : FVector2f(1.0f, 0.0f);
+				Kernel.SetParameters(BlurParams.Kernel);
+
+				AddToneMapStagePass<FClassicBloomBlurPS, FClassicBloomBlurCS>(GraphBuilder, ViewInfo.ShaderMap,
+					MoveTemp(PassName), BloomQueue, BlurParams, Output, DownsampledRect, ERenderTargetLoadAction::EClear);
+			};
+
+			// Step 2: Bright pass — extract bright pixels
+			// The whole bloom chain is low-frequency — R11G11B10F scratch is sufficient,
+			// and every later chain texture shares the bright pass's descriptor
+			FRDGTextureRef BrightPassTexture = Transients.Create(
+				DownsampledExtent, EToneMapIntermediate::BlurScratch, TEXT("ClassicBloom.BrightPass"),
+				FToneMapComputeStage::GetOutputFlags(BloomQueue), FClearValueBinding::Black);
+			const FRDGTextureDesc BrightPassDesc = BrightPassTexture->Desc;
+			{
+				TShaderMapRef<FClassicBloomBrightPassPS> PixelShader(ViewInfo.ShaderMap);
+				if (PixelShader.IsValid())
+				{
+					float EffectiveThreshold = Settings.BloomThreshold;
+					bool bIsSoftFocusMode = (Settings.BloomMode == EBloomMode::SoftFocus);
+					if (bIsSoftFocusMode)
+					{
+						EffectiveThreshold = 0.01f;
+					}
+
+					FClassicBloomBrightPassParameters BPParams;
+					BPParams.View = View.ViewUniformBuffer;
+					BPParams.SceneColorTexture = SceneColor.Texture;
+					BPParams.SceneColorSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+					BPParams.InputViewportSizeAndInvSize = Setup.BloomInputSizeAndInvSize;
+					BPParams.OutputViewportSizeAndInvSize = Setup.BloomOutputSizeAndInvSize;
+					BPParams.SvPositionToInputTextureUV = Setup.BloomBrightPassInputUV;
+
+					BPParams.BloomThreshold = EffectiveThreshold;
+					BPParams.BloomIntensity = 1.0f;
+					BPParams.ThresholdSoftness = FMath::Clamp(Settings.BloomThresholdSoftness, 0.0f, 1.0f);
+					BPParams.MaxBrightness = FMath::Max(Settings.BloomMaxBrightness, 0.0f);
+
+					AddToneMapStagePass<FClassicBloomBrightPassPS, FClassicBloomBrightPassCS>(GraphBuilder, ViewInfo.ShaderMap,
+						RDG_EVENT_NAME("BrightPass"), BloomQueue, BPParams, BrightPassTexture, DownsampledRect, ERenderTargetLoadAction::EClear);
+				}
+			}
+
+			// Step 3: Blur — Gaussian, Directional Glare, or Kawase
+			FRDGTextureRef BlurredBloomTexture = nullptr;
+			bool bUseSoftFocus = (Settings.BloomMode == EBloomMode::SoftFocus);
+
+			// --- Directional Glare ---
+			if (Passes.Blur == EBloomMode::DirectionalGlare)
+			{
+				int32 NumStreaks = FMath::Clamp(Settings.GlareStreakCount, 2, 16);
+				float StreakLength = FMath::Clamp((float)Settings.GlareStreakLength, 5.0f, 200.0f);
+				float ScaledStreakLength = StreakLength / (float)Divisor;
+				float Falloff = FMath::Clamp(Settings.GlareFalloff, 0.5f, 10.0f);
+				float AngleStep = 360.0f / (float)NumStreaks;
+
+				TShaderMapRef<FClassicBloomGlareStreakPS> GlareStreakShader(ViewInfo.ShaderMap);
+				TShaderMapRef<FClassicBloomGlareAccumulatePS> GlareAccumShader(ViewInfo.ShaderMap);
+
+				if (GlareStreakShader.IsValid() && GlareAccumShader.IsValid())
+				{
+					TArray<FRDGTextureRef, TInlineAllocator<16>> StreakTextures;
+
+					for (int32 i = 0; i < NumStreaks; ++i)
+					{
+						float Angle = (AngleStep * (float)i) + Settings.GlareRotationOffset;
+						float RadAngle = FMath::DegreesToRadians(Angle);
+						FVector2f Direction(FMath::Cos(RadAngle), FMath::Sin(RadAngle));
+
+						FRDGTextureRef StreakTexture = Transients.CreateFromDesc(BrightPassDesc, FToneMapPassNames::GetTextureName(EToneMapIndexedName::GlareStreak, i));
+						StreakTextures.Add(StreakTexture);
+
+						FClassicBloomGlareStreakParameters StreakParams;
+						StreakParams.View = View.ViewUniformBuffer;
+						StreakParams.SourceTexture = BrightPassTexture;
+						StreakParams.SourceSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+						StreakParams.BufferSizeAndInvSize = Setup.BloomBufferSizeAndInvSize;
+						StreakParams.StreakDirection = Direction;
+						StreakParams.StreakLength = ScaledStreakLength;
+						StreakParams.StreakFalloff = Falloff;
+						StreakParams.StreakSamples = Quality.GlareSamples;
+
+						AddToneMapStagePass<FClassicBloomGlareStreakPS, FClassicBloomGlareStreakCS>(GraphBuilder, ViewInfo.ShaderMap,
+							TONEMAP_INDEXED_EVENT_NAME("GlareStreak%d", "GlareStreak", i), BloomQueue, StreakParams, StreakTexture, DownsampledRect, ERenderTargetLoadAction::EClear);
+					}
+
+					// Bright pass has no readers left once every streak is queued
+					Transients.Release(BrightPassTexture);
+					BrightPassTexture = nullptr;
+
+					// Accumulate streaks
+					int32 StreaksToProcess = FMath::Min(NumStreaks, 4);
+					FRDGTextureRef AccumTexture = Transients.CreateFromDesc(BrightPassDesc, TEXT("ClassicBloom.GlareAccum"));
+
+					FClassicBloomGlareAccumulateParameters AccumParams;
+					AccumParams.View = View.ViewUniformBuffer;
+					AccumParams.StreakTexture0 = StreakTextures[0];
+					AccumParams.StreakTexture1 = StreaksToProcess >= 2 ? StreakTextures[1] : StreakTextures[0];
+					AccumParams.StreakTexture2 = StreaksToProcess >= 3 ? StreakTextures[2] : StreakTextures[0];
+					AccumParams.StreakTexture3 = StreaksToProcess >= 4 ? StreakTextures[3] : StreakTextures[0];
+					AccumParams.StreakSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+					AccumParams.GlareViewportSizeAndInvSize = Setup.BloomOutputSizeAndInvSize;
+					AccumParams.NumStreaks = StreaksToProcess;
+
+					AddToneMapStagePass<FClassicBloomGlareAccumulatePS, FClassicBloomGlareAccumulateCS>(GraphBuilder, ViewInfo.ShaderMap,
+						RDG_EVENT_NAME("GlareAccumulate"), BloomQueue, AccumParams, AccumTexture, DownsampledRect, ERenderTargetLoadAction::EClear);
+
+					// Additional batches for >4 streaks
+					if (NumStreaks > 4)
+					{
+						FRDGTextureRef PrevAccum = AccumTexture;
+						for (int32 BatchStart = 4; BatchStart < NumStreaks; BatchStart += 3)
+						{
+							FRDGTextureRef NextAccum = Transients.CreateFromDesc(BrightPassDesc, FToneMapPassNames::GetTextureName(EToneMapIndexedName::GlareAccum, BatchStart));
+							int32 StreaksInBatch = FMath::Min(3, NumStreaks - BatchStart);
+
+							FClassicBloomGlareAccumulateParameters BatchParams;
+							BatchParams.View = View.ViewUniformBuffer;
+							BatchParams.StreakTexture0 = PrevAccum;
+							BatchParams.StreakTexture1 = StreakTextures[BatchStart];
+							BatchParams.StreakTexture2 = StreaksInBatch >= 2 ? StreakTextures[BatchStart + 1] : StreakTextures[BatchStart];
+							BatchParams.StreakTexture3 = StreaksInBatch >= 3 ? StreakTextures[BatchStart + 2] : StreakTextures[BatchStart];
+							BatchParams.StreakSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+							BatchParams.GlareViewportSizeAndInvSize = Setup.BloomOutputSizeAndInvSize;
+							BatchParams.NumStreaks = 1 + StreaksInBatch;
+
+							AddToneMapStagePass<FClassicBloomGlareAccumulatePS, FClassicBloomGlareAccumulateCS>(GraphBuilder, ViewInfo.ShaderMap,
+								TONEMAP_INDEXED_EVENT_NAME("GlareAccumulate%d", "GlareAccumulate", BatchStart), BloomQueue, BatchParams, NextAccum, DownsampledRect, ERenderTargetLoadAction::EClear);
+
+							// Older partial sum is consumed — the next batch can write into it
+							Transients.Release(PrevAccum);
+							PrevAccum = NextAccum;
+						}
+						AccumTexture = PrevAccum;
+					}
+
+					// Individual streaks are folded into AccumTexture — their lifetime ends here
+					for (FRDGTextureRef StreakTexture : StreakTextures)
+					{
+						Transients.Release(StreakTexture);
+					}
+
+					// Light Gaussian blur to smooth the glare
+					FRDGTextureRef GlareBlurTemp = Transients.CreateFromDesc(BrightPassDesc, TEXT("ClassicBloom.GlareBlurTemp"));
+					BlurredBloomTexture = Transients.CreateFromDesc(BrightPassDesc, TEXT("ClassicBloom.GlareBlurred"));
+
+					const FToneMapGaussianKernel GlareKernel = FToneMapGaussianKernel::Build(Settings.BloomSize * 0.05f);
+					AddBloomBlurPass(RDG_EVENT_NAME("GlareBlurH"), GlareKernel, false, AccumTexture, GlareBlurTemp);
+					AddBloomBlurPass(RDG_EVENT_NAME("GlareBlurV"), GlareKernel, true, GlareBlurTemp, BlurredBloomTexture);
+
+					Transients.Release(GlareBlurTemp);
+					Transients.Release(AccumTexture);
+				}
+			}
+
+			// --- Kawase Bloom ---
+			if (Passes.Blur == EBloomMode::Kawase && !BlurredBloomTexture)
+			{
+				TShaderMapRef<FClassicBloomKawaseDownsamplePS> KawaseDownsampleShader(ViewInfo.ShaderMap);
+				TShaderMapRef<FClassicBloomKawaseUpsamplePS> KawaseUpsampleShader(ViewInfo.ShaderMap);
+
+				if (KawaseDownsampleShader.IsValid() && KawaseUpsampleShader.IsValid())
+				{
+					const int32 MipCount = Setup.KawaseMips.Num();
+					float FilterRadius = FMath::Clamp(Settings.KawaseFilterRadius, 0.0001f, 0.01f);
+					float ThresholdKnee = Settings.bKawaseSoftThreshold ? FMath::Clamp(Settings.KawaseThresholdKnee, 0.0f, 1.0f) : 0.0f;
+
+					// Level extents, rects and transforms come from the view setup
+					TArray<FRDGTextureRef, TInlineAllocator<8>> MipTextures;
+					for (int32 Mip = 0; Mip < MipCount; ++Mip)
+					{
+						FRDGTextureDesc MipDesc = FRDGTextureDesc::Create2D(
+							Setup.KawaseMips[Mip].Extent, BrightPassDesc.Format, FClearValueBinding::Black,
+							TexCreate_ShaderResource | TexCreate_RenderTargetable | FToneMapComputeStage::GetOutputFlags(BloomQueue));
+
+						MipTextures.Add(Transients.CreateFromDesc(MipDesc, FToneMapPassNames::GetTextureName(EToneMapIndexedName::KawaseMip, Mip)));
+					}
+
+					// Downsample pass: create mip pyramid from scene color
+					FRDGTextureRef DownsampleSource = SceneColor.Texture;
+					FVector4f SourceSizeAndInvSize(SceneColorExtent.X, SceneColorExtent.Y, 1.0f / SceneColorExtent.X, 1.0f / SceneColorExtent.Y);
+
+					for (int32 Mip = 0; Mip < MipCount; ++Mip)
+					{
+						const FToneMapKawaseMip& MipSetup = Setup.KawaseMips[Mip];
+
+						FClassicBloomKawaseDownsampleParameters DownParams;
+						DownParams.View = View.ViewUniformBuffer;
+						DownParams.SourceTexture = DownsampleSource;
+						DownParams.SourceSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+						DownParams.SourceSizeAndInvSize = SourceSizeAndInvSize;
+						DownParams.OutputSizeAndInvSize = MipSetup.SizeAndInvSize;
+						DownParams.SvPositionToSourceUV = MipSetup.SvPositionToSourceUV;
+
+						DownParams.BloomThreshold = Settings.BloomThreshold;
+						DownParams.ThresholdKnee = ThresholdKnee;
+						DownParams.MipLevel = Mip;
+						DownParams.bUseKarisAverage = (Mip == 0) ? 1 : 0;
+
+						AddToneMapStagePass<FClassicBloomKawaseDownsamplePS, FClassicBloomKawaseDownsampleCS>(GraphBuilder, ViewInfo.ShaderMap,
+							TONEMAP_INDEXED_EVENT_NAME("KawaseDownsample_Mip%d", "KawaseDownsample", Mip), BloomQueue, DownParams, MipTextures[Mip], MipSetup.Rect, ERenderTargetLoadAction::EClear);
+
+						DownsampleSource = MipTextures[Mip];
+						SourceSizeAndInvSize = MipSetup.SizeAndInvSize;
+					}
+
+					// Upsample pass: progressive upsample with additive blend
+					TArray<FRDGTextureRef, TInlineAllocator<8>> UpsampleTextures;
+					for (int32 Mip = MipCount - 2; Mip >= 0; --Mip)
+					{
+						FRDGTextureDesc UpsampleDesc = FRDGTextureDesc::Create2D(
+							Setup.KawaseMips[Mip].Extent, BrightPassDesc.Format, FClearValueBinding::Black,
+							TexCreate_ShaderResource | TexCreate_RenderTargetable | FToneMapComputeStage::GetOutputFlags(BloomQueue));
+						UpsampleTextures.Add(Transients.CreateFromDesc(UpsampleDesc, FToneMapPassNames::GetTextureName(EToneMapIndexedName::KawaseUpsample, Mip)));
+					}
+
+					FRDGTextureRef UpsampleSource = MipTextures[MipCount - 1];
+					int32 UpsampleIdx = 0;
+					for (int32 Mip = MipCount - 2; Mip >= 0; --Mip)
+					{
+						FClassicBloomKawaseUpsampleParameters UpParams;
+						UpParams.View = View.ViewUniformBuffer;
+						UpParams.SourceTexture = UpsampleSource;
+						UpParams.PreviousMipTexture = MipTextures[Mip];
+						UpParams.SourceSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+						UpParams.OutputSizeAndInvSize = Setup.KawaseMips[Mip].SizeAndInvSize;
+						UpParams.FilterRadius = FilterRadius;
+
+						AddToneMapStagePass<FClassicBloomKawaseUpsamplePS, FClassicBloomKawaseUpsampleCS>(GraphBuilder, ViewInfo.ShaderMap,
+							TONEMAP_INDEXED_EVENT_NAME("KawaseUpsample_Mip%d", "KawaseUpsample", Mip), BloomQueue, UpParams, UpsampleTextures[UpsampleIdx], Setup.KawaseMips[Mip].Rect, ERenderTargetLoadAction::EClear);
+
+						UpsampleSource = UpsampleTextures[UpsampleIdx];
+						++UpsampleIdx;
+					}
+
+					// Final upsample to original downsampled size
+					if (UpsampleTextures.Num() > 0)
+					{
+						BlurredBloomTexture = Transients.CreateFromDesc(BrightPassDesc, TEXT("ClassicBloom.KawaseBlurred"));
+
+						FClassicBloomKawaseUpsampleParameters FinalUpParams;
+						FinalUpParams.View = View.ViewUniformBuffer;
+						FinalUpParams.SourceTexture = UpsampleTextures.Last();
+						FinalUpParams.PreviousMipTexture = MipTextures[0];
+						FinalUpParams.SourceSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+						FinalUpParams.OutputSizeAndInvSize = Setup.BloomBufferSizeAndInvSize;
+						FinalUpParams.FilterRadius = FilterRadius;
+
+						AddToneMapStagePass<FClassicBloomKawaseUpsamplePS, FClassicBloomKawaseUpsampleCS>(GraphBuilder, ViewInfo.ShaderMap,
+							RDG_EVENT_NAME("KawaseUpsample_Final"), BloomQueue, FinalUpParams, BlurredBloomTexture, DownsampledRect, ERenderTargetLoadAction::EClear);
+					}
+					else
+					{
+						BlurredBloomTexture = MipTextures.Num() > 0 ? MipTextures[0] : BrightPassTexture;
+					}
+
+					for (FRDGTextureRef MipTexture : MipTextures)
+					{
+						if (MipTexture != BlurredBloomTexture) Transients.Release(MipTexture);
+					}
+					for (FRDGTextureRef UpsampleTexture : UpsampleTextures)
+					{
+						Transients.Release(UpsampleTexture);
+					}
+				}
+			}
+
+			// --- Standard Gaussian blur (or fallback) ---
+			if (!BlurredBloomTexture)
+			{
+				int32 NumBlurPasses = Quality.BloomBlurPasses;
+				FRDGTextureRef BlurSource = BrightPassTexture;
+				FRDGTextureRef BlurTempTexture = Transients.CreateFromDesc(BrightPassDesc, TEXT("ClassicBloom.BlurTemp"));
+				BlurredBloomTexture = Transients.CreateFromDesc(BrightPassDesc, TEXT("ClassicBloom.Blurred"));
+
+				const FToneMapGaussianKernel BlurKernel = FToneMapGaussianKernel::Build(Settings.BloomSize * 0.1f);
+				for (int32 PassIndex = 0; PassIndex < NumBlurPasses; ++PassIndex)
+				{
+					AddBloomBlurPass(RDG_EVENT_NAME("BlurHorizontal"), BlurKernel, false, BlurSource, BlurTempTexture);
+					AddBloomBlurPass(RDG_EVENT_NAME("BlurVertical"), BlurKernel, true, BlurTempTexture, BlurredBloomTexture);
+
+					BlurSource = BlurredBloomTexture;
+				}
+
+				Transients.Release(BlurTempTexture);
+			}
+
+			// Step 4: Composite bloom back onto scene color
+			if (BlurredBloomTexture)
+			{
+				// The chain may run on async compute — time it until its result is ready
+				BloomTimer.SetOutput(BlurredBloomTexture);
+
+				FRDGTextureDesc CompositeDesc = SceneColor.Texture->Desc;
+				CompositeDesc.ClearValue = FClearValueBinding::Black;
+				CompositeDesc.Flags |= TexCreate_RenderTargetable | TexCreate_ShaderResource;
+				FRDGTextureRef CompositeOutput = Transients.CreateFromDesc(CompositeDesc, TEXT("ClassicBloom.Composite"));
+				FIntRect CompositeViewRect = SceneColor.ViewRect;
+
+				TShaderMapRef<FClassicBloomCompositePS> CompositeShader(ViewInfo.ShaderMap);
+				if (CompositeShader.IsValid())
+				{
+					FClassicBloomCompositePS::FParameters* CParams = GraphBuilder.AllocParameters<FClassicBloomCompositePS::FParameters>();
+					CParams->View = View.ViewUniformBuffer;
+					CParams->SceneColorTexture = SceneColor.Texture;
+					CParams->SceneColorSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+					CParams->BloomTexture = BlurredBloomTexture;
+					CParams->BloomSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+					CParams->OutputViewportSizeAndInvSize = FVector4f(CompositeViewRect.Width(), CompositeViewRect.Height(), 1.0f / CompositeViewRect.Width(), 1.0f / CompositeViewRect.Height());
+					CParams->SvPositionToSceneColorUV = Setup.BloomCompositeSceneColorUV;
+					CParams->SvPositionToBloomUV = Setup.BloomCompositeBloomUV;
+
+					CParams->BloomIntensity = bUseSoftFocus ? 0.0f : Settings.BloomIntensity;
+
+					FLinearColor TintWithFlag = Settings.BloomTint;
+					TintWithFlag.A = Settings.bUseSceneColor ? 1.0f : 0.0f;
+					CParams->BloomTint = FVector4f(TintWithFlag);
+
+					CParams->BloomBlendMode = (float)Settings.BloomBlendMode;
+					CParams->BloomSaturation = Settings.BloomSaturation;
+					CParams->bProtectHighlights = Settings.bProtectHighlights ? 1.0f : 0.0f;
+					CParams->HighlightProtection = Settings.HighlightProtection;
+					CParams->SoftFocusIntensity = bUseSoftFocus ? Settings.BloomIntensity : 0.0f;
+					CParams->SoftFocusParams = FVector4f(
+						Settings.SoftFocusOverlayMultiplier,
+						Settings.SoftFocusBlendStrength,
+						Settings.SoftFocusSoftLightMultiplier,
+						Settings.SoftFocusFinalBlend);
+
+					// Removed debug options — set safe defaults
+					CParams->bUseAdaptiveScaling = 0.0f;
+					CParams->bShowBloomOnly = 0.0f;
+					CParams->bShowGammaCompensation = 0.0f;
+					CParams->bIsGameWorld = (ViewInfo.Family->Scene && ViewInfo.Family->Scene->GetWorld() && ViewInfo.Family->Scene->GetWorld()->IsGameWorld()) ? 1.0f : 0.0f;
+					CParams->GameModeBloomScale = 1.0f;
+
+					CParams->bUseBrightnessCompensation = 0.0f;
+					CParams->BrightnessCompensationMode = 0.0f;
+					CParams->BrightnessCompensationStrength = 0.0f;
+					CParams->ExposureCompensation = 0.0f;
+
+					// EClear ensures pixels outside CompositeViewRect are black
+					// (texture extent may be larger than viewport when window is not maximized)
+					CParams->RenderTargets[0] = FRenderTargetBinding(CompositeOutput, ERenderTargetLoadAction::EClear);
+
+					AddToneMapFullscreenPass(
+						GraphBuilder, ViewInfo.ShaderMap,
+						RDG_EVENT_NAME("CompositeBloom"),
+						CompositeShader, CParams, CompositeViewRect);
+
+					// Replace SceneColor with the bloom-composited result for downstream ToneMap processing
+					SceneColor = FScreenPassTexture(CompositeOutput, CompositeViewRect);
+					Context.bBloomApplied = true;
+				}
+
+				Transients.Release(BlurredBloomTexture);
+			}
+
+			Transients.Release(BrightPassTexture);
+		} // DownsampledRect valid
+	}
+
+private:
+	// What DeclareResources and AddPasses both run
+	struct FPasses
+	{
+		bool bDownsampledRect = false;
+		EBloomMode Blur = EBloomMode::Standard;   // Standard: the Gaussian (also Soft Focus)
+	};
+
+	static FPasses GetPasses(const FToneMapStageContext& Context)
+	{
+		const EBloomMode Mode = Context.Settings.BloomMode;
+		const FIntRect& Rect = Context.Setup.BloomRect;
+
+		// Glare and Kawase fall back to the Gaussian when their shaders are stripped
+		FPasses Passes;
+		Passes.bDownsampledRect = Rect.Width() > 0 && Rect.Height() > 0;
+		if (Mode == EBloomMode::DirectionalGlare
+			&& FToneMapShaderStripping::IsAvailable_RenderThread(EToneMapShaderFeature::DirectionalGlare, Context.ShaderPlatform))
+		{
+			Passes.Blur = EBloomMode::DirectionalGlare;
+		}
+		else if (Mode == EBloomMode::Kawase
+			&& FToneMapShaderStripping::IsAvailable_RenderThread(EToneMapShaderFeature::Kawase, Context.ShaderPlatform))
+		{
+			Passes.Blur = EBloomMode::Kawase;
+		}
+		return Passes;
+	}
+};
+
+// =============================================================================
+// Krawczyk Auto-Exposure — Luminance measurement & temporal adaptation
+// =============================================================================
+// Only runs when mode is Krawczyk and we're in ReplaceTonemap mode.
+// Pipeline:
+//   1. HistogramMetering   — weighted log-luminance histogram, trimmed
+//                            mean (1x1); LuminanceMeasurePS (16x16 grid
+//                            geometric mean) with r.ToneMapFX.HistogramMetering 0
+//   2. LuminanceAdaptPS    — Exponential blend with previous frame (1x1)
+//   3. Result passed to main shader as AdaptedLumTexture, and read back
+//      to the game thread (FToneMapExposureReadback)
+// =============================================================================
+
+class FToneMapExposureStage final : public IToneMapStage
+{
+public:
+	virtual const TCHAR* GetName() const override { return TEXT("Exposure"); }
+
+	virtual bool IsActive(const FToneMapStageContext& Context) const override
+	{
+		return FToneMapFramePlanner::WantsStage(EToneMapPlanStage::Exposure, Context.Settings, Context.PlanInputs);
+	}
+
+	virtual void DeclareResources(const FToneMapStageContext& Context, FToneMapStageResources& OutResources) const override
+	{
+		OutResources.Add(TEXT("ToneMap.MeasuredLum"), FIntPoint(1, 1), PF_R32_FLOAT);
+		if (Context.AdaptedLuminanceRT->IsValid())
+		{
+			OutResources.Add(TEXT("ToneMap.AdaptedLum"), FIntPoint(1, 1), PF_R32_FLOAT);
+		}
+	}
+
+	virtual void AddPasses(FToneMapStageContext& Context) const override
+	{
+		FRDGBuilder& GraphBuilder = Context.GraphBuilder;
+		const FViewInfo& ViewInfo = Context.ViewInfo;
+		const UToneMapComponent& Settings = Context.Settings;
+		const FScreenPassTexture& SceneColor = Context.SceneColor;
+		const FScreenPassTextureViewport& SceneColorViewport = Context.SceneColorViewport;
+		FRDGTextureRef& AdaptedLumTexture = Context.AdaptedLumTexture;
+
+		const float OneOverPreExposure = 1.0f / FMath::Max(ViewInfo.PreExposure, 0.001f);
+
+		// Compute scene color UV bounds (viewport rect in texture UV space)
+		const FIntRect& SceneVR = SceneColorViewport.Rect;
+		const FIntPoint SceneExt = SceneColor.Texture->Desc.Extent;
+		FVector4f UVBounds(
+			(float)SceneVR.Min.X / SceneExt.X,
+			(float)SceneVR.Min.Y / SceneExt.Y,
+			(float)SceneVR.Max.X / SceneExt.X,
+			(float)SceneVR.Max.Y / SceneExt.Y);
+
+		// --- Step 1: Measure scene luminance (→ 1x1 texture) ---
+		FRDGTextureRef MeasuredLumTexture;
+		FRDGBufferRef MeteringHistogram = nullptr;
+		if (FToneMapHistogramMetering::IsEnabled_RenderThread())
+		{
+			// Weighted histogram with percentile rejection (same 1x1 output)
+			FToneMapMeteringSettings Metering;
+			Metering.Mode        = (uint32)Settings.MeteringMode;
+			Metering.LowPercent  = Settings.MeteringLowPercent;
+			Metering.HighPercent = Settings.MeteringHighPercent;
+			Metering.SpotRadius  = Settings.MeteringSpotSize;
+			if (Settings.MeteringMode == EToneMapMeteringMode::Mask
+				&& Settings.MeteringMaskTexture != nullptr
+				&& Settings.MeteringMaskTexture->GetResource() != nullptr)
+			{
+				Metering.MaskTexture = Settings.MeteringMaskTexture->GetResource()->TextureRHI;
+			}
+
+			MeasuredLumTexture = FToneMapHistogramMetering::AddPasses(
+				GraphBuilder, ViewInfo.ShaderMap, Context.Transients, SceneColor.Texture, SceneVR,
+				OneOverPreExposure, Metering, &MeteringHistogram);
+		}
+		else
+		{
+			FRDGTextureDesc LumDesc = FRDGTextureDesc::Create2D(
+				FIntPoint(1, 1), PF_R32_FLOAT, FClearValueBinding::None,
+				TexCreate_ShaderResource | TexCreate_RenderTargetable);
+
+			MeasuredLumTexture = Context.Transients.CreateFromDesc(LumDesc, TEXT("ToneMap.MeasuredLum"));
+
+			auto* P = GraphBuilder.AllocParameters<FToneMapLumMeasurePS::FParameters>();
+			P->View                = ViewInfo.ViewUniformBuffer;
+			P->SceneColorTexture   = SceneColor.Texture;
+			P->SceneColorSampler   = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			P->SceneColorUVBounds  = UVBounds;
+			P->OneOverPreExposure  = OneOverPreExposure;
+			P->RenderTargets[0]    = FRenderTargetBinding(MeasuredLumTexture, ERenderTargetLoadAction::ENoAction);
+
+			TShaderMapRef<FToneMapLumMeasurePS> MeasureShader(ViewInfo.ShaderMap);
+			AddToneMapFullscreenPass(
+				GraphBuilder, ViewInfo.ShaderMap,
+				RDG_EVENT_NAME("ToneMap_LuminanceMeasure"),
+				MeasureShader, P,
+				FIntRect(0, 0, 1, 1));
+		}
+
+		// --- Step 2: Temporal adaptation (→ 1x1 persistent texture) ---
+		if (Context.AdaptedLuminanceRT->IsValid())
+		{
+			// Blend previous adapted luminance with new measurement
+			FRDGTextureRef PrevAdaptedLum = GraphBuilder.RegisterExternalTexture(
+				*Context.AdaptedLuminanceRT, TEXT("ToneMap.PrevAdaptedLum"));
+
+			FRDGTextureDesc AdaptDesc = FRDGTextureDesc::Create2D(
+				FIntPoint(1, 1), PF_R32_FLOAT, FClearValueBinding::None,
+				TexCreate_ShaderResource | TexCreate_RenderTargetable);
+
+			AdaptedLumTexture = GraphBuilder.CreateTexture(AdaptDesc, TEXT("ToneMap.AdaptedLum"));
+
+			auto* P = GraphBuilder.AllocParameters<FToneMapLumAdaptPS::FParameters>();
+			P->View                   = ViewInfo.ViewUniformBuffer;
+			P->PrevAdaptedLumTexture   = PrevAdaptedLum;
+			P->PrevAdaptedLumSampler   = TStaticSamplerState<SF_Point, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			P->CurrentLumTexture       = MeasuredLumTexture;
+			P->CurrentLumSampler       = TStaticSamplerState<SF_Point, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			P->AdaptSpeedUp            = Settings.AdaptationSpeedUp;
+			P->AdaptSpeedDown          = Settings.AdaptationSpeedDown;
+			P->DeltaTime               = FMath::Max(Context.DeltaTime, 0.001f);
+			P->RenderTargets[0]        = FRenderTargetBinding(AdaptedLumTexture, ERenderTargetLoadAction::ENoAction);
+
+			TShaderMapRef<FToneMapLumAdaptPS> AdaptShader(ViewInfo.ShaderMap);
+			AddToneMapFullscreenPass(
+				GraphBuilder, ViewInfo.ShaderMap,
+				RDG_EVENT_NAME("ToneMap_LuminanceAdapt"),
+				AdaptShader, P,
+				FIntRect(0, 0, 1, 1));
+		}
+		else
+		{
+			// First frame: use measured luminance directly (instant adaptation)
+			AdaptedLumTexture = MeasuredLumTexture;
+		}
+
+		// Extract adapted luminance for next frame's temporal blending
+		GraphBuilder.QueueTextureExtraction(AdaptedLumTexture, Context.AdaptedLuminanceRT);
+
+		// --- Step 3: Statistics for the game thread (read back a few frames later) ---
+		if (FToneMapExposureReadback::IsEnabled_RenderThread())
+		{
+			Context.ExposureReadback->AddPasses(
+				GraphBuilder, ViewInfo.ShaderMap, Context.Transients, AdaptedLumTexture, MeasuredLumTexture, MeteringHistogram,
+				Settings.MinAutoExposure, Settings.MaxAutoExposure);
+		}
+		Context.Transients.Release(MeteringHistogram);
+	}
+};
+
+// =============================================================================
+// Local contrast — Clarity and Dynamic Contrast blurs
+// (skipped when Clarity and every Dynamic Contrast slider are zero)
+// =============================================================================
+
+class FToneMapLocalContrastStage final : public IToneMapStage
+{
+public:
+	virtual const TCHAR* GetName() const override { return TEXT("LocalContrast"); }
+
+	virtual bool IsActive(const FToneMapStageContext& Context) const override
+	{
+		return FToneMapFramePlanner::WantsStage(EToneMapPlanStage::LocalContrast, Context.Settings, Context.PlanInputs);
+	}
+
+	virtual void DeclareResources(const FToneMapStageContext& Context, FToneMapStageResources& OutResources) const override
+	{
+		const FIntPoint ViewportSize = Context.ViewportSize;
+		const FPasses Passes = GetPasses(Context);
+		const bool bComputeViewBlur = Context.PlanInputs.bComputeViewBlur;
+
+		if (Passes.bLumaClarity || Passes.bLumaFine || Passes.bLumaCoarse)
+		{
+			OutResources.Add(TEXT("ToneMap.LocalContrastLuma"), ViewportSize, EToneMapIntermediate::Luminance);
+		}
+
+		if (Passes.bGuidedClarity)
+		{
+			OutResources.Add(TEXT("ToneMap.ClarityBase"), ViewportSize, EToneMapIntermediate::Color);
+		}
+		else if (Passes.bClarity)
+		{
+			const EToneMapIntermediate ClarityUsage = Passes.bLumaClarity ? EToneMapIntermediate::Luminance : EToneMapIntermediate::Color;
+			OutResources.Add(TEXT("ToneMap.HBlur"), ViewportSize, ClarityUsage);
+			OutResources.Add(TEXT("ToneMap.VBlur"), ViewportSize, ClarityUsage);
+			DeclareBlurScratch(Context, Context.Quality.ClarityRadius, bComputeViewBlur, ViewportSize, ClarityUsage, OutResources);
+		}
+
+		if (Passes.bGlobalColorCast)
+		{
+			OutResources.Add(TEXT("ToneMap.SceneAverageColor"), FIntPoint(1, 1), PF_FloatRGBA);
+		}
+		if (Passes.bFine)
+		{
+			const EToneMapIntermediate FineUsage = Passes.bLumaFine ? EToneMapIntermediate::Luminance : EToneMapIntermediate::Color;
+			OutResources.Add(TEXT("ToneMap.DynamicContrast.FineH"), ViewportSize, FineUsage);
+			OutResources.Add(TEXT("ToneMap.DynamicContrast.FineV"), ViewportSize, FineUsage);
+			DeclareBlurScratch(Context, 2.0f, bComputeViewBlur, ViewportSize, FineUsage, OutResources);
+		}
+		if (Passes.bCoarse)
+		{
+			const EToneMapIntermediate CoarseUsage = Passes.bLumaCoarse ? EToneMapIntermediate::Luminance : EToneMapIntermediate::BlurScratch;
+			OutResources.Add(TEXT("ToneMap.DynamicContrast.CoarseH"), ViewportSize, CoarseUsage);
+			OutResources.Add(TEXT("ToneMap.DynamicContrast.CoarseV"), ViewportSize, CoarseUsage);
+			DeclareBlurScratch(Context, 32.0f, bComputeViewBlur, ViewportSize, CoarseUsage, OutResources);
+		}
+	}
+
+	virtual void AddPasses(FToneMapStageContext& Context) const override
+	{
+		FRDGBuilder& GraphBuilder = Context.GraphBuilder;
+		const FViewInfo& ViewInfo = Context.ViewInfo;
+		const UToneMapComponent& Settings = Context.Settings;
+		const FToneMapResolvedQuality& Quality = Context.Quality;
+		FToneMapTransientTextures& Transients = Context.Transients;
+		const FScreenPassTexture& SceneColor = Context.SceneColor;
+		const FScreenPassTextureViewport& SceneColorViewport = Context.SceneColorViewport;
+		const FIntPoint ViewportSize = Context.ViewportSize;
+		const FPasses Passes = GetPasses(Context);
+
+		// One direction of the Clarity / Dynamic Contrast Gaussian.  The source
+		// region starting at SourceRect.Min maps 1:1 onto the ViewportSize output.
+		// All scratch formats (RGBA16F, R11G11B10F, R16F) must take UAV stores for the
+		// compute paths (tiled, and recursive for radii past the 48-texel kernel).
+		// The method comes from the plan inputs, as in the frame plan.
+		const bool bComputeViewBlur = Context.PlanInputs.bComputeViewBlur;
+		const ETextureCreateFlags ViewBlurFlags = bComputeViewBlur ? TexCreate_UAV : TexCreate_None;
+
+		auto AddViewBlurPass = [&](FRDGEventName&& PassName, const FToneMapGaussianKernel& Kernel, bool bVertical,
+			FRDGTextureRef Source, const FIntRect& SourceRect, FRDGTextureRef Output)
+		{
+			const EToneMapBlurMethod Method = Context.PlanInputs.GetBlurMethod(Kernel.Sigma, bComputeViewBlur);
+			if (Method != EToneMapBlurMethod::PixelShader)
+			{
+				FToneMapGaussianBlur::AddComputePass(GraphBuilder, ViewInfo.ShaderMap, Transients, MoveTemp(PassName), ERDGPassFlags::Compute,
+					Method, Kernel, bVertical, Source, SourceRect.Min, Output, ViewportSize);
+				return;
+			}
+
+			FToneMapGaussianBlur::AddPixelShaderPass(GraphBuilder, ViewInfo.ShaderMap, MoveTemp(PassName),
+				Kernel, bVertical, Source, SourceRect, Output, ViewportSize, ViewInfo.ViewUniformBuffer);
+		};
+
+		// Luma-only local contrast: the blurs read one R16F luminance extracted
+		// once per frame and the main pass rebuilds colour from per-pixel ratios.
+		// A local Correct Color Cast (r.ToneMapFX.GlobalColorCast=0) needs the
+		// neighbourhood's chroma, so its coarse blur stays RGB.  LumaOnlyBlurs
+		// tells the main pass which blurs are luma.
+		const FIntRect BlurRect(0, 0, ViewportSize.X, ViewportSize.Y);
+		FVector3f& LumaOnlyBlurs = Context.LumaOnlyBlurs;
+		FRDGTextureRef LocalContrastLuma = nullptr;
+
+		auto GetLocalContrastLuma = [&]() -> FRDGTextureRef
+		{
+			if (!LocalContrastLuma)
+			{
+				LocalContrastLuma = Transients.Create(ViewportSize, EToneMapIntermediate::Luminance, TEXT("ToneMap.LocalContrastLuma"));
+
+				auto* P = GraphBuilder.AllocParameters<FToneMapLocalContrastLumaPS::FParameters>();
+				P->SourceTexture = SceneColor.Texture;
+				P->SourceOrigin  = SceneColorViewport.Rect.Min;
+				P->RenderTargets[0] = FRenderTargetBinding(LocalContrastLuma, ERenderTargetLoadAction::ENoAction);
+
+				TShaderMapRef<FToneMapLocalContrastLumaPS> LumaShader(ViewInfo.ShaderMap);
+				AddToneMapFullscreenPass(
+					GraphBuilder, ViewInfo.ShaderMap,
+					RDG_EVENT_NAME("ToneMap_LocalContrastLuma"), LumaShader, P, BlurRect);
+			}
+			return LocalContrastLuma;
+		};
+
+		FRDGTextureRef& BlurredTexture = Context.BlurredTexture; // unset: no blur
+
+		if (Passes.bClarity)
+		{
+			// Clarity subtracts the blur from the pixel and the detail signal is small,
+			// so a colour blur stays RGBA16F (EToneMapIntermediate::Color) and a luma
+			// blur (r.ToneMapFX.LumaLocalContrast) R16F (EToneMapIntermediate::Luminance).
+			if (Passes.bGuidedClarity)
+			{
+				// Edge-aware base from the guided filter — constant cost for any radius
+				BlurredTexture = FToneMapGuidedFilter::AddClarityBasePasses(
+					GraphBuilder, ViewInfo.ShaderMap, Transients,
+					SceneColor.Texture, SceneColorViewport.Rect, ViewportSize,
+					Quality.ClarityRadius, Settings.ClarityEdgeThreshold);
+			}
+			else
+			{
+				const FToneMapGaussianKernel ClarityKernel = FToneMapGaussianKernel::Build(Quality.ClarityRadius);
+				const EToneMapIntermediate ClarityUsage = Passes.bLumaClarity ? EToneMapIntermediate::Luminance : EToneMapIntermediate::Color;
+				FRDGTextureRef ClaritySource = Passes.bLumaClarity ? GetLocalContrastLuma() : SceneColor.Texture;
+				LumaOnlyBlurs.X = Passes.bLumaClarity ? 1.0f : 0.0f;
+
+				FRDGTextureRef HBlurTexture = Transients.Create(ViewportSize, ClarityUsage, TEXT("ToneMap.HBlur"), ViewBlurFlags);
+				AddViewBlurPass(RDG_EVENT_NAME("ToneMap_HBlur"), ClarityKernel, false,
+					ClaritySource, Passes.bLumaClarity ? BlurRect : SceneColorViewport.Rect, HBlurTexture);
+
+				FRDGTextureRef VBlurTexture = Transients.Create(ViewportSize, ClarityUsage, TEXT("ToneMap.VBlur"), ViewBlurFlags);
+				AddViewBlurPass(RDG_EVENT_NAME("ToneMap_VBlur"), ClarityKernel, true,
+					HBlurTexture, FIntRect(0, 0, ViewportSize.X, ViewportSize.Y), VBlurTexture);
+
+				// Horizontal scratch is dead — Dynamic Contrast's fine H pass picks it up
+				Transients.Release(HBlurTexture);
+				BlurredTexture = VBlurTexture;
+			}
+		}
+
+		// =====================================================================
+		// Dynamic Contrast blur passes — Fine (radius 2) and Coarse (radius 32)
+		// Generates 3-scale blur pyramid for multi-scale local contrast.
+		// Skipped entirely when all Dynamic Contrast sliders are zero.
+		// =====================================================================
+
+		// Correct Color Cast reads the frame-average colour (r.ToneMapFX.GlobalColorCast)
+		// rather than the coarse blur; on its own it then needs no blur passes at all.
+		Context.bGlobalColorCast = Passes.bGlobalColorCast;
+		if (Passes.bGlobalColorCast)
+		{
+			Context.SceneAverageColorTexture = FToneMapColorAverage::AddPasses(
+				GraphBuilder, ViewInfo.ShaderMap, Transients, SceneColor.Texture, SceneColorViewport.Rect,
+				*Context.ColorAverageRT, Context.DeltaTime);
+		}
+
+		FRDGTextureRef& BlurredFineTexture   = Context.BlurredFineTexture;
+		FRDGTextureRef& BlurredCoarseTexture = Context.BlurredCoarseTexture;
+
+		if (Passes.bFine || Passes.bCoarse)
+		{
+			// Helper lambda: run a separable H+V Gaussian blur pass pair
+			auto RunBlurPair = [&](FRDGTextureRef InputTexture, const FIntRect& InputRect,
+				float Radius, EToneMapIntermediate Usage,
+				const TCHAR* NameH, const TCHAR* NameV,
+				const TCHAR* TexNameH, const TCHAR* TexNameV) -> FRDGTextureRef
+			{
+				const FToneMapGaussianKernel Kernel = FToneMapGaussianKernel::Build(Radius);
+
+				FRDGTextureRef HTex = Transients.Create(ViewportSize, Usage, TexNameH, ViewBlurFlags);
+				AddViewBlurPass(FRDGEventName(NameH), Kernel, false, InputTexture, InputRect, HTex);
+
+				FRDGTextureRef VTex = Transients.Create(ViewportSize, Usage, TexNameV, ViewBlurFlags);
+				AddViewBlurPass(FRDGEventName(NameV), Kernel, true, HTex, FIntRect(0, 0, ViewportSize.X, ViewportSize.Y), VTex);
+
+				Transients.Release(HTex);
+				return VTex;
+			};
+
+			// Fine blur: radius 2 — captures high-frequency surface detail
+			if (Passes.bLumaFine)
+			{
+				BlurredFineTexture = RunBlurPair(
+					GetLocalContrastLuma(), BlurRect, 2.0f, EToneMapIntermediate::Luminance,
+					TEXT("ToneMap_DynamicContrast_FineH"), TEXT("ToneMap_DynamicContrast_FineV"),
+					TEXT("ToneMap.DynamicContrast.FineH"), TEXT("ToneMap.DynamicContrast.FineV"));
+				LumaOnlyBlurs.Y = 1.0f;
+			}
+			else if (Passes.bFine)
+			{
+				BlurredFineTexture = RunBlurPair(
+					SceneColor.Texture, SceneColorViewport.Rect, 2.0f, EToneMapIntermediate::Color,
+					TEXT("ToneMap_DynamicContrast_FineH"), TEXT("ToneMap_DynamicContrast_FineV"),
+					TEXT("ToneMap.DynamicContrast.FineH"), TEXT("ToneMap.DynamicContrast.FineV"));
+			}
+
+			// Coarse blur: radius 32 — captures large-scale tonal structure.
+			// Low-frequency, so R11G11B10F scratch is within the error budget.
+			if (Passes.bLumaCoarse)
+			{
+				BlurredCoarseTexture = RunBlurPair(
+					GetLocalContrastLuma(), BlurRect, 32.0f, EToneMapIntermediate::Luminance,
+					TEXT("ToneMap_DynamicContrast_CoarseH"), TEXT("ToneMap_DynamicContrast_CoarseV"),
+					TEXT("ToneMap.DynamicContrast.CoarseH"), TEXT("ToneMap.DynamicContrast.CoarseV"));
+				LumaOnlyBlurs.Z = 1.0f;
+			}
+			else if (Passes.bCoarse)
+			{
+				BlurredCoarseTexture = RunBlurPair(
+					SceneColor.Texture, SceneColorViewport.Rect, 32.0f, EToneMapIntermediate::BlurScratch,
+					TEXT("ToneMap_DynamicContrast_CoarseH"), TEXT("ToneMap_DynamicContrast_CoarseV"),
+					TEXT("ToneMap.DynamicContrast.CoarseH"), TEXT("ToneMap.DynamicContrast.CoarseV"));
+			}
+		}
+
+		// Every luma blur has been added to the graph
+		Transients.Release(LocalContrastLuma);
+	}
+
+private:
+	// Which blurs run, and which of them are luma — what DeclareResources and AddPasses both run
+	struct FPasses
+	{
+		bool bClarity = false;
+		bool bGuidedClarity = false;
+		bool bLumaClarity = false;
+		bool bGlobalColorCast = false;
+		bool bFine = false;
+		bool bLumaFine = false;
+		bool bCoarse = false;
+		bool bLumaCoarse = false;
+	};
+
+	static FPasses GetPasses(const FToneMapStageContext& Context)
+	{
+		const UToneMapComponent& Settings = Context.Settings;
+		const bool bLumaLocalContrast = CVarToneMapLumaLocalContrast.GetValueOnRenderThread() != 0;
+
+		FPasses Passes;
+		Passes.bClarity       = FMath::Abs(Settings.Clarity) > 0.01f;
+		Passes.bGuidedClarity = Passes.bClarity && Settings.ClarityMode == EToneMapClarityMode::GuidedFilter && FToneMapGuidedFilter::IsSupported();
+		Passes.bLumaClarity   = Passes.bClarity && !Passes.bGuidedClarity && bLumaLocalContrast;
+
+		// Fine feeds Dynamic Contrast only; coarse also feeds Correct Contrast and
+		// the local Correct Color Cast, which needs the neighbourhood's chroma
+		Passes.bGlobalColorCast = Settings.CorrectColorCast > 0.01f && FToneMapColorAverage::UseGlobal_RenderThread();
+		const bool bLocalColorCast = Settings.CorrectColorCast > 0.01f && !Passes.bGlobalColorCast;
+		Passes.bFine       = Settings.DynamicContrast > 0.01f;
+		Passes.bLumaFine   = Passes.bFine && bLumaLocalContrast;
+		Passes.bCoarse     = Passes.bFine || Settings.CorrectContrast > 0.01f || bLocalColorCast;
+		Passes.bLumaCoarse = Passes.bCoarse && bLumaLocalContrast && !bLocalColorCast;
+		return Passes;
+	}
+};
+
+// =============================================================================
+// Durand-Dorsey 2002 Bilateral Tone Mapping — pre-pass
+// Runs before ToneMapProcess; the pre-tone-mapped result makes it skip the film curve.
+// =============================================================================
+
+class FToneMapDurandStage final : public IToneMapStage
+{
+public:
+	virtual const TCHAR* GetName() const override { return TEXT("Durand"); }
+
+	virtual bool IsActive(const FToneMapStageContext& Context) const override
+	{
+		return FToneMapFramePlanner::WantsStage(EToneMapPlanStage::Durand, Context.Settings, Context.PlanInputs)
+			&& FToneMapShaderStripping::IsAvailable_RenderThread(EToneMapShaderFeature::Durand, Context.ShaderPlatform);
+	}
+
+	virtual void DeclareResources(const FToneMapStageContext& Context, FToneMapStageResources& OutResources) const override
+	{
+		const FIntPoint WS = Context.ViewportSize;
+		OutResources.Add(TEXT("ToneMapDurand.LogLum"), WS, EToneMapIntermediate::LogLuminance);
+		OutResources.Add(TEXT("ToneMapDurand.BasePing"), WS, EToneMapIntermediate::LogLuminance);
+		OutResources.Add(TEXT("ToneMapDurand.BasePong"), WS, EToneMapIntermediate::LogLuminance);
+		OutResources.Add(TEXT("ToneMapDurand.Result"), WS, EToneMapIntermediate::Color);
+	}
+
+	virtual void AddPasses(FToneMapStageContext& Context) const override
+	{
+		FRDGBuilder& GraphBuilder = Context.GraphBuilder;
+		const FViewInfo& ViewInfo = Context.ViewInfo;
+		const UToneMapComponent& Settings = Context.Settings;
+		const FToneMapViewSetup& Setup = Context.Setup;
+		FToneMapTransientTextures& Transients = Context.Transients;
+		const FScreenPassTexture& SceneColor = Context.SceneColor;
+
+		RDG_EVENT_SCOPE(GraphBuilder, "ToneMapFX_Durand");
+
+		const FIntPoint WS = Context.ViewportSize;
+		const FVector4f BilateralBufferSize = Setup.WorkSizeAndInvSize;
+		const FScreenTransform DurandSceneColorUV = Setup.WorkSceneColorUV;
+
+		// --- Pass 1: log-luminance ---
+		FRDGTextureRef LogLumTex = Transients.Create(WS, EToneMapIntermediate::LogLuminance, TEXT("ToneMapDurand.LogLum"));
+
+		{
+			auto* P1 = GraphBuilder.AllocParameters<FToneMapDurandLogLumPS::FParameters>();
+			P1->View = ViewInfo.ViewUniformBuffer;
+			P1->SceneColorTexture = SceneColor.Texture;
+			P1->SceneColorSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			P1->SvPositionToSceneColorUV = DurandSceneColorUV;
+			P1->OneOverPreExposure = 1.0f / FMath::Max(ViewInfo.PreExposure, 0.001f);
+			P1->RenderTargets[0] = FRenderTargetBinding(LogLumTex, ERenderTargetLoadAction::ENoAction);
+			TShaderMapRef<FToneMapDurandLogLumPS> Shader1(ViewInfo.ShaderMap);
+			AddToneMapFullscreenPass(GraphBuilder, ViewInfo.ShaderMap,
+				RDG_EVENT_NAME("DurandLogLum"), Shader1, P1, FIntRect(0, 0, WS.X, WS.Y));
+		}
+
+		// --- Pass 2a/2b: cross-bilateral filter (horizontal then vertical) ---
+		// Base layer is a smoothed log-luminance — same R16F policy as the input
+		FRDGTextureRef BasePing = Transients.Create(WS, EToneMapIntermediate::LogLuminance, TEXT("ToneMapDurand.BasePing"));
+		FRDGTextureRef BasePong = Transients.Create(WS, EToneMapIntermediate::LogLuminance, TEXT("ToneMapDurand.BasePong"));
+
+		auto RunDurandBilateral = [&](FRDGTextureRef InLogLum, FRDGTextureRef GuideLogLum,
+		                              FRDGTextureRef OutTex, FVector2f Dir, const TCHAR* EventName)
+		{
+			auto* P2 = GraphBuilder.AllocParameters<FToneMapDurandBilateralPS::FParameters>();
+			P2->View = ViewInfo.ViewUniformBuffer;
+			P2->LogLumTexture = InLogLum;
+			P2->LogLumSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			P2->GuideTexture  = GuideLogLum;
+			P2->GuideSampler  = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			P2->BufferSizeAndInvSize = BilateralBufferSize;
+			P2->BlurDirection        = Dir;
+			P2->SpatialSigma         = Settings.DurandSpatialSigma;
+			P2->RangeSigma           = Settings.DurandRangeSigma;
+			P2->RenderTargets[0]     = FRenderTargetBinding(OutTex, ERenderTargetLoadAction::ENoAction);
+			TShaderMapRef<FToneMapDurandBilateralPS> Shader2(ViewInfo.ShaderMap);
+			AddToneMapFullscreenPass(GraphBuilder, ViewInfo.ShaderMap,
+				FRDGEventName(EventName), Shader2, P2, FIntRect(0, 0, WS.X, WS.Y));
+		};
+
+		RunDurandBilateral(LogLumTex, LogLumTex, BasePing, FVector2f(1.0f, 0.0f), TEXT("DurandBilateralH"));
+		RunDurandBilateral(BasePing,  LogLumTex, BasePong, FVector2f(0.0f, 1.0f), TEXT("DurandBilateralV"));
+		Transients.Release(BasePing);
+
+		// --- Pass 3: reconstruct ---
+		FRDGTextureRef DurandResult = Transients.Create(WS, EToneMapIntermediate::Color, TEXT("ToneMapDurand.Result"));
+
+		{
+			auto* P3 = GraphBuilder.AllocParameters<FToneMapDurandReconstructPS::FParameters>();
+			P3->View = ViewInfo.ViewUniformBuffer;
+			P3->SceneColorTexture = SceneColor.Texture;
+			P3->SceneColorSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			P3->LogLumTexture    = LogLumTex;
+			P3->LogLumSampler    = TStaticSamplerState<SF_Point, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			P3->BaseLayerTexture = BasePong;
+			P3->BaseLayerSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			P3->SvPositionToSceneColorUV = DurandSceneColorUV;
+			P3->BufferSizeAndInvSize   = BilateralBufferSize;
+			P3->OneOverPreExposure = 1.0f / FMath::Max(ViewInfo.PreExposure, 0.001f);
+			P3->BaseCompression    = Settings.DurandBaseCompression;
+			P3->DetailBoost        = Settings.DurandDetailBoost;
+			P3->RenderTargets[0]   = FRenderTargetBinding(DurandResult, ERenderTargetLoadAction::ENoAction);
+			TShaderMapRef<FToneMapDurandReconstructPS> Shader3(ViewInfo.ShaderMap);
+			AddToneMapFullscreenPass(GraphBuilder, ViewInfo.ShaderMap,
+				RDG_EVENT_NAME("DurandReconstruct"), Shader3, P3, FIntRect(0, 0, WS.X, WS.Y));
+		}
+
+		Transients.Release(LogLumTex);
+		Transients.Release(BasePong);
+
+		Context.PreToneMappedTexture = DurandResult;
+	}
+};
+
+// =============================================================================
+// Fattal et al. 2002 Gradient-Domain Tone Mapping — pre-pass
+//
+// All passes run at full viewport resolution.  Seeding Jacobi with
+// log(lum) ensures partial convergence produces a valid compression ratio:
+//   ratio = exp(I_final - logLumIn)  →  < 1 on contrast edges (attenuated)
+//                                       ≈ 1 in smooth areas (preserved)
+// =============================================================================
+
+class FToneMapFattalStage final : public IToneMapStage
+{
+public:
+	virtual const TCHAR* GetName() const override { return TEXT("Fattal"); }
+
+	virtual bool IsActive(const FToneMapStageContext& Context) const override
+	{
+		return FToneMapFramePlanner::WantsStage(EToneMapPlanStage::Fattal, Context.Settings, Context.PlanInputs)
+			&& FToneMapShaderStripping::IsAvailable_RenderThread(EToneMapShaderFeature::Fattal, Context.ShaderPlatform);
+	}
+
+	virtual void DeclareResources(const FToneMapStageContext& Context, FToneMapStageResources& OutResources) const override
+	{
+		const FIntPoint WS = Context.ViewportSize;
+		OutResources.Add(TEXT("ToneMapFattal.LogLum"), WS, EToneMapIntermediate::LogLuminance);
+		OutResources.Add(TEXT("ToneMapFattal.Gradient"), WS, EToneMapIntermediate::Vector2);
+		OutResources.Add(TEXT("ToneMapFattal.DivH"), WS, EToneMapIntermediate::Scalar);
+		OutResources.Add(TEXT("ToneMapFattal.JPing"), WS, EToneMapIntermediate::Scalar);
+		OutResources.Add(TEXT("ToneMapFattal.JPong"), WS, EToneMapIntermediate::Scalar);
+		OutResources.Add(TEXT("ToneMapFattal.Result"), WS, EToneMapIntermediate::Color);
+	}
+
+	virtual void AddPasses(FToneMapStageContext& Context) const override
+	{
+		FRDGBuilder& GraphBuilder = Context.GraphBuilder;
+		const FViewInfo& ViewInfo = Context.ViewInfo;
+		const UToneMapComponent& Settings = Context.Settings;
+		const FToneMapResolvedQuality& Quality = Context.Quality;
+		const FToneMapViewSetup& Setup = Context.Setup;
+		FToneMapTransientTextures& Transients = Context.Transients;
+		const FScreenPassTexture& SceneColor = Context.SceneColor;
+
+		RDG_EVENT_SCOPE(GraphBuilder, "ToneMapFX_Fattal");
+		FToneMapScopedStageTimer FattalTimer(GraphBuilder, Context.StageTimer, EToneMapGovernedStage::Fattal);
+
+		const FIntPoint WS = Context.ViewportSize;
+		const FVector4f FattalBufferSize = Setup.WorkSizeAndInvSize;
+		const float     FattalOneOverPreExposure = 1.0f / FMath::Max(ViewInfo.PreExposure, 0.001f);
+		const FScreenTransform FattalSceneColorUV = Setup.WorkSceneColorUV;
+
+		// --- Pass 0: log-luminance (Jacobi seed) ---
+		FRDGTextureRef LogLumTex = Transients.Create(WS, EToneMapIntermediate::LogLuminance, TEXT("ToneMapFattal.LogLum"));
+		{
+			auto* Pl = GraphBuilder.AllocParameters<FToneMapFattalLogLumPS::FParameters>();
+			Pl->View = ViewInfo.ViewUniformBuffer;
+			Pl->SceneColorTexture = SceneColor.Texture;
+			Pl->SceneColorSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			Pl->SvPositionToSceneColorUV = FattalSceneColorUV;
+			Pl->OneOverPreExposure = FattalOneOverPreExposure;
+			Pl->RenderTargets[0] = FRenderTargetBinding(LogLumTex, ERenderTargetLoadAction::ENoAction);
+			TShaderMapRef<FToneMapFattalLogLumPS> ShaderL(ViewInfo.ShaderMap);
+			AddToneMapFullscreenPass(GraphBuilder, ViewInfo.ShaderMap,
+				RDG_EVENT_NAME("FattalLogLum"), ShaderL, Pl, FIntRect(0, 0, WS.X, WS.Y));
+		}
+
+		// --- Pass 1: attenuated gradient field (Hx, Hy) ---
+		FRDGTextureRef GradientTex = Transients.Create(WS, EToneMapIntermediate::Vector2, TEXT("ToneMapFattal.Gradient"));
+		{
+			auto* Pg = GraphBuilder.AllocParameters<FToneMapFattalGradientPS::FParameters>();
+			Pg->View = ViewInfo.ViewUniformBuffer;
+			Pg->SceneColorTexture = SceneColor.Texture;
+			Pg->SceneColorSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			Pg->SvPositionToSceneColorUV = FattalSceneColorUV;
+			Pg->BufferSizeAndInvSize = FattalBufferSize;
+			Pg->OneOverPreExposure   = FattalOneOverPreExposure;
+			Pg->Alpha      = Settings.FattalAlpha;
+			Pg->Beta       = Settings.FattalBeta;
+			Pg->NoiseFloor = Settings.FattalNoise;
+			Pg->RenderTargets[0] = FRenderTargetBinding(GradientTex, ERenderTargetLoadAction::ENoAction);
+			TShaderMapRef<FToneMapFattalGradientPS> ShaderG(ViewInfo.ShaderMap);
+			AddToneMapFullscreenPass(GraphBuilder, ViewInfo.ShaderMap,
+				RDG_EVENT_NAME("FattalGradient"), ShaderG, Pg, FIntRect(0, 0, WS.X, WS.Y));
+		}
+
+		// --- Pass 2: divergence div(H) ---
+		FRDGTextureRef DivHTex = Transients.Create(WS, EToneMapIntermediate::Scalar, TEXT("ToneMapFattal.DivH"));
+		{
+			auto* Pd = GraphBuilder.AllocParameters<FToneMapFattalDivergencePS::FParameters>();
+			Pd->View = ViewInfo.ViewUniformBuffer;
+			Pd->GradientTexture = GradientTex;
+			Pd->GradientSampler = TStaticSamplerState<SF_Point, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			Pd->BufferSizeAndInvSize = FattalBufferSize;
+			Pd->RenderTargets[0] = FRenderTargetBinding(DivHTex, ERenderTargetLoadAction::ENoAction);
+			TShaderMapRef<FToneMapFattalDivergencePS> ShaderD(ViewInfo.ShaderMap);
+			AddToneMapFullscreenPass(GraphBuilder, ViewInfo.ShaderMap,
+				RDG_EVENT_NAME("FattalDivergence"), ShaderD, Pd, FIntRect(0, 0, WS.X, WS.Y));
+		}
+		Transients.Release(GradientTex);
+
+		// --- Pass 3: Jacobi Poisson solver (seeded with log-lum) ---
+		// The iterate accumulates over up to 200 passes — keep it in R32F.
+		FRDGTextureRef JPing = Transients.Create(WS, EToneMapIntermediate::Scalar, TEXT("ToneMapFattal.JPing"));
+		FRDGTextureRef JPong = Transients.Create(WS, EToneMapIntermediate::Scalar, TEXT("ToneMapFattal.JPong"));
+
+		FRDGTextureRef JCurrent = LogLumTex; // seed: logLum gives useful partial-convergence
+		const int32 FattalIters = Quality.FattalIterations;
+		for (int32 It = 0; It < FattalIters; ++It)
+		{
+			FRDGTextureRef JOut = (It % 2 == 0) ? JPing : JPong;
+			auto* Pj = GraphBuilder.AllocParameters<FToneMapFattalJacobiPS::FParameters>();
+			Pj->View = ViewInfo.ViewUniformBuffer;
+			Pj->CurrentITexture = JCurrent;
+			Pj->CurrentISampler = TStaticSamplerState<SF_Point, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			Pj->DivHTexture     = DivHTex;
+			Pj->DivHSampler     = TStaticSamplerState<SF_Point, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			Pj->BufferSizeAndInvSize = FattalBufferSize;
+			Pj->RenderTargets[0] = FRenderTargetBinding(JOut, ERenderTargetLoadAction::ENoAction);
+			TShaderMapRef<FToneMapFattalJacobiPS> ShaderJ(ViewInfo.ShaderMap);
+			AddToneMapFullscreenPass(GraphBuilder, ViewInfo.ShaderMap,
+				RDG_EVENT_NAME("FattalJacobi"), ShaderJ, Pj, FIntRect(0, 0, WS.X, WS.Y));
+			JCurrent = JOut;
+		}
+
+		// Only the solved iterate is read from here on
+		Transients.Release(LogLumTex);
+		Transients.Release(DivHTex);
+		Transients.Release(JCurrent == JPing ? JPong : JPing);
+
+		// --- Pass 4: reconstruct ---
+		FRDGTextureRef FattalResult = Transients.Create(WS, EToneMapIntermediate::Color, TEXT("ToneMapFattal.Result"));
+		{
+			auto* Pr = GraphBuilder.AllocParameters<FToneMapFattalReconstructPS::FParameters>();
+			Pr->View = ViewInfo.ViewUniformBuffer;
+			Pr->SceneColorTexture = SceneColor.Texture;
+			Pr->SceneColorSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			Pr->SolvedITexture    = JCurrent;
+			Pr->SolvedISampler    = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			Pr->SvPositionToSceneColorUV = FattalSceneColorUV;
+			Pr->BufferSizeAndInvSize     = FattalBufferSize;
+			Pr->OneOverPreExposure = FattalOneOverPreExposure;
+			Pr->OutputSaturation   = Settings.FattalSaturation;
+			Pr->RenderTargets[0]   = FRenderTargetBinding(FattalResult, ERenderTargetLoadAction::ENoAction);
+			TShaderMapRef<FToneMapFattalReconstructPS> ShaderR(ViewInfo.ShaderMap);
+			AddToneMapFullscreenPass(GraphBuilder, ViewInfo.ShaderMap,
+				RDG_EVENT_NAME("FattalReconstruct"), ShaderR, Pr, FIntRect(0, 0, WS.X, WS.Y));
+		}
+		Transients.Release(JCurrent);
+
+		Context.PreToneMappedTexture = FattalResult;
+	}
+};
+
+// =============================================================================
+// Lens Effects — Ciliary Corona and Lenticular Halo
+// Runs after bloom composite; composites the effects onto current SceneColor.
+// =============================================================================
+
+class FToneMapLensStage final : public IToneMapStage
+{
+public:
+	virtual const TCHAR* GetName() const override { return TEXT("Lens"); }
+
+	virtual bool IsActive(const FToneMapStageContext& Context) const override
+	{
+		const FPasses Passes = GetPasses(Context);
+		return Passes.bCorona || Passes.bHalo;
+	}
+
+	virtual void DeclareResources(const FToneMapStageContext& Context, FToneMapStageResources& OutResources) const override
+	{
+		const FPasses Passes = GetPasses(Context);
+		const FIntPoint LS = Context.Setup.LensSize;
+		OutResources.Add(TEXT("ToneMapLens.BrightPass"), LS, EToneMapIntermediate::BlurScratch);
+		if (Passes.bCorona)
+		{
+			OutResources.Add(TEXT("ToneMapLens.Corona"), LS, EToneMapIntermediate::BlurScratch);
+		}
+		if (Passes.bHalo)
+		{
+			OutResources.Add(TEXT("ToneMapLens.Halo"), LS, EToneMapIntermediate::BlurScratch);
+		}
+		OutResources.Add(TEXT("ToneMapLens.Composite"), Context.ViewportSize, Context.SceneColor.Texture->Desc.Format);
+	}
+
+	virtual void AddPasses(FToneMapStageContext& Context) const override
+	{
+		FRDGBuilder& GraphBuilder = Context.GraphBuilder;
+		const FViewInfo& ViewInfo = Context.ViewInfo;
+		const UToneMapComponent& Settings = Context.Settings;
+		const FToneMapResolvedQuality& Quality = Context.Quality;
+		const FToneMapViewSetup& Setup = Context.Setup;
+		FToneMapTransientTextures& Transients = Context.Transients;
+		FScreenPassTexture& SceneColor = Context.SceneColor;
+
+		const FPasses Passes = GetPasses(Context);
+		const bool bCorona = Passes.bCorona;
+		const bool bHalo   = Passes.bHalo;
+
+		RDG_EVENT_SCOPE(GraphBuilder, "ToneMapFX_LensEffects");
+		FToneMapScopedStageTimer LensTimer(GraphBuilder, Context.StageTimer, EToneMapGovernedStage::LensEffects);
+
+		const FIntPoint WS = Context.ViewportSize;
+
+		// Bright pass, corona and halo run at the quality tier's lens resolution;
+		// the composite upsamples them bilinearly at full working size.
+		const FIntPoint LS = Setup.LensSize;
+		const FVector4f LensBufferSize = Setup.LensSizeAndInvSize;
+
+		const FScreenTransform LensSceneColorUV = Setup.WorkSceneColorUV;
+		const FScreenTransform LensBufferSceneColorUV = Setup.LensBufferSceneColorUV;
+		const FScreenTransform LensBrightPassUV = Setup.LensBrightPassUV;
+		const FScreenTransform LensCompositeLensUV = Setup.LensCompositeLensUV;
+
+		// Use the lower of the two thresholds for the shared bright-pass
+		const float BrightPassThreshold = (bCorona && bHalo)
+			? FMath::Min(Settings.CoronaThreshold, Settings.HaloThreshold)
+			: (bCorona ? Settings.CoronaThreshold : Settings.HaloThreshold);
+
+		// Bright pass, corona and halo are soft additive layers — R11G11B10F scratch.
+		// (The bright-pass alpha weight is never read downstream.)
+		const EToneMapStageQueue LensQueue = FToneMapComputeStage::GetQueue_RenderThread(
+			Transients.GetFormatForUsage(EToneMapIntermediate::BlurScratch));
+		const ETextureCreateFlags LensFlags = FToneMapComputeStage::GetOutputFlags(LensQueue);
+
+		FRDGTextureRef BrightPassTex = Transients.Create(LS, EToneMapIntermediate::BlurScratch, TEXT("ToneMapLens.BrightPass"), LensFlags);
+
+		{
+			FToneMapLensBrightPassParameters Pb;
+			Pb.View = ViewInfo.ViewUniformBuffer;
+			Pb.SceneColorTexture = SceneColor.Texture;
+			Pb.SceneColorSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			Pb.SvPositionToSceneColorUV = LensBufferSceneColorUV;
+			Pb.Threshold = BrightPassThreshold;
+
+			AddToneMapStagePass<FToneMapLensBrightPassPS, FToneMapLensBrightPassCS>(GraphBuilder, ViewInfo.ShaderMap,
+				RDG_EVENT_NAME("LensBrightPass"), LensQueue, Pb, BrightPassTex, FIntRect(0, 0, LS.X, LS.Y), ERenderTargetLoadAction::ENoAction);
+		}
+
+		FRDGTextureRef LensCoronaTex = SceneColor.Texture; // fallback
+		FRDGTextureRef LensHaloTex   = SceneColor.Texture; // fallback
+
+		// Corona streaks
+		if (bCorona)
+		{
+			FRDGTextureRef CoronaOut = Transients.Create(LS, EToneMapIntermediate::BlurScratch, TEXT("ToneMapLens.Corona"), LensFlags);
+
+			FToneMapCoronaStreakParameters Pc;
+			Pc.View = ViewInfo.ViewUniformBuffer;
+			Pc.BrightPassTexture = BrightPassTex;
+			Pc.BrightPassSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			Pc.SvPositionToBrightPassUV = LensBrightPassUV;
+			Pc.BufferSizeAndInvSize = LensBufferSize;
+			Pc.SpikeCount           = Settings.CoronaSpikeCount;
+			Pc.SpikeLength          = Quality.CoronaSpikeLength;
+			Pc.CoronaIntensity      = Settings.CoronaIntensity;
+
+			AddToneMapStagePass<FToneMapCoronaStreakPS, FToneMapCoronaStreakCS>(GraphBuilder, ViewInfo.ShaderMap,
+				RDG_EVENT_NAME("CoronaStreaks"), LensQueue, Pc, CoronaOut, FIntRect(0, 0, LS.X, LS.Y), ERenderTargetLoadAction::ENoAction);
+
+			LensCoronaTex = CoronaOut;
+		}
+
+		// Lenticular halo ring
+		if (bHalo)
+		{
+			FRDGTextureRef HaloOut = Transients.Create(LS, EToneMapIntermediate::BlurScratch, TEXT("ToneMapLens.Halo"), LensFlags);
+
+			FToneMapHaloRingParameters Ph;
+			Ph.View = ViewInfo.ViewUniformBuffer;
+			Ph.BrightPassTexture = BrightPassTex;
+			Ph.BrightPassSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			Ph.SvPositionToBrightPassUV = LensBrightPassUV;
+			Ph.BufferSizeAndInvSize = LensBufferSize;
+			Ph.HaloRadius    = Settings.HaloRadius;
+			Ph.HaloThickness = Settings.HaloThickness;
+			Ph.HaloIntensity = Settings.HaloIntensity;
+			Ph.HaloTint      = FVector3f(Settings.HaloTint.R, Settings.HaloTint.G, Settings.HaloTint.B);
+			Ph.HaloAngularSamples = Quality.HaloAngularSamples;
+
+			AddToneMapStagePass<FToneMapHaloRingPS, FToneMapHaloRingCS>(GraphBuilder, ViewInfo.ShaderMap,
+				RDG_EVENT_NAME("HaloRing"), LensQueue, Ph, HaloOut, FIntRect(0, 0, LS.X, LS.Y), ERenderTargetLoadAction::ENoAction);
+
+			LensHaloTex = HaloOut;
+		}
+
+		// The last pass of the (possibly async) chain — time it until its result is ready
+		LensTimer.SetOutput(bHalo ? LensHaloTex : LensCoronaTex);
+		Transients.Release(BrightPassTex);
+
+		// Composite lens effects onto scene color
+		FRDGTextureRef LensCompositeOut = Transients.CreateFromDesc(
+			FRDGTextureDesc::Create2D(WS, SceneColor.Texture->Desc.Format, FClearValueBinding::None,
+			    TexCreate_ShaderResource | TexCreate_RenderTargetable),
+			TEXT("ToneMapLens.Composite"));
+
+		{
+			auto* Plc = GraphBuilder.AllocParameters<FToneMapLensCompositePS::FParameters>();
+			Plc->View = ViewInfo.ViewUniformBuffer;
+			Plc->SceneColorTexture = SceneColor.Texture;
+			Plc->SceneColorSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			Plc->CoronaTexture     = LensCoronaTex;
+			Plc->CoronaSampler     = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			Plc->HaloTexture       = LensHaloTex;
+			Plc->HaloSampler       = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			Plc->SvPositionToSceneColorUV = LensSceneColorUV;
+			Plc->SvPositionToLensUV       = LensCompositeLensUV;
+			Plc->bEnableCorona = bCorona ? 1.0f : 0.0f;
+			Plc->bEnableHalo   = bHalo   ? 1.0f : 0.0f;
+			Plc->RenderTargets[0] = FRenderTargetBinding(LensCompositeOut, ERenderTargetLoadAction::ENoAction);
+			TShaderMapRef<FToneMapLensCompositePS> ShaderLC(ViewInfo.ShaderMap);
+			AddToneMapFullscreenPass(GraphBuilder, ViewInfo.ShaderMap,
+				RDG_EVENT_NAME("LensEffectsComposite"), ShaderLC, Plc, FIntRect(0, 0, WS.X, WS.Y));
+		}
+
+		// Corona / halo fall back to SceneColor when disabled — only release real layers
+		if (bCorona) Transients.Release(LensCoronaTex);
+		if (bHalo)   Transients.Release(LensHaloTex);
+
+		// Replace SceneColor so downstream ToneMapProcess sees the lens-composited image
+		SceneColor = FScreenPassTexture(LensCompositeOut, FIntRect(0, 0, WS.X, WS.Y));
+	}
+
+private:
+	// Enabled layers whose shaders are compiled — what IsActive, DeclareResources and AddPasses all run
+	struct FPasses
+	{
+		bool bCorona = false;
+		bool bHalo = false;
+	};
+
+	static FPasses GetPasses(const FToneMapStageContext& Context)
+	{
+		const UToneMapComponent& Settings = Context.Settings;
+		const EShaderPlatform ShaderPlatform = Context.ShaderPlatform;
+
+		FPasses Passes;
+		Passes.bCorona = Settings.bEnableCiliaryCorona
+			&& FToneMapShaderStripping::IsAvailable_RenderThread(EToneMapShaderFeature::CiliaryCorona, ShaderPlatform);
+		Passes.bHalo   = Settings.bEnableLenticularHalo
+			&& FToneMapShaderStripping::IsAvailable_RenderThread(EToneMapShaderFeature::LenticularHalo, ShaderPlatform);
+		return Passes;
+	}
+};
+
+// ---------------------------------------------------------------------------
+// Baked LUT helpers
+// ---------------------------------------------------------------------------
+
+// Return a LUT baked from Grading — from the cache when the inputs are unchanged,
+// otherwise bake it and extract it into the least recently used cache slot.
+// BakeHash is GetBakeHash(Grading).  GradingBuffer may be null (transition end
+// points): one is created for the bake.
+static FRDGTextureRef GetOrBakeLUT(
+	FRDGBuilder& GraphBuilder,
+	const FViewInfo& ViewInfo,
+	TArrayView<FToneMapCachedLUT> Cache,
+	const FToneMapGradingUniformParameters& Grading,
+	uint32 BakeHash,
+	const FToneMapGradingUniformBufferRef& GradingBuffer,
+	float LUTSize,
+	const TCHAR* Name)
+{
+	const uint32 Hash = HashCombine(BakeHash, GetTypeHash(LUTSize));
+	const uint64 Frame = GFrameCounterRenderThread;
+
+	FToneMapCachedLUT* Slot = nullptr;
+	for (FToneMapCachedLUT& Entry : Cache)
+	{
+		if (Entry.Texture.IsValid() && Entry.ParameterHash == Hash)
+		{
+			Entry.LastUsedFrame = Frame;
+			return GraphBuilder.RegisterExternalTexture(Entry.Texture, Name);
+		}
+
+		// Never evict a slot another view already read or wrote this frame
+		if (Entry.LastUsedFrame != Frame && (!Slot || Entry.LastUsedFrame < Slot->LastUsedFrame))
+		{
+			Slot = &Entry;
+		}
+	}
+
+	const int32 LUTDim = (int32)LUTSize;
+	const FIntPoint LUTTextureSize(LUTDim * LUTDim, LUTDim);
+
+	// Baked LUTs stay RGBA16F regardless of the intermediate precision policy
+	FRDGTextureRef LUTTexture = GraphBuilder.CreateTexture(
+		FRDGTextureDesc::Create2D(LUTTextureSize, PF_FloatRGBA, FClearValueBinding::None,
+			TexCreate_ShaderResource | TexCreate_RenderTargetable),
+		Name);
+
+	auto* LP = GraphBuilder.AllocParameters<FToneMapCombineLUTPS::FParameters>();
+	LP->View = ViewInfo.ViewUniformBuffer;
+	LP->LUTSize = LUTSize;
+	LP->Grading = GradingBuffer.IsValid()
+		? GradingBuffer
+		: FToneMapGradingUniformBufferRef::CreateUniformBufferImmediate(Grading, UniformBuffer_SingleFrame);
+	LP->RenderTargets[0] = FRenderTargetBinding(LUTTexture, ERenderTargetLoadAction::ENoAction);
+
+	TShaderMapRef<FToneMapCombineLUTPS> CombineLUTShader(ViewInfo.ShaderMap);
+	AddToneMapFullscreenPass(
+		GraphBuilder, ViewInfo.ShaderMap,
+		RDG_EVENT_NAME("ToneMapCombineLUT"),
+		CombineLUTShader, LP,
+		FIntRect(0, 0, LUTTextureSize.X, LUTTextureSize.Y));
+
+	if (Slot)
+	{
+		// Drop the old texture now so a same-frame lookup cannot hit stale content
+		// before the extraction lands at graph execution
+		Slot->Texture.SafeRelease();
+		Slot->ParameterHash = Hash;
+		Slot->LastUsedFrame = Frame;
+		GraphBuilder.QueueTextureExtraction(LUTTexture, &Slot->Texture);
+	}
+
+	return LUTTexture;
+}
+
+// =============================================================================
+// Main Tone Map processing pass (dual-path: Per-Pixel vs LUT)
+// Scene-referred in, display-referred out — always active.
+// =============================================================================
+
+class FToneMapProcessStage final : public IToneMapStage
+{
+public:
+	virtual const TCHAR* GetName() const override { return TEXT("Process"); }
+
+	virtual bool IsActive(const FToneMapStageContext& Context) const override
+	{
+		return true;
+	}
+
+	virtual void DeclareResources(const FToneMapStageContext& Context, FToneMapStageResources& OutResources) const override
+	{
+		if (!WritesOverrideOutput(Context))
+		{
+			OutResources.Add(TEXT("ToneMap.Output"), Context.OriginalSceneColorExtent, PF_FloatRGBA);
+		}
+		DeclareChainTarget(Context, TEXT("ToneMap.PrePostPasses"), OutResources);
+	}
+
+	virtual void AddPasses(FToneMapStageContext& Context) const override
+	{
+		FRDGBuilder& GraphBuilder = Context.GraphBuilder;
+		const FSceneView& View = Context.View;
+		const FViewInfo& ViewInfo = Context.ViewInfo;
+		const FPostProcessMaterialInputs& Inputs = Context.Inputs;
+		const UToneMapComponent& Settings = Context.Settings;
+		FToneMapViewSetup& Setup = Context.Setup;
+		FToneMapTransientTextures& Transients = Context.Transients;
+		const FScreenPassTexture& SceneColor = Context.SceneColor;
+		const FIntPoint ViewportSize = Context.ViewportSize;
+		const bool bIsReplaceTonemap = Context.bIsReplaceTonemap;
+		const bool bHalfPrecision = Context.bHalfPrecision;
+		FScreenPassRenderTarget& OutputTarget = Context.OutputTarget;
+
+		// Inputs of stages that were culled stay unset — bind scene colour in their
+		// place (never sampled: the matching strength or flag is zero)
+		FRDGTextureRef BlurredTexture       = Context.BlurredTexture       ? Context.BlurredTexture       : SceneColor.Texture;
+		FRDGTextureRef BlurredFineTexture   = Context.BlurredFineTexture   ? Context.BlurredFineTexture   : SceneColor.Texture;
+		FRDGTextureRef BlurredCoarseTexture = Context.BlurredCoarseTexture ? Context.BlurredCoarseTexture : SceneColor.Texture;
+		FRDGTextureRef AdaptedLumTexture    = Context.AdaptedLumTexture;
+		FRDGTextureRef PreToneMappedTexture = Context.PreToneMappedTexture;
+		const bool bPreToneMapped = PreToneMappedTexture != nullptr;
+		const FVector3f LumaOnlyBlurs = Context.LumaOnlyBlurs;
+		const bool bGlobalColorCast = Context.bGlobalColorCast;
+		FRDGTextureRef SceneAverageColorTexture = Context.SceneAverageColorTexture;
+
+		// Engine bloom (ReplaceTonemap mode only, skipped if ClassicBloom already composited)
+		FScreenPassTexture BloomInput;
+		if (bIsReplaceTonemap && !Context.bBloomApplied)
+		{
+			FScreenPassTextureSlice BloomSlice = Inputs.GetInput(EPostProcessMaterialInput::CombinedBloom);
+			if (BloomSlice.IsValid())
+			{
+				BloomInput = FScreenPassTexture::CopyFromSlice(GraphBuilder, BloomSlice);
+			}
+		}
+
+		// ---- Output target ----
+		if (WritesOverrideOutput(Context))
+		{
+			// ReplacingTonemapper: engine provides the final backbuffer as OverrideOutput
+			// when Tonemap is the last pass (no FXAA/SMAA after). Use it directly.
+			OutputTarget = Inputs.OverrideOutput;
+		}
+		else
+		{
+			// Create an intermediate FP16 texture for downstream passes (SMAA, FXAA).
+			// Extent must match the engine's quantized scene buffer extent so that
+			// SMAA's QuantizeSceneBufferSize(Extent) is a no-op and RTMetrics are
+			// correct.  ViewRect stays (0,0)-based matching ViewportSize.
+			// EClear prevents uninitialized gap pixels between ViewRect and extent
+			// from showing as green in non-fullscreen viewports.
+			OutputTarget = FScreenPassRenderTarget(
+				Transients.CreateFromDesc(
+					FRDGTextureDesc::Create2D(
+						Context.OriginalSceneColorExtent, PF_FloatRGBA,
+						FClearValueBinding::Black,
+						TexCreate_ShaderResource | TexCreate_RenderTargetable),
+					TEXT("ToneMap.Output")),
+				FIntRect(0, 0, ViewportSize.X, ViewportSize.Y),
+				ERenderTargetLoadAction::EClear);
+		}
+
+		Context.FinalOutputTarget = OutputTarget;
+
+		// If any stage follows ToneMapProcess, redirect it to an intermediate
+		if (Context.HasStagesAfter())
+		{
+			OutputTarget = FScreenPassRenderTarget(
+				Transients.Create(ViewportSize, EToneMapIntermediate::Color, TEXT("ToneMap.PrePostPasses")),
+				FIntRect(0, 0, ViewportSize.X, ViewportSize.Y),
+				ERenderTargetLoadAction::ENoAction);
+		}
+
+		const bool bUseLUTPath = (Settings.ProcessingPath == EToneMapProcessingPath::LUT);
+
+		// Grading constants shared by every variant of the pass — only refilled
+		// when the view's settings snapshot changes
+		const FToneMapGradingUniformBufferRef GradingBuffer = Setup.Grading.Update_RenderThread(
+			Settings, Context.SettingsHash, bIsReplaceTonemap, bPreToneMapped);
+
+		if (!bUseLUTPath)
+		{
+			// =================================================================
+			// PER-PIXEL PATH — existing single-pass processing
+			// =================================================================
+			auto* P = GraphBuilder.AllocParameters<FToneMapProcessPS::FParameters>();
+			P->View              = ViewInfo.ViewUniformBuffer;
+			P->Grading           = GradingBuffer;
+			P->SceneColorTexture = SceneColor.Texture;
+			P->SceneColorSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			P->BlurredTexture    = BlurredTexture;
+			P->BlurredSampler    = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+
+			// SvPosition → ViewportUV [0,1] → texture UV.  Handles viewport offsets
+			// (e.g. OverrideOutput with non-zero Min in ReplaceTonemap mode) that caused
+			// glitches on viewport resize; cached until the output viewport changes.
+			const FIntPoint OutputExtent = FIntPoint(OutputTarget.Texture->Desc.Extent.X, OutputTarget.Texture->Desc.Extent.Y);
+			const FIntRect  OutputViewRect = OutputTarget.ViewRect;
+			const FScreenPassTextureViewport OutputVP(OutputExtent, OutputViewRect);
+			Setup.UpdateOutput(SceneColor.Texture->Desc.Extent, OutputExtent, OutputViewRect);
+
+			// SceneColor (engine-provided, may have non-zero offset) and the blurred
+			// texture (ViewportSize, rect (0,0)->(W,H), no offset)
+			P->SvPositionToSceneColorUV = Setup.OutputSceneColorUV;
+			P->SvPositionToBlurredUV = Setup.OutputWorkUV;
+
+			// Output viewport rect for split-screen comparison
+			P->OutputViewportRect = Setup.OutputViewportRect;
+
+			// ---- Bloom texture (ReplaceTonemap mode) ----
+			if (bIsReplaceTonemap && BloomInput.IsValid())
+			{
+				P->BloomTexture = BloomInput.Texture;
+				P->BloomSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+				const FScreenPassTextureViewport BloomVP(BloomInput);
+
+				// SvPosition → ViewportUV [0,1] → Bloom TextureUV
+				P->SvPositionToBloomUV = (
+					FScreenTransform::ChangeTextureBasisFromTo(OutputVP, FScreenTransform::ETextureBasis::TexelPosition, FScreenTransform::ETextureBasis::ViewportUV) *
+					FScreenTransform::ChangeTextureBasisFromTo(BloomVP, FScreenTransform::ETextureBasis::ViewportUV, FScreenTransform::ETextureBasis::TextureUV));
+			}
+			else
+			{
+				// Provide a valid fallback (scene color itself, won't be sampled when bReplaceTonemap==0)
+				P->BloomTexture = SceneColor.Texture;
+				P->BloomSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+				P->SvPositionToBloomUV = P->SvPositionToSceneColorUV;
+			}
+
+			// ---- ReplaceTonemap exposure ----
+			P->OneOverPreExposure = 1.0f / FMath::Max(ViewInfo.PreExposure, 0.001f);
+			P->GlobalExposure     = FMath::Max(View.GetLastEyeAdaptationExposure(), 0.001f);
+
+			// ---- Krawczyk adapted luminance ----
+			if (AdaptedLumTexture)
+			{
+				P->AdaptedLumTexture = AdaptedLumTexture;
+			}
+			else
+			{
+				// Provide a valid fallback (won't be sampled when mode != Krawczyk)
+				P->AdaptedLumTexture = SceneColor.Texture;
+			}
+			P->AdaptedLumSampler = TStaticSamplerState<SF_Point, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+
+			// ---- Pre-tone-mapped texture (Durand / Fattal bypass) ----
+			if (bPreToneMapped && PreToneMappedTexture)
+			{
+				P->PreToneMappedTexture = PreToneMappedTexture;
+				P->PreToneMappedSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+
+				// Pre-mapped texture lives in ViewportSize space with rect (0,0)→(W,H)
+				P->SvPositionToPreToneMappedUV = Setup.OutputWorkUV;
+			}
+			else
+			{
+				// Fallback: provide valid texture to prevent RDG null-binding assert (won't be sampled)
+				P->PreToneMappedTexture = SceneColor.Texture;
+				P->PreToneMappedSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+				P->SvPositionToPreToneMappedUV = P->SvPositionToSceneColorUV;
+			}
+
+			// --- Dynamic Contrast fine/coarse blur textures ---
+			P->BlurredFineTexture   = BlurredFineTexture;
+			P->BlurredFineSampler   = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			P->BlurredCoarseTexture = BlurredCoarseTexture;
+			P->BlurredCoarseSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			P->LumaOnlyBlurs        = LumaOnlyBlurs;
+
+			// Correct Color Cast reference: frame average (1x1) or the coarse blur
+			P->bGlobalColorCast         = bGlobalColorCast ? 1.0f : 0.0f;
+			P->SceneAverageColorTexture = bGlobalColorCast ? SceneAverageColorTexture : SceneColor.Texture;
+
+			// Fine/coarse blur textures: same layout as Clarity blurred (ViewportSize, rect 0→W,H)
+			P->SvPositionToBlurredFineUV = Setup.OutputWorkUV;
+			P->SvPositionToBlurredCoarseUV = Setup.OutputWorkUV;
+
+			P->DitherQuantization = Context.GetDitherQuantization();
+
+			P->RenderTargets[0] = FRenderTargetBinding(OutputTarget.Texture, OutputTarget.LoadAction);
+
+			FToneMapProcessPS::FPermutationDomain ProcessPermutation;
+			ProcessPermutation.Set<FToneMapHalfPrecisionDim>(bHalfPrecision);
+			TShaderMapRef<FToneMapProcessPS> ProcessShader(ViewInfo.ShaderMap, ProcessPermutation);
+			AddToneMapFullscreenPass(
+				GraphBuilder, ViewInfo.ShaderMap,
+				RDG_EVENT_NAME("ToneMapProcess"),
+				ProcessShader, P,
+				OutputTarget.ViewRect);
+		}
+		else
+		{
+			// =================================================================
+			// LUT PATH — Bake non-spatial ops into 32^3 LUT, then apply
+			// =================================================================
+			const float LUTDim = 32.0f;
+
+			// --- Step 1: Baked LUT(s) ---
+			// The LUT is only rebaked when its inputs change.  During a preset
+			// transition both end points are baked once and ApplyLUT blends them,
+			// so the transition costs the same as a static frame.
+			FRDGTextureRef BakedLUTTexture = nullptr;
+			FRDGTextureRef BlendLUTTexture = nullptr;
+			float LUTBlendAlpha = 0.0f;
+
+			const FToneMapLUTBlend& LUTBlend = Settings.LUTBlend;
+			if (LUTBlend.From && LUTBlend.To)
+			{
+				FToneMapGradingUniformParameters EndPoint;
+				FToneMapGradingParameters::Fill(EndPoint, *LUTBlend.From, bIsReplaceTonemap, bPreToneMapped);
+				BakedLUTTexture = GetOrBakeLUT(GraphBuilder, ViewInfo, Context.LUTCache, EndPoint, FToneMapGradingParameters::GetBakeHash(EndPoint),
+					FToneMapGradingUniformBufferRef(), LUTDim, TEXT("ToneMap.TransitionLUTFrom"));
+
+				FToneMapGradingParameters::Fill(EndPoint, *LUTBlend.To, bIsReplaceTonemap, bPreToneMapped);
+				BlendLUTTexture = GetOrBakeLUT(GraphBuilder, ViewInfo, Context.LUTCache, EndPoint, FToneMapGradingParameters::GetBakeHash(EndPoint),
+					FToneMapGradingUniformBufferRef(), LUTDim, TEXT("ToneMap.TransitionLUTTo"));
+
+				LUTBlendAlpha = LUTBlend.Alpha;
+			}
+			else
+			{
+				BakedLUTTexture = GetOrBakeLUT(GraphBuilder, ViewInfo, Context.LUTCache, Setup.Grading.Parameters, Setup.Grading.BakeHash,
+					GradingBuffer, LUTDim, TEXT("ToneMap.BakedLUT"));
+				BlendLUTTexture = BakedLUTTexture;
+			}
+
+			// --- Step 2: Apply the baked LUT + spatial ops ---
+			{
+				auto* AP = GraphBuilder.AllocParameters<FToneMapApplyLUTPS::FParameters>();
+				AP->View = ViewInfo.ViewUniformBuffer;
+				AP->Grading = GradingBuffer;
+
+				AP->SceneColorTexture = SceneColor.Texture;
+				AP->SceneColorSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+
+				AP->BakedLUTTexture = BakedLUTTexture;
+				AP->BakedLUTSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+				AP->BlendLUTTexture = BlendLUTTexture;
+				AP->LUTBlendAlpha = LUTBlendAlpha;
+				AP->LUTSize = LUTDim;
+				AP->InvLUTSize = 1.0f / LUTDim;
+
+				// Screen transforms (same as per-pixel path)
+				const FIntPoint OutputExtent = FIntPoint(OutputTarget.Texture->Desc.Extent.X, OutputTarget.Texture->Desc.Extent.Y);
+				const FIntRect  OutputViewRect = OutputTarget.ViewRect;
+				const FScreenPassTextureViewport OutputVP(OutputExtent, OutputViewRect);
+				Setup.UpdateOutput(SceneColor.Texture->Desc.Extent, OutputExtent, OutputViewRect);
+
+				AP->SvPositionToSceneColorUV = Setup.OutputSceneColorUV;
+				AP->SvPositionToBlurredUV = Setup.OutputWorkUV;
+
+				// Output viewport rect
+				AP->OutputViewportRect = Setup.OutputViewportRect;
+
+				// Bloom
+				if (bIsReplaceTonemap && BloomInput.IsValid())
+				{
+					AP->BloomTexture = BloomInput.Texture;
+					AP->BloomSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+					const FScreenPassTextureViewport BloomVP(BloomInput);
+					AP->SvPositionToBloomUV = (
+						FScreenTransform::ChangeTextureBasisFromTo(OutputVP, FScreenTransform::ETextureBasis::TexelPosition, FScreenTransform::ETextureBasis::ViewportUV) *
+						FScreenTransform::ChangeTextureBasisFromTo(BloomVP, FScreenTransform::ETextureBasis::ViewportUV, FScreenTransform::ETextureBasis::TextureUV));
+				}
+				else
+				{
+					AP->BloomTexture = SceneColor.Texture;
+					AP->BloomSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+					AP->SvPositionToBloomUV = AP->SvPositionToSceneColorUV;
+				}
+
+				// Exposure removal
+				AP->OneOverPreExposure = 1.0f / FMath::Max(ViewInfo.PreExposure, 0.001f);
+				AP->GlobalExposure = FMath::Max(View.GetLastEyeAdaptationExposure(), 0.001f);
+
+				// Auto-Exposure (Krawczyk)
+				if (AdaptedLumTexture)
+				{
+					AP->AdaptedLumTexture = AdaptedLumTexture;
+				}
+				else
+				{
+					AP->AdaptedLumTexture = SceneColor.Texture;
+				}
+				AP->AdaptedLumSampler = TStaticSamplerState<SF_Point, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+
+				// Clarity blur
+				AP->BlurredTexture = BlurredTexture;
+				AP->BlurredSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+
+				// Dynamic Contrast blur textures
+				AP->BlurredFineTexture = BlurredFineTexture;
+				AP->BlurredFineSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+				AP->BlurredCoarseTexture = BlurredCoarseTexture;
+				AP->BlurredCoarseSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+				AP->LumaOnlyBlurs = LumaOnlyBlurs;
+				AP->bGlobalColorCast = bGlobalColorCast ? 1.0f : 0.0f;
+				AP->SceneAverageColorTexture = bGlobalColorCast ? SceneAverageColorTexture : SceneColor.Texture;
+				AP->SvPositionToBlurredFineUV = Setup.OutputWorkUV;
+				AP->SvPositionToBlurredCoarseUV = Setup.OutputWorkUV;
+
+				// Pre-tone-mapped (Durand/Fattal)
+				if (bPreToneMapped && PreToneMappedTexture)
+				{
+					AP->PreToneMappedTexture = PreToneMappedTexture;
+					AP->PreToneMappedSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+					AP->SvPositionToPreToneMappedUV = Setup.OutputWorkUV;
+				}
+				else
+				{
+					AP->PreToneMappedTexture = SceneColor.Texture;
+					AP->PreToneMappedSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+					AP->SvPositionToPreToneMappedUV = AP->SvPositionToSceneColorUV;
+				}
+
+				// Dithering
+				AP->DitherQuantization = Context.GetDitherQuantization();
+
+				AP->RenderTargets[0] = FRenderTargetBinding(OutputTarget.Texture, OutputTarget.LoadAction);
+
+				FToneMapApplyLUTPS::FPermutationDomain ApplyLUTPermutation;
+				ApplyLUTPermutation.Set<FToneMapHalfPrecisionDim>(bHalfPrecision);
+				TShaderMapRef<FToneMapApplyLUTPS> ApplyLUTShader(ViewInfo.ShaderMap, ApplyLUTPermutation);
+				AddToneMapFullscreenPass(
+					GraphBuilder, ViewInfo.ShaderMap,
+					RDG_EVENT_NAME("ToneMapApplyLUT"),
+					ApplyLUTShader, AP,
+					OutputTarget.ViewRect);
+			}
+		}
+
+		// Everything upstream of the grading pass has been consumed — hand the
+		// blur / pre-tone-map / scene-colour intermediates to the post-pass chain.
+		// (Fallback bindings alias SceneColor; Release ignores duplicates and
+		// textures the tracker does not own.)
+		Transients.Release(BlurredTexture);
+		Transients.Release(BlurredFineTexture);
+		Transients.Release(BlurredCoarseTexture);
+		Transients.Release(PreToneMappedTexture);
+		Transients.Release(SceneColor.Texture);
+	}
+
+private:
+	// ReplacingTonemapper hands over the backbuffer when nothing follows Tonemap —
+	// the one output DeclareResources and AddPasses both leave out
+	static bool WritesOverrideOutput(const FToneMapStageContext& Context)
+	{
+		return Context.bIsReplaceTonemap && Context.Inputs.OverrideOutput.IsValid();
+	}
+};
+
+// =============================================================================
+// Sharpening — runs after ToneMapProcess, before LUT
+// =============================================================================
+
+class FToneMapSharpenStage final : public IToneMapStage
+{
+public:
+	virtual const TCHAR* GetName() const override { return TEXT("Sharpen"); }
+
+	virtual bool IsActive(const FToneMapStageContext& Context) const override
+	{
+		return FToneMapFramePlanner::WantsStage(EToneMapPlanStage::Sharpen, Context.Settings, Context.PlanInputs);
+	}
+
+	virtual void DeclareResources(const FToneMapStageContext& Context, FToneMapStageResources& OutResources) const override
+	{
+		DeclareChainTarget(Context, TEXT("ToneMap.PreLUT"), OutResources);
+	}
+
+	virtual void AddPasses(FToneMapStageContext& Context) const override
+	{
+		FRDGBuilder& GraphBuilder = Context.GraphBuilder;
+		const FViewInfo& ViewInfo = Context.ViewInfo;
+		const UToneMapComponent& Settings = Context.Settings;
+		const FScreenPassRenderTarget& OutputTarget = Context.OutputTarget;
+		const FIntPoint ViewportSize = Context.ViewportSize;
+		const bool bHalfPrecision = Context.bHalfPrecision;
+
+		// Another intermediate when a later stage follows, otherwise the final output
+		const FScreenPassRenderTarget SharpenOutputTarget = Context.CreateChainTarget(TEXT("ToneMap.PreLUT"));
+
+		auto* SP = GraphBuilder.AllocParameters<FToneMapSharpenPS::FParameters>();
+		SP->View              = ViewInfo.ViewUniformBuffer;
+		SP->SceneColorTexture = OutputTarget.Texture;  // ToneMapProcess output
+		SP->SceneColorSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+
+		// UV transform: SvPosition in SharpenOutputTarget → UV in ToneMapProcess intermediate
+		const FIntPoint SharpenOutExtent(SharpenOutputTarget.Texture->Desc.Extent.X,
+		                                 SharpenOutputTarget.Texture->Desc.Extent.Y);
+		const FScreenPassTextureViewport SharpenOutVP(SharpenOutExtent, SharpenOutputTarget.ViewRect);
+		const FScreenPassTextureViewport PreSharpenVP(
+			ViewportSize, FIntRect(0, 0, ViewportSize.X, ViewportSize.Y));
+
+		SP->SvPositionToSceneColorUV = (
+			FScreenTransform::ChangeTextureBasisFromTo(SharpenOutVP,
+				FScreenTransform::ETextureBasis::TexelPosition,
+				FScreenTransform::ETextureBasis::ViewportUV) *
+			FScreenTransform::ChangeTextureBasisFromTo(PreSharpenVP,
+				FScreenTransform::ETextureBasis::ViewportUV,
+				FScreenTransform::ETextureBasis::TextureUV));
+
+		SP->SharpenAmount = Settings.SharpenAmount;
+		SP->SharpenRadius = Settings.SharpenRadius;
+		SP->TexelSize     = FVector2f(1.0f / ViewportSize.X, 1.0f / ViewportSize.Y);
+		SP->DitherQuantization = Context.GetDitherQuantization();
+
+		SP->RenderTargets[0] = FRenderTargetBinding(SharpenOutputTarget.Texture, SharpenOutputTarget.LoadAction);
+
+		FToneMapSharpenPS::FPermutationDomain SharpenPermutation;
+		SharpenPermutation.Set<FToneMapHalfPrecisionDim>(bHalfPrecision);
+		TShaderMapRef<FToneMapSharpenPS> SharpenShader(ViewInfo.ShaderMap, SharpenPermutation);
+		AddToneMapFullscreenPass(
+			GraphBuilder, ViewInfo.ShaderMap,
+			RDG_EVENT_NAME("ToneMapSharpen"),
+			SharpenShader, SP,
+			SharpenOutputTarget.ViewRect);
+
+		// Update OutputTarget so LUT/Vignette/HDR reads from sharpened output.
+		// The previous intermediate is free for the next stage to ping-pong into.
+		Context.AdvanceChain(SharpenOutputTarget);
+	}
+};
+
+// =============================================================================
+// LUT — runs after ToneMapProcess (post-tonemap, post-sRGB)
+// =============================================================================
+
+class FToneMapLUTStage final : public IToneMapStage
+{
+public:
+	virtual const TCHAR* GetName() const override { return TEXT("LUT"); }
+
+	virtual bool IsActive(const FToneMapStageContext& Context) const override
+	{
+		// The planner sees the asset; only the frame knows whether it has streamed in
+		const UToneMapComponent& Settings = Context.Settings;
+		return FToneMapFramePlanner::WantsStage(EToneMapPlanStage::LUT, Settings, Context.PlanInputs)
+			&& Settings.LUTTexture->GetResource() != nullptr
+			&& Settings.LUTTexture->GetResource()->TextureRHI != nullptr;
+	}
+
+	virtual void DeclareResources(const FToneMapStageContext& Context, FToneMapStageResources& OutResources) const override
+	{
+		DeclareChainTarget(Context, TEXT("ToneMap.PreVignette"), OutResources);
+	}
+
+	virtual void AddPasses(FToneMapStageContext& Context) const override
+	{
+		FRDGBuilder& GraphBuilder = Context.GraphBuilder;
+		const FViewInfo& ViewInfo = Context.ViewInfo;
+		const UToneMapComponent& Settings = Context.Settings;
+		const FScreenPassRenderTarget& OutputTarget = Context.OutputTarget;
+		const FIntPoint ViewportSize = Context.ViewportSize;
+
+		// Another intermediate when a later stage follows, otherwise the final output
+		const FScreenPassRenderTarget LUTOutputTarget = Context.CreateChainTarget(TEXT("ToneMap.PreVignette"));
+
+		auto* LP = GraphBuilder.AllocParameters<FToneMapLUTPS::FParameters>();
+		LP->View              = ViewInfo.ViewUniformBuffer;
+		LP->SceneColorTexture = OutputTarget.Texture;  // ToneMapProcess output
+		LP->SceneColorSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+
+		// UV transform: SvPosition in LUTOutputTarget → UV in ToneMapProcess intermediate
+		const FIntPoint LUTOutExtent(LUTOutputTarget.Texture->Desc.Extent.X,
+		                             LUTOutputTarget.Texture->Desc.Extent.Y);
+		const FScreenPassTextureViewport LUTOutVP(LUTOutExtent, LUTOutputTarget.ViewRect);
+		const FScreenPassTextureViewport PreLUTVP(
+			ViewportSize, FIntRect(0, 0, ViewportSize.X, ViewportSize.Y));
+
+		LP->SvPositionToSceneColorUV = (
+			FScreenTransform::ChangeTextureBasisFromTo(LUTOutVP,
+				FScreenTransform::ETextureBasis::TexelPosition,
+				FScreenTransform::ETextureBasis::ViewportUV) *
+			FScreenTransform::ChangeTextureBasisFromTo(PreLUTVP,
+				FScreenTransform::ETextureBasis::ViewportUV,
+				FScreenTransform::ETextureBasis::TextureUV));
+
+		// LUT texture — detect dimensions to determine cube size
+		FRHITexture* LUTRHI = Settings.LUTTexture->GetResource()->TextureRHI;
+		FRDGTextureRef LUTTex = GraphBuilder.RegisterExternalTexture(
+			CreateRenderTarget(LUTRHI, TEXT("ToneMapLUTTex")));
+		LP->LUTTexture = LUTTex;
+		LP->LUTSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+
+		// LUT cube dimension = texture height (256×16→16, 1024×32→32, 4096×64→64)
+		const float LUTSize = (float)LUTRHI->GetSizeXYZ().Y;
+		LP->LUTSize      = LUTSize;
+		LP->InvLUTSize    = 1.0f / FMath::Max(LUTSize, 1.0f);
+		LP->LUTIntensity  = Settings.LUTIntensity;
+		LP->DitherQuantization = Context.GetDitherQuantization();
+
+		LP->RenderTargets[0] = FRenderTargetBinding(LUTOutputTarget.Texture, LUTOutputTarget.LoadAction);
+
+		TShaderMapRef<FToneMapLUTPS> LUTShader(ViewInfo.ShaderMap);
+		AddToneMapFullscreenPass(
+			GraphBuilder, ViewInfo.ShaderMap,
+			RDG_EVENT_NAME("ToneMapLUT"),
+			LUTShader, LP,
+			LUTOutputTarget.ViewRect);
+
+		// Update OutputTarget so the next pass (vignette) reads from LUT output
+		Context.AdvanceChain(LUTOutputTarget);
+	}
+};
+
+// =============================================================================
+// Vignette — runs after LUT (or ToneMapProcess if no LUT)
+// =============================================================================
+
+class FToneMapVignetteStage final : public IToneMapStage
+{
+public:
+	virtual const TCHAR* GetName() const override { return TEXT("Vignette"); }
+
+	virtual bool IsActive(const FToneMapStageContext& Context) const override
+	{
+		return FToneMapFramePlanner::WantsStage(EToneMapPlanStage::Vignette, Context.Settings, Context.PlanInputs);
+	}
+
+	virtual void DeclareResources(const FToneMapStageContext& Context, FToneMapStageResources& OutResources) const override
+	{
+		DeclareChainTarget(Context, TEXT("ToneMap.PreHDREncode"), OutResources);
+	}
+
+	virtual void AddPasses(FToneMapStageContext& Context) const override
+	{
+		FRDGBuilder& GraphBuilder = Context.GraphBuilder;
+		const FViewInfo& ViewInfo = Context.ViewInfo;
+		const UToneMapComponent& Settings = Context.Settings;
+		const FScreenPassRenderTarget& OutputTarget = Context.OutputTarget;
+		const FIntPoint ViewportSize = Context.ViewportSize;
+		const bool bHalfPrecision = Context.bHalfPrecision;
+
+		// Another intermediate when a later stage follows, otherwise the final output
+		const FScreenPassRenderTarget VignetteOutputTarget = Context.CreateChainTarget(TEXT("ToneMap.PreHDREncode"));
+
+		auto* VP = GraphBuilder.AllocParameters<FToneMapVignettePS::FParameters>();
+		VP->View              = ViewInfo.ViewUniformBuffer;
+		VP->SceneColorTexture = OutputTarget.Texture;  // LUT output (or ToneMapProcess if no LUT)
+		VP->SceneColorSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+
+		// UV transform: SvPosition in VignetteOutputTarget → UV in previous pass intermediate
+		const FIntPoint VigOutExtent(VignetteOutputTarget.Texture->Desc.Extent.X,
+		                               VignetteOutputTarget.Texture->Desc.Extent.Y);
+		const FScreenPassTextureViewport VigOutVP(VigOutExtent, VignetteOutputTarget.ViewRect);
+		const FScreenPassTextureViewport PreVignetteVP(
+			ViewportSize, FIntRect(0, 0, ViewportSize.X, ViewportSize.Y));
+
+		VP->SvPositionToSceneColorUV = (
+			FScreenTransform::ChangeTextureBasisFromTo(VigOutVP,
+				FScreenTransform::ETextureBasis::TexelPosition,
+				FScreenTransform::ETextureBasis::ViewportUV) *
+			FScreenTransform::ChangeTextureBasisFromTo(PreVignetteVP,
+				FScreenTransform::ETextureBasis::ViewportUV,
+				FScreenTransform::ETextureBasis::TextureUV));
+
+		// Vignette parameters: Mode, Size, Intensity
+		VP->VignetteParams = FVector4f(
+			(float)static_cast<uint8>(Settings.VignetteMode),
+			Settings.VignetteSize,
+			Settings.VignetteIntensity,
+			(float)static_cast<uint8>(Settings.VignetteFalloff));
+		VP->FalloffExponent = Settings.VignetteFalloffExponent;
+
+		// Alpha texture (optional)
+		const bool bHasAlphaTex = Settings.bVignetteUseAlphaTexture
+			&& Settings.VignetteAlphaTexture != nullptr
+			&& Settings.VignetteAlphaTexture->GetResource() != nullptr
+			&& Settings.VignetteAlphaTexture->GetResource()->TextureRHI != nullptr;
+
+		VP->bUseAlphaTexture  = bHasAlphaTex ? 1.0f : 0.0f;
+		VP->bAlphaTextureOnly = (bHasAlphaTex && Settings.bVignetteAlphaTextureOnly) ? 1.0f : 0.0f;
+		VP->TextureChannelIndex = (float)static_cast<uint8>(Settings.VignetteTextureChannel);
+
+		if (bHasAlphaTex)
+		{
+			FRHITexture* AlphaRHI = Settings.VignetteAlphaTexture->GetResource()->TextureRHI;
+			VP->AlphaTexture = GraphBuilder.RegisterExternalTexture(
+				CreateRenderTarget(AlphaRHI, TEXT("VignetteAlphaTex")));
+		}
+		else
+		{
+			// Safe fallback — won't be sampled when bUseAlphaTexture == 0
+			VP->AlphaTexture = OutputTarget.Texture;
+		}
+		VP->AlphaSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+		VP->DitherQuantization = Context.GetDitherQuantization();
+
+		VP->RenderTargets[0] = FRenderTargetBinding(VignetteOutputTarget.Texture, VignetteOutputTarget.LoadAction);
+
+		FToneMapVignettePS::FPermutationDomain VignettePermutation;
+		VignettePermutation.Set<FToneMapHalfPrecisionDim>(bHalfPrecision);
+		TShaderMapRef<FToneMapVignettePS> VignetteShader(ViewInfo.ShaderMap, VignettePermutation);
+		AddToneMapFullscreenPass(
+			GraphBuilder, ViewInfo.ShaderMap,
+			RDG_EVENT_NAME("ToneMapVignette"),
+			VignetteShader, VP,
+			VignetteOutputTarget.ViewRect);
+
+		// Update OutputTarget so the HDR encode pass (if any) reads from Vignette output
+		Context.AdvanceChain(VignetteOutputTarget);
+	}
+};
+
+// =============================================================================
+// HDR Output Encoding — final pass (ST2084/PQ or scRGB)
+//
+// Converts sRGB-encoded output to the display's native HDR format.
+// Only runs when the display is actually in HDR mode (OutputDevice >= 3).
+// =============================================================================
+
+class FToneMapHDREncodeStage final : public IToneMapStage
+{
+public:
+	virtual const TCHAR* GetName() const override { return TEXT("HDREncode"); }
+
+	virtual bool IsActive(const FToneMapStageContext& Context) const override
+	{
+		return FToneMapFramePlanner::WantsStage(EToneMapPlanStage::HDREncode, Context.Settings, Context.PlanInputs);
+	}
+
+	virtual void DeclareResources(const FToneMapStageContext& Context, FToneMapStageResources& OutResources) const override
+	{
+		DeclareChainTarget(Context, TEXT("ToneMap.PostHDREncode"), OutResources);
+	}
+
+	virtual void AddPasses(FToneMapStageContext& Context) const override
+	{
+		FRDGBuilder& GraphBuilder = Context.GraphBuilder;
+		const FViewInfo& ViewInfo = Context.ViewInfo;
+		const UToneMapComponent& Settings = Context.Settings;
+		const FScreenPassRenderTarget& OutputTarget = Context.OutputTarget;
+
+		RDG_EVENT_SCOPE(GraphBuilder, "ToneMapFX_HDREncode");
+
+		// Normally the final output; a project stage after it gets an intermediate
+		const FScreenPassRenderTarget HDROutputTarget = Context.CreateChainTarget(TEXT("ToneMap.PostHDREncode"));
+
+		auto* HP = GraphBuilder.AllocParameters<FToneMapHDREncodePS::FParameters>();
+		HP->View              = ViewInfo.ViewUniformBuffer;
+		HP->SceneColorTexture = OutputTarget.Texture;
+		HP->SceneColorSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+
+		// UV transform: SvPosition in HDROutputTarget → UV in previous pass
+		const FIntPoint HDROutExtent(HDROutputTarget.Texture->Desc.Extent.X,
+		                              HDROutputTarget.Texture->Desc.Extent.Y);
+		const FScreenPassTextureViewport HDROutVP(HDROutExtent, HDROutputTarget.ViewRect);
+		const FScreenPassTextureViewport PreHDRVP(
+			FIntPoint(OutputTarget.Texture->Desc.Extent.X, OutputTarget.Texture->Desc.Extent.Y),
+			FIntRect(0, 0, OutputTarget.Texture->Desc.Extent.X, OutputTarget.Texture->Desc.Extent.Y));
+
+		HP->SvPositionToSceneColorUV = (
+			FScreenTransform::ChangeTextureBasisFromTo(HDROutVP,
+				FScreenTransform::ETextureBasis::TexelPosition,
+				FScreenTransform::ETextureBasis::ViewportUV) *
+			FScreenTransform::ChangeTextureBasisFromTo(PreHDRVP,
+				FScreenTransform::ETextureBasis::ViewportUV,
+				FScreenTransform::ETextureBasis::TextureUV));
+
+		HP->OutputDeviceType = (float)Context.HDROutputDevice;
+		HP->PaperWhiteNits   = Settings.PaperWhiteNits;
+		HP->MaxDisplayNits   = Context.HDRMaxDisplayNits;
+		HP->DitherQuantization = Context.GetDitherQuantization();
+
+		HP->RenderTargets[0] = FRenderTargetBinding(HDROutputTarget.Texture, HDROutputTarget.LoadAction);
+
+		TShaderMapRef<FToneMapHDREncodePS> HDRShader(ViewInfo.ShaderMap);
+		AddToneMapFullscreenPass(
+			GraphBuilder, ViewInfo.ShaderMap,
+			RDG_EVENT_NAME("HDREncode"),
+			HDRShader, HP,
+			HDROutputTarget.ViewRect);
+
+		Context.AdvanceChain(HDROutputTarget);
+	}
+};
+
+// ---------------------------------------------------------------------------
+// Registration
+// ---------------------------------------------------------------------------
+
+void FToneMapStageRegistry::RegisterBuiltInStages()
+{
+	Register(MakeShared<FToneMapBloomStage, ESPMode::ThreadSafe>(),         FToneMapStageOrder::Bloom);
+	Register(MakeShared<FToneMapExposureStage, ESPMode::ThreadSafe>(),      FToneMapStageOrder::Exposure);
+	Register(MakeShared<FToneMapLocalContrastStage, ESPMode::ThreadSafe>(), FToneMapStageOrder::LocalContrast);
+	Register(MakeShared<FToneMapDurandStage, ESPMode::ThreadSafe>(),        FToneMapStageOrder::Durand);
+	Register(MakeShared<FToneMapFattalStage, ESPMode::ThreadSafe>(),        FToneMapStageOrder::Fattal);
+	Register(MakeShared<FToneMapLensStage, ESPMode::ThreadSafe>(),          FToneMapStageOrder::Lens);
+	Register(MakeShared<FToneMapProcessStage, ESPMode::ThreadSafe>(),       FToneMapStageOrder::Process);
+	Register(MakeShared<FToneMapSharpenStage, ESPMode::ThreadSafe>(),       FToneMapStageOrder::Sharpen);
+	Register(MakeShared<FToneMapLUTStage, ESPMode::ThreadSafe>(),           FToneMapStageOrder::LUT);
+	Register(MakeShared<FToneMapVignetteStage, ESPMode::ThreadSafe>(),      FToneMapStageOrder::Vignette);
+	Register(MakeShared<FToneMapHDREncodeStage, ESPMode::ThreadSafe>(),     FToneMapStageOrder::HDREncode);
+}
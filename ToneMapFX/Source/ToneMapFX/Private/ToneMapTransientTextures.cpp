@@ -0,0 +1,235 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapTransientTextures.h"
+#include "ToneMapStats.h"
+#include "HAL/IConsoleManager.h"
+#include "CoreGlobals.h"
+
+DEFINE_STAT(STAT_ToneMapFX_PeakTransientMemory);
+DEFINE_STAT(STAT_ToneMapFX_TransientTexturesCreated);
+
+static TAutoConsoleVariable<int32> CVarToneMapReducedPrecision(
+	TEXT("r.ToneMapFX.ReducedPrecisionIntermediates"),
+	1,
+	TEXT("Use reduced-precision formats for ToneMapFX intermediates where the error is not visible.\n")
+	TEXT(" 0: RGBA16F colour / R32F luminance everywhere (legacy)\n")
+	TEXT(" 1: R11G11B10F blur scratch, R16F log-luminance (default)"),
+	ECVF_RenderThreadSafe | ECVF_Scalability);
+
+static TAutoConsoleVariable<int32> CVarToneMapTransientBudgetMB(
+	TEXT("r.ToneMapFX.TransientBudgetMB"),
+	0,
+	TEXT("Per-view budget for ToneMapFX transient textures in MB (0 = unlimited).\n")
+	TEXT("A view whose peak exceeds it renders bloom and lens effects at half resolution per level\n")
+	TEXT("(up to 3) from the next frame on; within the frame, the remaining blur scratch and\n")
+	TEXT("log-luminance intermediates fall back to reduced formats. Peak usage is reported in 'stat ToneMapFX'."),
+	ECVF_RenderThreadSafe | ECVF_Scalability);
+
+FToneMapTransientTextures::FToneMapTransientTextures(FRDGBuilder& InGraphBuilder)
+	: GraphBuilder(InGraphBuilder)
+{
+	BudgetBytes = GetBudgetBytes_RenderThread();
+}
+
+uint64 FToneMapTransientTextures::GetBudgetBytes_RenderThread()
+{
+	const int32 BudgetMB = CVarToneMapTransientBudgetMB.GetValueOnRenderThread();
+	return BudgetMB > 0 ? (uint64)BudgetMB * 1024 * 1024 : 0;
+}
+
+// ---------------------------------------------------------------------------
+// Format policy
+// ---------------------------------------------------------------------------
+
+EPixelFormat FToneMapTransientTextures::GetFormat(EToneMapIntermediate Usage, bool bUnderBudgetPressure)
+{
+	const bool bReduced = CVarToneMapReducedPrecision.GetValueOnRenderThread() != 0;
+
+	switch (Usage)
+	{
+	case EToneMapIntermediate::Color:
+		// Alpha and negative values must survive — never demoted
+		return PF_FloatRGBA;
+	case EToneMapIntermediate::BlurScratch:
+		return (bReduced || bUnderBudgetPressure) ? PF_FloatR11G11B10 : PF_FloatRGBA;
+	case EToneMapIntermediate::LogLuminance:
+		// log2 values stay within ±24 — half precision keeps ~0.01 absolute error
+		return (bReduced || bUnderBudgetPressure) ? PF_R16F : PF_R32_FLOAT;
+	case EToneMapIntermediate::Scalar:
+		// Poisson solve / gradient fields — half precision diverges
+		return PF_R32_FLOAT;
+	case EToneMapIntermediate::Vector2:
+		return PF_G32R32F;
+	case EToneMapIntermediate::Luminance:
+		return PF_R16F;
+	default:
+		return PF_FloatRGBA;
+	}
+}
+
+uint64 FToneMapTransientTextures::GetTextureBytes(FIntPoint Extent, EPixelFormat Format)
+{
+	const FPixelFormatInfo& Info = GPixelFormats[Format];
+	const uint64 BlocksX = FMath::DivideAndRoundUp(Extent.X, FMath::Max(Info.BlockSizeX, 1));
+	const uint64 BlocksY = FMath::DivideAndRoundUp(Extent.Y, FMath::Max(Info.BlockSizeY, 1));
+	return BlocksX * BlocksY * (uint64)Info.BlockBytes;
+}
+
+// ---------------------------------------------------------------------------
+// Allocation
+// ---------------------------------------------------------------------------
+
+FRDGTextureRef FToneMapTransientTextures::Create(
+	FIntPoint Extent,
+	EToneMapIntermediate Usage,
+	const TCHAR* Name,
+	ETextureCreateFlags ExtraFlags,
+	const FClearValueBinding& ClearValue)
+{
+	// The resource that crosses the budget keeps the format the caller planned
+	// for (GetFormatForUsage); the ones after it are demoted
+	const FRDGTextureDesc Desc = FRDGTextureDesc::Create2D(
+		Extent, GetFormat(Usage, bOverBudget), ClearValue,
+		TexCreate_ShaderResource | TexCreate_RenderTargetable | ExtraFlags);
+
+	return CreateFromDesc(Desc, Name);
+}
+
+FRDGTextureRef FToneMapTransientTextures::CreateFromDesc(const FRDGTextureDesc& Desc, const TCHAR* Name)
+{
+	FRDGTextureRef Texture = GraphBuilder.CreateTexture(Desc, Name);
+	const uint64 Bytes = GetTextureBytes(Desc.Extent, Desc.Format);
+	LiveTextures.Add(Texture, Bytes);
+	AddLiveBytes(Bytes, Name);
+	return Texture;
+}
+
+FRDGBufferRef FToneMapTransientTextures::CreateBuffer(const FRDGBufferDesc& Desc, const TCHAR* Name)
+{
+	FRDGBufferRef Buffer = GraphBuilder.CreateBuffer(Desc, Name);
+	const uint64 Bytes = Desc.GetSize();
+	LiveBuffers.Add(Buffer, Bytes);
+	AddLiveBytes(Bytes, Name);
+	return Buffer;
+}
+
+void FToneMapTransientTextures::AddExternalBytes(uint64 Bytes)
+{
+	// Held for the whole frame — never released
+	LiveBytes += Bytes;
+	PeakBytes  = FMath::Max(PeakBytes, LiveBytes);
+}
+
+void FToneMapTransientTextures::AddLiveBytes(uint64 Bytes, const TCHAR* Name)
+{
+	LiveBytes += Bytes;
+	PeakBytes  = FMath::Max(PeakBytes, LiveBytes);
+	++NumCreated;
+
+	if (!bOverBudget && BudgetBytes > 0 && LiveBytes > BudgetBytes)
+	{
+		bOverBudget = true;
+
+		static bool bWarnedOnce = false;
+		if (!bWarnedOnce)
+		{
+			bWarnedOnce = true;
+			UE_LOG(LogTemp, Warning,
+				TEXT("ToneMapFX: Transient budget of %llu MB exceeded at '%s' — switching remaining blur scratch to reduced formats and lowering bloom / lens resolution"),
+				BudgetBytes / (1024 * 1024), Name);
+		}
+	}
+}
+
+void FToneMapTransientTextures::Release(FRDGTextureRef Texture)
+{
+	uint64 Bytes = 0;
+	if (Texture && LiveTextures.RemoveAndCopyValue(Texture, Bytes))
+	{
+		LiveBytes -= Bytes;
+	}
+}
+
+void FToneMapTransientTextures::Release(FRDGBufferRef Buffer)
+{
+	uint64 Bytes = 0;
+	if (Buffer && LiveBuffers.RemoveAndCopyValue(Buffer, Bytes))
+	{
+		LiveBytes -= Bytes;
+	}
+}
+
+void FToneMapTransientTextures::ReportStats() const
+{
+	// Views render one after another on the render thread; keep the largest
+	// peak of the frame rather than whichever view reported last
+	static uint64 StatFrame = MAX_uint64;
+	static uint64 FramePeakBytes = 0;
+	if (StatFrame != GFrameCounterRenderThread)
+	{
+		StatFrame = GFrameCounterRenderThread;
+		FramePeakBytes = 0;
+	}
+	FramePeakBytes = FMath::Max(FramePeakBytes, PeakBytes);
+
+	SET_MEMORY_STAT(STAT_ToneMapFX_PeakTransientMemory, FramePeakBytes);
+	INC_DWORD_STAT_BY(STAT_ToneMapFX_TransientTexturesCreated, NumCreated);
+}
+
+// ---------------------------------------------------------------------------
+// Budget feedback across frames
+// ---------------------------------------------------------------------------
+
+FToneMapTransientBudgetState FToneMapTransientTextures::StepBudget(
+	const FToneMapTransientBudgetState& State,
+	uint64 PeakBytes,
+	uint64 BudgetBytes)
+{
+	if (BudgetBytes == 0)
+	{
+		return FToneMapTransientBudgetState();
+	}
+
+	FToneMapTransientBudgetState Next = State;
+
+	// First frame at a new level: remember what the step bought, so climbing
+	// back is only tried once that much headroom exists
+	if (Next.bMeasureSaving)
+	{
+		Next.Savings[Next.Level] = Next.PeakBeforeStep > PeakBytes ? Next.PeakBeforeStep - PeakBytes : 0;
+		Next.bMeasureSaving = false;
+	}
+
+	if (PeakBytes > BudgetBytes)
+	{
+		if (Next.Level < FToneMapTransientBudgetState::MaxLevel)
+		{
+			Next.Level++;
+			Next.PeakBeforeStep = PeakBytes;
+			Next.bMeasureSaving = true;
+		}
+	}
+	else if (Next.Level > 0 && PeakBytes + Next.Savings[Next.Level] <= BudgetBytes)
+	{
+		Next.Level--;
+	}
+
+	return Next;
+}
+
+void FToneMapTransientTextures::ApplyBudget(const FToneMapTransientBudgetState& State, FToneMapResolvedQuality& Quality)
+{
+	const int32 Level = FMath::Clamp(State.Level, 0, FToneMapTransientBudgetState::MaxLevel);
+	if (Level == 0) return;
+
+	const float Scale = 1.0f / (float)(1 << Level);
+
+	// One Kawase mip fewer per halving keeps the coarsest mip where it was
+	Quality.BloomDownsampleScale = FMath::Max(0.0625f, Quality.BloomDownsampleScale * Scale);
+	Quality.KawaseMipCount       = FMath::Max(3, Quality.KawaseMipCount - Level);
+
+	// Spike length is in lens-buffer pixels and shrinks with the buffer
+	const float LensScale = FMath::Max(0.0625f, Quality.LensResolutionScale * Scale);
+	Quality.CoronaSpikeLength   = FMath::Max(1, FMath::RoundToInt32(Quality.CoronaSpikeLength * LensScale / Quality.LensResolutionScale));
+	Quality.LensResolutionScale = LensScale;
+}
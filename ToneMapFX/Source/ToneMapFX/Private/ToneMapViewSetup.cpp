@@ -0,0 +1,197 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapViewSetup.h"
+#include "ToneMapStats.h"
+#include "RenderingThread.h"
+
+DEFINE_STAT(STAT_ToneMapFX_ViewSetup);
+
+// Entries untouched for this many frames are dropped once the cache grows
+static constexpr uint64 GViewSetupMaxIdleFrames = 120;
+static constexpr int32  GViewSetupPruneThreshold = 8;
+
+static FVector4f SizeAndInvSize(FIntPoint Size)
+{
+	return FVector4f(Size.X, Size.Y, 1.0f / Size.X, 1.0f / Size.Y);
+}
+
+// SvPosition in Output → ViewportUV [0,1] → Input TextureUV
+static FScreenTransform SvPositionToTextureUV(const FScreenPassTextureViewport& Output, const FScreenPassTextureViewport& Input)
+{
+	return
+		FScreenTransform::ChangeTextureBasisFromTo(Output, FScreenTransform::ETextureBasis::TexelPosition, FScreenTransform::ETextureBasis::ViewportUV) *
+		FScreenTransform::ChangeTextureBasisFromTo(Input, FScreenTransform::ETextureBasis::ViewportUV, FScreenTransform::ETextureBasis::TextureUV);
+}
+
+uint32 FToneMapViewSetupKey::GetHash() const
+{
+	const int32 Values[] =
+	{
+		SceneColorExtent.X, SceneColorExtent.Y,
+		SceneColorRect.Min.X, SceneColorRect.Min.Y, SceneColorRect.Max.X, SceneColorRect.Max.Y,
+		BloomDivisor, KawaseMipCount, FMath::RoundToInt32(LensResolutionScale * 1000.0f),
+	};
+	return FCrc::MemCrc32(Values, sizeof(Values));
+}
+
+// ---------------------------------------------------------------------------
+// Derived setup
+// ---------------------------------------------------------------------------
+
+void FToneMapViewSetup::Build(const FToneMapViewSetupKey& InKey)
+{
+	Key = InKey;
+	Hash = Key.GetHash();
+	OutputHash = 0;
+	KawaseMips.Reset();
+
+	const FIntPoint ViewSize = Key.SceneColorRect.Size();
+	if (ViewSize.X <= 0 || ViewSize.Y <= 0)
+	{
+		// Every pass is skipped for an empty viewport — the transforms are never read
+		BloomExtent = WorkSize = LensSize = FIntPoint::ZeroValue;
+		BloomRect = WorkRect = LensRect = FIntRect();
+		return;
+	}
+
+	const FScreenPassTextureViewport SceneColorVP(Key.SceneColorExtent, Key.SceneColorRect);
+
+	// ClassicBloom: bright pass, blur chain and composite
+	BloomExtent = FIntPoint::DivideAndRoundUp(ViewSize, FMath::Max(1, Key.BloomDivisor));
+	BloomRect = FIntRect(FIntPoint::ZeroValue, BloomExtent);
+	const FScreenPassTextureViewport BloomVP(BloomExtent, BloomRect);
+
+	BloomInputSizeAndInvSize = SizeAndInvSize(ViewSize);
+	BloomOutputSizeAndInvSize = SizeAndInvSize(BloomRect.Size());
+	BloomBufferSizeAndInvSize = SizeAndInvSize(BloomExtent);
+	BloomBrightPassInputUV = SvPositionToTextureUV(BloomVP, SceneColorVP);
+	BloomCompositeSceneColorUV = SvPositionToTextureUV(SceneColorVP, SceneColorVP);
+	BloomCompositeBloomUV = SvPositionToTextureUV(SceneColorVP, BloomVP);
+
+	// Kawase pyramid: each level halves the previous one, never below 1x1
+	FIntPoint CurrentExtent = BloomExtent;
+	FIntRect CurrentRect = BloomRect;
+	FScreenPassTextureViewport SourceVP = SceneColorVP;
+	for (int32 Level = 0; Level < Key.KawaseMipCount; ++Level)
+	{
+		CurrentExtent = FIntPoint::DivideAndRoundUp(CurrentExtent, 2);
+		CurrentRect = FIntRect(FIntPoint::ZeroValue, FIntPoint::DivideAndRoundUp(CurrentRect.Size(), 2));
+		CurrentExtent.X = FMath::Max(CurrentExtent.X, 1);
+		CurrentExtent.Y = FMath::Max(CurrentExtent.Y, 1);
+		CurrentRect.Max.X = FMath::Max(CurrentRect.Max.X, 1);
+		CurrentRect.Max.Y = FMath::Max(CurrentRect.Max.Y, 1);
+
+		FToneMapKawaseMip& Mip = KawaseMips.AddDefaulted_GetRef();
+		Mip.Extent = CurrentExtent;
+		Mip.Rect = CurrentRect;
+		Mip.SizeAndInvSize = SizeAndInvSize(CurrentExtent);
+
+		const FScreenPassTextureViewport MipVP(CurrentExtent, CurrentRect);
+		Mip.SvPositionToSourceUV = SvPositionToTextureUV(MipVP, SourceVP);
+		SourceVP = MipVP;
+	}
+
+	// Working size: full-viewport scratch at the origin
+	WorkSize = ViewSize;
+	WorkRect = FIntRect(FIntPoint::ZeroValue, WorkSize);
+	WorkSizeAndInvSize = SizeAndInvSize(WorkSize);
+	const FScreenPassTextureViewport WorkVP(WorkSize, WorkRect);
+	WorkSceneColorUV = SvPositionToTextureUV(WorkVP, SceneColorVP);
+
+	// Lens effects at the quality tier's resolution; layers cover their whole
+	// texture, so the composite's viewport UV is the lens texture UV
+	LensSize = FIntPoint(
+		FMath::Max(1, FMath::RoundToInt32(WorkSize.X * Key.LensResolutionScale)),
+		FMath::Max(1, FMath::RoundToInt32(WorkSize.Y * Key.LensResolutionScale)));
+	LensRect = FIntRect(FIntPoint::ZeroValue, LensSize);
+	LensSizeAndInvSize = SizeAndInvSize(LensSize);
+	const FScreenPassTextureViewport LensVP(LensSize, LensRect);
+	LensBufferSceneColorUV = SvPositionToTextureUV(LensVP, SceneColorVP);
+	LensBrightPassUV = SvPositionToTextureUV(LensVP, LensVP);
+	LensCompositeLensUV = FScreenTransform::ChangeTextureBasisFromTo(WorkVP, FScreenTransform::ETextureBasis::TexelPosition, FScreenTransform::ETextureBasis::ViewportUV);
+}
+
+void FToneMapViewSetup::UpdateOutput(FIntPoint SceneColorExtent, FIntPoint OutputExtent, const FIntRect& OutputRect)
+{
+	const int32 Values[] =
+	{
+		SceneColorExtent.X, SceneColorExtent.Y,
+		OutputExtent.X, OutputExtent.Y, OutputRect.Min.X, OutputRect.Min.Y, OutputRect.Max.X, OutputRect.Max.Y,
+	};
+	const uint32 NewOutputHash = FCrc::MemCrc32(Values, sizeof(Values), Hash);
+	if (NewOutputHash == OutputHash)
+	{
+		return;
+	}
+	OutputHash = NewOutputHash;
+
+	// Output may have a non-zero Min (OverrideOutput in ReplaceTonemap mode)
+	const FScreenPassTextureViewport OutputVP(OutputExtent, OutputRect);
+	OutputViewportRect = FVector4f(OutputRect.Min.X, OutputRect.Min.Y, OutputRect.Max.X, OutputRect.Max.Y);
+	OutputSceneColorUV = SvPositionToTextureUV(OutputVP, FScreenPassTextureViewport(SceneColorExtent, Key.SceneColorRect));
+	OutputWorkUV = SvPositionToTextureUV(OutputVP, FScreenPassTextureViewport(WorkSize, WorkRect));
+}
+
+FToneMapViewSetup& FToneMapViewSetupCache::Get_RenderThread(uint32 ViewKey, const FToneMapViewSetupKey& Key)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ToneMapFX_ViewSetup);
+	check(IsInRenderingThread());
+
+	const uint64 Frame = GFrameCounterRenderThread;
+
+	// Editor viewports and captures come and go — forget the ones that stopped rendering
+	if (Entries.Num() > GViewSetupPruneThreshold)
+	{
+		for (auto It = Entries.CreateIterator(); It; ++It)
+		{
+			if (It->Value.LastUsedFrame + GViewSetupMaxIdleFrames < Frame)
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	const uint32 Hash = Key.GetHash();
+	FToneMapViewSetup* Setup = Entries.Find(ViewKey);
+	if (!Setup || Setup->Hash != Hash)
+	{
+		Setup = &Entries.FindOrAdd(ViewKey);
+		Setup->Build(Key);
+	}
+	Setup->LastUsedFrame = Frame;
+	return *Setup;
+}
+
+// ---------------------------------------------------------------------------
+// Static pass names
+// ---------------------------------------------------------------------------
+
+const TCHAR* FToneMapPassNames::GetTextureName(EToneMapIndexedName Name, int32 Index)
+{
+	static const TCHAR* const Prefixes[] =
+	{
+		TEXT("ClassicBloom.Streak"),
+		TEXT("ClassicBloom.GlareAccum"),
+		TEXT("ClassicBloom.KawaseMip"),
+		TEXT("ClassicBloom.KawaseUpsample"),
+	};
+	static_assert(UE_ARRAY_COUNT(Prefixes) == (int32)EToneMapIndexedName::Num, "One prefix per EToneMapIndexedName");
+
+	// Built once and never freed: graphs hold on to the pointers until they execute
+	static const TArray<FString> Names = []
+	{
+		TArray<FString> Result;
+		Result.Reserve(UE_ARRAY_COUNT(Prefixes) * MaxIndex);
+		for (const TCHAR* Prefix : Prefixes)
+		{
+			for (int32 i = 0; i < MaxIndex; ++i)
+			{
+				Result.Add(FString::Printf(TEXT("%s%d"), Prefix, i));
+			}
+		}
+		return Result;
+	}();
+
+	checkSlow(Index >= 0 && Index < MaxIndex);
+	return *Names[(int32)Name * MaxIndex + FMath::Clamp(Index, 0, MaxIndex - 1)];
+}
@@ -0,0 +1,195 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapVolumes.h"
+#include "ToneMapComponent.h"
+#include "ToneMapStats.h"
+#include "UObject/UnrealType.h"
+
+DEFINE_STAT(STAT_ToneMapFX_ResolveVolumes);
+
+// ---------------------------------------------------------------------------
+// Spatial index
+// ---------------------------------------------------------------------------
+
+FIntPoint FToneMapVolumeIndex::GetCell(const FVector& Location)
+{
+	return FIntPoint(
+		FMath::FloorToInt32(Location.X / CellSize),
+		FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+void FToneMapVolumeIndex::Rebuild(const TArray<TWeakObjectPtr<UToneMapComponent>>& Components)
+{
+	Cells.Reset();
+	AlwaysTested.Reset();
+
+	for (int32 Index = 0; Index < Components.Num(); ++Index)
+	{
+		const UToneMapComponent* Comp = Components[Index].Get();
+		if (!Comp) continue;
+
+		if (Comp->bUnbound)
+		{
+			AlwaysTested.Add(Index);
+			continue;
+		}
+
+		const FVector Extent = Comp->BoxExtent.GetAbs();
+		const FBox WorldBox = FBox(-Extent, Extent)
+			.TransformBy(Comp->GetComponentTransform())
+			.ExpandBy(FMath::Max(Comp->BlendRadius, 0.0f));
+
+		const FIntPoint MinCell = GetCell(WorldBox.Min);
+		const FIntPoint MaxCell = GetCell(WorldBox.Max);
+		const int64 NumCells = (int64)(MaxCell.X - MinCell.X + 1) * (int64)(MaxCell.Y - MinCell.Y + 1);
+
+		if (NumCells > MaxCellsPerVolume)
+		{
+			AlwaysTested.Add(Index);
+			continue;
+		}
+
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+			{
+				Cells.FindOrAdd(FIntPoint(X, Y)).Add(Index);
+			}
+		}
+	}
+}
+
+void FToneMapVolumeIndex::Query(const FVector& Location, TArray<int32, TInlineAllocator<16>>& OutIndices) const
+{
+	OutIndices.Reset();
+	OutIndices.Append(AlwaysTested);
+
+	if (const TArray<int32>* CellEntries = Cells.Find(GetCell(Location)))
+	{
+		OutIndices.Append(*CellEntries);
+	}
+
+	// Both lists are ascending and disjoint; merge them back into registration order
+	OutIndices.Sort();
+}
+
+float FToneMapVolumeIndex::ComputeWeight(const UToneMapComponent& Component, const FVector& Location)
+{
+	const float Weight = FMath::Clamp(Component.BlendWeight, 0.0f, 1.0f);
+	if (Component.bUnbound) return Weight;
+
+	// Closest point of the (oriented, scaled) box, measured in world units
+	const FTransform& Transform = Component.GetComponentTransform();
+	const FVector Extent = Component.BoxExtent.GetAbs();
+	const FVector Local = Transform.InverseTransformPosition(Location);
+	const FVector Closest = Transform.TransformPosition(Local.BoundToBox(-Extent, Extent));
+	const float Distance = (float)FVector::Dist(Location, Closest);
+
+	if (Distance <= UE_KINDA_SMALL_NUMBER) return Weight;
+	if (Distance >= Component.BlendRadius) return 0.0f;
+
+	return Weight * (1.0f - Distance / Component.BlendRadius);
+}
+
+// ---------------------------------------------------------------------------
+// Settings blending
+// ---------------------------------------------------------------------------
+
+enum class EToneMapBlendKind : uint8
+{
+	Float,
+	Int,
+	LinearColor,
+	Discrete,
+};
+
+// Blend kind per preset property, parallel to UToneMapComponent::GetPresetProperties()
+static const TArray<EToneMapBlendKind>& GetBlendKinds()
+{
+	static const TArray<EToneMapBlendKind> Kinds = []()
+	{
+		TArray<EToneMapBlendKind> Result;
+		for (FProperty* Prop : UToneMapComponent::GetPresetProperties())
+		{
+			const FStructProperty* StructProp = CastField<FStructProperty>(Prop);
+
+			if (Prop->IsA<FFloatProperty>())                                           Result.Add(EToneMapBlendKind::Float);
+			else if (Prop->IsA<FIntProperty>())                                        Result.Add(EToneMapBlendKind::Int);
+			else if (StructProp && StructProp->Struct == TBaseStructure<FLinearColor>::Get()) Result.Add(EToneMapBlendKind::LinearColor);
+			else                                                                       Result.Add(EToneMapBlendKind::Discrete);
+		}
+		return Result;
+	}();
+	return Kinds;
+}
+
+void FToneMapSettingsBlend::Copy(UToneMapComponent& Dest, const UToneMapComponent& Src)
+{
+	for (FProperty* Prop : UToneMapComponent::GetPresetProperties())
+	{
+		Prop->CopySingleValue(
+			Prop->ContainerPtrToValuePtr<void>(&Dest),
+			Prop->ContainerPtrToValuePtr<void>(&Src));
+	}
+}
+
+uint32 FToneMapSettingsBlend::GetHash(const UToneMapComponent& Settings)
+{
+	uint32 Hash = 0;
+	for (FProperty* Prop : UToneMapComponent::GetPresetProperties())
+	{
+		const void* ValuePtr = Prop->ContainerPtrToValuePtr<void>(&Settings);
+
+		// Bitfield bools share their byte with their neighbours
+		if (const FBoolProperty* BoolProp = CastField<FBoolProperty>(Prop))
+		{
+			Hash = HashCombineFast(Hash, BoolProp->GetPropertyValue(ValuePtr) ? 1u : 0u);
+		}
+		else
+		{
+			Hash = FCrc::MemCrc32(ValuePtr, Prop->GetSize(), Hash);
+		}
+	}
+	return Hash;
+}
+
+void FToneMapSettingsBlend::Lerp(UToneMapComponent& Dest, const UToneMapComponent& Src, float Weight)
+{
+	const TArray<FProperty*>& Props = UToneMapComponent::GetPresetProperties();
+	const TArray<EToneMapBlendKind>& Kinds = GetBlendKinds();
+
+	for (int32 Index = 0; Index < Props.Num(); ++Index)
+	{
+		FProperty* Prop = Props[Index];
+		void* DestPtr = Prop->ContainerPtrToValuePtr<void>(&Dest);
+		const void* SrcPtr = Prop->ContainerPtrToValuePtr<void>(&Src);
+
+		switch (Kinds[Index])
+		{
+		case EToneMapBlendKind::Float:
+		{
+			float& Value = *static_cast<float*>(DestPtr);
+			Value = FMath::Lerp(Value, *static_cast<const float*>(SrcPtr), Weight);
+			break;
+		}
+		case EToneMapBlendKind::Int:
+		{
+			int32& Value = *static_cast<int32*>(DestPtr);
+			Value = FMath::RoundToInt32(FMath::Lerp((float)Value, (float)*static_cast<const int32*>(SrcPtr), Weight));
+			break;
+		}
+		case EToneMapBlendKind::LinearColor:
+		{
+			FLinearColor& Value = *static_cast<FLinearColor*>(DestPtr);
+			Value = FMath::Lerp(Value, *static_cast<const FLinearColor*>(SrcPtr), Weight);
+			break;
+		}
+		default:
+			if (Weight >= 0.5f)
+			{
+				Prop->CopySingleValue(DestPtr, SrcPtr);
+			}
+			break;
+		}
+	}
+}
@@ -6,54 +6,121 @@
 #include "GlobalShader.h"
 #include "ShaderParameterStruct.h"
 #include "ScreenPass.h"
+#include "ToneMapFXSettings.h"
+#include "ToneMapComputeStage.h"
+#include "ToneMapGaussianBlur.h"
 
 // Bright pass shader - extracts bright pixels for bloom
+BEGIN_SHADER_PARAMETER_STRUCT(FClassicBloomBrightPassParameters, )
+	SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
+	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, SceneColorTexture)
+	SHADER_PARAMETER_SAMPLER(SamplerState, SceneColorSampler)
+	SHADER_PARAMETER(FVector4f, InputViewportSizeAndInvSize)
+	SHADER_PARAMETER(FVector4f, OutputViewportSizeAndInvSize)
+	SHADER_PARAMETER(FScreenTransform, SvPositionToInputTextureUV) // Transform SvPosition to scene color texture UV
+	SHADER_PARAMETER(float, BloomThreshold)
+	SHADER_PARAMETER(float, BloomIntensity)
+	SHADER_PARAMETER(float, ThresholdSoftness) // 0..1 — 0=hard cutoff, 1=very wide/soft knee
+	SHADER_PARAMETER(float, MaxBrightness)    // Clamp extreme HDR values (0=no clamp)
+END_SHADER_PARAMETER_STRUCT()
+
 class FClassicBloomBrightPassPS : public FGlobalShader
 {
 public:
 	DECLARE_GLOBAL_SHADER(FClassicBloomBrightPassPS);
 	SHADER_USE_PARAMETER_STRUCT(FClassicBloomBrightPassPS, FGlobalShader);
 
+	using FStageParameters = FClassicBloomBrightPassParameters;
+
 	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
-		SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
-		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, SceneColorTexture)
-		SHADER_PARAMETER_SAMPLER(SamplerState, SceneColorSampler)
-		SHADER_PARAMETER(FVector4f, InputViewportSizeAndInvSize)
-		SHADER_PARAMETER(FVector4f, OutputViewportSizeAndInvSize)
-		SHADER_PARAMETER(FScreenTransform, SvPositionToInputTextureUV) // Transform SvPosition to scene color texture UV
-		SHADER_PARAMETER(float, BloomThreshold)
-		SHADER_PARAMETER(float, BloomIntensity)
-		SHADER_PARAMETER(float, ThresholdSoftness) // 0..1 — 0=hard cutoff, 1=very wide/soft knee
-		SHADER_PARAMETER(float, MaxBrightness)    // Clamp extreme HDR values (0=no clamp)
+		SHADER_PARAMETER_STRUCT_INCLUDE(FStageParameters, Stage)
 		RENDER_TARGET_BINDING_SLOTS()
 	END_SHADER_PARAMETER_STRUCT()
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
-		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::Bloom, Parameters.Platform);
+	}
+};
+
+// Compute variant (r.ToneMapFX.AsyncCompute)
+class FClassicBloomBrightPassCS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FClassicBloomBrightPassCS);
+	SHADER_USE_PARAMETER_STRUCT(FClassicBloomBrightPassCS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_INCLUDE(FClassicBloomBrightPassParameters, Stage)
+		SHADER_PARAMETER_STRUCT_INCLUDE(FToneMapComputeStageOutput, Output)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::Bloom, Parameters.Platform);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		FToneMapComputeStage::ModifyCompilationEnvironment(OutEnvironment);
 	}
 };
 
 // Gaussian blur shader - separable (does horizontal or vertical)
+BEGIN_SHADER_PARAMETER_STRUCT(FClassicBloomBlurParameters, )
+	SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
+	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, SourceTexture)
+	SHADER_PARAMETER_SAMPLER(SamplerState, SourceSampler)
+	SHADER_PARAMETER(FVector4f, BufferSizeAndInvSize)
+	SHADER_PARAMETER(FVector2f, BlurDirection)
+	SHADER_PARAMETER_STRUCT_INCLUDE(FToneMapGaussianKernelParameters, Kernel)
+END_SHADER_PARAMETER_STRUCT()
+
 class FClassicBloomBlurPS : public FGlobalShader
 {
 public:
 	DECLARE_GLOBAL_SHADER(FClassicBloomBlurPS);
 	SHADER_USE_PARAMETER_STRUCT(FClassicBloomBlurPS, FGlobalShader);
 
+	using FStageParameters = FClassicBloomBlurParameters;
+
 	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
-		SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
-		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, SourceTexture)
-		SHADER_PARAMETER_SAMPLER(SamplerState, SourceSampler)
-		SHADER_PARAMETER(FVector4f, BufferSizeAndInvSize)
-		SHADER_PARAMETER(FVector2f, BlurDirection)
-		SHADER_PARAMETER(float, BlurRadius)
+		SHADER_PARAMETER_STRUCT_INCLUDE(FStageParameters, Stage)
 		RENDER_TARGET_BINDING_SLOTS()
 	END_SHADER_PARAMETER_STRUCT()
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
-		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::Bloom, Parameters.Platform);
+	}
+};
+
+// Compute variant (r.ToneMapFX.AsyncCompute)
+class FClassicBloomBlurCS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FClassicBloomBlurCS);
+	SHADER_USE_PARAMETER_STRUCT(FClassicBloomBlurCS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_INCLUDE(FClassicBloomBlurParameters, Stage)
+		SHADER_PARAMETER_STRUCT_INCLUDE(FToneMapComputeStageOutput, Output)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::Bloom, Parameters.Platform);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		FToneMapComputeStage::ModifyCompilationEnvironment(OutEnvironment);
 	}
 };
 
@@ -95,57 +162,122 @@ public:
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
-		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::Bloom, Parameters.Platform);
 	}
 };
 
 // Directional glare streak shader
+BEGIN_SHADER_PARAMETER_STRUCT(FClassicBloomGlareStreakParameters, )
+	SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
+	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, SourceTexture)
+	SHADER_PARAMETER_SAMPLER(SamplerState, SourceSampler)
+	SHADER_PARAMETER(FVector4f, BufferSizeAndInvSize)
+	SHADER_PARAMETER(FVector2f, StreakDirection) // Normalized direction vector
+	SHADER_PARAMETER(float, StreakLength) // Length in texels
+	SHADER_PARAMETER(float, StreakFalloff) // Exponential falloff rate
+	SHADER_PARAMETER(int32, StreakSamples) // Samples per direction (8/16/32/48/64)
+END_SHADER_PARAMETER_STRUCT()
+
 class FClassicBloomGlareStreakPS : public FGlobalShader
 {
 public:
 	DECLARE_GLOBAL_SHADER(FClassicBloomGlareStreakPS);
 	SHADER_USE_PARAMETER_STRUCT(FClassicBloomGlareStreakPS, FGlobalShader);
 
+	using FStageParameters = FClassicBloomGlareStreakParameters;
+
 	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
-		SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
-		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, SourceTexture)
-		SHADER_PARAMETER_SAMPLER(SamplerState, SourceSampler)
-		SHADER_PARAMETER(FVector4f, BufferSizeAndInvSize)
-		SHADER_PARAMETER(FVector2f, StreakDirection) // Normalized direction vector
-		SHADER_PARAMETER(float, StreakLength) // Length in texels
-		SHADER_PARAMETER(float, StreakFalloff) // Exponential falloff rate
-		SHADER_PARAMETER(int32, StreakSamples) // Samples per direction (8/16/32/48/64)
+		SHADER_PARAMETER_STRUCT_INCLUDE(FStageParameters, Stage)
 		RENDER_TARGET_BINDING_SLOTS()
 	END_SHADER_PARAMETER_STRUCT()
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
-		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::DirectionalGlare, Parameters.Platform);
+	}
+};
+
+// Compute variant (r.ToneMapFX.AsyncCompute)
+class FClassicBloomGlareStreakCS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FClassicBloomGlareStreakCS);
+	SHADER_USE_PARAMETER_STRUCT(FClassicBloomGlareStreakCS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_INCLUDE(FClassicBloomGlareStreakParameters, Stage)
+		SHADER_PARAMETER_STRUCT_INCLUDE(FToneMapComputeStageOutput, Output)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::DirectionalGlare, Parameters.Platform);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		FToneMapComputeStage::ModifyCompilationEnvironment(OutEnvironment);
 	}
 };
 
 // Glare streak accumulation shader - combines multiple streak directions
+BEGIN_SHADER_PARAMETER_STRUCT(FClassicBloomGlareAccumulateParameters, )
+	SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
+	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, StreakTexture0)
+	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, StreakTexture1)
+	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, StreakTexture2)
+	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, StreakTexture3)
+	SHADER_PARAMETER_SAMPLER(SamplerState, StreakSampler)
+	SHADER_PARAMETER(FVector4f, GlareViewportSizeAndInvSize)
+	SHADER_PARAMETER(int32, NumStreaks)
+END_SHADER_PARAMETER_STRUCT()
+
 class FClassicBloomGlareAccumulatePS : public FGlobalShader
 {
 public:
 	DECLARE_GLOBAL_SHADER(FClassicBloomGlareAccumulatePS);
 	SHADER_USE_PARAMETER_STRUCT(FClassicBloomGlareAccumulatePS, FGlobalShader);
 
+	using FStageParameters = FClassicBloomGlareAccumulateParameters;
+
 	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
-		SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
-		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, StreakTexture0)
-		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, StreakTexture1)
-		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, StreakTexture2)
-		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, StreakTexture3)
-		SHADER_PARAMETER_SAMPLER(SamplerState, StreakSampler)
-		SHADER_PARAMETER(FVector4f, GlareViewportSizeAndInvSize)
-		SHADER_PARAMETER(int32, NumStreaks)
+		SHADER_PARAMETER_STRUCT_INCLUDE(FStageParameters, Stage)
 		RENDER_TARGET_BINDING_SLOTS()
 	END_SHADER_PARAMETER_STRUCT()
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
-		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::DirectionalGlare, Parameters.Platform);
+	}
+};
+
+// Compute variant (r.ToneMapFX.AsyncCompute)
+class FClassicBloomGlareAccumulateCS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FClassicBloomGlareAccumulateCS);
+	SHADER_USE_PARAMETER_STRUCT(FClassicBloomGlareAccumulateCS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_INCLUDE(FClassicBloomGlareAccumulateParameters, Stage)
+		SHADER_PARAMETER_STRUCT_INCLUDE(FToneMapComputeStageOutput, Output)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::DirectionalGlare, Parameters.Platform);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		FToneMapComputeStage::ModifyCompilationEnvironment(OutEnvironment);
 	}
 };
 
@@ -155,51 +287,115 @@ public:
 // ============================================================================
 
 // Kawase downsample shader - 13-tap filter with Karis average for firefly reduction
+BEGIN_SHADER_PARAMETER_STRUCT(FClassicBloomKawaseDownsampleParameters, )
+	SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
+	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, SourceTexture)
+	SHADER_PARAMETER_SAMPLER(SamplerState, SourceSampler)
+	SHADER_PARAMETER(FVector4f, SourceSizeAndInvSize) // Source texture size for sampling offsets
+	SHADER_PARAMETER(FVector4f, OutputSizeAndInvSize) // Output viewport size for UV calculation
+	SHADER_PARAMETER(FScreenTransform, SvPositionToSourceUV) // Transform SvPosition to source texture UV
+	SHADER_PARAMETER(float, BloomThreshold)
+	SHADER_PARAMETER(float, ThresholdKnee)
+	SHADER_PARAMETER(int32, MipLevel) // 0 = first downsample (apply threshold), >0 = subsequent
+	SHADER_PARAMETER(int32, bUseKarisAverage) // 1 = apply Karis average (first mip only)
+END_SHADER_PARAMETER_STRUCT()
+
 class FClassicBloomKawaseDownsamplePS : public FGlobalShader
 {
 public:
 	DECLARE_GLOBAL_SHADER(FClassicBloomKawaseDownsamplePS);
 	SHADER_USE_PARAMETER_STRUCT(FClassicBloomKawaseDownsamplePS, FGlobalShader);
 
+	using FStageParameters = FClassicBloomKawaseDownsampleParameters;
+
 	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
-		SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
-		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, SourceTexture)
-		SHADER_PARAMETER_SAMPLER(SamplerState, SourceSampler)
-		SHADER_PARAMETER(FVector4f, SourceSizeAndInvSize) // Source texture size for sampling offsets
-		SHADER_PARAMETER(FVector4f, OutputSizeAndInvSize) // Output viewport size for UV calculation
-		SHADER_PARAMETER(FScreenTransform, SvPositionToSourceUV) // Transform SvPosition to source texture UV
-		SHADER_PARAMETER(float, BloomThreshold)
-		SHADER_PARAMETER(float, ThresholdKnee)
-		SHADER_PARAMETER(int32, MipLevel) // 0 = first downsample (apply threshold), >0 = subsequent
-		SHADER_PARAMETER(int32, bUseKarisAverage) // 1 = apply Karis average (first mip only)
+		SHADER_PARAMETER_STRUCT_INCLUDE(FStageParameters, Stage)
 		RENDER_TARGET_BINDING_SLOTS()
 	END_SHADER_PARAMETER_STRUCT()
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
-		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::Kawase, Parameters.Platform);
+	}
+};
+
+// Compute variant (r.ToneMapFX.AsyncCompute)
+class FClassicBloomKawaseDownsampleCS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FClassicBloomKawaseDownsampleCS);
+	SHADER_USE_PARAMETER_STRUCT(FClassicBloomKawaseDownsampleCS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_INCLUDE(FClassicBloomKawaseDownsampleParameters, Stage)
+		SHADER_PARAMETER_STRUCT_INCLUDE(FToneMapComputeStageOutput, Output)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::Kawase, Parameters.Platform);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		FToneMapComputeStage::ModifyCompilationEnvironment(OutEnvironment);
 	}
 };
 
 // Kawase upsample shader - 9-tap tent filter with additive blend
+BEGIN_SHADER_PARAMETER_STRUCT(FClassicBloomKawaseUpsampleParameters, )
+	SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
+	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, SourceTexture)
+	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, PreviousMipTexture)
+	SHADER_PARAMETER_SAMPLER(SamplerState, SourceSampler)
+	SHADER_PARAMETER(FVector4f, OutputSizeAndInvSize) // Output viewport size for UV calculation
+	SHADER_PARAMETER(float, FilterRadius) // Radius in texture coordinates
+END_SHADER_PARAMETER_STRUCT()
+
 class FClassicBloomKawaseUpsamplePS : public FGlobalShader
 {
 public:
 	DECLARE_GLOBAL_SHADER(FClassicBloomKawaseUpsamplePS);
 	SHADER_USE_PARAMETER_STRUCT(FClassicBloomKawaseUpsamplePS, FGlobalShader);
 
+	using FStageParameters = FClassicBloomKawaseUpsampleParameters;
+
 	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
-		SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
-		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, SourceTexture)
-		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, PreviousMipTexture)
-		SHADER_PARAMETER_SAMPLER(SamplerState, SourceSampler)
-		SHADER_PARAMETER(FVector4f, OutputSizeAndInvSize) // Output viewport size for UV calculation
-		SHADER_PARAMETER(float, FilterRadius) // Radius in texture coordinates
+		SHADER_PARAMETER_STRUCT_INCLUDE(FStageParameters, Stage)
 		RENDER_TARGET_BINDING_SLOTS()
 	END_SHADER_PARAMETER_STRUCT()
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
-		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::Kawase, Parameters.Platform);
+	}
+};
+
+// Compute variant (r.ToneMapFX.AsyncCompute)
+class FClassicBloomKawaseUpsampleCS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FClassicBloomKawaseUpsampleCS);
+	SHADER_USE_PARAMETER_STRUCT(FClassicBloomKawaseUpsampleCS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_INCLUDE(FClassicBloomKawaseUpsampleParameters, Stage)
+		SHADER_PARAMETER_STRUCT_INCLUDE(FToneMapComputeStageOutput, Output)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::Kawase, Parameters.Platform);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		FToneMapComputeStage::ModifyCompilationEnvironment(OutEnvironment);
 	}
 };
@@ -0,0 +1,153 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RenderGraphBuilder.h"
+#include "RHIResources.h"
+
+struct FToneMapResolvedQuality;
+
+// =============================================================================
+// GPU budget governor — r.ToneMapFX.BudgetMs
+//
+// Closed loop over the measured GPU time of earlier frames:
+//
+//   timestamps (N frames old) → Step() → per-stage degrade level → Apply()
+//
+// When the ToneMapFX total stays over budget for DegradeFrames samples, the
+// most expensive governed stage drops one level.  Only after RecoverFrames
+// samples below BudgetMs * RecoverFraction does the cheapest degraded stage
+// climb back one level.  The gap between the two thresholds plus the sample
+// counts keep the loop from oscillating around the budget.
+//
+// Step() and Apply() are pure functions, so the decision logic can be driven
+// by synthetic timing traces as well as by the GPU timer — the
+// ToneMapFX.Governor automation tests (ToneMapFXTests) do exactly that.
+// =============================================================================
+
+enum class EToneMapGovernedStage : uint8
+{
+	Total,          // whole ToneMapFX pass — compared against the budget
+	Bloom,          // glare samples, Kawase mip count
+	Fattal,         // Jacobi iterations
+	LensEffects,    // lens resolution scale (and spike length with it)
+	Num,
+};
+
+struct FToneMapStageTimings
+{
+	float Ms[(int32)EToneMapGovernedStage::Num] = {};
+};
+
+struct FToneMapGovernorConfig
+{
+	float BudgetMs = 0.0f;          // <= 0 disables the governor
+	float RecoverFraction = 0.8f;   // recover only below BudgetMs * RecoverFraction
+	int32 DegradeFrames = 3;        // consecutive over-budget samples before a step down
+	int32 RecoverFrames = 30;       // consecutive under-budget samples before a step up
+	int32 MaxLevel = 4;
+};
+
+struct TONEMAPFX_API FToneMapGovernorState
+{
+	// Degrade level per stage (0 = untouched); the Total entry is unused
+	int32 Levels[(int32)EToneMapGovernedStage::Num] = {};
+	int32 OverBudgetSamples = 0;
+	int32 UnderBudgetSamples = 0;
+
+	int32 GetTotalLevel() const;
+};
+
+class TONEMAPFX_API FToneMapBudgetGovernor
+{
+public:
+	// Current CVar values (render thread)
+	static FToneMapGovernorConfig GetConfig_RenderThread();
+
+	// Advance the controller by one measured frame
+	static FToneMapGovernorState Step(
+		const FToneMapGovernorState& State,
+		const FToneMapStageTimings& Timings,
+		const FToneMapGovernorConfig& Config);
+
+	// Lower the resolved quality according to the per-stage levels
+	static void Apply(const FToneMapGovernorState& State, FToneMapResolvedQuality& Quality);
+};
+
+// =============================================================================
+// Per-stage GPU timer — timestamp query pairs read back without stalling
+//
+// Queries of a frame are kept until every one of them has landed; Poll()
+// never waits, so results typically arrive two or three frames late.  Frames
+// still pending once the ring wraps are dropped rather than waited on.
+// Render thread only.
+//
+// Timestamps are written on the graphics queue.  Stages whose chain runs on
+// async compute (bloom, lens) pass their output to End(): the end stamp reads
+// it, so RDG joins the async queue before writing it.  For those stages the
+// interval is the latency from the stage's start on the graphics queue until
+// its output is usable there — the part of the chain the frame waits for, not
+// its full async cost.
+// =============================================================================
+
+class FToneMapStageTimer
+{
+public:
+	// Start collecting queries for a new frame (no-op if FrameNumber is current)
+	void BeginFrame(uint64 FrameNumber);
+
+	void Begin(FRDGBuilder& GraphBuilder, EToneMapGovernedStage Stage);
+	void End(FRDGBuilder& GraphBuilder, EToneMapGovernedStage Stage, FRDGTextureRef Output = nullptr);
+
+	// Timings of the oldest completed frame; false if none is ready yet
+	bool Poll(FToneMapStageTimings& OutTimings);
+
+private:
+	struct FStageQuery
+	{
+		EToneMapGovernedStage Stage = EToneMapGovernedStage::Total;
+		FRHIPooledRenderQuery BeginQuery;
+		FRHIPooledRenderQuery EndQuery;
+	};
+
+	struct FFrameRecord
+	{
+		uint64 FrameNumber = 0;
+		TArray<FStageQuery> Queries;
+	};
+
+	// After: texture the stamp waits for (null: in graph order only)
+	FRHIRenderQuery* AddTimestamp(FRDGBuilder& GraphBuilder, FRHIPooledRenderQuery& OutQuery, FRDGTextureRef After = nullptr);
+
+	static constexpr int32 MaxFramesInFlight = 4;
+
+	FFrameRecord Frames[MaxFramesInFlight];
+	int32 CurrentFrame = 0;
+	FRenderQueryPoolRHIRef QueryPool;
+};
+
+// Times the enclosing scope like RDG_EVENT_SCOPE; does nothing when Timer is null
+class FToneMapScopedStageTimer
+{
+public:
+	FToneMapScopedStageTimer(FRDGBuilder& InGraphBuilder, FToneMapStageTimer* InTimer, EToneMapGovernedStage InStage)
+		: GraphBuilder(InGraphBuilder), Timer(InTimer), Stage(InStage)
+	{
+		if (Timer) Timer->Begin(GraphBuilder, Stage);
+	}
+
+	~FToneMapScopedStageTimer()
+	{
+		if (Timer) Timer->End(GraphBuilder, Stage, Output);
+	}
+
+	// Result of a stage that may run on async compute; the end stamp waits for it
+	void SetOutput(FRDGTextureRef InOutput) { Output = InOutput; }
+
+private:
+	FRDGBuilder& GraphBuilder;
+	FToneMapStageTimer* Timer;
+	EToneMapGovernedStage Stage;
+	FRDGTextureRef Output = nullptr;
+};
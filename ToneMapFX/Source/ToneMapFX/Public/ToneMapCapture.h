@@ -0,0 +1,162 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+#include "RenderGraphBuilder.h"
+#include "ScreenPass.h"
+#include "UObject/StrongObjectPtr.h"
+#include "ToneMapScalability.h"
+#include "ToneMapBudgetGovernor.h"
+#include "ToneMapReferenceImage.h"
+
+class FViewInfo;
+class FRHIGPUTextureReadback;
+class UToneMapComponent;
+
+// =============================================================================
+// Frame capture and replay
+// (r.ToneMapFX.Capture, r.ToneMapFX.Replay, -run=ToneMapFXReplay)
+//
+// r.ToneMapFX.Capture [Name] records the next ToneMapFX frame of the first
+// view that runs the pass into Saved/ToneMapFX/Captures/<Name>/:
+//   SceneColor.exr  scene colour over the view rect, pre-exposed as rendered
+//   Bloom.exr       the engine's CombinedBloom at view size, when the main
+//                   pass composites it (ReplaceTonemap without ToneMapFX bloom)
+//   Settings.txt    the blended settings snapshot, as a preset
+//   View.txt        view size, PreExposure, eye adaptation, the Krawczyk
+//                   adapted luminance and the quality the frame resolved to
+// The images go through GPU texture readbacks polled on later frames; the
+// render thread never waits, and the files are written on a worker thread.
+//
+// FToneMapReplay loads a capture.  'r.ToneMapFX.Replay <capture> gpu' feeds
+// its scene colour and settings back into the live view and logs the GPU
+// timings of the governed stages (ToneMapBudgetGovernor.h).  The CPU replay
+// through the reference pipeline lives in the ToneMapFXTests module
+// (ToneMapCPUReplay.h), as does the console command.
+// =============================================================================
+
+/** Everything about the captured frame that is not an image or a setting (View.txt) */
+struct TONEMAPFX_API FToneMapCaptureView
+{
+	FIntPoint ViewSize = FIntPoint::ZeroValue;
+	float PreExposure = 1.0f;
+	float EyeAdaptationExposure = 1.0f;     // View.GetLastEyeAdaptationExposure()
+	float AdaptedLuminance = -1.0f;         // Krawczyk adapted luminance of this frame; -1 without
+	float DeltaTime = 0.016f;
+	int32 QualityLevel = 3;                 // r.ToneMapFX.Quality
+	FToneMapResolvedQuality Quality;        // after the tier and the governor
+	uint64 FrameNumber = 0;
+	bool bReplaceTonemap = false;
+	bool bEngineBloom = false;              // Bloom.exr was captured
+	bool bHalfPrecision = false;            // r.ToneMapFX.HalfPrecision on this platform
+	FString ShaderPlatform;
+
+	// Key=Value lines; floats round-trip exactly
+	FString ToString() const;
+	bool Parse(const FString& Text);
+};
+
+/** A capture loaded from disk */
+struct TONEMAPFX_API FToneMapCaptureData
+{
+	FString Directory;
+	FToneMapCaptureView View;
+	FToneMapReferenceImage SceneColor;      // as captured (pre-exposed)
+	FToneMapReferenceImage Bloom;           // empty unless View.bEngineBloom
+	TStrongObjectPtr<UToneMapComponent> Settings;
+};
+
+// =============================================================================
+// Capture — readbacks owned by the view extension
+// =============================================================================
+
+class TONEMAPFX_API FToneMapFrameCapture
+{
+public:
+	FToneMapFrameCapture();
+	~FToneMapFrameCapture();
+
+	// Capture the next ToneMapFX frame; an empty Name uses a timestamp (game thread)
+	static void Request(const FString& Name);
+
+	// Saved/ToneMapFX/Captures
+	static FString GetCaptureRoot();
+
+	// Claim a pending request for a view about to render with Settings: writes
+	// Settings.txt and returns the directory the render thread should fill, or
+	// an empty string when nothing is requested (game thread, SetupView)
+	static FString BeginCapture_GameThread(const UToneMapComponent& Settings);
+
+	// Queue the readbacks of this frame's inputs into Directory.  Bloom and
+	// AdaptedLum may be null / invalid.
+	void AddPasses(
+		FRDGBuilder& GraphBuilder,
+		const FViewInfo& View,
+		const FString& Directory,
+		const FToneMapCaptureView& CaptureView,
+		FScreenPassTexture SceneColor,
+		FScreenPassTexture Bloom,
+		FRDGTextureRef AdaptedLum);
+
+	// Hand every capture whose readbacks have landed to a writer task; never blocks
+	void Poll_RenderThread();
+
+private:
+	struct FPending;
+
+	TArray<TUniquePtr<FPending>> Pending;
+};
+
+// =============================================================================
+// GPU replay — the capture fed back into one live view
+// =============================================================================
+
+class TONEMAPFX_API FToneMapGPUReplay
+{
+public:
+	FToneMapGPUReplay(const FToneMapCaptureData& Capture, int32 InNumFrames);
+
+	// Swap the view's scene colour for the captured one.  False (and the
+	// replay ends) when the view size no longer matches the capture.
+	bool Inject_RenderThread(FRDGBuilder& GraphBuilder, const FViewInfo& View, FScreenPassTexture& InOutSceneColor);
+
+	// Timings polled from the stage timer while the replay runs; the first
+	// frames may still belong to the live scene and are dropped
+	void AddTimings_RenderThread(const FToneMapStageTimings& Timings);
+
+	bool IsFinished() const { return bFinished.load(std::memory_order_acquire); }
+
+private:
+	void Finish_RenderThread();
+
+	FString Directory;
+	FIntPoint ViewSize = FIntPoint::ZeroValue;
+	TArray<FLinearColor> Pixels;            // released once uploaded
+	int32 NumFrames = 0;
+
+	TRefCountPtr<IPooledRenderTarget> SceneColorRT;
+	int32 NumInjected = 0;
+	int32 NumSamples = 0;
+	FToneMapStageTimings Sum;
+	std::atomic<bool> bFinished = false;
+};
+
+// =============================================================================
+// Replay
+// =============================================================================
+
+class TONEMAPFX_API FToneMapReplay
+{
+public:
+	// A capture name under GetCaptureRoot(), or a directory
+	static FString ResolveCaptureDirectory(const FString& NameOrPath);
+
+	static bool Load(const FString& Directory, FToneMapCaptureData& OutCapture);
+
+	// Replay the capture on the GPU for NumFrames frames of the live view
+	// (game thread); the view extension picks the request up in SetupView
+	static bool RequestGPU(const FString& Directory, int32 NumFrames);
+	static bool ClaimGPURequest_GameThread(FString& OutDirectory, int32& OutNumFrames);
+};
@@ -0,0 +1,95 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GlobalShader.h"
+#include "ShaderParameterStruct.h"
+#include "RenderGraphBuilder.h"
+
+class FToneMapTransientTextures;
+
+// =============================================================================
+// Frame-average colour for Correct Color Cast (r.ToneMapFX.GlobalColorCast)
+//
+// Gray-world needs the scene average.  The coarse Dynamic Contrast blur was
+// used as a local stand-in: two full-resolution passes, and a correction that
+// drifted across the screen.  Instead a two-dispatch reduction writes the
+// mean RGB (or a luma-weighted mean) to a 1x1 texture, smoothed over time
+// against the previous frame, and the main pass reads it as a constant.
+// =============================================================================
+
+class FToneMapColorAverageReduceCS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FToneMapColorAverageReduceCS);
+	SHADER_USE_PARAMETER_STRUCT(FToneMapColorAverageReduceCS, FGlobalShader);
+
+	static constexpr int32 GroupSize = 16;  // GroupSize² threads, one 2x2 quad each
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, SceneColorTexture)
+		SHADER_PARAMETER_SAMPLER(SamplerState, SceneColorSampler)
+		SHADER_PARAMETER(FIntVector4, SceneColorRect)
+		SHADER_PARAMETER(FVector2f, SceneColorExtentInv)
+		SHADER_PARAMETER(float, LumaWeighting)
+		SHADER_PARAMETER_RDG_BUFFER_UAV(RWStructuredBuffer<float4>, PartialSums)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		OutEnvironment.SetDefine(TEXT("GROUP_SIZE"), GroupSize);
+	}
+};
+
+class FToneMapColorAverageResolveCS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FToneMapColorAverageResolveCS);
+	SHADER_USE_PARAMETER_STRUCT(FToneMapColorAverageResolveCS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<float4>, PartialSumsSRV)
+		SHADER_PARAMETER(uint32, NumPartials)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, PrevAverageTexture)
+		SHADER_PARAMETER(float, bHasPrevAverage)
+		SHADER_PARAMETER(float, AdaptSpeed)
+		SHADER_PARAMETER(float, DeltaTime)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, AverageOutput)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		OutEnvironment.SetDefine(TEXT("GROUP_SIZE"), FToneMapColorAverageReduceCS::GroupSize);
+	}
+};
+
+class TONEMAPFX_API FToneMapColorAverage
+{
+public:
+	// True when Correct Color Cast should use the frame average (render thread)
+	static bool UseGlobal_RenderThread();
+
+	// Reduce SceneRect of SceneColor to its 1x1 average colour.  History holds
+	// the previous frame's result and receives this frame's.
+	static FRDGTextureRef AddPasses(
+		FRDGBuilder& GraphBuilder,
+		const FGlobalShaderMap* ShaderMap,
+		FToneMapTransientTextures& Transients,
+		FRDGTextureRef SceneColor,
+		const FIntRect& SceneRect,
+		TRefCountPtr<IPooledRenderTarget>& History,
+		float DeltaTime);
+};
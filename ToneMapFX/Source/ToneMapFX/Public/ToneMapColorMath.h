@@ -0,0 +1,249 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// =============================================================================
+// Shared colour math — C++ build of Shaders/Private/ToneMapColorMath.ush
+//
+// The grading operators and film curves are written once, in the subset of
+// HLSL that also compiles as C++.  This header supplies the HLSL vector types
+// and intrinsics that subset uses, then includes the shader header inside
+// the ToneMapColorMath namespace, so CPU code calls the very functions the
+// GPU passes run:
+//
+//   ToneMapColorMath::float3 C = ToneMapColorMath::ApplyWhiteBalance(Color, 20.0f, 0.0f);
+//
+// FToneMapColorMath evaluates every operator on a fixed RGB lattice and
+// the ToneMapFX.ColorMath automation tests compare the result with a golden table.
+// The precision-generic operators are also built on an emulated fp16 type
+// (ToneMapColorMath::Half) to measure what the half permutation costs
+// (r.ToneMapFX.HalfPrecisionError).
+// =============================================================================
+
+namespace ToneMapColorMath
+{
+	struct float2
+	{
+		float x, y;
+
+		float2() = default;
+		constexpr float2(float s) : x(s), y(s) {}
+		constexpr float2(float InX, float InY) : x(InX), y(InY) {}
+	};
+
+	struct float3
+	{
+		float x, y, z;
+
+		float3() = default;
+		constexpr float3(float s) : x(s), y(s), z(s) {}  // HLSL scalar splat
+		constexpr float3(float InX, float InY, float InZ) : x(InX), y(InY), z(InZ) {}
+
+		float3& operator+=(const float3& B) { x += B.x; y += B.y; z += B.z; return *this; }
+		float3& operator-=(const float3& B) { x -= B.x; y -= B.y; z -= B.z; return *this; }
+		float3& operator*=(const float3& B) { x *= B.x; y *= B.y; z *= B.z; return *this; }
+		float3& operator/=(const float3& B) { x /= B.x; y /= B.y; z /= B.z; return *this; }
+	};
+
+	struct float4
+	{
+		float x, y, z, w;
+
+		float4() = default;
+		constexpr float4(float s) : x(s), y(s), z(s), w(s) {}
+		constexpr float4(float InX, float InY, float InZ, float InW) : x(InX), y(InY), z(InZ), w(InW) {}
+	};
+
+	inline float3 operator-(const float3& A) { return float3(-A.x, -A.y, -A.z); }
+	inline float3 operator+(const float3& A, const float3& B) { return float3(A.x + B.x, A.y + B.y, A.z + B.z); }
+	inline float3 operator-(const float3& A, const float3& B) { return float3(A.x - B.x, A.y - B.y, A.z - B.z); }
+	inline float3 operator*(const float3& A, const float3& B) { return float3(A.x * B.x, A.y * B.y, A.z * B.z); }
+	inline float3 operator/(const float3& A, const float3& B) { return float3(A.x / B.x, A.y / B.y, A.z / B.z); }
+	inline float3 operator+(const float3& A, float B) { return A + float3(B); }
+	inline float3 operator-(const float3& A, float B) { return A - float3(B); }
+	inline float3 operator*(const float3& A, float B) { return A * float3(B); }
+	inline float3 operator/(const float3& A, float B) { return A / float3(B); }
+	inline float3 operator+(float A, const float3& B) { return float3(A) + B; }
+	inline float3 operator-(float A, const float3& B) { return float3(A) - B; }
+	inline float3 operator*(float A, const float3& B) { return float3(A) * B; }
+	inline float3 operator/(float A, const float3& B) { return float3(A) / B; }
+
+	// ---- Intrinsics (HLSL semantics) ----
+	inline float abs(float A) { return FMath::Abs(A); }
+	inline float sign(float A) { return A > 0.0f ? 1.0f : (A < 0.0f ? -1.0f : 0.0f); }
+	inline float min(float A, float B) { return FMath::Min(A, B); }
+	inline float max(float A, float B) { return FMath::Max(A, B); }
+	inline float clamp(float A, float Lo, float Hi) { return FMath::Clamp(A, Lo, Hi); }
+	inline float saturate(float A) { return FMath::Clamp(A, 0.0f, 1.0f); }
+	inline float lerp(float A, float B, float T) { return A + (B - A) * T; }
+	inline float frac(float A) { return A - FMath::FloorToFloat(A); }
+	inline float pow(float A, float B) { return FMath::Pow(A, B); }
+	inline float exp2(float A) { return FMath::Exp2(A); }
+	inline float log2(float A) { return FMath::Log2(A); }
+	inline float smoothstep(float Lo, float Hi, float A)
+	{
+		const float T = saturate((A - Lo) / (Hi - Lo));
+		return T * T * (3.0f - 2.0f * T);
+	}
+
+	inline float dot(const float2& A, const float2& B) { return A.x * B.x + A.y * B.y; }
+	inline float dot(const float3& A, const float3& B) { return A.x * B.x + A.y * B.y + A.z * B.z; }
+
+	inline float3 abs(const float3& A) { return float3(abs(A.x), abs(A.y), abs(A.z)); }
+	inline float3 sign(const float3& A) { return float3(sign(A.x), sign(A.y), sign(A.z)); }
+	inline float3 min(const float3& A, const float3& B) { return float3(min(A.x, B.x), min(A.y, B.y), min(A.z, B.z)); }
+	inline float3 max(const float3& A, const float3& B) { return float3(max(A.x, B.x), max(A.y, B.y), max(A.z, B.z)); }
+	inline float3 min(const float3& A, float B) { return min(A, float3(B)); }
+	inline float3 max(const float3& A, float B) { return max(A, float3(B)); }
+	inline float3 clamp(const float3& A, float Lo, float Hi) { return float3(clamp(A.x, Lo, Hi), clamp(A.y, Lo, Hi), clamp(A.z, Lo, Hi)); }
+	inline float3 saturate(const float3& A) { return clamp(A, 0.0f, 1.0f); }
+	inline float3 lerp(const float3& A, const float3& B, const float3& T) { return A + (B - A) * T; }
+	inline float3 lerp(const float3& A, const float3& B, float T) { return A + (B - A) * T; }
+	inline float3 pow(const float3& A, float B) { return float3(pow(A.x, B), pow(A.y, B), pow(A.z, B)); }
+	inline float3 log2(const float3& A) { return float3(log2(A.x), log2(A.y), log2(A.z)); }
+
+	#define TONEMAP_FN inline
+	#include "../../../Shaders/Private/ToneMapColorMath.ush"
+
+	// -------------------------------------------------------------------------
+	// Emulated min16float for the r.ToneMapFX.HalfPrecision permutation.
+	// Every value is rounded to the nearest fp16 after each operation — the
+	// worst case of a native 16-bit ALU, where real hardware may keep more.
+	// There are no implicit conversions to or from float, so an unwrapped
+	// literal in ToneMapColorMathOps.ush fails to compile here as well.
+	// -------------------------------------------------------------------------
+	namespace Half
+	{
+		struct half
+		{
+			float V;  // always exactly representable in fp16
+
+			half() = default;
+			explicit half(float F) : V(FFloat16(F).GetFloat()) {}
+			explicit half(double D) : half((float)D) {}
+
+			explicit operator float() const { return V; }
+		};
+
+		inline half operator-(half A) { return half(-A.V); }
+		inline half operator+(half A, half B) { return half(A.V + B.V); }
+		inline half operator-(half A, half B) { return half(A.V - B.V); }
+		inline half operator*(half A, half B) { return half(A.V * B.V); }
+		inline half operator/(half A, half B) { return half(A.V / B.V); }
+		inline half& operator+=(half& A, half B) { return A = A + B; }
+		inline half& operator-=(half& A, half B) { return A = A - B; }
+		inline half& operator*=(half& A, half B) { return A = A * B; }
+		inline half& operator/=(half& A, half B) { return A = A / B; }
+		inline bool operator<(half A, half B) { return A.V < B.V; }
+		inline bool operator>(half A, half B) { return A.V > B.V; }
+		inline bool operator<=(half A, half B) { return A.V <= B.V; }
+		inline bool operator>=(half A, half B) { return A.V >= B.V; }
+		inline bool operator==(half A, half B) { return A.V == B.V; }
+
+		struct half3
+		{
+			half x, y, z;
+
+			half3() = default;
+			explicit half3(half s) : x(s), y(s), z(s) {}
+			half3(half InX, half InY, half InZ) : x(InX), y(InY), z(InZ) {}
+			explicit half3(const float3& F) : x(F.x), y(F.y), z(F.z) {}
+
+			float3 ToFloat() const { return float3(x.V, y.V, z.V); }
+		};
+
+		struct half4
+		{
+			half x, y, z, w;
+
+			half4() = default;
+			explicit half4(half s) : x(s), y(s), z(s), w(s) {}
+			half4(half InX, half InY, half InZ, half InW) : x(InX), y(InY), z(InZ), w(InW) {}
+			explicit half4(const float4& F) : x(F.x), y(F.y), z(F.z), w(F.w) {}
+		};
+
+		inline half3 operator-(const half3& A) { return half3(-A.x, -A.y, -A.z); }
+		inline half3 operator+(const half3& A, const half3& B) { return half3(A.x + B.x, A.y + B.y, A.z + B.z); }
+		inline half3 operator-(const half3& A, const half3& B) { return half3(A.x - B.x, A.y - B.y, A.z - B.z); }
+		inline half3 operator*(const half3& A, const half3& B) { return half3(A.x * B.x, A.y * B.y, A.z * B.z); }
+		inline half3 operator/(const half3& A, const half3& B) { return half3(A.x / B.x, A.y / B.y, A.z / B.z); }
+		inline half3 operator+(const half3& A, half B) { return A + half3(B); }
+		inline half3 operator-(const half3& A, half B) { return A - half3(B); }
+		inline half3 operator*(const half3& A, half B) { return A * half3(B); }
+		inline half3 operator/(const half3& A, half B) { return A / half3(B); }
+		inline half3 operator+(half A, const half3& B) { return half3(A) + B; }
+		inline half3 operator-(half A, const half3& B) { return half3(A) - B; }
+		inline half3 operator*(half A, const half3& B) { return half3(A) * B; }
+		inline half3 operator/(half A, const half3& B) { return half3(A) / B; }
+
+		// ---- Intrinsics: evaluated in float, result rounded to fp16 ----
+		inline half abs(half A) { return half(FMath::Abs(A.V)); }
+		inline half sign(half A) { return half(A.V > 0.0f ? 1.0f : (A.V < 0.0f ? -1.0f : 0.0f)); }
+		inline half min(half A, half B) { return A.V < B.V ? A : B; }
+		inline half max(half A, half B) { return A.V > B.V ? A : B; }
+		inline half clamp(half A, half Lo, half Hi) { return min(max(A, Lo), Hi); }
+		inline half saturate(half A) { return clamp(A, half(0.0f), half(1.0f)); }
+		inline half lerp(half A, half B, half T) { return A + (B - A) * T; }
+		inline half frac(half A) { return half(A.V - FMath::FloorToFloat(A.V)); }
+		inline half pow(half A, half B) { return half(FMath::Pow(A.V, B.V)); }
+		inline half exp2(half A) { return half(FMath::Exp2(A.V)); }
+		inline half log2(half A) { return half(FMath::Log2(A.V)); }
+		inline half smoothstep(half Lo, half Hi, half A)
+		{
+			const half T = saturate((A - Lo) / (Hi - Lo));
+			return T * T * (half(3.0f) - half(2.0f) * T);
+		}
+
+		inline half dot(const half3& A, const half3& B) { return A.x * B.x + A.y * B.y + A.z * B.z; }
+
+		inline half3 abs(const half3& A) { return half3(abs(A.x), abs(A.y), abs(A.z)); }
+		inline half3 sign(const half3& A) { return half3(sign(A.x), sign(A.y), sign(A.z)); }
+		inline half3 min(const half3& A, const half3& B) { return half3(min(A.x, B.x), min(A.y, B.y), min(A.z, B.z)); }
+		inline half3 max(const half3& A, const half3& B) { return half3(max(A.x, B.x), max(A.y, B.y), max(A.z, B.z)); }
+		inline half3 min(const half3& A, half B) { return min(A, half3(B)); }
+		inline half3 max(const half3& A, half B) { return max(A, half3(B)); }
+		inline half3 clamp(const half3& A, half Lo, half Hi) { return half3(clamp(A.x, Lo, Hi), clamp(A.y, Lo, Hi), clamp(A.z, Lo, Hi)); }
+		inline half3 saturate(const half3& A) { return clamp(A, half(0.0f), half(1.0f)); }
+		inline half3 lerp(const half3& A, const half3& B, half T) { return A + (B - A) * T; }
+		inline half3 pow(const half3& A, half B) { return half3(pow(A.x, B), pow(A.y, B), pow(A.z, B)); }
+
+		#define TM_REAL  half
+		#define TM_REAL3 half3
+		#define TM_REAL4 half4
+		#include "../../../Shaders/Private/ToneMapColorMathOps.ush"
+		#undef TM_REAL
+		#undef TM_REAL3
+		#undef TM_REAL4
+	}
+
+	#undef TONEMAP_FN
+}
+
+class TONEMAPFX_API FToneMapColorMath
+{
+public:
+	// Lattice levels per channel — dark, mid grey, white and HDR values
+	static constexpr int32 LatticeLevels = 6;
+	static constexpr int32 LatticeSize = LatticeLevels * LatticeLevels * LatticeLevels;
+
+	static int32 GetNumOperators();
+	static const TCHAR* GetOperatorName(int32 Operator);
+
+	// Input colour Index of the lattice (R fastest)
+	static ToneMapColorMath::float3 GetLatticeColor(int32 Index);
+
+	// One operator with the fixed parameters the golden table was built with
+	static ToneMapColorMath::float3 EvaluateOperator(int32 Operator, const ToneMapColorMath::float3& Color);
+
+	// The same operator through ToneMapColorMath::Half, input rounded to fp16.
+	// Only operators with a min16float overload have one; the film curves are
+	// fp32 in every permutation.
+	static bool HasHalfVariant(int32 Operator);
+	static ToneMapColorMath::float3 EvaluateOperatorHalf(int32 Operator, const ToneMapColorMath::float3& Color);
+
+	// Worst half-vs-float difference of an operator: absolute over the LDR part
+	// of the lattice (levels up to 1), relative above 1 over the whole lattice
+	static void MeasureHalfPrecisionError(int32 Operator, float& OutMaxErrorLDR, float& OutMaxErrorHDR);
+};
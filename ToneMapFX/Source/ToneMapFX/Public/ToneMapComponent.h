@@ -7,6 +7,9 @@
 #include "Engine/Texture.h"
 #include "ToneMapComponent.generated.h"
 
+class UToneMapPresetAsset;
+struct FStreamableHandle;
+
 // ============================================================================
 // Bloom enums
 // ============================================================================
@@ -117,6 +120,20 @@ enum class EToneMapAutoExposure : uint8
 		ToolTip = "(EXPERIMENTAL) Krawczyk et al. 2005: automatic scene key estimation from log-average luminance. UE's built-in exposure is disabled automatically.")
 };
 
+/** Which part of the frame the Krawczyk auto-exposure meters */
+UENUM(BlueprintType)
+enum class EToneMapMeteringMode : uint8
+{
+	Average         UMETA(DisplayName = "Average",
+		ToolTip = "Whole frame, every sample weighted equally."),
+	CenterWeighted  UMETA(DisplayName = "Center-Weighted",
+		ToolTip = "Whole frame, with the centre weighted about four times as much as the corners."),
+	Spot            UMETA(DisplayName = "Spot",
+		ToolTip = "Only a circle in the centre of the frame (see Metering Spot Size)."),
+	Mask            UMETA(DisplayName = "Mask Texture",
+		ToolTip = "Per-pixel weight from the red channel of Metering Mask (white = metered, black = ignored).")
+};
+
 /** Processing path: how color grading operations are evaluated */
 UENUM(BlueprintType)
 enum class EToneMapProcessingPath : uint8
@@ -127,6 +144,16 @@ enum class EToneMapProcessingPath : uint8
 		ToolTip = "Non-spatial operations baked into a 32x32x32 3D LUT, sampled with one trilinear fetch per pixel. Trades ALU for texture bandwidth — same visual quality with lower GPU cost. Use Dither Quantization for anti-banding.")
 };
 
+/** Clarity: how the local-contrast base layer is computed */
+UENUM(BlueprintType)
+enum class EToneMapClarityMode : uint8
+{
+	Gaussian     UMETA(DisplayName = "Gaussian",
+		ToolTip = "Classic unsharp mask: the base is a Gaussian blur of scene colour. Can halo around high-contrast edges at large radii."),
+	GuidedFilter UMETA(DisplayName = "Guided Filter (Edge-Aware)",
+		ToolTip = "He et al. guided filter on log luminance. Edges stronger than Clarity Edge Threshold are preserved, so no halos; cost is independent of Clarity Radius. Requires compute typed UAV support, otherwise falls back to Gaussian.")
+};
+
 // ============================================================================
 // Vignette enums
 // ============================================================================
@@ -171,6 +198,66 @@ enum class EVignetteTextureChannel : uint8
 		ToolTip = "Read the blue channel.")
 };
 
+/** Easing applied to the progress of a preset transition */
+UENUM(BlueprintType)
+enum class EToneMapTransitionCurve : uint8
+{
+	Linear    UMETA(DisplayName = "Linear"),
+	EaseIn    UMETA(DisplayName = "Ease In",     ToolTip = "Starts slowly, finishes fast."),
+	EaseOut   UMETA(DisplayName = "Ease Out",    ToolTip = "Starts fast, settles slowly."),
+	EaseInOut UMETA(DisplayName = "Ease In/Out", ToolTip = "Smoothstep — slow at both ends.")
+};
+
+/**
+ * LUT blend request carried by a resolved settings snapshot (render thread).
+ * When From and To are set, the LUT path bakes each end point once and lerps
+ * the two LUTs per pixel instead of rebaking the interpolated settings.
+ */
+struct FToneMapLUTBlend
+{
+	const UToneMapComponent* From = nullptr;
+	const UToneMapComponent* To   = nullptr;
+	float Alpha = 0.0f;
+};
+
+/** Krawczyk auto-exposure statistics of a recent frame, read back from the GPU */
+USTRUCT(BlueprintType)
+struct TONEMAPFX_API FToneMapExposureStats
+{
+	GENERATED_BODY()
+
+	/** False until the first readback has arrived. */
+	UPROPERTY(BlueprintReadOnly, Category = "Tone Map|Auto-Exposure")
+	bool bValid = false;
+
+	/** Render frame the statistics were measured on (a few frames behind the game). */
+	UPROPERTY(BlueprintReadOnly, Category = "Tone Map|Auto-Exposure")
+	int64 FrameNumber = 0;
+
+	/** Temporally adapted scene luminance (pre-exposure removed). */
+	UPROPERTY(BlueprintReadOnly, Category = "Tone Map|Auto-Exposure")
+	float AdaptedLuminance = 0.0f;
+
+	/** Scene luminance measured on that frame, before adaptation. */
+	UPROPERTY(BlueprintReadOnly, Category = "Tone Map|Auto-Exposure")
+	float MeasuredLuminance = 0.0f;
+
+	/** Auto-exposure multiplier applied to the scene (manual Exposure not included). */
+	UPROPERTY(BlueprintReadOnly, Category = "Tone Map|Auto-Exposure")
+	float AutoExposure = 1.0f;
+
+	/** Metering histogram: fraction of metering weight per log2-luminance bin
+	    (64 bins, -10 to +14 EV).  Empty with r.ToneMapFX.HistogramMetering 0. */
+	UPROPERTY(BlueprintReadOnly, Category = "Tone Map|Auto-Exposure")
+	TArray<float> Histogram;
+};
+
+/** Fired when an asynchronously loaded preset has been applied */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnToneMapPresetLoaded, UToneMapPresetAsset*, Preset);
+
+/** Fired on the game thread when new Krawczyk exposure statistics arrive */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnToneMapExposureMeasured, const FToneMapExposureStats&, Stats);
+
 /**
  * Scene component that drives the Tone Map FX post-process effect.
  * Place on any actor to enable Photoshop Camera-Raw-style color grading.
@@ -299,6 +386,17 @@ public:
 			  EditCondition = "Clarity != 0"))
 	float ClarityRadius = 8.0f;
 
+	/** Base-layer filter for Clarity. Guided Filter is edge-aware and halo-free. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tone Map|Presence",
+		meta=(EditCondition = "Clarity != 0"))
+	EToneMapClarityMode ClarityMode = EToneMapClarityMode::Gaussian;
+
+	/** Guided Filter: luminance step (stops) above which an edge is preserved rather than enhanced. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tone Map|Presence",
+		meta=(ClampMin = "0.05", ClampMax = "4.0", UIMin = "0.05", UIMax = "4.0",
+			  EditCondition = "Clarity != 0 && ClarityMode == EToneMapClarityMode::GuidedFilter"))
+	float ClarityEdgeThreshold = 0.5f;
+
 	/** Selective saturation — boosts under-saturated colours more than saturated ones. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tone Map|Presence",
 		meta=(ClampMin = "-100.0", ClampMax = "100.0", UIMin = "-100.0", UIMax = "100.0"))
@@ -600,6 +698,37 @@ public:
 		      EditCondition = "Mode == EToneMapMode::ReplaceTonemap && AutoExposureMode == EToneMapAutoExposure::Krawczyk"))
 	float MaxAutoExposure = 20.0f;
 
+	/** Which part of the frame is metered.  Needs r.ToneMapFX.HistogramMetering 1 (default).
+	    Average with the full histogram kept is the log-average of earlier versions. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tone Map|Auto-Exposure",
+		meta=(EditCondition = "Mode == EToneMapMode::ReplaceTonemap && AutoExposureMode == EToneMapAutoExposure::Krawczyk"))
+	EToneMapMeteringMode MeteringMode = EToneMapMeteringMode::Average;
+
+	/** Darkest part of the luminance histogram ignored by metering, in percent.
+	    Keeps deep shadows and black borders from brightening the image; 10 is a good start. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tone Map|Auto-Exposure",
+		meta=(ClampMin = "0.0", ClampMax = "99.0", UIMin = "0.0", UIMax = "50.0",
+		      EditCondition = "Mode == EToneMapMode::ReplaceTonemap && AutoExposureMode == EToneMapAutoExposure::Krawczyk"))
+	float MeteringLowPercent = 0.0f;
+
+	/** Brightest part of the histogram kept by metering, in percent.
+	    Lower values stop a bright sky or a single lamp from darkening the image; 90 is a good start. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tone Map|Auto-Exposure",
+		meta=(ClampMin = "1.0", ClampMax = "100.0", UIMin = "50.0", UIMax = "100.0",
+		      EditCondition = "Mode == EToneMapMode::ReplaceTonemap && AutoExposureMode == EToneMapAutoExposure::Krawczyk"))
+	float MeteringHighPercent = 100.0f;
+
+	/** Radius of the spot-metering circle as a fraction of the screen height. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tone Map|Auto-Exposure",
+		meta=(ClampMin = "0.01", ClampMax = "1.0", UIMin = "0.02", UIMax = "0.5",
+		      EditCondition = "Mode == EToneMapMode::ReplaceTonemap && AutoExposureMode == EToneMapAutoExposure::Krawczyk && MeteringMode == EToneMapMeteringMode::Spot"))
+	float MeteringSpotSize = 0.1f;
+
+	/** Metering weight mask mapped over the screen.  Red channel: white = metered, black = ignored. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tone Map|Auto-Exposure",
+		meta=(EditCondition = "Mode == EToneMapMode::ReplaceTonemap && AutoExposureMode == EToneMapAutoExposure::Krawczyk && MeteringMode == EToneMapMeteringMode::Mask"))
+	TObjectPtr<UTexture> MeteringMaskTexture;
+
 	// =========================================================================
 	// Film Curve (ReplaceTonemap mode only)
 	// =========================================================================
@@ -1103,6 +1232,58 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tone Map|Engine Overrides")
 	bool bDisableUnrealBloom = true;
 
+	// =========================================================================
+	// Volume — where these settings apply and how they blend with others
+	// =========================================================================
+
+	/** Apply everywhere in the level (classic single-actor behaviour).
+	    Disable to restrict the settings to the box below and fade them out
+	    over Blend Radius — overlapping components are blended per view. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tone Map|Volume")
+	bool bUnbound = true;
+
+	/** Half-size of the volume box in local space (scaled and rotated with the component). */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tone Map|Volume",
+		meta=(EditCondition = "!bUnbound"))
+	FVector BoxExtent = FVector(500.0f);
+
+	/** Distance outside the box (world units) over which the settings fade to zero weight. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tone Map|Volume",
+		meta=(ClampMin = "0.0", UIMin = "0.0", UIMax = "5000.0", EditCondition = "!bUnbound"))
+	float BlendRadius = 100.0f;
+
+	/** Weight of these settings when the camera is inside the volume.
+	    1 = fully replaces lower-priority settings, 0 = no effect. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tone Map|Volume",
+		meta=(ClampMin = "0.0", ClampMax = "1.0", UIMin = "0.0", UIMax = "1.0"))
+	float BlendWeight = 1.0f;
+
+	/** Overlapping components are blended in ascending priority — the highest priority wins.
+	    Floats, integers and colors interpolate; toggles, modes and textures switch at 50% weight. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tone Map|Volume")
+	float Priority = 0.0f;
+
+	/** Latest Krawczyk exposure statistics of this world (a few frames late; bValid
+	    is false until the first readback arrives).  See r.ToneMapFX.ExposureReadback. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Tone Map|Auto-Exposure")
+	FToneMapExposureStats GetLastMeasuredExposure() const;
+
+	/** Broadcast whenever new Krawczyk exposure statistics have been read back. */
+	UPROPERTY(BlueprintAssignable, Category = "Tone Map|Auto-Exposure")
+	FOnToneMapExposureMeasured OnExposureMeasured;
+
+	/** Switch between unbound and box-bounded behaviour at runtime. */
+	UFUNCTION(BlueprintCallable, Category = "Tone Map|Volume")
+	void SetUnbound(bool bInUnbound);
+
+	/** Resize the volume box at runtime. */
+	UFUNCTION(BlueprintCallable, Category = "Tone Map|Volume")
+	void SetBoxExtent(FVector InBoxExtent);
+
+	/** Change the fade distance at runtime. */
+	UFUNCTION(BlueprintCallable, Category = "Tone Map|Volume")
+	void SetBlendRadius(float InBlendRadius);
+
 	// =========================================================================
 	// Presets (Save / Load to .txt files via OS file dialog)
 	// =========================================================================
@@ -1129,6 +1310,48 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Tone Map|Presets")
 	static FString GetPresetDirectory();
 
+	/** Apply a preset asset immediately (asset must already be loaded). */
+	UFUNCTION(BlueprintCallable, Category = "Tone Map|Presets")
+	bool ApplyPreset(const UToneMapPresetAsset* Preset);
+
+	/** Stream a preset asset in the background and apply it on the game thread once
+	    loaded.  Applies immediately if the asset is already resident.  A newer request
+	    cancels a pending one, so only the most recent preset is applied. */
+	UFUNCTION(BlueprintCallable, Category = "Tone Map|Presets")
+	void LoadPresetAsync(TSoftObjectPtr<UToneMapPresetAsset> Preset);
+
+	/** Broadcast after LoadPresetAsync has applied its preset. */
+	UPROPERTY(BlueprintAssignable, Category = "Tone Map|Presets")
+	FOnToneMapPresetLoaded OnPresetLoaded;
+
+	/** Blend from the current settings to a preset over Duration seconds.
+	    In LUT mode both looks are baked once and cross-faded on the GPU, so a
+	    running transition costs about the same as a static frame.  Duration <= 0
+	    applies the preset immediately; a new call restarts from the current state. */
+	UFUNCTION(BlueprintCallable, Category = "Tone Map|Presets")
+	void TransitionToPreset(const UToneMapPresetAsset* Preset, float Duration = 2.0f,
+		EToneMapTransitionCurve Curve = EToneMapTransitionCurve::EaseInOut);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Tone Map|Presets")
+	bool IsTransitioning() const { return bTransitioning; }
+
+	/** Eased transition progress, 0 = source look, 1 = target look. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Tone Map|Presets")
+	float GetTransitionAlpha() const;
+
+	/** Transition end points (valid while IsTransitioning). */
+	const UToneMapComponent* GetTransitionFrom() const { return TransitionFrom; }
+	const UToneMapComponent* GetTransitionTo() const { return TransitionTo; }
+
+	/** Set on resolved snapshots only (see UToneMapSubsystem::ResolveForView). */
+	FToneMapLUTBlend LUTBlend;
+
+	/** Properties serialised by presets (text and asset), built once per session. */
+	static const TArray<FProperty*>& GetPresetProperties();
+
+	/** Preset property by name, or nullptr if the component no longer has it. */
+	static FProperty* FindPresetProperty(FName PropertyName);
+
 	// =========================================================================
 	// Helpers
 	// =========================================================================
@@ -1144,6 +1367,9 @@ protected:
 	virtual void OnUnregister() override;
 	virtual void BeginPlay() override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport) override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
 #if WITH_EDITOR
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
 #endif
@@ -1151,4 +1377,20 @@ protected:
 private:
 	void RegisterWithSubsystem();
 	void UnregisterFromSubsystem();
+	void MarkVolumeDirty();
+
+	// Keeps the pending LoadPresetAsync request alive (and cancellable)
+	TSharedPtr<FStreamableHandle> PresetLoadHandle;
+
+	// Preset transition end points — transient components holding full settings
+	UPROPERTY(Transient)
+	TObjectPtr<UToneMapComponent> TransitionFrom;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UToneMapComponent> TransitionTo;
+
+	float TransitionElapsed = 0.0f;
+	float TransitionDuration = 0.0f;
+	EToneMapTransitionCurve TransitionCurve = EToneMapTransitionCurve::EaseInOut;
+	bool bTransitioning = false;
 };
@@ -0,0 +1,98 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GlobalShader.h"
+#include "ShaderParameterStruct.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+#include "PixelShaderUtils.h"
+#include "ToneMapPSOPrecache.h"
+
+// =============================================================================
+// Compute execution of full-screen stages — r.ToneMapFX.AsyncCompute
+//
+// The bloom chain (bright pass, blur, glare, Kawase pyramid) and the lens
+// chain (bright pass, corona, halo) only ever write one texel per invocation,
+// so each of their pixel shaders also has a compute entry point generated
+// from the same .usf body (Shaders/Private/ToneMapComputeStage.ush).
+//
+// On the async compute queue those chains overlap with the graphics work
+// around them; RDG inserts the cross-queue fences.  The composites that
+// write back into scene colour stay on the raster pipeline.
+//
+// Stage inputs live in a shared parameter struct; the pixel variant adds
+// the render-target slots, the compute variant FToneMapComputeStageOutput.
+// =============================================================================
+
+enum class EToneMapStageQueue : uint8
+{
+	Raster,         // pixel shader on the graphics queue
+	Compute,        // compute shader on the graphics queue
+	AsyncCompute,   // compute shader on the async compute queue
+};
+
+BEGIN_SHADER_PARAMETER_STRUCT(FToneMapComputeStageOutput, )
+	SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, ComputeOutput)
+	SHADER_PARAMETER(FUintVector4, ComputeOutputRect) // xy = min, zw = max (exclusive)
+END_SHADER_PARAMETER_STRUCT()
+
+class TONEMAPFX_API FToneMapComputeStage
+{
+public:
+	static constexpr int32 GroupSize = 8;
+
+	// Queue for stages writing OutputFormat this frame (render thread).
+	// Falls back to Raster when the format has no typed UAV store.
+	static EToneMapStageQueue GetQueue_RenderThread(EPixelFormat OutputFormat);
+
+	// Extra creation flags the stage outputs need on the given queue
+	static ETextureCreateFlags GetOutputFlags(EToneMapStageQueue Queue)
+	{
+		return Queue == EToneMapStageQueue::Raster ? TexCreate_None : TexCreate_UAV;
+	}
+
+	static void ModifyCompilationEnvironment(FShaderCompilerEnvironment& OutEnvironment)
+	{
+		OutEnvironment.SetDefine(TEXT("TONEMAP_STAGE_GROUP_SIZE"), GroupSize);
+	}
+};
+
+// Add one stage pass writing Rect of Output, as a pixel or compute shader.
+// LoadAction only matters for the raster path — the compute path writes
+// every texel of Rect and leaves the rest of Output untouched.
+template<typename PSType, typename CSType>
+void AddToneMapStagePass(
+	FRDGBuilder& GraphBuilder,
+	const FGlobalShaderMap* ShaderMap,
+	FRDGEventName&& PassName,
+	EToneMapStageQueue Queue,
+	const typename PSType::FStageParameters& Stage,
+	FRDGTextureRef Output,
+	const FIntRect& Rect,
+	ERenderTargetLoadAction LoadAction = ERenderTargetLoadAction::ENoAction)
+{
+	if (Queue == EToneMapStageQueue::Raster)
+	{
+		typename PSType::FParameters* Params = GraphBuilder.AllocParameters<typename PSType::FParameters>();
+		Params->Stage = Stage;
+		Params->RenderTargets[0] = FRenderTargetBinding(Output, LoadAction);
+
+		TShaderMapRef<PSType> PixelShader(ShaderMap);
+		AddToneMapFullscreenPass(GraphBuilder, ShaderMap, MoveTemp(PassName), PixelShader, Params, Rect);
+		return;
+	}
+
+	typename CSType::FParameters* Params = GraphBuilder.AllocParameters<typename CSType::FParameters>();
+	Params->Stage = Stage;
+	Params->Output.ComputeOutput = GraphBuilder.CreateUAV(Output);
+	Params->Output.ComputeOutputRect = FUintVector4(Rect.Min.X, Rect.Min.Y, Rect.Max.X, Rect.Max.Y);
+
+	TShaderMapRef<CSType> ComputeShader(ShaderMap);
+	AddToneMapComputePass(
+		GraphBuilder, MoveTemp(PassName),
+		Queue == EToneMapStageQueue::AsyncCompute ? ERDGPassFlags::AsyncCompute : ERDGPassFlags::Compute,
+		ComputeShader, Params,
+		FComputeShaderUtils::GetGroupCount(Rect.Size(), FToneMapComputeStage::GroupSize));
+}
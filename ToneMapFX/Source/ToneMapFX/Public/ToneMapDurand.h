@@ -6,6 +6,7 @@
 #include "GlobalShader.h"
 #include "ShaderParameterStruct.h"
 #include "ScreenPass.h"
+#include "ToneMapFXSettings.h"
 
 // =============================================================================
 // Durand & Dorsey 2002 — Pass 1: Compute log-luminance map
@@ -29,7 +30,8 @@ public:
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
-		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::Durand, Parameters.Platform);
 	}
 };
 
@@ -62,7 +64,8 @@ public:
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
-		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::Durand, Parameters.Platform);
 	}
 };
 
@@ -97,6 +100,7 @@ public:
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
-		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::Durand, Parameters.Platform);
 	}
 };
@@ -0,0 +1,112 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GlobalShader.h"
+#include "ShaderParameterStruct.h"
+#include "RenderGraphBuilder.h"
+#include "Containers/CircularQueue.h"
+#include "ToneMapHistogramMetering.h"
+
+class FToneMapTransientTextures;
+
+class FRHIGPUBufferReadback;
+
+// =============================================================================
+// Exposure readback — Krawczyk statistics for the game thread
+// (r.ToneMapFX.ExposureReadback)
+//
+// Each frame the adapted / measured luminance, the auto-exposure multiplier
+// and the metering histogram are packed into one small buffer and copied to
+// a GPU readback in a ring of MaxFramesInFlight slots.  Later frames poll the
+// ring without waiting and push finished samples into a lock-free
+// single-producer / single-consumer queue, drained on the game thread by
+// SetupView.  Results arrive two or three frames late; a slot that is still
+// in flight when the ring wraps is skipped rather than waited on.
+// =============================================================================
+
+class FToneMapExposureStatsPackCS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FToneMapExposureStatsPackCS);
+	SHADER_USE_PARAMETER_STRUCT(FToneMapExposureStatsPackCS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, AdaptedLumTexture)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, MeasuredLumTexture)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(Buffer<uint>, HistogramInput)
+		SHADER_PARAMETER(uint32, bHasHistogram)
+		SHADER_PARAMETER(float, MinAutoExposure)
+		SHADER_PARAMETER(float, MaxAutoExposure)
+		SHADER_PARAMETER_RDG_BUFFER_UAV(RWBuffer<uint>, StatsOutput)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		OutEnvironment.SetDefine(TEXT("NUM_BINS"), FToneMapHistogramMetering::NumBins);
+	}
+};
+
+/** One frame of exposure statistics as read back from the GPU */
+struct FToneMapExposureSample
+{
+	uint64 FrameNumber = 0;              // render-thread frame that produced it
+	float AdaptedLuminance = 0.0f;
+	float MeasuredLuminance = 0.0f;
+	float AutoExposure = 1.0f;
+	float Histogram[FToneMapHistogramMetering::NumBins] = {};  // fraction of metering weight per bin; all 0 without histogram metering
+};
+
+class TONEMAPFX_API FToneMapExposureReadback
+{
+public:
+	FToneMapExposureReadback();
+	~FToneMapExposureReadback();
+
+	// True when statistics should be read back this frame (render thread)
+	static bool IsEnabled_RenderThread();
+
+	// Collect finished readbacks, then queue this frame's copy.  Once per
+	// frame — later views of the same frame are ignored.  Histogram may be null.
+	// The staging ring is counted in Transients' peak for the view that queues.
+	void AddPasses(
+		FRDGBuilder& GraphBuilder,
+		const FGlobalShaderMap* ShaderMap,
+		FToneMapTransientTextures& Transients,
+		FRDGTextureRef AdaptedLum,
+		FRDGTextureRef MeasuredLum,
+		FRDGBufferRef Histogram,
+		float MinAutoExposure,
+		float MaxAutoExposure);
+
+	// Oldest sample not yet consumed; false when none is waiting (game thread)
+	bool Dequeue_GameThread(FToneMapExposureSample& OutSample) { return Results.Dequeue(OutSample); }
+
+private:
+	static constexpr int32 MaxFramesInFlight = 4;
+	static constexpr int32 NumStats = 4 + FToneMapHistogramMetering::NumBins;
+
+	struct FSlot
+	{
+		TUniquePtr<FRHIGPUBufferReadback> Readback;
+		uint64 FrameNumber = 0;
+		bool bPending = false;
+	};
+
+	// Move every ready slot into Results, oldest first; never blocks
+	void Poll_RenderThread();
+
+	FSlot Slots[MaxFramesInFlight];
+	int32 NextSlot = 0;
+	uint64 LastQueuedFrame = ~uint64(0);
+
+	// Render thread produces, game thread consumes
+	TCircularQueue<FToneMapExposureSample> Results;
+};
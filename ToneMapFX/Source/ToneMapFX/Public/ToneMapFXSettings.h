@@ -0,0 +1,103 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "RHIShaderPlatform.h"
+#include "ToneMapFXSettings.generated.h"
+
+// =============================================================================
+// Project Settings > Plugins > Tone Map FX — shader stripping
+//
+// Operators and bloom / lens modes a project never uses can be switched off
+// here.  Their global shaders then fail ShouldCompilePermutation, so they are
+// neither compiled nor cooked, and the shader map loaded at PostConfigInit
+// shrinks accordingly.  At runtime a component asking for a stripped feature
+// skips it (Durand / Fattal fall back to Reinhard) and logs a warning once.
+//
+// Stored in [/Script/ToneMapFX.ToneMapFXSettings] of DefaultEngine.ini, so a
+// platform's own Engine.ini can strip more than the project default.  The
+// values are read straight from the config (FToneMapShaderStripping) because
+// shaders are filtered before UObjects exist.
+// =============================================================================
+
+UCLASS(config = Engine, defaultconfig, meta = (DisplayName = "Tone Map FX"))
+class TONEMAPFX_API UToneMapFXSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	UToneMapFXSettings();
+
+	/** Compile the Durand-Dorsey bilateral film curve (3 pixel shaders). */
+	UPROPERTY(config, EditAnywhere, Category = "Shader Stripping|Operators", meta = (ConfigRestartRequired = true))
+	bool bDurand = true;
+
+	/** Compile the Fattal gradient-domain film curve (5 pixel shaders). */
+	UPROPERTY(config, EditAnywhere, Category = "Shader Stripping|Operators", meta = (ConfigRestartRequired = true))
+	bool bFattal = true;
+
+	/** Compile the bloom chain. Off strips every bloom mode. */
+	UPROPERTY(config, EditAnywhere, Category = "Shader Stripping|Bloom", meta = (ConfigRestartRequired = true))
+	bool bBloom = true;
+
+	/** Compile the Directional Glare bloom mode (streak + accumulate, pixel and compute). */
+	UPROPERTY(config, EditAnywhere, Category = "Shader Stripping|Bloom", meta = (ConfigRestartRequired = true, EditCondition = "bBloom"))
+	bool bDirectionalGlare = true;
+
+	/** Compile the Kawase bloom mode (downsample + upsample, pixel and compute). */
+	UPROPERTY(config, EditAnywhere, Category = "Shader Stripping|Bloom", meta = (ConfigRestartRequired = true, EditCondition = "bBloom"))
+	bool bKawase = true;
+
+	/** Compile the Ciliary Corona lens effect. */
+	UPROPERTY(config, EditAnywhere, Category = "Shader Stripping|Lens Effects", meta = (ConfigRestartRequired = true))
+	bool bCiliaryCorona = true;
+
+	/** Compile the Lenticular Halo lens effect. */
+	UPROPERTY(config, EditAnywhere, Category = "Shader Stripping|Lens Effects", meta = (ConfigRestartRequired = true))
+	bool bLenticularHalo = true;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+};
+
+enum class EToneMapShaderFeature : uint8
+{
+	Durand,
+	Fattal,
+	Bloom,              // bright pass, Gaussian blur, composite
+	DirectionalGlare,
+	Kawase,
+	LensEffects,        // lens bright pass + composite, shared by corona and halo
+	CiliaryCorona,
+	LenticularHalo,
+
+	Num
+};
+
+class TONEMAPFX_API FToneMapShaderStripping
+{
+public:
+	// For ShouldCompilePermutation and the cook: false when the project's
+	// current settings strip Feature on Platform
+	static bool ShouldCompile(EToneMapShaderFeature Feature, EShaderPlatform Platform);
+
+	// Whether the running shader map has Feature — the settings as they were
+	// at startup, unchanged by later edits until a restart
+	static bool IsCompiled(EToneMapShaderFeature Feature, EShaderPlatform Platform);
+
+	// Render thread: IsCompiled, warning once per feature when it was stripped
+	static bool IsAvailable_RenderThread(EToneMapShaderFeature Feature, EShaderPlatform Platform);
+
+	// Log the stripped features and their shaders for every platform
+	// evaluated so far (the cook does this once per platform)
+	static void Report();
+
+	// Re-read the settings for the cook and the report after an edit.  The
+	// startup snapshot behind IsCompiled is kept: shaders change on restart.
+	static void Invalidate();
+
+	static const TCHAR* GetFeatureName(EToneMapShaderFeature Feature);
+};
@@ -6,6 +6,7 @@
 #include "GlobalShader.h"
 #include "ShaderParameterStruct.h"
 #include "ScreenPass.h"
+#include "ToneMapFXSettings.h"
 
 // =============================================================================
 // Fattal et al. 2002 — Pass 0: Compute ln(lum) at work resolution
@@ -29,7 +30,8 @@ public:
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
-		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::Fattal, Parameters.Platform);
 	}
 };
 
@@ -59,7 +61,8 @@ public:
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
-		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::Fattal, Parameters.Platform);
 	}
 };
 
@@ -84,7 +87,8 @@ public:
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
-		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::Fattal, Parameters.Platform);
 	}
 };
 
@@ -113,7 +117,8 @@ public:
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
-		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::Fattal, Parameters.Platform);
 	}
 };
 
@@ -143,6 +148,7 @@ public:
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
-		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::Fattal, Parameters.Platform);
 	}
 };
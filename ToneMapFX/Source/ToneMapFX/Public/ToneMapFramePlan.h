@@ -0,0 +1,174 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ToneMapScalability.h"
+
+class UToneMapComponent;
+enum class EToneMapShaderFeature : uint8;
+enum class EToneMapBlurMethod : uint8;
+
+// =============================================================================
+// Frame plan — what a preset costs before it reaches a GPU
+//
+// FToneMapFramePlanner walks the same decisions as the registered stages
+// (ToneMapStage.h) from a settings snapshot and a viewport size, without the
+// RHI or a render graph, and returns
+//   - the ordered passes with their extents and the textures they read / write,
+//   - every texture with its size and lifetime (first writer, last reader),
+//   - the peak transient memory with perfect reuse after the last reader,
+//   - estimated texture fetches and ALU per pass and per stage.
+//
+// Fetch counts follow the shaders' loops (kernel sizes, sample counts, the
+// quality tier's caps); ALU is a relative per-pixel weight read off the
+// shaders, good for comparing presets, not for predicting milliseconds.
+//
+// The built-in stages ask FToneMapFramePlanner::WantsStage whether the view
+// needs them and FToneMapPlanInputs::GetBlurMethod how to blur, so the
+// runtime and the plan cull the same stages and run the same blur passes.
+// r.ToneMapFX.DumpPlan logs a plan; -run=ToneMapFXPlanAudit audits a folder
+// of presets; the ToneMapFX.FramePlan automation tests check the planner.
+// =============================================================================
+
+// Usage of a ToneMapFX scratch texture — the format policy per usage is
+// documented with FToneMapTransientTextures (ToneMapTransientTextures.h)
+enum class EToneMapIntermediate : uint8
+{
+	Color,
+	BlurScratch,
+	LogLuminance,
+	Scalar,
+	Vector2,
+	Luminance,
+};
+
+// Built-in stages, in execution order (see FToneMapStageOrder)
+enum class EToneMapPlanStage : uint8
+{
+	Bloom,
+	Exposure,
+	LocalContrast,
+	Durand,
+	Fattal,
+	Lens,
+	Process,
+	Sharpen,
+	LUT,
+	Vignette,
+	HDREncode,
+
+	Num
+};
+
+// Everything outside the settings snapshot that changes the plan
+struct TONEMAPFX_API FToneMapPlanInputs
+{
+	FIntPoint ViewportSize = FIntPoint(1920, 1080);
+	FToneMapResolvedQuality Quality;        // after the quality tier (and governor) caps
+
+	bool bReplaceTonemap = false;           // Mode == ReplaceTonemap
+	bool bHDREncode = false;                // HDR display and bHDROutput
+	bool bOverrideOutput = false;           // ReplaceTonemap writing into the engine's output
+
+	// Console variables and platform support (defaults match the CVar defaults)
+	bool bReducedPrecision = true;          // r.ToneMapFX.ReducedPrecisionIntermediates
+	bool bLumaLocalContrast = true;         // r.ToneMapFX.LumaLocalContrast
+	bool bGlobalColorCast = true;           // r.ToneMapFX.GlobalColorCast
+	bool bHistogramMetering = true;         // r.ToneMapFX.HistogramMetering
+	bool bGuidedFilter = true;              // typed UAV stores for the guided filter
+	bool bTiledBlur = true;                 // r.ToneMapFX.TiledBlur
+	int32 RecursiveBlur = 0;                // r.ToneMapFX.RecursiveBlur
+	bool bComputeViewBlur = true;           // typed UAV stores for the Clarity / Dynamic Contrast blurs
+	bool bComputeBloom = true;              // bloom chain as compute (r.ToneMapFX.AsyncCompute, typed UAV stores)
+	bool bPreviousAdaptedLuminance = true;  // Krawczyk history from the last frame exists
+	uint32 CompiledFeatures = MAX_uint32;   // bit per EToneMapShaderFeature not stripped
+
+	int32 SceneColorBytesPerPixel = 8;      // PF_FloatRGBA scene colour
+
+	// Viewport, quality tier and mode for Settings, with the console
+	// variables and the shader stripping of the running platform (game thread)
+	static FToneMapPlanInputs Make(const UToneMapComponent& Settings, FIntPoint ViewportSize, int32 QualityLevel);
+
+	bool IsFeatureCompiled(EToneMapShaderFeature Feature) const { return (CompiledFeatures & (1u << static_cast<uint32>(Feature))) != 0; }
+
+	// FToneMapGaussianBlur::GetMethod with these inputs' console variables
+	EToneMapBlurMethod GetBlurMethod(float Sigma, bool bComputeOutput) const;
+};
+
+struct FToneMapPlanTexture
+{
+	const TCHAR* Name = nullptr;
+	FIntPoint Extent = FIntPoint::ZeroValue;
+	int32 BytesPerPixel = 0;
+	bool bTransient = true;                 // false: scene colour, the output, textures kept across frames
+	int32 FirstPass = INDEX_NONE;           // first writer
+	int32 LastPass = INDEX_NONE;            // last reader (or the writer when nothing reads it)
+
+	uint64 GetBytes() const { return (uint64)Extent.X * (uint64)Extent.Y * (uint64)BytesPerPixel; }
+};
+
+struct FToneMapPlanPass
+{
+	const TCHAR* Name = nullptr;
+	EToneMapPlanStage Stage = EToneMapPlanStage::Process;
+	FIntPoint Extent = FIntPoint::ZeroValue;    // pixels written
+	int32 FetchesPerPixel = 0;
+	int32 ALUPerPixel = 0;
+	bool bCachedAcrossFrames = false;           // only runs when its inputs change (baked LUT)
+	TArray<int32, TInlineAllocator<6>> Reads;   // indices into FToneMapFramePlan::Textures
+	int32 Write = INDEX_NONE;
+
+	uint64 GetPixels() const { return (uint64)Extent.X * (uint64)Extent.Y; }
+	uint64 GetFetches() const { return GetPixels() * (uint64)FetchesPerPixel; }
+	uint64 GetALU() const { return GetPixels() * (uint64)ALUPerPixel; }
+};
+
+struct FToneMapPlanStageCost
+{
+	bool bActive = false;
+	int32 NumPasses = 0;
+	uint64 Fetches = 0;
+	uint64 ALU = 0;
+};
+
+struct TONEMAPFX_API FToneMapFramePlan
+{
+	FToneMapPlanInputs Inputs;
+	TArray<FToneMapPlanPass> Passes;
+	TArray<FToneMapPlanTexture> Textures;
+	FToneMapPlanStageCost Stages[(int32)EToneMapPlanStage::Num];
+	int32 OutputTexture = INDEX_NONE;       // what the last pass writes
+
+	uint64 PeakTransientBytes = 0;
+	int32 PeakPass = INDEX_NONE;            // pass during which the peak is reached
+	uint64 PersistentBytes = 0;             // baked LUTs, adapted luminance
+
+	// Per frame — passes cached across frames are left out
+	uint64 GetTotalFetches() const;
+	uint64 GetTotalALU() const;
+
+	// Lifetimes in range and ordered, reads after writes, the chain ending in the
+	// output and the peak consistent with the lifetimes.  Describes the first
+	// violation in OutError.
+	bool Validate(FString* OutError = nullptr) const;
+
+	// Passes, textures and per-stage costs to the log
+	void Log() const;
+};
+
+class TONEMAPFX_API FToneMapFramePlanner
+{
+public:
+	// Whether the view's settings ask for Stage.  Shader stripping is not
+	// applied here — the runtime checks it separately so it can warn.
+	static bool WantsStage(EToneMapPlanStage Stage, const UToneMapComponent& Settings, const FToneMapPlanInputs& Inputs);
+
+	// Full plan for one view.  Pure: no RHI, CVar or config access.
+	static FToneMapFramePlan Build(const UToneMapComponent& Settings, const FToneMapPlanInputs& Inputs);
+
+	// Bytes per pixel of a usage without budget pressure (see GetFormat)
+	static int32 GetBytesPerPixel(EToneMapIntermediate Usage, bool bReducedPrecision);
+
+	static const TCHAR* GetStageName(EToneMapPlanStage Stage);
+};
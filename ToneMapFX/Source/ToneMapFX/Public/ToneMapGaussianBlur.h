@@ -0,0 +1,203 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GlobalShader.h"
+#include "ShaderParameterStruct.h"
+#include "ShaderPermutation.h"
+#include "RenderGraphBuilder.h"
+#include "SceneView.h"
+
+class FToneMapTransientTextures;
+
+// =============================================================================
+// Separable Gaussian blur — shared kernel and LDS-tiled compute path
+//
+// The kernel (half size ceil(3·sigma), capped at 48 texels)
+// is built once per pass on the CPU and bound as constants, for both the pixel
+// shaders (ToneMapBlur.usf, ClassicBloomBlur.usf) and the tiled compute shader.
+//
+//   Pixel shader   linear-sampling pairs: 1 + 2·ceil(h/2) bilinear fetches
+//   Tiled compute  tile + apron loaded once to groupshared memory, 2h+1 LDS
+//                  reads per texel (r.ToneMapFX.TiledBlur, default on)
+//   Recursive      Young–van Vliet third-order IIR, a causal and then an
+//                  anti-causal scan per row / column, the first stored in the
+//                  output's format — constant cost for any sigma and no
+//                  48-texel truncation (r.ToneMapFX.RecursiveBlur, default off)
+//
+// The ToneMapFX.Blur.GPUCost automation test times the three variants on the
+// GPU at sigma 8, 32 and 48; ToneMapFX.Blur.RecursiveError checks the CPU
+// reference of the recursive filter against a true Gaussian.
+// =============================================================================
+
+enum class EToneMapBlurMethod : uint8
+{
+	PixelShader,
+	Tiled,
+	Recursive,
+};
+
+BEGIN_SHADER_PARAMETER_STRUCT(FToneMapGaussianKernelParameters, )
+	SHADER_PARAMETER_ARRAY(FVector4f, KernelWeights, [13]) // w[0 … 48], four per element
+	SHADER_PARAMETER_ARRAY(FVector4f, KernelPairs, [12])   // (offset, weight) pairs, two per element
+	SHADER_PARAMETER(int32, KernelHalfSize)
+	SHADER_PARAMETER(int32, KernelNumPairs)
+END_SHADER_PARAMETER_STRUCT()
+
+struct TONEMAPFX_API FToneMapGaussianKernel
+{
+	static constexpr int32 MaxHalfSize = 48;
+	static constexpr int32 MaxPairs = (MaxHalfSize + 1) / 2;
+
+	float Sigma = 0.0f;
+	int32 HalfSize = 0;
+	int32 NumPairs = 0;
+	float Weights[MaxHalfSize + 1] = {};   // normalised over the full 2h+1 taps
+	FVector2f Pairs[MaxPairs];            // x = offset in texels, y = combined weight
+
+	// Same kernel the pixel shaders used to evaluate per tap
+	static FToneMapGaussianKernel Build(float Sigma);
+
+	void SetParameters(FToneMapGaussianKernelParameters& OutParameters) const;
+};
+
+class FToneMapGaussianBlurTiledCS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FToneMapGaussianBlurTiledCS);
+	SHADER_USE_PARAMETER_STRUCT(FToneMapGaussianBlurTiledCS, FGlobalShader);
+
+	static constexpr int32 TileSize = 128;
+
+	class FVerticalDim : SHADER_PERMUTATION_BOOL("BLUR_VERTICAL");
+	using FPermutationDomain = TShaderPermutationDomain<FVerticalDim>;
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_INCLUDE(FToneMapGaussianKernelParameters, Kernel)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, SourceTexture)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, BlurOutput)
+		SHADER_PARAMETER(FIntPoint, SourceOrigin)
+		SHADER_PARAMETER(FIntPoint, SourceClampMax)
+		SHADER_PARAMETER(FUintVector2, OutputSize)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		OutEnvironment.SetDefine(TEXT("TILE_SIZE"), TileSize);
+	}
+};
+
+class FToneMapGaussianRecursiveCS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FToneMapGaussianRecursiveCS);
+	SHADER_USE_PARAMETER_STRUCT(FToneMapGaussianRecursiveCS, FGlobalShader);
+
+	static constexpr int32 GroupSize = 64;
+
+	class FVerticalDim : SHADER_PERMUTATION_BOOL("BLUR_VERTICAL");
+	class FReverseDim : SHADER_PERMUTATION_BOOL("RECURSIVE_REVERSE");   // anti-causal scan
+	using FPermutationDomain = TShaderPermutationDomain<FVerticalDim, FReverseDim>;
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, SourceTexture)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, BlurOutput)
+		SHADER_PARAMETER(FIntPoint, SourceOrigin)
+		SHADER_PARAMETER(FIntPoint, SourceClampMax)
+		SHADER_PARAMETER(FUintVector2, OutputSize)
+		SHADER_PARAMETER(FVector4f, RecursiveCoeffs) // x = B, yzw = b1/b0, b2/b0, b3/b0
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZE"), GroupSize);
+	}
+};
+
+class TONEMAPFX_API FToneMapGaussianBlur
+{
+public:
+	// True when OutputFormat supports typed UAV stores (tiled / recursive paths)
+	static bool SupportsComputeOutput(EPixelFormat OutputFormat);
+
+	// Clarity / Dynamic Contrast: every scratch format they blur into
+	// (RGBA16F, R11G11B10F, R16F) takes typed UAV stores
+	static bool SupportsComputeViewBlur();
+
+	// Method for a kernel of the given sigma with r.ToneMapFX.TiledBlur and
+	// r.ToneMapFX.RecursiveBlur at bTiled / RecursiveMode.  Without a
+	// compute-capable output only the pixel shader is available.  Pure — the
+	// frame plan (FToneMapPlanInputs::GetBlurMethod) and the stages share it.
+	static EToneMapBlurMethod GetMethod(float Sigma, bool bComputeOutput, bool bTiled, int32 RecursiveMode);
+
+	// GetMethod with the console variables' render thread values
+	static EToneMapBlurMethod GetMethod_RenderThread(float Sigma, bool bComputeOutput);
+	static bool IsTiledEnabled_RenderThread();
+	static int32 GetRecursiveMode_RenderThread();
+
+	// Passes per blur direction: the recursive filter runs a causal and then an anti-causal scan
+	static int32 GetNumPasses(EToneMapBlurMethod Method) { return Method == EToneMapBlurMethod::Recursive ? 2 : 1; }
+
+	// One blur direction with a compute method (Tiled or Recursive).  Output
+	// texel p reads source texel p + SourceOrigin; taps clamp to the source
+	// texture.  Output needs TexCreate_UAV.
+	static void AddComputePass(
+		FRDGBuilder& GraphBuilder,
+		const FGlobalShaderMap* ShaderMap,
+		FToneMapTransientTextures& Transients,
+		FRDGEventName&& PassName,
+		ERDGPassFlags PassFlags,
+		EToneMapBlurMethod Method,
+		const FToneMapGaussianKernel& Kernel,
+		bool bVertical,
+		FRDGTextureRef Source,
+		FIntPoint SourceOrigin,
+		FRDGTextureRef Output,
+		FIntPoint OutputSize);
+
+	// One direction with the pixel shader (ToneMapBlur.usf): the SourceRect of
+	// Source is stretched onto the OutputSize region of Output.
+	static void AddPixelShaderPass(
+		FRDGBuilder& GraphBuilder,
+		const FGlobalShaderMap* ShaderMap,
+		FRDGEventName&& PassName,
+		const FToneMapGaussianKernel& Kernel,
+		bool bVertical,
+		FRDGTextureRef Source,
+		const FIntRect& SourceRect,
+		FRDGTextureRef Output,
+		FIntPoint OutputSize,
+		const TUniformBufferRef<FViewUniformShaderParameters>& ViewUniformBuffer = {});
+
+	// Young–van Vliet coefficients: x = B, yzw = b1/b0, b2/b0, b3/b0
+	static FVector4f GetRecursiveCoefficients(float Sigma);
+
+	// CPU references on one line of samples (edges clamp)
+	static void FilterRecursive(TConstArrayView<float> Input, TArrayView<float> Output, float Sigma);
+	static void FilterGaussian(TConstArrayView<float> Input, TArrayView<float> Output, float Sigma);
+
+private:
+	static void AddTiledPass(
+		FRDGBuilder& GraphBuilder, const FGlobalShaderMap* ShaderMap, FRDGEventName&& PassName, ERDGPassFlags PassFlags,
+		const FToneMapGaussianKernel& Kernel, bool bVertical,
+		FRDGTextureRef Source, FIntPoint SourceOrigin, FRDGTextureRef Output, FIntPoint OutputSize);
+
+	static void AddRecursivePass(
+		FRDGBuilder& GraphBuilder, const FGlobalShaderMap* ShaderMap, FToneMapTransientTextures& Transients,
+		FRDGEventName&& PassName, ERDGPassFlags PassFlags,
+		float Sigma, bool bVertical,
+		FRDGTextureRef Source, FIntPoint SourceOrigin, FRDGTextureRef Output, FIntPoint OutputSize);
+};
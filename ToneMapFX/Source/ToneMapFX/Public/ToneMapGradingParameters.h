@@ -0,0 +1,132 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ShaderParameterMacros.h"
+#include "UniformBuffer.h"
+
+class UToneMapComponent;
+
+// =============================================================================
+// Grading uniform buffer — ToneMapGrading in HLSL
+//
+// The settings-derived constants of the main pass (FToneMapProcessPS), the
+// LUT bake (FToneMapCombineLUTPS) and the LUT apply (FToneMapApplyLUTPS).
+// Each pass references one buffer instead of declaring its own copy of the
+// grading parameters, so the three cannot drift apart.  Values that change
+// per frame or per chain position (pre-exposure, eye adaptation, dithering,
+// texture transforms) stay loose parameters of the passes.
+//
+// FToneMapGradingBuffer keeps one buffer per view (FToneMapViewSetup).  It is
+// keyed on the hash of the view's settings snapshot, so a static preset is
+// neither refilled nor rehashed; only a new snapshot hash fills the struct,
+// and the buffer is recreated only when the hash of its contents changes.
+// The LUT cache keys its bakes on the part of the contents the bake reads
+// (GetBakeHash, cached with the buffer).  `stat ToneMapFX` counts the updates.
+// =============================================================================
+
+BEGIN_GLOBAL_SHADER_PARAMETER_STRUCT(FToneMapGradingUniformParameters, TONEMAPFX_API)
+	// Mode: 0 = PostProcess (LDR), 1 = ReplaceTonemap (HDR)
+	SHADER_PARAMETER(float, bReplaceTonemap)
+	// Durand / Fattal ran: the film curve is skipped
+	SHADER_PARAMETER(float, bPreToneMapped)
+
+	// Film Curve (ReplaceTonemap mode)
+	SHADER_PARAMETER(float, FilmCurveMode)          // 0=Hable, 1=ReinhardLum, 2=ReinhardJodie, 3=ReinhardStd, 4=Durand, 5=Fattal, 6=AgX
+	SHADER_PARAMETER(float, ReinhardWhitePoint)
+	SHADER_PARAMETER(FVector4f, HableParams1)       // x=A(Shoulder), y=B(Linear), z=C(LinearAngle), w=D(ToeStrength)
+	SHADER_PARAMETER(FVector4f, HableParams2)       // x=E(ToeNum), y=F(ToeDenom), z=W(WhitePoint), w=unused
+	SHADER_PARAMETER(FVector4f, AgXParams)          // x=MinEV, y=MaxEV, z=Look(0=None,1=Punchy,2=Golden), w=unused
+	SHADER_PARAMETER(FVector3f, HDRColorBalance)
+	SHADER_PARAMETER(float, HDRSaturation)
+
+	// White Balance
+	SHADER_PARAMETER(float, Temperature)
+	SHADER_PARAMETER(float, Tint)
+
+	// Exposure
+	SHADER_PARAMETER(float, ExposureValue)
+	SHADER_PARAMETER(float, CameraEV)               // derived from ISO / shutter / aperture
+	SHADER_PARAMETER(float, bUseCameraExposure)
+
+	// Auto-Exposure (ReplaceTonemap mode)
+	SHADER_PARAMETER(float, AutoExposureMode)       // 0=None, 1=EngineDefault, 2=Krawczyk
+	SHADER_PARAMETER(float, MinAutoExposure)
+	SHADER_PARAMETER(float, MaxAutoExposure)
+
+	// Tone
+	SHADER_PARAMETER(float, Contrast)
+	SHADER_PARAMETER(float, HighlightsValue)
+	SHADER_PARAMETER(float, ShadowsValue)
+	SHADER_PARAMETER(float, WhitesValue)
+	SHADER_PARAMETER(float, BlacksValue)
+	SHADER_PARAMETER(float, ToneSmoothingValue)
+	SHADER_PARAMETER(float, ContrastMidpoint)
+
+	// Presence
+	SHADER_PARAMETER(float, ClarityStrength)        // spatial: main pass and LUT apply only
+	SHADER_PARAMETER(float, VibranceStrength)
+	SHADER_PARAMETER(float, SaturationStrength)
+
+	// Dynamic Contrast strengths (spatial)
+	SHADER_PARAMETER(float, DynamicContrastStrength)
+	SHADER_PARAMETER(float, CorrectContrastStrength)
+	SHADER_PARAMETER(float, CorrectColorCastStrength)
+
+	// Tone Curve (x=Highlights, y=Lights, z=Darks, w=Shadows)
+	SHADER_PARAMETER(FVector4f, ToneCurveParams)
+
+	// HSL — float4(Reds, Oranges, Yellows, Greens) / float4(Aquas, Blues, Purples, Magentas)
+	SHADER_PARAMETER(FVector4f, HueShift1)
+	SHADER_PARAMETER(FVector4f, HueShift2)
+	SHADER_PARAMETER(FVector4f, SatAdj1)
+	SHADER_PARAMETER(FVector4f, SatAdj2)
+	SHADER_PARAMETER(FVector4f, LumAdj1)
+	SHADER_PARAMETER(FVector4f, LumAdj2)
+	SHADER_PARAMETER(float, HSLSmoothing)
+
+	// Feature toggles
+	SHADER_PARAMETER(float, bEnableHSL)
+	SHADER_PARAMETER(float, bEnableCurves)
+END_GLOBAL_SHADER_PARAMETER_STRUCT()
+
+using FToneMapGradingUniformBufferRef = TUniformBufferRef<FToneMapGradingUniformParameters>;
+
+struct TONEMAPFX_API FToneMapGradingParameters
+{
+	// Every field from a settings snapshot
+	static void Fill(
+		FToneMapGradingUniformParameters& Out,
+		const UToneMapComponent& Settings,
+		bool bReplaceTonemap,
+		bool bPreToneMapped);
+
+	// Identical hashes upload identical constants
+	static uint32 GetHash(const FToneMapGradingUniformParameters& Parameters);
+
+	// Hash of the fields the LUT bake reads — spatial strengths and the
+	// auto-exposure range leave a baked LUT valid
+	static uint32 GetBakeHash(const FToneMapGradingUniformParameters& Parameters);
+};
+
+// One view's grading buffer, refilled only when the settings snapshot changes
+// and recreated only when its contents change
+struct TONEMAPFX_API FToneMapGradingBuffer
+{
+	uint32 SettingsKey = 0;                 // snapshot hash and mode flags Parameters came from
+	uint32 Hash = 0;                        // GetHash(Parameters)
+	uint32 BakeHash = 0;                    // GetBakeHash(Parameters)
+	FToneMapGradingUniformParameters Parameters;
+	FToneMapGradingUniformBufferRef Buffer;
+
+	// The buffer for Settings — the cached one while SettingsHash (the view's
+	// FToneMapSettingsSnapshot::GetHash) and the mode flags match (render thread)
+	const FToneMapGradingUniformBufferRef& Update_RenderThread(
+		const UToneMapComponent& Settings,
+		uint32 SettingsHash,
+		bool bReplaceTonemap,
+		bool bPreToneMapped);
+
+	void Reset() { SettingsKey = 0; Hash = 0; BakeHash = 0; Buffer.SafeRelease(); }
+};
@@ -0,0 +1,184 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GlobalShader.h"
+#include "ShaderParameterStruct.h"
+#include "RenderGraphBuilder.h"
+
+class FToneMapTransientTextures;
+
+// =============================================================================
+// Guided-filter Clarity base layer (EToneMapClarityMode::GuidedFilter)
+//
+// Replaces the Clarity Gaussian with an edge-aware base from a self-guided
+// filter on log luminance.  Log luminance is written once; box statistics of
+// I and I², and then box means of the per-window coefficients a and b, each
+// come from one box pass per axis (ToneMapGuidedFilter.usf).  A box pass is a
+// group-shared prefix sum over a tile of one row or column plus its apron, so
+// any ClarityRadius costs the same.  The result binds as the Clarity
+// BlurredTexture — the main pass is unchanged.
+// =============================================================================
+
+class TONEMAPFX_API FToneMapGuidedFilter
+{
+public:
+	// Threads per group and texels per row / column tile
+	static constexpr int32 GroupSize = 128;
+
+	// The tile plus its apron fills the group-shared span of 3 * GroupSize
+	static constexpr int32 MaxBoxRadius = GroupSize;
+
+	// All passes write through typed UAVs (R16F / R32F log luminance,
+	// G32R32F box rows and coefficients, RGBA16F base)
+	static bool IsSupported();
+
+	// Box radius with the same variance as a Gaussian of the given sigma,
+	// capped at MaxBoxRadius
+	static int32 GetBoxRadius(float Sigma);
+
+	// THREADGROUP_SIZE / MAX_BOX_RADIUS for ToneMapGuidedFilter.usf
+	static void ModifyCompilationEnvironment(FShaderCompilerEnvironment& OutEnvironment);
+
+	// Edge-aware Clarity base for the Source region starting at SourceRect.Min,
+	// OutputSize texels, as an EToneMapIntermediate::Color texture.
+	// EdgeThreshold is the log2-luminance step (EV) treated as an edge.
+	static FRDGTextureRef AddClarityBasePasses(
+		FRDGBuilder& GraphBuilder,
+		const FGlobalShaderMap* ShaderMap,
+		FToneMapTransientTextures& Transients,
+		FRDGTextureRef Source,
+		const FIntRect& SourceRect,
+		FIntPoint OutputSize,
+		float Sigma,
+		float EdgeThreshold);
+};
+
+BEGIN_SHADER_PARAMETER_STRUCT(FToneMapGuidedFilterParameters, )
+	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, SceneColorTexture)
+	SHADER_PARAMETER(FIntPoint, SourceOrigin)
+	SHADER_PARAMETER(FIntPoint, SourceClampMax)
+	SHADER_PARAMETER(FUintVector2, OutputSize)
+	SHADER_PARAMETER(int32, BoxRadius)
+	SHADER_PARAMETER(float, EdgeEpsilon)     // EV²
+END_SHADER_PARAMETER_STRUCT()
+
+class FToneMapGuidedLogLumaCS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FToneMapGuidedLogLumaCS);
+	SHADER_USE_PARAMETER_STRUCT(FToneMapGuidedLogLumaCS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_INCLUDE(FToneMapGuidedFilterParameters, Guided)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float>, LogLumaOutput)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		FToneMapGuidedFilter::ModifyCompilationEnvironment(OutEnvironment);
+	}
+};
+
+class FToneMapGuidedBoxRowsCS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FToneMapGuidedBoxRowsCS);
+	SHADER_USE_PARAMETER_STRUCT(FToneMapGuidedBoxRowsCS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_INCLUDE(FToneMapGuidedFilterParameters, Guided)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, LogLumaTexture)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float2>, BoxOutput)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		FToneMapGuidedFilter::ModifyCompilationEnvironment(OutEnvironment);
+	}
+};
+
+class FToneMapGuidedCoeffColumnsCS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FToneMapGuidedCoeffColumnsCS);
+	SHADER_USE_PARAMETER_STRUCT(FToneMapGuidedCoeffColumnsCS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_INCLUDE(FToneMapGuidedFilterParameters, Guided)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, BoxInputTexture)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float2>, CoeffOutput)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		FToneMapGuidedFilter::ModifyCompilationEnvironment(OutEnvironment);
+	}
+};
+
+class FToneMapGuidedCoeffRowsCS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FToneMapGuidedCoeffRowsCS);
+	SHADER_USE_PARAMETER_STRUCT(FToneMapGuidedCoeffRowsCS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_INCLUDE(FToneMapGuidedFilterParameters, Guided)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, BoxInputTexture)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float2>, BoxOutput)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		FToneMapGuidedFilter::ModifyCompilationEnvironment(OutEnvironment);
+	}
+};
+
+class FToneMapGuidedBaseColumnsCS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FToneMapGuidedBaseColumnsCS);
+	SHADER_USE_PARAMETER_STRUCT(FToneMapGuidedBaseColumnsCS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_INCLUDE(FToneMapGuidedFilterParameters, Guided)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, BoxInputTexture)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, BaseOutput)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		FToneMapGuidedFilter::ModifyCompilationEnvironment(OutEnvironment);
+	}
+};
@@ -0,0 +1,46 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GlobalShader.h"
+#include "ShaderPermutation.h"
+#include "DataDrivenShaderPlatformInfo.h"
+
+// =============================================================================
+// Half-precision permutation — r.ToneMapFX.HalfPrecision
+//
+// The display-referred passes (Process, Apply LUT, Sharpen, Vignette) have a
+// TONEMAP_HALF_PRECISION permutation that runs their LDR maths in min16float
+// (Shaders/Private/ToneMapHalfPrecision.ush).  Scene-referred colour and the
+// film curves stay fp32 in every permutation.
+//
+// The permutation is only compiled for platforms whose shader format can
+// have real 16-bit types, and only bound where the RHI reports native 16-bit
+// ALU support.  r.ToneMapFX.HalfPrecisionError measures the cost per operator
+// against the fp32 build of ToneMapColorMath.ush.
+// =============================================================================
+
+class FToneMapHalfPrecisionDim : SHADER_PERMUTATION_BOOL("TONEMAP_HALF_PRECISION");
+
+class TONEMAPFX_API FToneMapHalfPrecision
+{
+public:
+	// Whether the passes should bind their half permutation this frame (render thread)
+	static bool IsEnabled_RenderThread(EShaderPlatform Platform);
+
+	// Skip the half permutation where min16float can never be fp16
+	static bool ShouldCompilePermutation(EShaderPlatform Platform, bool bHalfPrecision)
+	{
+		return !bHalfPrecision
+			|| FDataDrivenShaderPlatformInfo::GetSupportsRealTypes(Platform) != ERHIFeatureSupport::Unsupported;
+	}
+
+	static void ModifyCompilationEnvironment(bool bHalfPrecision, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		if (bHalfPrecision)
+		{
+			OutEnvironment.CompilerFlags.Add(CFLAG_AllowRealTypes);
+		}
+	}
+};
@@ -0,0 +1,116 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GlobalShader.h"
+#include "ShaderParameterStruct.h"
+#include "RenderGraphBuilder.h"
+
+class FToneMapTransientTextures;
+
+// =============================================================================
+// Histogram metering for Krawczyk auto-exposure (r.ToneMapFX.HistogramMetering)
+//
+// The 16x16 geometric mean lets a bright sky or a single lamp pull exposure
+// around.  Instead a log2-luminance histogram is built in one dispatch at
+// quarter resolution, each sample weighted by the metering mode (average,
+// centre-weighted, spot or mask texture), and the measured luminance is the
+// mean of the bins between the low and high percentiles.  The result drops
+// into the existing temporal adaptation and scene-key evaluation.
+//
+// BuildHistogram / ResolveHistogram are the CPU reference of the two passes;
+// the ToneMapFX.Metering.* automation tests check them on synthetic scenes
+// against the geometric mean.
+// =============================================================================
+
+class FToneMapHistogramBuildCS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FToneMapHistogramBuildCS);
+	SHADER_USE_PARAMETER_STRUCT(FToneMapHistogramBuildCS, FGlobalShader);
+
+	static constexpr int32 GroupSize = 16;
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER(FVector2f, HistogramLog2Range)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, SceneColorTexture)
+		SHADER_PARAMETER_SAMPLER(SamplerState, SceneColorSampler)
+		SHADER_PARAMETER(FIntVector4, SceneColorRect)
+		SHADER_PARAMETER(FVector2f, SceneColorExtentInv)
+		SHADER_PARAMETER(float, OneOverPreExposure)
+		SHADER_PARAMETER(uint32, MeteringMode)
+		SHADER_PARAMETER(float, SpotRadius)
+		SHADER_PARAMETER_TEXTURE(Texture2D, MeteringMaskTexture)
+		SHADER_PARAMETER_SAMPLER(SamplerState, MeteringMaskSampler)
+		SHADER_PARAMETER_RDG_BUFFER_UAV(RWBuffer<uint>, HistogramOutput)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment);
+};
+
+class FToneMapHistogramResolveCS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FToneMapHistogramResolveCS);
+	SHADER_USE_PARAMETER_STRUCT(FToneMapHistogramResolveCS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER(FVector2f, HistogramLog2Range)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(Buffer<uint>, HistogramInput)
+		SHADER_PARAMETER(FVector2f, MeteringPercentiles)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float>, MeasuredLumOutput)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment);
+};
+
+/** Per-view metering inputs, filled from the component */
+struct FToneMapMeteringSettings
+{
+	uint32 Mode = 0;             // EToneMapMeteringMode
+	float LowPercent = 0.0f;
+	float HighPercent = 100.0f;
+	float SpotRadius = 0.1f;     // fraction of viewport height
+	FRHITexture* MaskTexture = nullptr;
+};
+
+class TONEMAPFX_API FToneMapHistogramMetering
+{
+public:
+	static constexpr int32 NumBins = 64;
+	static constexpr int32 SampleStride = 4;          // one tap per 4x4 texels
+	static constexpr float MinLog2Luminance = -10.0f;
+	static constexpr float MaxLog2Luminance = 14.0f;  // 0.375 EV per bin
+	static constexpr float WeightScale = 256.0f;      // fixed-point metering weight
+
+	// True when the histogram replaces the geometric-mean grid (render thread)
+	static bool IsEnabled_RenderThread();
+
+	// Measured scene luminance (1x1 R32F, pre-exposure removed) — same
+	// contract as the LuminanceMeasurePS output.  OutHistogram receives the
+	// NumBins uint buffer (fixed-point weights) for exposure readback.
+	static FRDGTextureRef AddPasses(
+		FRDGBuilder& GraphBuilder,
+		const FGlobalShaderMap* ShaderMap,
+		FToneMapTransientTextures& Transients,
+		FRDGTextureRef SceneColor,
+		const FIntRect& SceneRect,
+		float OneOverPreExposure,
+		const FToneMapMeteringSettings& Settings,
+		FRDGBufferRef* OutHistogram = nullptr);
+
+	// CPU reference.  Weights are 0–1 per sample (empty = all 1).
+	static void BuildHistogram(TConstArrayView<float> Luminance, TConstArrayView<float> Weights, TArrayView<uint32> OutBins);
+	static float ResolveHistogram(TConstArrayView<uint32> Bins, float LowPercent, float HighPercent);
+};
@@ -6,29 +6,63 @@
 #include "GlobalShader.h"
 #include "ShaderParameterStruct.h"
 #include "ScreenPass.h"
+#include "ToneMapFXSettings.h"
+#include "ToneMapComputeStage.h"
 
 // =============================================================================
 // Lens Effects — Shared bright-pass for both corona and halo
 //   Output: RGBA16F bright pixels only (below threshold = black)
 // =============================================================================
+BEGIN_SHADER_PARAMETER_STRUCT(FToneMapLensBrightPassParameters, )
+	SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
+	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, SceneColorTexture)
+	SHADER_PARAMETER_SAMPLER(SamplerState, SceneColorSampler)
+	SHADER_PARAMETER(FScreenTransform, SvPositionToSceneColorUV)
+	SHADER_PARAMETER(float, Threshold)
+END_SHADER_PARAMETER_STRUCT()
+
 class FToneMapLensBrightPassPS : public FGlobalShader
 {
 public:
 	DECLARE_GLOBAL_SHADER(FToneMapLensBrightPassPS);
 	SHADER_USE_PARAMETER_STRUCT(FToneMapLensBrightPassPS, FGlobalShader);
 
+	using FStageParameters = FToneMapLensBrightPassParameters;
+
 	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
-		SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
-		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, SceneColorTexture)
-		SHADER_PARAMETER_SAMPLER(SamplerState, SceneColorSampler)
-		SHADER_PARAMETER(FScreenTransform, SvPositionToSceneColorUV)
-		SHADER_PARAMETER(float, Threshold)
+		SHADER_PARAMETER_STRUCT_INCLUDE(FStageParameters, Stage)
 		RENDER_TARGET_BINDING_SLOTS()
 	END_SHADER_PARAMETER_STRUCT()
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
-		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::LensEffects, Parameters.Platform);
+	}
+};
+
+// Compute variant (r.ToneMapFX.AsyncCompute)
+class FToneMapLensBrightPassCS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FToneMapLensBrightPassCS);
+	SHADER_USE_PARAMETER_STRUCT(FToneMapLensBrightPassCS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_INCLUDE(FToneMapLensBrightPassParameters, Stage)
+		SHADER_PARAMETER_STRUCT_INCLUDE(FToneMapComputeStageOutput, Output)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::LensEffects, Parameters.Platform);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		FToneMapComputeStage::ModifyCompilationEnvironment(OutEnvironment);
 	}
 };
 
@@ -39,27 +73,59 @@ public:
 //   All arms are summed into one pass (up to MAX_CORONA_SPIKES directions).
 //   Output: RGBA16F corona layer
 // =============================================================================
+BEGIN_SHADER_PARAMETER_STRUCT(FToneMapCoronaStreakParameters, )
+	SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
+	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, BrightPassTexture)
+	SHADER_PARAMETER_SAMPLER(SamplerState, BrightPassSampler)
+	SHADER_PARAMETER(FScreenTransform, SvPositionToBrightPassUV)
+	SHADER_PARAMETER(FVector4f, BufferSizeAndInvSize)   // xy=bp size, zw=1/bp size
+	SHADER_PARAMETER(int32, SpikeCount)                 // total arms (e.g. 6)
+	SHADER_PARAMETER(int32, SpikeLength)                // half-length in bp pixels
+	SHADER_PARAMETER(float, CoronaIntensity)
+END_SHADER_PARAMETER_STRUCT()
+
 class FToneMapCoronaStreakPS : public FGlobalShader
 {
 public:
 	DECLARE_GLOBAL_SHADER(FToneMapCoronaStreakPS);
 	SHADER_USE_PARAMETER_STRUCT(FToneMapCoronaStreakPS, FGlobalShader);
 
+	using FStageParameters = FToneMapCoronaStreakParameters;
+
 	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
-		SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
-		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, BrightPassTexture)
-		SHADER_PARAMETER_SAMPLER(SamplerState, BrightPassSampler)
-		SHADER_PARAMETER(FScreenTransform, SvPositionToBrightPassUV)
-		SHADER_PARAMETER(FVector4f, BufferSizeAndInvSize)   // xy=bp size, zw=1/bp size
-		SHADER_PARAMETER(int32, SpikeCount)                 // total arms (e.g. 6)
-		SHADER_PARAMETER(int32, SpikeLength)                // half-length in bp pixels
-		SHADER_PARAMETER(float, CoronaIntensity)
+		SHADER_PARAMETER_STRUCT_INCLUDE(FStageParameters, Stage)
 		RENDER_TARGET_BINDING_SLOTS()
 	END_SHADER_PARAMETER_STRUCT()
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
-		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::CiliaryCorona, Parameters.Platform);
+	}
+};
+
+// Compute variant (r.ToneMapFX.AsyncCompute)
+class FToneMapCoronaStreakCS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FToneMapCoronaStreakCS);
+	SHADER_USE_PARAMETER_STRUCT(FToneMapCoronaStreakCS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_INCLUDE(FToneMapCoronaStreakParameters, Stage)
+		SHADER_PARAMETER_STRUCT_INCLUDE(FToneMapComputeStageOutput, Output)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::CiliaryCorona, Parameters.Platform);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		FToneMapComputeStage::ModifyCompilationEnvironment(OutEnvironment);
 	}
 };
 
@@ -70,28 +136,61 @@ public:
 //   A fast approximation uses a large-kernel box + subtraction to isolate an annulus.
 //   Output: RGBA16F halo layer
 // =============================================================================
+BEGIN_SHADER_PARAMETER_STRUCT(FToneMapHaloRingParameters, )
+	SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
+	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, BrightPassTexture)
+	SHADER_PARAMETER_SAMPLER(SamplerState, BrightPassSampler)
+	SHADER_PARAMETER(FScreenTransform, SvPositionToBrightPassUV)
+	SHADER_PARAMETER(FVector4f, BufferSizeAndInvSize)
+	SHADER_PARAMETER(float, HaloRadius)     // UV units
+	SHADER_PARAMETER(float, HaloThickness)  // UV units (ring width)
+	SHADER_PARAMETER(float, HaloIntensity)
+	SHADER_PARAMETER(FVector3f, HaloTint)   // RGB tint for the ring
+	SHADER_PARAMETER(int32, HaloAngularSamples) // angular directions (quality tier, <= 32)
+END_SHADER_PARAMETER_STRUCT()
+
 class FToneMapHaloRingPS : public FGlobalShader
 {
 public:
 	DECLARE_GLOBAL_SHADER(FToneMapHaloRingPS);
 	SHADER_USE_PARAMETER_STRUCT(FToneMapHaloRingPS, FGlobalShader);
 
+	using FStageParameters = FToneMapHaloRingParameters;
+
 	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
-		SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
-		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, BrightPassTexture)
-		SHADER_PARAMETER_SAMPLER(SamplerState, BrightPassSampler)
-		SHADER_PARAMETER(FScreenTransform, SvPositionToBrightPassUV)
-		SHADER_PARAMETER(FVector4f, BufferSizeAndInvSize)
-		SHADER_PARAMETER(float, HaloRadius)     // UV units
-		SHADER_PARAMETER(float, HaloThickness)  // UV units (ring width)
-		SHADER_PARAMETER(float, HaloIntensity)
-		SHADER_PARAMETER(FVector3f, HaloTint)   // RGB tint for the ring
+		SHADER_PARAMETER_STRUCT_INCLUDE(FStageParameters, Stage)
 		RENDER_TARGET_BINDING_SLOTS()
 	END_SHADER_PARAMETER_STRUCT()
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
-		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::LenticularHalo, Parameters.Platform);
+	}
+};
+
+// Compute variant (r.ToneMapFX.AsyncCompute)
+class FToneMapHaloRingCS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FToneMapHaloRingCS);
+	SHADER_USE_PARAMETER_STRUCT(FToneMapHaloRingCS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_INCLUDE(FToneMapHaloRingParameters, Stage)
+		SHADER_PARAMETER_STRUCT_INCLUDE(FToneMapComputeStageOutput, Output)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::LenticularHalo, Parameters.Platform);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		FToneMapComputeStage::ModifyCompilationEnvironment(OutEnvironment);
 	}
 };
 
@@ -124,6 +223,7 @@ public:
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
-		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapShaderStripping::ShouldCompile(EToneMapShaderFeature::LensEffects, Parameters.Platform);
 	}
 };
@@ -0,0 +1,83 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GlobalShader.h"
+#include "RenderGraphBuilder.h"
+#include "PixelShaderUtils.h"
+#include "RenderGraphUtils.h"
+
+// =============================================================================
+// PSO precaching — r.ToneMapFX.PSOPrecache
+//
+// Every ToneMapFX pixel pass is a full-screen triangle with default blend,
+// rasterizer and depth state (FPixelShaderUtils::AddFullscreenPass), so its
+// pipeline is fully determined by (pixel shader permutation, render-target
+// format).  A table of every FToneMap*PS / FClassicBloom*PS — with all of
+// their permutations, e.g. the half-precision one — and the formats each can
+// write under the intermediate-format policy (ToneMapTransientTextures.h) is
+// handed to
+//   - UE's global PSO collector, so r.PSOPrecaching compiles them at startup
+//     alongside the engine's own post-process pipelines, and
+//   - PrewarmPipelines(), which a game can call from a loading screen before
+//     toggling Fattal, lens effects or LUT mode for the first time.
+// Compute pipelines are the shader permutation alone; the table lists the
+// compute twins of the bloom / lens stages (r.ToneMapFX.AsyncCompute), the
+// tiled and recursive blurs, the guided filter, histogram metering, the
+// colour average and the exposure readback, with every permutation.
+//
+// Passes go through AddToneMapFullscreenPass / AddToneMapComputePass, which
+// report the first use of any pipeline that was neither collected nor
+// prewarmed: one log line per pipeline and the 'On-Demand PSOs' counter in
+// `stat ToneMapFX`.
+// =============================================================================
+
+class TONEMAPFX_API FToneMapPSOPrecache
+{
+public:
+	// Create or precache every ToneMapFX pipeline for the feature level.
+	// Any thread; the work is enqueued on the render thread.  Pipelines are
+	// compiled asynchronously where PSO precaching is enabled, synchronously
+	// otherwise — call it while a loading screen hides the cost.
+	static void PrewarmPipelines(ERHIFeatureLevel::Type FeatureLevel = GMaxRHIFeatureLevel);
+
+	// Note that a pass is about to use this pipeline; reports it once if it was
+	// not precached (render thread)
+	static void TrackGraphics_RenderThread(const TShaderRef<FShader>& PixelShader, EPixelFormat RenderTargetFormat);
+	static void TrackCompute_RenderThread(const TShaderRef<FShader>& ComputeShader);
+
+	// Pipelines reported as created on demand since startup
+	static int32 GetNumOnDemand();
+};
+
+// FPixelShaderUtils::AddFullscreenPass, reporting pipelines that were not precached
+template<typename PSType>
+void AddToneMapFullscreenPass(
+	FRDGBuilder& GraphBuilder,
+	const FGlobalShaderMap* ShaderMap,
+	FRDGEventName&& PassName,
+	const TShaderRef<PSType>& PixelShader,
+	typename PSType::FParameters* Parameters,
+	const FIntRect& Viewport)
+{
+	const FRDGTextureRef RenderTarget = Parameters->RenderTargets[0].GetTexture();
+	FToneMapPSOPrecache::TrackGraphics_RenderThread(PixelShader, RenderTarget ? RenderTarget->Desc.Format : PF_Unknown);
+
+	FPixelShaderUtils::AddFullscreenPass(GraphBuilder, ShaderMap, MoveTemp(PassName), PixelShader, Parameters, Viewport);
+}
+
+// FComputeShaderUtils::AddPass, reporting pipelines that were not precached
+template<typename CSType>
+void AddToneMapComputePass(
+	FRDGBuilder& GraphBuilder,
+	FRDGEventName&& PassName,
+	ERDGPassFlags PassFlags,
+	const TShaderRef<CSType>& ComputeShader,
+	typename CSType::FParameters* Parameters,
+	FIntVector GroupCount)
+{
+	FToneMapPSOPrecache::TrackCompute_RenderThread(ComputeShader);
+
+	FComputeShaderUtils::AddPass(GraphBuilder, MoveTemp(PassName), PassFlags, ComputeShader, Parameters, GroupCount);
+}
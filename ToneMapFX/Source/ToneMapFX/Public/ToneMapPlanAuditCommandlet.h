@@ -0,0 +1,32 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ToneMapPlanAuditCommandlet.generated.h"
+
+// ============================================================================
+// Offline cost audit of a preset folder
+//
+//   UnrealEditor-Cmd <Project>.uproject -run=ToneMapFXPlanAudit -nullrhi
+//       [-dir=<folder>] [-width=W -height=H] [-quality=N] [-csv=<file>]
+//       [-budgetmb=M]
+//
+// Builds an FToneMapFramePlan for every .txt preset in the folder (default
+// Saved/ToneMapFX), logs it and writes one CSV row per preset.  Returns 1
+// when a plan is invalid, a preset fails to load or a preset's peak
+// transient memory exceeds -budgetmb.  The planner itself is covered by the
+// ToneMapFX.FramePlan automation tests.
+// ============================================================================
+
+UCLASS()
+class TONEMAPFX_API UToneMapFXPlanAuditCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UToneMapFXPlanAuditCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,119 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ToneMapPresetAsset.generated.h"
+
+class UToneMapComponent;
+
+// ============================================================================
+// Packed preset data
+//
+// Every preset property of UToneMapComponent stored as its raw in-memory value
+// in one contiguous byte blob, addressed by a small name/type/offset table.
+// Object references (LUT / vignette textures) live in a separate UPROPERTY
+// array so they are cooked and loaded together with the asset.
+//
+// Applying is a lookup-free copy loop: the layout is resolved to FProperty
+// pointers once per asset, after that each entry is a single CopySingleValue.
+// Entries whose name or type no longer matches the component are skipped,
+// which keeps old assets loadable across plugin versions.
+// ============================================================================
+
+USTRUCT()
+struct FToneMapPackedProperty
+{
+	GENERATED_BODY()
+
+	/** Property name on UToneMapComponent */
+	UPROPERTY()
+	FName Name;
+
+	/** Property class name (FloatProperty, EnumProperty, ...) — guards against type changes */
+	UPROPERTY()
+	FName TypeName;
+
+	/** Byte offset into Values, or index into ObjectValues for object properties */
+	UPROPERTY()
+	int32 Offset = 0;
+
+	/** Element size in bytes (0 for object properties) */
+	UPROPERTY()
+	int32 Size = 0;
+};
+
+USTRUCT(BlueprintType)
+struct TONEMAPFX_API FToneMapPresetData
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FToneMapPackedProperty> Layout;
+
+	UPROPERTY()
+	TArray<uint8> Values;
+
+	UPROPERTY()
+	TArray<TObjectPtr<UObject>> ObjectValues;
+
+	/** Pack the current settings of a component */
+	void CaptureFrom(const UToneMapComponent& Component);
+
+	/** Copy the packed settings onto a component. Returns the number of properties applied. */
+	int32 ApplyTo(UToneMapComponent& Component) const;
+
+	bool IsEmpty() const { return Layout.Num() == 0; }
+
+	/** Drop the resolved property cache (after the layout changed) */
+	void InvalidateResolvedLayout() { ResolvedProperties.Reset(); }
+
+private:
+	void ResolveLayout() const;
+
+	// Layout entry → matching component property (nullptr = stale entry, skipped)
+	mutable TArray<FProperty*> ResolvedProperties;
+};
+
+// ============================================================================
+// UToneMapPresetAsset — cookable ToneMapFX preset
+//
+// Create via Content Browser → Miscellaneous → Data Asset → ToneMapPresetAsset.
+// Fill it from an existing .txt preset with "Import From Text File", or write
+// one back out with "Export To Text File".  At runtime apply it directly with
+// UToneMapComponent::ApplyPreset or stream it with LoadPresetAsync.
+// ============================================================================
+
+UCLASS(BlueprintType)
+class TONEMAPFX_API UToneMapPresetAsset : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/** Packed component settings */
+	UPROPERTY(VisibleAnywhere, Category = "Preset")
+	FToneMapPresetData Settings;
+
+	/** Capture the settings of a component into this asset. */
+	UFUNCTION(BlueprintCallable, Category = "Tone Map|Presets")
+	void CaptureFromComponent(const UToneMapComponent* Component);
+
+	/** Import a .txt preset (same format as UToneMapComponent::SavePresetToPath). */
+	UFUNCTION(BlueprintCallable, Category = "Tone Map|Presets")
+	bool ImportFromTextPath(const FString& FilePath);
+
+	/** Export this asset as a .txt preset. */
+	UFUNCTION(BlueprintCallable, Category = "Tone Map|Presets")
+	bool ExportToTextPath(const FString& FilePath) const;
+
+#if WITH_EDITOR
+	/** Open a file browser and import a .txt preset into this asset. */
+	UFUNCTION(CallInEditor, Category = "Preset")
+	void ImportFromTextFile();
+
+	/** Open a Save File dialog and export this asset as a .txt preset. */
+	UFUNCTION(CallInEditor, Category = "Preset")
+	void ExportToTextFile();
+#endif
+};
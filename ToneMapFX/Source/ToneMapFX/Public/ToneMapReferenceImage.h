@@ -0,0 +1,37 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ToneMapColorMath.h"
+
+// =============================================================================
+// Linear float image shared by frame capture (ToneMapCapture.h) and the CPU
+// reference pipeline of the ToneMapFXTests module.  Reads and writes EXR.
+// =============================================================================
+
+/** Linear RGB float image, row-major */
+struct TONEMAPFX_API FToneMapReferenceImage
+{
+	int32 Width = 0;
+	int32 Height = 0;
+	TArray<ToneMapColorMath::float3> Pixels;
+
+	void Init(int32 InWidth, int32 InHeight);
+
+	ToneMapColorMath::float3& At(int32 X, int32 Y) { return Pixels[Y * Width + X]; }
+	const ToneMapColorMath::float3& At(int32 X, int32 Y) const { return Pixels[Y * Width + X]; }
+
+	// AM_Clamp point fetch, and SF_Bilinear sample at a texture UV
+	const ToneMapColorMath::float3& Load(int32 X, int32 Y) const;
+	ToneMapColorMath::float3 Sample(float U, float V) const;
+
+	// Texture UV of texel (X, Y)'s centre
+	float GetU(int32 X) const { return ((float)X + 0.5f) / (float)Width; }
+	float GetV(int32 Y) const { return ((float)Y + 0.5f) / (float)Height; }
+
+	// Any format FImageUtils reads, converted to linear RGBA32F; alpha is dropped
+	bool LoadFromFile(const FString& Path);
+	// Format by extension (.exr keeps the full range)
+	bool SaveToFile(const FString& Path) const;
+};
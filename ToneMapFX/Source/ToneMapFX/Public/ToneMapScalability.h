@@ -0,0 +1,87 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UToneMapComponent;
+
+// =============================================================================
+// Quality tiers — r.ToneMapFX.Quality (0 = Low … 3 = Epic, 4 = Cinematic)
+//
+// Each tier caps the cost-driving component settings and scales the working
+// resolution of the lens effects, so the same preset stays within budget on
+// low-end hardware.  A cap never raises a value, it only limits it.
+//
+// Tier values come from Scalability.ini sections named like the engine's own
+// groups, with the compiled-in defaults below as fallback:
+//
+//   [ToneMapFXQuality@0]
+//   MaxGlareSamples=8
+//   LensResolutionScale=0.5
+//
+// The plugin's Config/DefaultScalability.ini sets r.ToneMapFX.Quality from
+// the [PostProcessQuality@N] sections, so it follows sg.PostProcessQuality.
+// =============================================================================
+
+struct FToneMapQualityTier
+{
+	int32 MaxGlareSamples        = 64;
+	int32 MaxKawaseMipCount      = 8;
+	int32 MaxFattalIterations    = 200;
+	int32 MaxCoronaSpikeLength   = 400;
+	int32 HaloAngularSamples     = 32;   // shader maximum
+	int32 MaxBloomBlurPasses     = 4;
+	float MaxClarityRadius       = 50.0f;
+	float MaxBloomDownsampleScale = 2.0f;
+	float LensResolutionScale    = 1.0f;
+};
+
+// Settings actually used by the passes once a tier's caps are applied
+struct FToneMapResolvedQuality
+{
+	int32 GlareSamples = 0;
+	int32 KawaseMipCount = 0;
+	int32 FattalIterations = 0;
+	int32 CoronaSpikeLength = 0;   // in lens-buffer pixels
+	int32 HaloAngularSamples = 0;
+	int32 BloomBlurPasses = 0;
+	float ClarityRadius = 0.0f;
+	float BloomDownsampleScale = 0.0f;
+	float LensResolutionScale = 1.0f;
+};
+
+class TONEMAPFX_API FToneMapScalability
+{
+public:
+	static constexpr int32 NumTiers = 5;
+
+	// Read the tier tables from Scalability.ini (module startup)
+	static void LoadConfig();
+
+	// Active tier index for the render thread, clamped to [0, NumTiers)
+	static int32 GetQualityLevel_RenderThread();
+
+	static const FToneMapQualityTier& GetTier(int32 QualityLevel);
+
+	// Compiled-in values of a tier, before Scalability.ini overrides
+	static FToneMapQualityTier GetDefaultTier(int32 QualityLevel);
+
+	// Tier in effect for the frame being rendered
+	static const FToneMapQualityTier& GetActiveTier_RenderThread()
+	{
+		return GetTier(GetQualityLevel_RenderThread());
+	}
+
+	// Apply a tier's caps to a component's settings (pure — no CVar or config access)
+	static FToneMapResolvedQuality Resolve(const UToneMapComponent& Settings, const FToneMapQualityTier& Tier);
+
+	// Walk every tier, log what it resolves to for Settings and warn when a
+	// lower tier ends up more expensive than a higher one.  Returns false on a
+	// non-monotonic table.  ToneMapFX.Scalability.* automation tests check the
+	// tables and the frame plan each tier produces.
+	static bool ValidateTiers(const UToneMapComponent& Settings);
+
+private:
+	static FToneMapQualityTier Tiers[NumTiers];
+};
@@ -0,0 +1,49 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ToneMapShaderReportCommandlet.generated.h"
+
+// ============================================================================
+// Offline instruction / register report of every ToneMapFX shader
+//
+//   UnrealEditor-Cmd <Project>.uproject -run=ToneMapFXShaderReport -nullrhi
+//       [-formats=PCD3D_SM5+PCD3D_SM6+SF_VULKAN_SM5] [-shader=<name filter>]
+//       [-csv=<file>] [-baseline=<csv>] [-maxgrowth=<percent>]
+//
+// Compiles every permutation of every /Plugin/ToneMapFX global shader that
+// ShouldCompilePermutation keeps (shader stripping included) for each shader
+// format, through the shader compiling manager and ShaderCompileWorker.  No
+// RHI or GPU is involved; a format whose compiler is not installed on this
+// host is skipped with a warning.
+//
+// One CSV row per shader, permutation and format (default
+// Saved/ToneMapFX/ShaderReport.csv):
+//   Instructions     the backend's count (DXBC / DXIL / SPIR-V instructions)
+//   TempRegisters    DXBC temp registers; DXIL and SPIR-V are SSA, so only a
+//                    backend that reports register statistics fills it
+//   TextureFetches   static sample / load / gather instructions in the
+//                    bytecode (DXBC STAT part, SPIR-V opcodes) — a loop body
+//                    counts once; empty for DXIL
+//   TextureSamplers  sampler slots bound
+//   CodeBytes        compiled size
+// Columns a format cannot report are left empty.
+//
+// With -baseline the report is diffed against an earlier CSV into
+// ShaderReportDiff.csv next to it.  Returns 1 when a permutation fails to
+// compile, or when -maxgrowth is given and a metric of a permutation grows by
+// more than that percentage.  Editor builds only.
+// ============================================================================
+
+UCLASS()
+class TONEMAPFX_API UToneMapFXShaderReportCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UToneMapFXShaderReportCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -6,6 +6,9 @@
 #include "GlobalShader.h"
 #include "ShaderParameterStruct.h"
 #include "ScreenPass.h"
+#include "ToneMapHalfPrecision.h"
+#include "ToneMapGaussianBlur.h"
+#include "ToneMapGradingParameters.h"
 
 // =============================================================================
 // Gaussian blur shader for Clarity (separable horizontal/vertical)
@@ -22,9 +25,30 @@ public:
 		SHADER_PARAMETER_SAMPLER(SamplerState, SourceSampler)
 		SHADER_PARAMETER(FVector4f, BufferSizeAndInvSize)
 		SHADER_PARAMETER(FVector2f, BlurDirection)
-		SHADER_PARAMETER(float, BlurRadius)
 		SHADER_PARAMETER(FVector4f, SourceViewportRect)
 		SHADER_PARAMETER(FVector4f, SourceExtentInv)
+		SHADER_PARAMETER_STRUCT_INCLUDE(FToneMapGaussianKernelParameters, Kernel)
+		RENDER_TARGET_BINDING_SLOTS()
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+};
+
+// =============================================================================
+// Luminance extraction for luma-only local contrast (R16F output)
+// =============================================================================
+class FToneMapLocalContrastLumaPS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FToneMapLocalContrastLumaPS);
+	SHADER_USE_PARAMETER_STRUCT(FToneMapLocalContrastLumaPS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, SourceTexture)
+		SHADER_PARAMETER(FIntPoint, SourceOrigin)
 		RENDER_TARGET_BINDING_SLOTS()
 	END_SHADER_PARAMETER_STRUCT()
 
@@ -36,6 +60,8 @@ public:
 
 // =============================================================================
 // Main Tone Map processing shader — all adjustments in a single pass
+//   The grading constants come from the shared ToneMapGrading buffer
+//   (ToneMapGradingParameters.h); only per-frame values are loose.
 // =============================================================================
 class FToneMapProcessPS : public FGlobalShader
 {
@@ -43,6 +69,8 @@ public:
 	DECLARE_GLOBAL_SHADER(FToneMapProcessPS);
 	SHADER_USE_PARAMETER_STRUCT(FToneMapProcessPS, FGlobalShader);
 
+	using FPermutationDomain = TShaderPermutationDomain<FToneMapHalfPrecisionDim>;
+
 	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
 		SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
 		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, SceneColorTexture)
@@ -60,61 +88,24 @@ public:
 		SHADER_PARAMETER_SAMPLER(SamplerState, BloomSampler)
 		SHADER_PARAMETER(FScreenTransform, SvPositionToBloomUV)
 
-		// Mode: 0 = PostProcess (LDR), 1 = ReplaceTonemap (HDR)
-		SHADER_PARAMETER(float, bReplaceTonemap)
+		// Grading constants (mode, film curve, grading, spatial strengths)
+		SHADER_PARAMETER_STRUCT_REF(FToneMapGradingUniformParameters, Grading)
 
 		// Exposure removal (ReplaceTonemap mode)
 		SHADER_PARAMETER(float, OneOverPreExposure)
 		SHADER_PARAMETER(float, GlobalExposure)
 
-		// Film Curve params (ReplaceTonemap mode)
-		SHADER_PARAMETER(float, FilmCurveMode) // 0=Hable, 1=ReinhardLum, 2=ReinhardJodie, 3=ReinhardStd, 4=Durand, 5=Fattal, 6=AgX
-		SHADER_PARAMETER(FVector4f, HableParams1) // x=A(Shoulder), y=B(Linear), z=C(LinearAngle), w=D(ToeStrength)
-		SHADER_PARAMETER(FVector4f, HableParams2) // x=E(ToeNum), y=F(ToeDenom), z=W(WhitePoint), w=unused
-		SHADER_PARAMETER(float, ReinhardWhitePoint)
-		SHADER_PARAMETER(float, HDRSaturation)
-		SHADER_PARAMETER(FVector3f, HDRColorBalance)
-
-		// AgX params (ReplaceTonemap mode, FilmCurve == AgX)
-		SHADER_PARAMETER(FVector4f, AgXParams) // x=MinEV, y=MaxEV, z=Look(0=None,1=Punchy,2=Golden), w=unused
-
 		// Pre-tone-mapped bypass (Durand / Fattal multi-pass operators)
-		// When bPreToneMapped > 0.5, ApplyFilmCurve is skipped and PreToneMappedTexture is
-		// composited directly.  All color-grading, sRGB conversion, dithering still run.
-		SHADER_PARAMETER(float, bPreToneMapped)
+		// When ToneMapGrading.bPreToneMapped > 0.5, ApplyFilmCurve is skipped and
+		// PreToneMappedTexture is composited directly.  All color-grading, sRGB
+		// conversion, dithering still run.
 		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, PreToneMappedTexture)
 		SHADER_PARAMETER_SAMPLER(SamplerState, PreToneMappedSampler)
 		SHADER_PARAMETER(FScreenTransform, SvPositionToPreToneMappedUV)
 
-		// Auto-Exposure (ReplaceTonemap mode)
-		SHADER_PARAMETER(float, AutoExposureMode) // 0=None, 1=EngineDefault, 2=Krawczyk
+		// Auto-Exposure (ReplaceTonemap mode, Krawczyk)
 		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, AdaptedLumTexture)
 		SHADER_PARAMETER_SAMPLER(SamplerState, AdaptedLumSampler)
-		SHADER_PARAMETER(float, MinAutoExposure)
-		SHADER_PARAMETER(float, MaxAutoExposure)
-
-		// White Balance
-		SHADER_PARAMETER(float, Temperature)
-		SHADER_PARAMETER(float, Tint)
-
-		// Exposure
-		SHADER_PARAMETER(float, ExposureValue)
-		SHADER_PARAMETER(float, CameraEV)
-		SHADER_PARAMETER(float, bUseCameraExposure)
-
-		// Tone
-		SHADER_PARAMETER(float, Contrast)
-		SHADER_PARAMETER(float, HighlightsValue)
-		SHADER_PARAMETER(float, ShadowsValue)
-		SHADER_PARAMETER(float, WhitesValue)
-		SHADER_PARAMETER(float, BlacksValue)
-		SHADER_PARAMETER(float, ToneSmoothingValue)
-		SHADER_PARAMETER(float, ContrastMidpoint)
-
-		// Presence
-		SHADER_PARAMETER(float, ClarityStrength)
-		SHADER_PARAMETER(float, VibranceStrength)
-		SHADER_PARAMETER(float, SaturationStrength)
 
 		// Dynamic Contrast — multi-scale blur textures
 		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, BlurredFineTexture)
@@ -123,31 +114,11 @@ public:
 		SHADER_PARAMETER_SAMPLER(SamplerState, BlurredCoarseSampler)
 		SHADER_PARAMETER(FScreenTransform, SvPositionToBlurredFineUV)
 		SHADER_PARAMETER(FScreenTransform, SvPositionToBlurredCoarseUV)
+		SHADER_PARAMETER(FVector3f, LumaOnlyBlurs)      // x = Clarity, y = fine, z = coarse: 1 = R16F luma blur
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, SceneAverageColorTexture) // 1x1 frame average (Correct Color Cast)
+		SHADER_PARAMETER(float, bGlobalColorCast)       // 1 = Correct Color Cast uses SceneAverageColorTexture
 
-		// Dynamic Contrast — strengths
-		SHADER_PARAMETER(float, DynamicContrastStrength)
-		SHADER_PARAMETER(float, CorrectContrastStrength)
-		SHADER_PARAMETER(float, CorrectColorCastStrength)
-
-		// Tone Curve (x=Highlights, y=Lights, z=Darks, w=Shadows)
-		SHADER_PARAMETER(FVector4f, ToneCurveParams)
-
-		// HSL — packed per-color adjustments
-		// float4(Reds, Oranges, Yellows, Greens)
-		// float4(Aquas, Blues, Purples, Magentas)
-		SHADER_PARAMETER(FVector4f, HueShift1)
-		SHADER_PARAMETER(FVector4f, HueShift2)
-		SHADER_PARAMETER(FVector4f, SatAdj1)
-		SHADER_PARAMETER(FVector4f, SatAdj2)
-		SHADER_PARAMETER(FVector4f, LumAdj1)
-		SHADER_PARAMETER(FVector4f, LumAdj2)
-
-		// HSL range smoothing
-		SHADER_PARAMETER(float, HSLSmoothing)
-
-		// Feature toggles
-		SHADER_PARAMETER(float, bEnableHSL)
-		SHADER_PARAMETER(float, bEnableCurves)
+		// Dithering — applied by the last pass of the chain only
 		SHADER_PARAMETER(float, DitherQuantization) // 0=off, 1/255=8-bit, 1/1023=10-bit
 
 		RENDER_TARGET_BINDING_SLOTS()
@@ -155,7 +126,16 @@ public:
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
-		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+		const FPermutationDomain PermutationVector(Parameters.PermutationId);
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapHalfPrecision::ShouldCompilePermutation(Parameters.Platform, PermutationVector.Get<FToneMapHalfPrecisionDim>());
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		const FPermutationDomain PermutationVector(Parameters.PermutationId);
+		FToneMapHalfPrecision::ModifyCompilationEnvironment(PermutationVector.Get<FToneMapHalfPrecisionDim>(), OutEnvironment);
 	}
 };
 
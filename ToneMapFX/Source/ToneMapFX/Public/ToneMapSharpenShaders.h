@@ -6,6 +6,7 @@
 #include "GlobalShader.h"
 #include "ShaderParameterStruct.h"
 #include "ScreenPass.h"
+#include "ToneMapHalfPrecision.h"
 
 // =============================================================================
 // Sharpening — Unsharp mask via 9-tap kernel
@@ -18,6 +19,8 @@ public:
 	DECLARE_GLOBAL_SHADER(FToneMapSharpenPS);
 	SHADER_USE_PARAMETER_STRUCT(FToneMapSharpenPS, FGlobalShader);
 
+	using FPermutationDomain = TShaderPermutationDomain<FToneMapHalfPrecisionDim>;
+
 	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
 		SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
 		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, SceneColorTexture)
@@ -34,6 +37,15 @@ public:
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
-		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+		const FPermutationDomain PermutationVector(Parameters.PermutationId);
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapHalfPrecision::ShouldCompilePermutation(Parameters.Platform, PermutationVector.Get<FToneMapHalfPrecisionDim>());
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		const FPermutationDomain PermutationVector(Parameters.PermutationId);
+		FToneMapHalfPrecision::ModifyCompilationEnvironment(PermutationVector.Get<FToneMapHalfPrecisionDim>(), OutEnvironment);
 	}
 };
@@ -0,0 +1,230 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RenderGraphBuilder.h"
+#include "ScreenPass.h"
+#include "Stats/Stats.h"
+#include "ToneMapScalability.h"
+#include "ToneMapTransientTextures.h"
+
+class FViewInfo;
+class FSceneView;
+class UToneMapComponent;
+class FToneMapStageTimer;
+class FToneMapExposureReadback;
+struct FToneMapViewSetup;
+struct FPostProcessMaterialInputs;
+
+// =============================================================================
+// Tone map stages
+//
+// PostProcessPass_RenderThread no longer hard-codes the pipeline.  Each step
+// (bloom, exposure, local contrast, Durand, Fattal, lens, the main process
+// pass and the display-referred chain) is an IToneMapStage registered with
+// FToneMapStageRegistry at an order slot.  Every frame the planner asks each
+// stage whether the view's settings snapshot needs it, culls the rest before
+// a single pass is added, then runs the survivors in order against one
+// FToneMapStageContext that carries scene colour and the intermediates the
+// later stages read.  The built-in stages take the settings half of that
+// decision from FToneMapFramePlanner::WantsStage (ToneMapFramePlan.h), so the
+// offline plan and the frame agree on what runs.
+//
+// Projects add their own steps by registering a stage between two built-in
+// slots (e.g. FToneMapStageOrder::Lens + 50) from their module's startup.
+// `stat ToneMapFX` shows the graph-building cost of every stage;
+// r.ToneMapFX.ListStages prints the registered order.
+// =============================================================================
+
+// Built-in order slots — gaps of 100 leave room for project stages
+struct FToneMapStageOrder
+{
+	static constexpr int32 Bloom         = 100;
+	static constexpr int32 Exposure      = 200;
+	static constexpr int32 LocalContrast = 300;
+	static constexpr int32 Durand        = 400;
+	static constexpr int32 Fattal        = 500;
+	static constexpr int32 Lens          = 600;
+	static constexpr int32 Process       = 700;   // scene-referred → display-referred
+	static constexpr int32 Sharpen       = 800;
+	static constexpr int32 LUT           = 900;
+	static constexpr int32 Vignette      = 1000;
+	static constexpr int32 HDREncode     = 1100;
+};
+
+// Persistent baked grading LUT (LUT processing path)
+struct FToneMapCachedLUT
+{
+	uint32 ParameterHash = 0;
+	uint64 LastUsedFrame = 0;
+	TRefCountPtr<IPooledRenderTarget> Texture;
+};
+
+// Scratch textures a stage will allocate this frame, before aliasing
+struct FToneMapStageResources
+{
+	struct FTexture
+	{
+		const TCHAR* Name = nullptr;
+		FIntPoint Extent = FIntPoint::ZeroValue;
+		EPixelFormat Format = PF_Unknown;
+	};
+
+	TArray<FTexture, TInlineAllocator<16>> Textures;
+
+	void Add(const TCHAR* Name, FIntPoint Extent, EPixelFormat Format) { Textures.Add({ Name, Extent, Format }); }
+	void Add(const TCHAR* Name, FIntPoint Extent, EToneMapIntermediate Usage) { Add(Name, Extent, FToneMapTransientTextures::GetFormat(Usage)); }
+
+	uint64 GetBytes() const;
+};
+
+class IToneMapStage;
+
+struct FToneMapRegisteredStage
+{
+	TSharedPtr<IToneMapStage, ESPMode::ThreadSafe> Stage;
+	int32 Order = 0;
+	TStatId StatId;
+};
+
+using FToneMapStagePlan = TArray<FToneMapRegisteredStage, TInlineAllocator<16>>;
+
+// =============================================================================
+// Per-view state shared by the stages of one frame
+// =============================================================================
+
+struct TONEMAPFX_API FToneMapStageContext
+{
+	FToneMapStageContext(
+		FRDGBuilder& InGraphBuilder,
+		const FSceneView& InView,
+		const FPostProcessMaterialInputs& InInputs,
+		const UToneMapComponent& InSettings,
+		FToneMapViewSetup& InSetup,
+		FToneMapTransientTextures& InTransients);
+
+	// --- Frame inputs ---
+	FRDGBuilder& GraphBuilder;
+	const FSceneView& View;
+	const FViewInfo& ViewInfo;
+	const FPostProcessMaterialInputs& Inputs;
+	const UToneMapComponent& Settings;      // blended snapshot for this view
+	uint32 SettingsHash = 0;                // FToneMapSettingsSnapshot::GetHash of Settings
+	FToneMapViewSetup& Setup;               // cached extents and transforms
+	FToneMapTransientTextures& Transients;
+
+	FToneMapResolvedQuality Quality;        // after r.ToneMapFX.Quality and the governor
+	FToneMapPlanInputs PlanInputs;          // the frame as FToneMapFramePlanner sees it
+	FToneMapStageTimer* StageTimer = nullptr;
+	EShaderPlatform ShaderPlatform = SP_NumPlatforms;
+	bool bIsReplaceTonemap = false;
+	bool bHalfPrecision = false;            // r.ToneMapFX.HalfPrecision on this platform
+
+	// Quantized scene-buffer extent — the output texture must match it (SMAA RTMetrics)
+	FIntPoint OriginalSceneColorExtent = FIntPoint::ZeroValue;
+	// Scene-colour viewport as the engine handed it over; ViewportSize is the working size
+	FScreenPassTextureViewport SceneColorViewport;
+	FIntPoint ViewportSize = FIntPoint::ZeroValue;
+
+	// --- Persistent state owned by the view extension ---
+	TRefCountPtr<IPooledRenderTarget>* AdaptedLuminanceRT = nullptr;
+	TRefCountPtr<IPooledRenderTarget>* ColorAverageRT = nullptr;
+	FToneMapExposureReadback* ExposureReadback = nullptr;
+	TArrayView<FToneMapCachedLUT> LUTCache;
+	float DeltaTime = 0.016f;
+
+	// --- Display output (resolved before planning) ---
+	bool   bHDREncode = false;              // HDR display and the component asks for HDR output
+	uint32 HDROutputDevice = 0;
+	float  HDRMaxDisplayNits = 80.0f;
+	float  DitherQuantization = 0.0f;       // applied by the last stage only
+
+	// --- Chain state, written by the stages as they run ---
+	FScreenPassTexture SceneColor;                     // bloom and lens replace it
+	bool bBloomApplied = false;
+	FRDGTextureRef AdaptedLumTexture = nullptr;        // Krawczyk
+	FRDGTextureRef BlurredTexture = nullptr;           // Clarity base; nullptr = scene colour
+	FRDGTextureRef BlurredFineTexture = nullptr;
+	FRDGTextureRef BlurredCoarseTexture = nullptr;
+	FVector3f LumaOnlyBlurs = FVector3f::ZeroVector;
+	bool bGlobalColorCast = false;
+	FRDGTextureRef SceneAverageColorTexture = nullptr;
+	FRDGTextureRef PreToneMappedTexture = nullptr;     // Durand / Fattal
+	FScreenPassRenderTarget OutputTarget;              // latest display-referred image
+	FScreenPassRenderTarget FinalOutputTarget;         // what the callback returns
+
+	// --- Plan, set by FToneMapStagePlanner::Execute ---
+	TConstArrayView<FToneMapRegisteredStage> Plan;
+	int32 StageIndex = INDEX_NONE;
+
+	bool HasStagesAfter() const { return StageIndex + 1 < Plan.Num(); }
+
+	// Dithering only survives when no later pass filters it away
+	float GetDitherQuantization() const { return HasStagesAfter() ? 0.0f : DitherQuantization; }
+
+	// Display-referred chain: where the running stage writes — a working-size
+	// intermediate when more stages follow, otherwise the final output
+	FScreenPassRenderTarget CreateChainTarget(const TCHAR* Name);
+
+	// Make Target the chain's latest image and end the lifetime of the one it replaces
+	void AdvanceChain(const FScreenPassRenderTarget& Target);
+};
+
+// =============================================================================
+// IToneMapStage
+// =============================================================================
+
+class IToneMapStage
+{
+public:
+	virtual ~IToneMapStage() = default;
+
+	// Stable name for stats, logs and Unregister (static storage)
+	virtual const TCHAR* GetName() const = 0;
+
+	// Whether this view needs the stage.  Called before any stage runs, so it
+	// may only look at the settings snapshot, the platform and the frame
+	// inputs — not at what earlier stages produced.
+	virtual bool IsActive(const FToneMapStageContext& Context) const = 0;
+
+	// Scratch textures AddPasses is about to create, for stats and planning
+	virtual void DeclareResources(const FToneMapStageContext& Context, FToneMapStageResources& OutResources) const {}
+
+	// Add the stage's passes and publish its results on the context
+	virtual void AddPasses(FToneMapStageContext& Context) const = 0;
+};
+
+// =============================================================================
+// Registry and planner
+// =============================================================================
+
+class TONEMAPFX_API FToneMapStageRegistry
+{
+public:
+	// Add Stage at Order (FToneMapStageOrder).  Stages sharing an order run in
+	// registration order; a stage with the same name is replaced.  Any thread —
+	// takes effect from the next planned frame.
+	static void Register(TSharedRef<IToneMapStage, ESPMode::ThreadSafe> Stage, int32 Order);
+	static void Unregister(const TCHAR* StageName);
+
+	// Built-in stages (module startup) / drop everything (module shutdown)
+	static void RegisterBuiltInStages();
+	static void Reset();
+
+	// Copy of the registered stages in execution order
+	static void GetStages(FToneMapStagePlan& OutStages);
+
+	// Log the registered order (r.ToneMapFX.ListStages)
+	static void Dump();
+};
+
+class TONEMAPFX_API FToneMapStagePlanner
+{
+public:
+	// Active stages for this view in registry order; the rest are culled
+	static void Plan(const FToneMapStageContext& Context, FToneMapStagePlan& OutPlan);
+
+	// Declare and add the passes of every planned stage, in order
+	static void Execute(FToneMapStageContext& Context, const FToneMapStagePlan& Plan);
+};
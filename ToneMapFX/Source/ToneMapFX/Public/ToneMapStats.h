@@ -0,0 +1,25 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+// =============================================================================
+// ToneMapFX stats group — `stat ToneMapFX`
+// =============================================================================
+
+DECLARE_STATS_GROUP(TEXT("ToneMapFX"), STATGROUP_ToneMapFX, STATCAT_Advanced);
+
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Peak Transient Memory (per view)"), STAT_ToneMapFX_PeakTransientMemory, STATGROUP_ToneMapFX, TONEMAPFX_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Transient Resources Created"), STAT_ToneMapFX_TransientTexturesCreated, STATGROUP_ToneMapFX, TONEMAPFX_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Resolve Volumes"), STAT_ToneMapFX_ResolveVolumes, STATGROUP_ToneMapFX, TONEMAPFX_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("View Setup"), STAT_ToneMapFX_ViewSetup, STATGROUP_ToneMapFX, TONEMAPFX_API);
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Governed GPU Time (ms)"), STAT_ToneMapFX_GovernedGPUTime, STATGROUP_ToneMapFX, TONEMAPFX_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Governor Degrade Level"), STAT_ToneMapFX_GovernorLevel, STATGROUP_ToneMapFX, TONEMAPFX_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("On-Demand PSOs"), STAT_ToneMapFX_OnDemandPSOs, STATGROUP_ToneMapFX, TONEMAPFX_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Plan Stages"), STAT_ToneMapFX_PlanStages, STATGROUP_ToneMapFX, TONEMAPFX_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Active Stages"), STAT_ToneMapFX_ActiveStages, STATGROUP_ToneMapFX, TONEMAPFX_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Culled Stages"), STAT_ToneMapFX_CulledStages, STATGROUP_ToneMapFX, TONEMAPFX_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Declared Stage Memory (per view)"), STAT_ToneMapFX_DeclaredStageMemory, STATGROUP_ToneMapFX, TONEMAPFX_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Grading Buffer Updates"), STAT_ToneMapFX_GradingBufferUpdates, STATGROUP_ToneMapFX, TONEMAPFX_API);
@@ -6,9 +6,45 @@
 #include "Subsystems/WorldSubsystem.h"
 #include "SceneViewExtension.h"
 #include "RendererInterface.h"
+#include "ToneMapVolumes.h"
+#include "ToneMapBudgetGovernor.h"
+#include "ToneMapExposureReadback.h"
+#include "ToneMapViewSetup.h"
+#include "ToneMapComponent.h"
+#include "ToneMapStage.h"
+#include "ToneMapCapture.h"
 #include "ToneMapSubsystem.generated.h"
 
-class UToneMapComponent;
+// =============================================================================
+// Settings snapshot — what one view renders with this frame
+//
+// The game thread blends the settings into a pooled component, hashes them
+// and hands the render thread a shared reference.  Nothing writes the
+// component again while anyone besides the pool holds the snapshot: the pool
+// only recycles it once the render thread has dropped its reference (the
+// view's next snapshot replaced it, or the view stopped rendering).
+// =============================================================================
+
+class FToneMapSettingsSnapshot
+{
+public:
+	const UToneMapComponent& Get() const { return *Settings; }
+
+	// FToneMapSettingsBlend::GetHash of the settings, taken when they were blended
+	uint32 GetHash() const { return Hash; }
+
+private:
+	friend class UToneMapSubsystem;
+
+	UToneMapComponent* Settings = nullptr;
+	uint32 Hash = 0;
+
+	// Snapshots Settings->LUTBlend points at, kept alive with it
+	TSharedPtr<const FToneMapSettingsSnapshot, ESPMode::ThreadSafe> BlendFrom;
+	TSharedPtr<const FToneMapSettingsSnapshot, ESPMode::ThreadSafe> BlendTo;
+};
+
+using FToneMapSettingsSnapshotPtr = TSharedPtr<const FToneMapSettingsSnapshot, ESPMode::ThreadSafe>;
 
 // =============================================================================
 // Scene View Extension — hooks into the post-process pipeline
@@ -34,9 +70,32 @@ public:
 	virtual bool IsActiveThisFrame_Internal(const FSceneViewExtensionContext& Context) const override;
 	virtual int32 GetPriority() const override { return 50; }
 
+	// Drop all per-view settings snapshots and derived setup (subsystem shutdown)
+	void ResetViewSettings_RenderThread() { RenderThreadSettings.Reset(); ViewSetupCache.Reset(); RenderThreadReplays.Reset(); CaptureRequests.Reset(); TransientBudgets.Reset(); }
+
 private:
 	TWeakObjectPtr<UToneMapSubsystem> WeakSubsystem;
 
+	struct FViewSettings
+	{
+		FToneMapSettingsSnapshotPtr Snapshot;
+		uint64 LastFrame = 0;
+	};
+
+	// Blended settings per view key, handed over from SetupView by render command.
+	// Only touched on the render thread.  Views without a view state share key 0.
+	TMap<uint32, FViewSettings> RenderThreadSettings;
+
+	// Snapshot of the view, or nullptr when ToneMapFX is off there (render thread)
+	const FToneMapSettingsSnapshot* FindSnapshot_RenderThread(uint32 ViewKey) const;
+	const UToneMapComponent* FindSettings_RenderThread(uint32 ViewKey) const;
+
+	// Forget views that stopped rendering, releasing their snapshots to the pool
+	void PruneViews_RenderThread();
+
+	// Viewport-derived extents and transforms per view key (render thread only)
+	FToneMapViewSetupCache ViewSetupCache;
+
 	// Cached mode from game thread (read in SetupView)
 	bool bCachedReplaceTonemap = false;
 	bool bCachedHDROutput = false;
@@ -44,9 +103,44 @@ private:
 	// Persistent adapted luminance for Krawczyk auto-exposure (survives across frames)
 	TRefCountPtr<IPooledRenderTarget> AdaptedLuminanceRT;
 
+	// Persistent frame-average colour for Correct Color Cast (temporal smoothing)
+	TRefCountPtr<IPooledRenderTarget> ColorAverageRT;
+
+	// Krawczyk statistics on their way to the game thread (drained in SetupView)
+	FToneMapExposureReadback ExposureReadback;
+
+	// Baked LUTs reused while their inputs are unchanged (render thread only).
+	// Four slots cover a transition's two end points plus a couple of views.
+	FToneMapCachedLUT LUTCache[4];
+
+	// r.ToneMapFX.BudgetMs — GPU timestamps of earlier frames and the degrade
+	// levels derived from them (render thread only)
+	FToneMapStageTimer GPUStageTimer;
+	FToneMapGovernorState GovernorState;
+
+	// r.ToneMapFX.TransientBudgetMB — bloom / lens resolution level per view key
+	// (render thread only)
+	TMap<uint32, FToneMapTransientBudgetState> TransientBudgets;
+
 	// Delta time cached from game thread for render thread use
 	float LastDeltaTime = 0.016f;
 
+	// r.ToneMapFX.Capture — readbacks in flight and the capture directory each
+	// view should fill this frame (render thread only)
+	FToneMapFrameCapture FrameCapture;
+	TMap<uint32, FString> CaptureRequests;
+
+	// r.ToneMapFX.Replay gpu — the capture fed back into one view.  Its settings
+	// stay on the game thread (the render thread reads pooled snapshots of
+	// them); its scene colour and timings live in the shared replay.
+	TUniquePtr<FToneMapCaptureData> ReplayCapture;
+	TSharedPtr<FToneMapGPUReplay, ESPMode::ThreadSafe> GPUReplay;
+	uint32 ReplayViewKey = 0;
+	TMap<uint32, TSharedPtr<FToneMapGPUReplay, ESPMode::ThreadSafe>> RenderThreadReplays;
+
+	// Start, advance or end the GPU replay; the replay if ViewKey is its view
+	TSharedPtr<FToneMapGPUReplay, ESPMode::ThreadSafe> UpdateGPUReplay_GameThread(uint32 ViewKey);
+
 	FScreenPassTexture PostProcessPass_RenderThread(
 		FRDGBuilder& GraphBuilder,
 		const FSceneView& View,
@@ -71,9 +165,48 @@ public:
 
 	const TArray<TWeakObjectPtr<UToneMapComponent>>& GetComponents() const { return Components; }
 
+	/** Blend every component affecting ViewLocation (by priority and weight) into a
+	 *  snapshot the render thread can read while the game thread moves on.
+	 *  Game thread only.  Returns nullptr when no enabled component contributes. */
+	FToneMapSettingsSnapshotPtr ResolveForView(const FVector& ViewLocation);
+
+	/** Copy Source into a snapshot the render thread can read, as ResolveForView
+	 *  does for the blended settings (GPU replay).  Game thread only. */
+	FToneMapSettingsSnapshotPtr SnapshotOf(const UToneMapComponent& Source);
+
+	/** True if any registered component is active and enabled. */
+	bool HasAnyEnabledComponent() const;
+
+	/** Rebuild the volume index before the next resolve (component moved / reshaped). */
+	void MarkVolumesDirty() { bVolumeIndexDirty = true; }
+
+	/** Store a read-back exposure sample and broadcast it to every registered component.
+	 *  Game thread only. */
+	void PublishExposureSample(const FToneMapExposureSample& Sample);
+
+	const FToneMapExposureStats& GetLastExposureStats() const { return LastExposureStats; }
+
 private:
+	using FMutableSnapshot = TSharedRef<FToneMapSettingsSnapshot, ESPMode::ThreadSafe>;
+
+	// A pooled snapshot no one else references, cleared of its LUT blend
+	FMutableSnapshot AcquireSnapshot();
+
 	TSharedPtr<FToneMapSceneViewExtension, ESPMode::ThreadSafe> SceneViewExtension;
 
 	UPROPERTY(Transient)
 	TArray<TWeakObjectPtr<UToneMapComponent>> Components;
+
+	FToneMapVolumeIndex VolumeIndex;
+	bool bVolumeIndexDirty = true;
+
+	// Unregistered components holding blended settings, one per entry of
+	// Snapshots.  An entry is reused only when the pool holds its last reference.
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UToneMapComponent>> SnapshotPool;
+
+	TArray<FMutableSnapshot> Snapshots;
+	int32 NextSnapshot = 0;
+
+	FToneMapExposureStats LastExposureStats;
 };
@@ -0,0 +1,134 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RenderGraphBuilder.h"
+#include "ToneMapFramePlan.h"
+
+// =============================================================================
+// Intermediate usage — selects the pixel format of a ToneMapFX scratch texture
+// (EToneMapIntermediate lives in ToneMapFramePlan.h so the planner needs no RHI)
+//
+// With r.ToneMapFX.ReducedPrecisionIntermediates=1 (default) each usage picks
+// the smallest format whose error stays below what the consuming pass can see:
+//   Color        RGBA16F        detail-sensitive colour (Clarity, fine blur, results)
+//   BlurScratch  R11G11B10F     low-frequency colour (bloom chain, lens, coarse blur)
+//   LogLuminance R16F           log2 luminance (Durand base layer, Fattal seed)
+//   Scalar       R32F           precision-critical scalar (Fattal Poisson solve)
+//   Vector2      G32R32F        gradient fields
+//   Luminance    R16F           linear luma (luma-only local-contrast blurs)
+//
+// r.ToneMapFX.TransientBudgetMB acts in two ways:
+//   - within a frame, once the live footprint exceeds it, the usages whose
+//     error budget allows it are demoted for the rest of the frame:
+//     BlurScratch to R11G11B10F and LogLuminance to R16F.  Color keeps its
+//     alpha and sign, Scalar / Vector2 their precision.  With reduced
+//     precision on (the default) these formats are already in use.
+//   - across frames, a view whose peak exceeded the budget renders its bloom
+//     chain and lens buffers at half resolution per level (StepBudget /
+//     ApplyBudget), and climbs back once the saving measured on the way down
+//     fits under the budget again.  Full-resolution results are not touched,
+//     so a budget below them only reaches MaxLevel.
+// =============================================================================
+
+// Per-view state of the cross-frame budget feedback
+struct FToneMapTransientBudgetState
+{
+	static constexpr int32 MaxLevel = 3;
+
+	int32 Level = 0;                        // bloom / lens resolution halvings
+	uint64 PeakBeforeStep = 0;              // peak of the frame that stepped down
+	bool bMeasureSaving = false;            // next peak tells what the step saved
+	uint64 Savings[MaxLevel + 1] = {};      // bytes saved by stepping down to each level
+};
+
+// =============================================================================
+// Per-view transient resource tracker
+//
+// Thin wrapper over FRDGBuilder::CreateTexture / CreateBuffer that
+//   - resolves the format policy above,
+//   - tracks live and peak bytes for the budget and the STATGROUP_ToneMapFX
+//     memory stats.  Every scratch resource has to come through here, or the
+//     budget does not see it.
+// Memory reuse between stages is left to RDG's transient allocator, which
+// aliases resources whose pass lifetimes do not overlap.  Release() only marks
+// where a resource's lifetime ends, so the peak follows the same lifetimes.
+// Buffers the stages create (histogram, reduction partials, blur scratch) and
+// persistent readback staging are counted as well.
+// =============================================================================
+class TONEMAPFX_API FToneMapTransientTextures
+{
+public:
+	explicit FToneMapTransientTextures(FRDGBuilder& InGraphBuilder);
+
+	// Create a 2D render-targetable texture for the given usage
+	FRDGTextureRef Create(
+		FIntPoint Extent,
+		EToneMapIntermediate Usage,
+		const TCHAR* Name,
+		ETextureCreateFlags ExtraFlags = TexCreate_None,
+		const FClearValueBinding& ClearValue = FClearValueBinding::None);
+
+	// Create a texture with an explicit descriptor (e.g. scene-colour format)
+	FRDGTextureRef CreateFromDesc(const FRDGTextureDesc& Desc, const TCHAR* Name);
+
+	// Create a buffer; counted like the textures
+	FRDGBufferRef CreateBuffer(const FRDGBufferDesc& Desc, const TCHAR* Name);
+
+	// Mark the end of a resource's lifetime once its last reader has been added
+	// to the graph.  Resources not created by this tracker (e.g. SceneColor
+	// fallbacks) are ignored.
+	void Release(FRDGTextureRef Texture);
+	void Release(FRDGBufferRef Buffer);
+
+	// Memory the view holds outside RDG for this frame (readback staging)
+	void AddExternalBytes(uint64 Bytes);
+
+	// Resolve the pixel format for a usage, honouring the precision CVar
+	static EPixelFormat GetFormat(EToneMapIntermediate Usage, bool bUnderBudgetPressure = false);
+
+	// Format Create() picks for Usage at this point of the frame
+	EPixelFormat GetFormatForUsage(EToneMapIntermediate Usage) const { return GetFormat(Usage, bOverBudget); }
+
+	// Estimated GPU footprint of a 2D texture
+	static uint64 GetTextureBytes(FIntPoint Extent, EPixelFormat Format);
+
+	uint64 GetPeakBytes() const { return PeakBytes; }
+	uint64 GetLiveBytes() const { return LiveBytes; }
+	int32  GetNumCreated() const { return NumCreated; }
+
+	bool IsOverBudget() const { return bOverBudget; }
+
+	// Publish peak memory / resource counts to the stats system.  The peak stat
+	// is the largest of the frame's views.
+	void ReportStats() const;
+
+	// r.ToneMapFX.TransientBudgetMB in bytes, 0 when unlimited (render thread)
+	static uint64 GetBudgetBytes_RenderThread();
+
+	// Advance a view's budget feedback by the peak of the frame just built.
+	// Pure: a budget of 0 resets the state.
+	static FToneMapTransientBudgetState StepBudget(
+		const FToneMapTransientBudgetState& State,
+		uint64 PeakBytes,
+		uint64 BudgetBytes);
+
+	// Lower the bloom and lens resolution by the state's level
+	static void ApplyBudget(const FToneMapTransientBudgetState& State, FToneMapResolvedQuality& Quality);
+
+private:
+	void AddLiveBytes(uint64 Bytes, const TCHAR* Name);
+
+	FRDGBuilder& GraphBuilder;
+
+	// Live resources created by this tracker → their byte size
+	TMap<FRDGTextureRef, uint64> LiveTextures;
+	TMap<FRDGBufferRef, uint64>  LiveBuffers;
+
+	uint64 LiveBytes   = 0;
+	uint64 PeakBytes   = 0;
+	uint64 BudgetBytes = 0;
+	int32  NumCreated  = 0;
+	bool   bOverBudget = false;
+};
@@ -0,0 +1,144 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RenderGraphEvent.h"
+#include "ScreenPass.h"
+#include "ToneMapGradingParameters.h"
+
+// =============================================================================
+// Per-view pass setup cache
+//
+// Most of what PostProcessPass_RenderThread derives before adding a pass —
+// downsampled extents, the Kawase mip chain, FScreenTransforms between the
+// scene-colour viewport, the working-size scratch textures and the output
+// viewport — depends only on viewport sizes and a few quality settings.
+// FToneMapViewSetup holds all of it for one view.  It is rebuilt when the
+// hash of its inputs (FToneMapViewSetupKey) changes, i.e. on resize, on a
+// quality / governor change, or when the view starts writing elsewhere.
+// Parameter structs are still filled per frame, but from these values.
+// The grading uniform buffer of the main pass lives here as well and is
+// kept across rebuilds; it follows the settings, not the viewport.
+//
+// `stat ToneMapFX` shows the lookup cost; the ToneMapFX.ViewSetup automation
+// tests check the derived setup and time it cached and uncached.
+// =============================================================================
+
+struct TONEMAPFX_API FToneMapViewSetupKey
+{
+	FIntPoint SceneColorExtent = FIntPoint::ZeroValue;
+	FIntRect  SceneColorRect;
+	int32     BloomDivisor = 1;
+	int32     KawaseMipCount = 0;
+	float     LensResolutionScale = 1.0f;
+
+	uint32 GetHash() const;
+};
+
+// One level of the Kawase pyramid
+struct FToneMapKawaseMip
+{
+	FIntPoint Extent = FIntPoint::ZeroValue;
+	FIntRect  Rect;
+	FVector4f SizeAndInvSize = FVector4f::Zero();
+
+	// Downsample: this level's SvPosition → the previous level's (or scene colour's) UV
+	FScreenTransform SvPositionToSourceUV;
+};
+
+struct TONEMAPFX_API FToneMapViewSetup
+{
+	FToneMapViewSetupKey Key;
+	uint32 Hash = 0;
+	uint64 LastUsedFrame = 0;
+
+	// --- ClassicBloom — scene-colour viewport at 1/Divisor ---
+	FIntPoint BloomExtent = FIntPoint::ZeroValue;
+	FIntRect  BloomRect;
+	FVector4f BloomInputSizeAndInvSize = FVector4f::Zero();    // scene-colour viewport
+	FVector4f BloomOutputSizeAndInvSize = FVector4f::Zero();   // BloomRect
+	FVector4f BloomBufferSizeAndInvSize = FVector4f::Zero();   // BloomExtent
+	FScreenTransform BloomBrightPassInputUV;
+	FScreenTransform BloomCompositeSceneColorUV;
+	FScreenTransform BloomCompositeBloomUV;
+	TArray<FToneMapKawaseMip, TInlineAllocator<8>> KawaseMips;
+
+	// --- Working size — full-viewport scratch at the origin (Durand, Fattal, lens, blurs) ---
+	FIntPoint WorkSize = FIntPoint::ZeroValue;
+	FIntRect  WorkRect;
+	FVector4f WorkSizeAndInvSize = FVector4f::Zero();
+	FScreenTransform WorkSceneColorUV;
+
+	// --- Lens effects at r.ToneMapFX.Quality's lens resolution ---
+	FIntPoint LensSize = FIntPoint::ZeroValue;
+	FIntRect  LensRect;
+	FVector4f LensSizeAndInvSize = FVector4f::Zero();
+	FScreenTransform LensBufferSceneColorUV;
+	FScreenTransform LensBrightPassUV;
+	FScreenTransform LensCompositeLensUV;
+
+	// --- Main pass — depends on the output target as well, cached separately ---
+	uint32 OutputHash = 0;
+	FVector4f OutputViewportRect = FVector4f::Zero();
+	FScreenTransform OutputSceneColorUV;
+	FScreenTransform OutputWorkUV;     // Clarity / fine / coarse blurs and the pre-tone-mapped result
+
+	// --- Grading constants of the main pass — recreated when their hash changes ---
+	FToneMapGradingBuffer Grading;
+
+	// Recompute the sizes and transforms above from Key (render thread)
+	void Build(const FToneMapViewSetupKey& InKey);
+
+	// Refresh the main-pass transforms when the output viewport changed.  The
+	// lens composite replaces scene colour with a working-size texture, so the
+	// extent the main pass reads is passed in as well.
+	void UpdateOutput(FIntPoint SceneColorExtent, FIntPoint OutputExtent, const FIntRect& OutputRect);
+};
+
+// Render-thread cache of FToneMapViewSetup, one entry per view key
+class TONEMAPFX_API FToneMapViewSetupCache
+{
+public:
+	// Setup for this view, rebuilt only when Key hashes differently from last frame
+	FToneMapViewSetup& Get_RenderThread(uint32 ViewKey, const FToneMapViewSetupKey& Key);
+
+	void Reset() { Entries.Reset(); }
+
+private:
+	TMap<uint32, FToneMapViewSetup> Entries;
+};
+
+// =============================================================================
+// Static pass names
+//
+// RDG keeps the TCHAR pointer it is given as a texture name, so indexed
+// names (one per glare streak, Kawase level, ...) come from a table built
+// once instead of a per-frame FString::Printf.  Event names are formatted
+// only when RDG events are emitted; otherwise the static prefix is used.
+// =============================================================================
+
+enum class EToneMapIndexedName : uint8
+{
+	GlareStreak,        // ClassicBloom.Streak<N>
+	GlareAccum,         // ClassicBloom.GlareAccum<N>
+	KawaseMip,          // ClassicBloom.KawaseMip<N>
+	KawaseUpsample,     // ClassicBloom.KawaseUpsample<N>
+
+	Num
+};
+
+struct TONEMAPFX_API FToneMapPassNames
+{
+	// Streaks are clamped to 16, the Kawase chain to 8 levels
+	static constexpr int32 MaxIndex = 16;
+
+	static const TCHAR* GetTextureName(EToneMapIndexedName Name, int32 Index);
+};
+
+#if RDG_EVENTS != RDG_EVENTS_NONE
+#define TONEMAP_INDEXED_EVENT_NAME(Format, StaticName, Index) \
+	(GetEmitRDGEvents() ? RDG_EVENT_NAME(Format, Index) : RDG_EVENT_NAME(StaticName))
+#else
+#define TONEMAP_INDEXED_EVENT_NAME(Format, StaticName, Index) RDG_EVENT_NAME(StaticName)
+#endif
@@ -6,6 +6,7 @@
 #include "GlobalShader.h"
 #include "ShaderParameterStruct.h"
 #include "ScreenPass.h"
+#include "ToneMapHalfPrecision.h"
 
 // =============================================================================
 // Vignette — Screen-space darken / lighten from edges
@@ -20,6 +21,8 @@ public:
 	DECLARE_GLOBAL_SHADER(FToneMapVignettePS);
 	SHADER_USE_PARAMETER_STRUCT(FToneMapVignettePS, FGlobalShader);
 
+	using FPermutationDomain = TShaderPermutationDomain<FToneMapHalfPrecisionDim>;
+
 	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
 		SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
 		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, SceneColorTexture)
@@ -43,6 +46,15 @@ public:
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
-		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+		const FPermutationDomain PermutationVector(Parameters.PermutationId);
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FToneMapHalfPrecision::ShouldCompilePermutation(Parameters.Platform, PermutationVector.Get<FToneMapHalfPrecisionDim>());
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		const FPermutationDomain PermutationVector(Parameters.PermutationId);
+		FToneMapHalfPrecision::ModifyCompilationEnvironment(PermutationVector.Get<FToneMapHalfPrecisionDim>(), OutEnvironment);
 	}
 };
@@ -0,0 +1,59 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UToneMapComponent;
+
+// =============================================================================
+// Volume spatial index — uniform 2D hash grid over the bounded components
+//
+// Each bounded component is inserted into every XY cell its box (expanded by
+// BlendRadius) overlaps; a view then only tests the components of one cell.
+// Unbound components and boxes spanning too many cells are kept in small
+// side lists that every query includes.  Entries are indices into the
+// subsystem's component array, which is why the index is rebuilt whenever a
+// component registers, unregisters, moves or changes its volume shape.
+// =============================================================================
+
+class FToneMapVolumeIndex
+{
+public:
+	void Rebuild(const TArray<TWeakObjectPtr<UToneMapComponent>>& Components);
+
+	// Component indices that may affect Location, ascending (= registration order)
+	void Query(const FVector& Location, TArray<int32, TInlineAllocator<16>>& OutIndices) const;
+
+	// Effective blend weight of a component at Location (0 = no influence)
+	static float ComputeWeight(const UToneMapComponent& Component, const FVector& Location);
+
+private:
+	static FIntPoint GetCell(const FVector& Location);
+
+	// World units per grid cell (XY only — ToneMapFX volumes rarely stack vertically)
+	static constexpr double CellSize = 4096.0;
+
+	// Boxes larger than this many cells go to the always-tested list
+	static constexpr int32 MaxCellsPerVolume = 256;
+
+	TMap<FIntPoint, TArray<int32>> Cells;
+	TArray<int32> AlwaysTested;
+};
+
+// =============================================================================
+// Settings blending — reflection-driven over the preset property set
+//
+//   float / int32 / FLinearColor   interpolated by weight
+//   bool / enum / texture          taken from the contributor once its weight
+//                                  reaches 0.5 (cannot be interpolated)
+// =============================================================================
+
+struct FToneMapSettingsBlend
+{
+	static void Copy(UToneMapComponent& Dest, const UToneMapComponent& Src);
+	static void Lerp(UToneMapComponent& Dest, const UToneMapComponent& Src, float Weight);
+
+	// CRC of the preset property values — equal hashes render identically
+	static uint32 GetHash(const UToneMapComponent& Settings);
+};
@@ -14,6 +14,7 @@ public class ToneMapFX : ModuleRules
 				"Core",
 				"CoreUObject",
 				"Engine",
+				"DeveloperSettings",
 				"RenderCore",
 				"Renderer",
 				"RHI",
@@ -26,10 +27,17 @@ public class ToneMapFX : ModuleRules
 			{
 				"Slate",
 				"SlateCore",
-				"DesktopPlatform"
+				"DesktopPlatform",
+				"ImageCore"
 			}
 		);
 
+		// Shader formats for the offline shader report (-run=ToneMapFXShaderReport)
+		if (Target.bBuildEditor)
+		{
+			PrivateDependencyModuleNames.Add("TargetPlatform");
+		}
+
 		// Access to private/internal Renderer headers (FViewInfo, SceneRendering, etc.)
 		string RendererBase = System.IO.Path.Combine(EngineDirectory, "Source/Runtime/Renderer");
 		string RendererPrivate = System.IO.Path.Combine(RendererBase, "Private");
@@ -0,0 +1,314 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapBudgetGovernor.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// FToneMapBudgetGovernor::Step driven by synthetic timing traces.  A stage at
+// degrade level L costs its base time * 0.75^L (FToneMapBudgetGovernor::Apply
+// removes about a quarter of the work per level), and the measured frame
+// reaches Step ReadbackLatency frames late, as the GPU timer's do.
+
+static constexpr EAutomationTestFlags GToneMapGovernorTestFlags =
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+namespace ToneMapGovernorTests
+{
+	static constexpr int32 ReadbackLatency = 2;
+
+	static const EToneMapGovernedStage GStages[] =
+	{
+		EToneMapGovernedStage::Bloom,
+		EToneMapGovernedStage::Fattal,
+		EToneMapGovernedStage::LensEffects,
+	};
+
+	struct FLoad
+	{
+		float BloomMs = 0.0f;
+		float FattalMs = 0.0f;
+		float LensMs = 0.0f;
+		float UngovernedMs = 0.0f;      // main pass, sharpen, … — never degraded
+
+		// Bloom and lens chains on async compute: their end stamps wait for the
+		// chain's output on the graphics queue, so they read the latency left
+		// after the head start the chain got on the async queue
+		bool bAsyncChains = false;
+		float AsyncHeadStartMs = 0.0f;
+
+		bool IsAsync(EToneMapGovernedStage Stage) const
+		{
+			return bAsyncChains && (Stage == EToneMapGovernedStage::Bloom || Stage == EToneMapGovernedStage::LensEffects);
+		}
+
+		float GetBaseMs(EToneMapGovernedStage Stage) const
+		{
+			switch (Stage)
+			{
+			case EToneMapGovernedStage::Bloom:       return BloomMs;
+			case EToneMapGovernedStage::Fattal:      return FattalMs;
+			case EToneMapGovernedStage::LensEffects: return LensMs;
+			default:                                 return 0.0f;
+			}
+		}
+	};
+
+	static FToneMapStageTimings Measure(const FLoad& Load, const FToneMapGovernorState& State, float NoiseMs)
+	{
+		FToneMapStageTimings Timings;
+		float Total = Load.UngovernedMs + NoiseMs;
+		for (const EToneMapGovernedStage Stage : GStages)
+		{
+			float Ms = Load.GetBaseMs(Stage) * FMath::Pow(0.75f, (float)State.Levels[(int32)Stage]);
+			if (Load.IsAsync(Stage))
+			{
+				Ms = FMath::Max(Ms - Load.AsyncHeadStartMs, 0.0f);
+			}
+			Timings.Ms[(int32)Stage] = Ms;
+			Total += Ms;
+		}
+		Timings.Ms[(int32)EToneMapGovernedStage::Total] = Total;
+		return Timings;
+	}
+
+	struct FTrace
+	{
+		FToneMapGovernorState State;
+		TArray<FToneMapStageTimings> InFlight;  // rendered, not yet read back
+		int32 NumDegrades = 0;
+		int32 NumRecoveries = 0;
+		int32 LastChangeFrame = INDEX_NONE;
+		int32 FirstRecoveryFrame = INDEX_NONE;
+		float LastTotalMs = 0.0f;
+
+		// Render one frame at the current levels and feed Step the frame that lands now
+		void Advance(int32 Frame, const FLoad& Load, float NoiseMs, const FToneMapGovernorConfig& Config)
+		{
+			InFlight.Add(Measure(Load, State, NoiseMs));
+			if (InFlight.Num() <= ReadbackLatency)
+			{
+				return;
+			}
+			const FToneMapStageTimings Landed = InFlight[0];
+			InFlight.RemoveAt(0);
+
+			const int32 Before = State.GetTotalLevel();
+			State = FToneMapBudgetGovernor::Step(State, Landed, Config);
+			const int32 After = State.GetTotalLevel();
+
+			NumDegrades += After > Before ? 1 : 0;
+			NumRecoveries += After < Before ? 1 : 0;
+			if (After != Before)
+			{
+				LastChangeFrame = Frame;
+			}
+			if (After < Before && FirstRecoveryFrame == INDEX_NONE)
+			{
+				FirstRecoveryFrame = Frame;
+			}
+			LastTotalMs = Measure(Load, State, 0.0f).Ms[(int32)EToneMapGovernedStage::Total];
+		}
+	};
+
+	static FToneMapGovernorConfig MakeConfig(float BudgetMs)
+	{
+		FToneMapGovernorConfig Config;
+		Config.BudgetMs = BudgetMs;
+		return Config;
+	}
+
+	// 6.0 ms of work against a 4.0 ms budget
+	static const FLoad GHeavyLoad = { 2.5f, 2.0f, 1.0f, 0.5f };
+}
+
+// ---------------------------------------------------------------------------
+// Converges under budget and stays there
+// ---------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapGovernorConvergenceTest, "ToneMapFX.Governor.Convergence", GToneMapGovernorTestFlags)
+
+bool FToneMapGovernorConvergenceTest::RunTest(const FString& Parameters)
+{
+	using namespace ToneMapGovernorTests;
+
+	const FToneMapGovernorConfig Config = MakeConfig(4.0f);
+	FRandomStream Noise(1234);
+
+	FTrace Trace;
+	constexpr int32 NumFrames = 600;
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		Trace.Advance(Frame, GHeavyLoad, Noise.FRandRange(-0.05f, 0.05f), Config);
+	}
+
+	TestTrue(FString::Printf(TEXT("Settled total %.2f ms within the %.2f ms budget"), Trace.LastTotalMs, Config.BudgetMs),
+		Trace.LastTotalMs <= Config.BudgetMs);
+	TestEqual(TEXT("Only degrades on the way down"), Trace.NumRecoveries, 0);
+	TestTrue(FString::Printf(TEXT("Settled by frame %d"), Trace.LastChangeFrame), Trace.LastChangeFrame < NumFrames / 2);
+
+	// The readback latency is shorter than DegradeFrames, so frames rendered
+	// before a step never push a second one: at most one step per stage level
+	// that the 4.0 ms budget needs (5 from the model), never every level
+	TestTrue(FString::Printf(TEXT("%d steps down"), Trace.NumDegrades), Trace.NumDegrades <= 5);
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// Hysteresis — no oscillation around either threshold
+// ---------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapGovernorHysteresisTest, "ToneMapFX.Governor.Hysteresis", GToneMapGovernorTestFlags)
+
+bool FToneMapGovernorHysteresisTest::RunTest(const FString& Parameters)
+{
+	using namespace ToneMapGovernorTests;
+
+	const FToneMapGovernorConfig Config = MakeConfig(5.0f);
+	constexpr int32 NumFrames = 1000;
+
+	// 5.1 ms of work with +-0.3 ms noise: one step down lands it at 4.35 ms,
+	// inside the [4.0, 5.0] band, where the noise must not move it again
+	{
+		const FLoad Load = { 3.0f, 1.0f, 0.5f, 0.6f };
+		FRandomStream Noise(42);
+		FTrace Trace;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			Trace.Advance(Frame, Load, Noise.FRandRange(-0.3f, 0.3f), Config);
+		}
+		TestEqual(TEXT("Noisy load near the budget: steps down"), Trace.NumDegrades, 1);
+		TestEqual(TEXT("Noisy load near the budget: steps back up"), Trace.NumRecoveries, 0);
+	}
+
+	// Alternating just over and just under the budget never reaches
+	// DegradeFrames consecutive over-budget samples
+	{
+		const FLoad Load = { 3.0f, 1.0f, 0.5f, 0.5f };
+		FTrace Trace;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			Trace.Advance(Frame, Load, (Frame & 1) ? 0.15f : -0.15f, Config);
+		}
+		TestEqual(TEXT("Straddling the budget: level changes"), Trace.NumDegrades + Trace.NumRecoveries, 0);
+	}
+
+	// Same at the recovery threshold (4.0 ms) with two levels already taken
+	{
+		const FLoad Load = { 3.0f / (0.75f * 0.75f), 1.0f, 0.0f, 0.5f };  // 4.0 ms at Bloom level 2
+		FTrace Trace;
+		Trace.State.Levels[(int32)EToneMapGovernedStage::Bloom] = 2;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			Trace.Advance(Frame, Load, (Frame & 1) ? 0.1f : -0.1f, Config);
+		}
+		TestEqual(TEXT("Straddling the recovery threshold: level changes"), Trace.NumDegrades + Trace.NumRecoveries, 0);
+	}
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// Recovery once the load drops
+// ---------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapGovernorRecoveryTest, "ToneMapFX.Governor.Recovery", GToneMapGovernorTestFlags)
+
+bool FToneMapGovernorRecoveryTest::RunTest(const FString& Parameters)
+{
+	using namespace ToneMapGovernorTests;
+
+	const FToneMapGovernorConfig Config = MakeConfig(4.0f);
+
+	FTrace Trace;
+	for (int32 Frame = 0; Frame < 300; ++Frame)
+	{
+		Trace.Advance(Frame, GHeavyLoad, 0.0f, Config);
+	}
+	const int32 DegradedLevels = Trace.State.GetTotalLevel();
+	if (!TestTrue(TEXT("Heavy load degraded some stage"), DegradedLevels > 0))
+	{
+		return false;
+	}
+
+	// Half the work: 3.0 ms at full quality, under BudgetMs * RecoverFraction
+	const FLoad LightLoad = { 1.25f, 1.0f, 0.5f, 0.25f };
+	FTrace Light;
+	Light.State = Trace.State;
+	constexpr int32 NumFrames = 1000;
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		Light.Advance(Frame, LightLoad, 0.0f, Config);
+	}
+
+	TestEqual(TEXT("Every level restored"), Light.State.GetTotalLevel(), 0);
+	TestEqual(TEXT("No step down while recovering"), Light.NumDegrades, 0);
+	TestEqual(TEXT("One step up per degraded level"), Light.NumRecoveries, DegradedLevels);
+	TestTrue(FString::Printf(TEXT("First step up after %d frames, not before RecoverFrames"), Light.FirstRecoveryFrame),
+		Light.FirstRecoveryFrame >= Config.RecoverFrames);
+	TestTrue(FString::Printf(TEXT("Restored total %.2f ms within the budget"), Light.LastTotalMs), Light.LastTotalMs <= Config.BudgetMs);
+
+	// Governor off: Step hands back an untouched state
+	FToneMapGovernorConfig Off = Config;
+	Off.BudgetMs = 0.0f;
+	const FToneMapGovernorState Reset = FToneMapBudgetGovernor::Step(Trace.State, Measure(GHeavyLoad, Trace.State, 0.0f), Off);
+	TestEqual(TEXT("BudgetMs 0 clears every level"), Reset.GetTotalLevel(), 0);
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// Async compute — chains measured as latency on the graphics queue
+// ---------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapGovernorAsyncComputeTest, "ToneMapFX.Governor.AsyncCompute", GToneMapGovernorTestFlags)
+
+bool FToneMapGovernorAsyncComputeTest::RunTest(const FString& Parameters)
+{
+	using namespace ToneMapGovernorTests;
+
+	const FToneMapGovernorConfig Config = MakeConfig(4.0f);
+	constexpr int32 NumFrames = 600;
+
+	// Bloom dominates and runs async with a 0.5 ms head start: the governor
+	// has to see it through its latency and degrade it, not Fattal
+	{
+		FLoad Load = { 4.0f, 1.0f, 1.0f, 0.5f };
+		Load.bAsyncChains = true;
+		Load.AsyncHeadStartMs = 0.5f;
+
+		FRandomStream Noise(7);
+		FTrace Trace;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			Trace.Advance(Frame, Load, Noise.FRandRange(-0.05f, 0.05f), Config);
+		}
+
+		const int32 BloomLevel = Trace.State.Levels[(int32)EToneMapGovernedStage::Bloom];
+		const int32 FattalLevel = Trace.State.Levels[(int32)EToneMapGovernedStage::Fattal];
+		TestTrue(FString::Printf(TEXT("Async: settled total %.2f ms within the %.2f ms budget"), Trace.LastTotalMs, Config.BudgetMs),
+			Trace.LastTotalMs <= Config.BudgetMs);
+		TestTrue(FString::Printf(TEXT("Async: bloom level %d above Fattal level %d"), BloomLevel, FattalLevel), BloomLevel > FattalLevel);
+		TestEqual(TEXT("Async: steps back up"), Trace.NumRecoveries, 0);
+	}
+
+	// A chain that finishes inside its head start reads 0 ms: the graphics
+	// queue never waited for it, and degrading it would buy nothing
+	{
+		FLoad Load = { 3.0f, 1.5f, 0.25f, 1.0f };
+		Load.bAsyncChains = true;
+		Load.AsyncHeadStartMs = 0.5f;
+
+		FTrace Trace;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			Trace.Advance(Frame, Load, 0.0f, Config);
+		}
+
+		TestEqual(TEXT("Hidden lens chain: lens level"), Trace.State.Levels[(int32)EToneMapGovernedStage::LensEffects], 0);
+		TestTrue(FString::Printf(TEXT("Hidden lens chain: settled total %.2f ms within the budget"), Trace.LastTotalMs),
+			Trace.LastTotalMs <= Config.BudgetMs);
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
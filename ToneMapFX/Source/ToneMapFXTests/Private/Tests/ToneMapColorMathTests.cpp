@@ -0,0 +1,120 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapColorMathGolden.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// The C++ build of ToneMapColorMath.ush: every operator on the 6x6x6 lattice
+// against Resources/ColorMathGolden.csv, plus a few closed-form values that
+// hold independently of the table.
+
+static constexpr EAutomationTestFlags GToneMapColorMathTestFlags =
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+// ---------------------------------------------------------------------------
+// Every operator against Resources/ColorMathGolden.csv
+// ---------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapColorMathGoldenTest, "ToneMapFX.ColorMath.Golden", GToneMapColorMathTestFlags)
+
+bool FToneMapColorMathGoldenTest::RunTest(const FString& Parameters)
+{
+	using namespace ToneMapColorMath;
+
+	// Same bound the table was cut at (%.7g rows, relative above 1)
+	constexpr float Tolerance = 1e-4f;
+	constexpr int32 MaxReportedRows = 10;
+
+	TArray<float3> Expected;
+	if (!TestTrue(TEXT("Golden table loads"), FToneMapColorMathGolden::Load(FToneMapColorMathGolden::GetPath(), Expected)))
+	{
+		return false;
+	}
+
+	int32 NumReported = 0;
+	for (int32 Operator = 0; Operator < FToneMapColorMath::GetNumOperators(); ++Operator)
+	{
+		const TCHAR* Name = FToneMapColorMath::GetOperatorName(Operator);
+
+		float Worst = 0.0f;
+		for (int32 Index = 0; Index < FToneMapColorMath::LatticeSize; ++Index)
+		{
+			const float3 Input = FToneMapColorMath::GetLatticeColor(Index);
+			const float3 Actual = FToneMapColorMath::EvaluateOperator(Operator, Input);
+			const float3& Golden = Expected[Operator * FToneMapColorMath::LatticeSize + Index];
+
+			const float Error = FToneMapColorMathGolden::GetError(Actual, Golden);
+			Worst = FMath::Max(Worst, Error);
+			if (Error > Tolerance && NumReported++ < MaxReportedRows)
+			{
+				AddError(FString::Printf(TEXT("%s (%g, %g, %g): expected (%g, %g, %g), got (%g, %g, %g)"),
+					Name, Input.x, Input.y, Input.z, Golden.x, Golden.y, Golden.z, Actual.x, Actual.y, Actual.z));
+			}
+		}
+
+		AddInfo(FString::Printf(TEXT("%s: max error %.2e"), Name, Worst));
+		TestTrue(FString::Printf(TEXT("%s max error %.2e within %.0e"), Name, Worst, Tolerance), Worst <= Tolerance);
+	}
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// Closed-form values — catch a table regenerated from broken operators
+// ---------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapColorMathAnchorsTest, "ToneMapFX.ColorMath.Anchors", GToneMapColorMathTestFlags)
+
+bool FToneMapColorMathAnchorsTest::RunTest(const FString& Parameters)
+{
+	using namespace ToneMapColorMath;
+
+	auto FindOperator = [](const TCHAR* Name)
+	{
+		for (int32 Operator = 0; Operator < FToneMapColorMath::GetNumOperators(); ++Operator)
+		{
+			if (FCString::Strcmp(FToneMapColorMath::GetOperatorName(Operator), Name) == 0)
+			{
+				return Operator;
+			}
+		}
+		return (int32)INDEX_NONE;
+	};
+
+	const int32 Exposure = FindOperator(TEXT("Exposure"));
+	const int32 HSLRoundTrip = FindOperator(TEXT("HSLRoundTrip"));
+	const int32 LinearToSRGB = FindOperator(TEXT("LinearToSRGB"));
+	if (!TestTrue(TEXT("Anchor operators exist"), Exposure != INDEX_NONE && HSLRoundTrip != INDEX_NONE && LinearToSRGB != INDEX_NONE))
+	{
+		return false;
+	}
+
+	// Lattice: R fastest, levels 0 .. 4
+	const float3 First = FToneMapColorMath::GetLatticeColor(0);
+	const float3 Last = FToneMapColorMath::GetLatticeColor(FToneMapColorMath::LatticeSize - 1);
+	const float3 Grey = FToneMapColorMath::GetLatticeColor(2);
+	TestEqual(TEXT("Lattice starts at black"), FMath::Max3(First.x, First.y, First.z), 0.0f);
+	TestEqual(TEXT("Lattice ends at HDR white"), FMath::Min3(Last.x, Last.y, Last.z), 4.0f);
+	TestTrue(TEXT("Lattice index 2 is (0.18, 0, 0)"), Grey.x == 0.18f && Grey.y == 0.0f && Grey.z == 0.0f);
+
+	// +1.5 EV
+	TestEqual(TEXT("Exposure +1.5 EV of 0.18"), FToneMapColorMath::EvaluateOperator(Exposure, Grey).x, 0.18f * FMath::Exp2(1.5f), 1e-6f);
+
+	// IEC 61966-2-1 encode
+	TestEqual(TEXT("sRGB of 0.18"), FToneMapColorMath::EvaluateOperator(LinearToSRGB, float3(0.18f)).x, 0.4613561f, 1e-5f);
+	TestEqual(TEXT("sRGB of 1"), FToneMapColorMath::EvaluateOperator(LinearToSRGB, float3(1.0f)).x, 1.0f, 1e-5f);
+	TestEqual(TEXT("sRGB of 0"), FToneMapColorMath::EvaluateOperator(LinearToSRGB, float3(0.0f)).x, 0.0f);
+
+	// RGB -> HSL -> RGB is the identity on [0, 1]
+	float WorstRoundTrip = 0.0f;
+	for (int32 Index = 0; Index < FToneMapColorMath::LatticeSize; ++Index)
+	{
+		const float3 Input = saturate(FToneMapColorMath::GetLatticeColor(Index));
+		const float3 Diff = abs(FToneMapColorMath::EvaluateOperator(HSLRoundTrip, Input) - Input);
+		WorstRoundTrip = FMath::Max(WorstRoundTrip, FMath::Max3(Diff.x, Diff.y, Diff.z));
+	}
+	TestTrue(FString::Printf(TEXT("HSL round trip error %.2e within 1e-5"), WorstRoundTrip), WorstRoundTrip <= 1e-5f);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,304 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapFramePlan.h"
+#include "ToneMapComponent.h"
+#include "ToneMapFXSettings.h"
+#include "ToneMapGaussianBlur.h"
+#include "Engine/Texture2D.h"
+#include "UObject/Package.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// FToneMapFramePlanner on synthetic settings: every plan validates, stages
+// cull like at runtime, known pass counts per operator, and each Gaussian is
+// planned with the method the stages pick (FToneMapPlanInputs::GetBlurMethod).
+
+static constexpr EAutomationTestFlags GToneMapFramePlanTestFlags =
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+namespace ToneMapFramePlanTests
+{
+	// 1080p at the highest quality tier, defaults otherwise
+	static FToneMapPlanInputs MakeInputs()
+	{
+		FToneMapPlanInputs Inputs;
+		Inputs.ViewportSize = FIntPoint(1920, 1080);
+		Inputs.Quality = FToneMapScalability::Resolve(*GetDefault<UToneMapComponent>(), FToneMapScalability::GetTier(FToneMapScalability::NumTiers - 1));
+		return Inputs;
+	}
+
+	// Every optional stage off: the process pass alone
+	static UToneMapComponent* MakeMinimalSettings()
+	{
+		UToneMapComponent* Settings = NewObject<UToneMapComponent>(GetTransientPackage());
+		Settings->bEnableBloom = false;
+		Settings->bEnableCiliaryCorona = false;
+		Settings->bEnableLenticularHalo = false;
+		Settings->bEnableSharpening = false;
+		Settings->bEnableVignette = false;
+		Settings->bEnableLUT = false;
+		Settings->Clarity = Settings->DynamicContrast = Settings->CorrectContrast = Settings->CorrectColorCast = 0.0f;
+		return Settings;
+	}
+
+	static FToneMapFramePlan BuildValid(FAutomationTestBase& Test, const TCHAR* Case, const UToneMapComponent& Settings, const FToneMapPlanInputs& Inputs)
+	{
+		FToneMapFramePlan Plan = FToneMapFramePlanner::Build(Settings, Inputs);
+		FString Error;
+		const bool bValid = Plan.Validate(&Error);
+		Test.TestTrue(FString::Printf(TEXT("%s: plan is valid (%s)"), Case, bValid ? TEXT("ok") : *Error), bValid);
+		return Plan;
+	}
+
+	static int32 NumPasses(const FToneMapFramePlan& Plan, EToneMapPlanStage Stage)
+	{
+		return Plan.Stages[(int32)Stage].NumPasses;
+	}
+
+	static int32 NumTextures(const FToneMapFramePlan& Plan, const TCHAR* Name)
+	{
+		int32 Count = 0;
+		for (const FToneMapPlanTexture& Texture : Plan.Textures)
+		{
+			Count += FCString::Strcmp(Texture.Name, Name) == 0 ? 1 : 0;
+		}
+		return Count;
+	}
+
+	// Passes of one H + V Gaussian pair with the method the stage would pick
+	static int32 NumBlurPairPasses(const FToneMapPlanInputs& Inputs, float Sigma, bool bComputeOutput)
+	{
+		return 2 * FToneMapGaussianBlur::GetNumPasses(Inputs.GetBlurMethod(Sigma, bComputeOutput));
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Stage selection and pass counts per operator
+// ---------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapFramePlanStagesTest, "ToneMapFX.FramePlan.Stages", GToneMapFramePlanTestFlags)
+
+bool FToneMapFramePlanStagesTest::RunTest(const FString& Parameters)
+{
+	using namespace ToneMapFramePlanTests;
+
+	const FToneMapPlanInputs Inputs = MakeInputs();
+	UToneMapComponent* Settings = MakeMinimalSettings();
+
+	// Nothing enabled: one pass straight into the output
+	const FToneMapFramePlan Minimal = BuildValid(*this, TEXT("Minimal"), *Settings, Inputs);
+	TestEqual(TEXT("Minimal: the process pass only"), Minimal.Passes.Num(), 1);
+	TestTrue(TEXT("Minimal: no transient memory"), Minimal.PeakTransientBytes == 0);
+
+	// Fattal: log, gradient, divergence, the Jacobi iterations, reconstruct
+	Settings->Mode = EToneMapMode::ReplaceTonemap;
+	Settings->FilmCurve = EToneMapFilmCurve::Fattal;
+	FToneMapPlanInputs Replace = Inputs;
+	Replace.bReplaceTonemap = true;
+	const FToneMapFramePlan Fattal = BuildValid(*this, TEXT("Fattal"), *Settings, Replace);
+	TestEqual(TEXT("Fattal pass count"), NumPasses(Fattal, EToneMapPlanStage::Fattal), 4 + Replace.Quality.FattalIterations);
+
+	// A stripped operator is culled like at runtime
+	FToneMapPlanInputs Stripped = Replace;
+	Stripped.CompiledFeatures &= ~(1u << (uint32)EToneMapShaderFeature::Fattal);
+	const FToneMapFramePlan FattalStripped = BuildValid(*this, TEXT("Fattal stripped"), *Settings, Stripped);
+	TestFalse(TEXT("Stripped Fattal is culled"), FattalStripped.Stages[(int32)EToneMapPlanStage::Fattal].bActive);
+
+	// Durand: log, bilateral H and V, reconstruct
+	Settings->FilmCurve = EToneMapFilmCurve::Durand;
+	const FToneMapFramePlan Durand = BuildValid(*this, TEXT("Durand"), *Settings, Replace);
+	TestEqual(TEXT("Durand pass count"), NumPasses(Durand, EToneMapPlanStage::Durand), 4);
+
+	// Krawczyk: histogram build + resolve + adaptation; measure only on the first frame
+	Settings->AutoExposureMode = EToneMapAutoExposure::Krawczyk;
+	const FToneMapFramePlan Exposure = BuildValid(*this, TEXT("Exposure"), *Settings, Replace);
+	TestEqual(TEXT("Exposure pass count"), NumPasses(Exposure, EToneMapPlanStage::Exposure), 3);
+	TestTrue(TEXT("Adapted luminance is persistent"), Exposure.PersistentBytes >= 4);
+
+	FToneMapPlanInputs FirstFrame = Replace;
+	FirstFrame.bHistogramMetering = false;
+	FirstFrame.bPreviousAdaptedLuminance = false;
+	const FToneMapFramePlan ExposureFirst = BuildValid(*this, TEXT("Exposure first frame"), *Settings, FirstFrame);
+	TestEqual(TEXT("First frame exposure pass count"), NumPasses(ExposureFirst, EToneMapPlanStage::Exposure), 1);
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// Everything on: every stage active, the chain ping-pongs into the output
+// ---------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapFramePlanFullTest, "ToneMapFX.FramePlan.Full", GToneMapFramePlanTestFlags)
+
+bool FToneMapFramePlanFullTest::RunTest(const FString& Parameters)
+{
+	using namespace ToneMapFramePlanTests;
+
+	UToneMapComponent* Settings = NewObject<UToneMapComponent>(GetTransientPackage());
+	Settings->Mode = EToneMapMode::ReplaceTonemap;
+	Settings->bHDROutput = true;
+	Settings->bEnableBloom = true;
+	Settings->BloomIntensity = 1.0f;
+	Settings->BloomMode = EBloomMode::Kawase;
+	Settings->bEnableCiliaryCorona = true;
+	Settings->bEnableLenticularHalo = true;
+	Settings->Clarity = 0.5f;
+	Settings->DynamicContrast = 0.5f;
+	Settings->CorrectColorCast = 0.5f;
+	Settings->bEnableSharpening = true;
+	Settings->SharpenAmount = 0.5f;
+	Settings->bEnableLUT = true;
+	Settings->LUTTexture = NewObject<UTexture2D>(GetTransientPackage());
+	Settings->LUTIntensity = 1.0f;
+	Settings->bEnableVignette = true;
+	Settings->VignetteIntensity = 0.5f;
+	Settings->ProcessingPath = EToneMapProcessingPath::LUT;
+
+	FToneMapPlanInputs Full = MakeInputs();
+	Full.bReplaceTonemap = true;
+	Full.bHDREncode = true;
+
+	const FToneMapFramePlan Plan = BuildValid(*this, TEXT("Full"), *Settings, Full);
+	for (int32 StageIndex = 0; StageIndex < (int32)EToneMapPlanStage::Num; ++StageIndex)
+	{
+		const EToneMapPlanStage Stage = (EToneMapPlanStage)StageIndex;
+		if (Stage != EToneMapPlanStage::Durand && Stage != EToneMapPlanStage::Fattal)
+		{
+			TestTrue(FString::Printf(TEXT("%s is active with passes"), FToneMapFramePlanner::GetStageName(Stage)),
+				Plan.Stages[StageIndex].bActive && Plan.Stages[StageIndex].NumPasses > 0);
+		}
+	}
+
+	// Bright pass, M downsamples, M-1 upsamples, the final upsample, composite
+	const int32 Mips = Full.Quality.KawaseMipCount;
+	if (Mips > 1)
+	{
+		TestEqual(TEXT("Kawase pass count"), NumPasses(Plan, EToneMapPlanStage::Bloom), 2 * Mips + 2);
+	}
+
+	// Baked LUTs don't count towards the per-frame cost
+	int32 NumCached = 0;
+	for (const FToneMapPlanPass& Pass : Plan.Passes)
+	{
+		NumCached += Pass.bCachedAcrossFrames ? 1 : 0;
+	}
+	TestEqual(TEXT("One cached LUT bake"), NumCached, 1);
+	TestTrue(TEXT("HDR encode is last"), Plan.Passes.Last().Stage == EToneMapPlanStage::HDREncode);
+
+	// Four times the pixels, at least twice the transient memory
+	FToneMapPlanInputs Large = Full;
+	Large.ViewportSize = FIntPoint(3840, 2160);
+	const FToneMapFramePlan LargePlan = BuildValid(*this, TEXT("Full 4K"), *Settings, Large);
+	TestTrue(TEXT("4K at least doubles the peak"), LargePlan.PeakTransientBytes >= 2 * Plan.PeakTransientBytes);
+	TestTrue(TEXT("4K costs more fetches"), LargePlan.GetTotalFetches() > Plan.GetTotalFetches());
+
+	// Reduced precision never costs memory
+	FToneMapPlanInputs FullPrecision = Full;
+	FullPrecision.bReducedPrecision = false;
+	const FToneMapFramePlan FullPrecisionPlan = BuildValid(*this, TEXT("Full precision"), *Settings, FullPrecision);
+	TestTrue(TEXT("Reduced precision does not raise the peak"), FullPrecisionPlan.PeakTransientBytes >= Plan.PeakTransientBytes);
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// Blur methods — r.ToneMapFX.TiledBlur / RecursiveBlur and compute support
+// ---------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapFramePlanBlurMethodsTest, "ToneMapFX.FramePlan.BlurMethods", GToneMapFramePlanTestFlags)
+
+bool FToneMapFramePlanBlurMethodsTest::RunTest(const FString& Parameters)
+{
+	using namespace ToneMapFramePlanTests;
+
+	// Gaussian Clarity, fine (sigma 2) and coarse (sigma 32) luma blurs, and the standard bloom
+	UToneMapComponent* Settings = MakeMinimalSettings();
+	Settings->Clarity = 0.5f;
+	Settings->ClarityMode = EToneMapClarityMode::Gaussian;
+	Settings->DynamicContrast = 0.5f;
+	Settings->bEnableBloom = true;
+	Settings->BloomIntensity = 1.0f;
+	Settings->BloomMode = EBloomMode::Standard;
+
+	FToneMapPlanInputs Inputs = MakeInputs();
+	const float ClaritySigma = Inputs.Quality.ClarityRadius;
+	const int32 BloomBlurs = Inputs.Quality.BloomBlurPasses;
+	const float BloomSigma = Settings->BloomSize * 0.1f;
+
+	struct FCase
+	{
+		const TCHAR* Name;
+		bool bTiled;
+		int32 RecursiveMode;
+		bool bCompute;
+	};
+	const FCase Cases[] =
+	{
+		{ TEXT("Pixel shader"),             false, 0, true  },
+		{ TEXT("Tiled"),                    true,  0, true  },
+		{ TEXT("Recursive when truncated"), true,  1, true  },
+		{ TEXT("Recursive"),                true,  2, true  },
+		{ TEXT("Recursive, no UAV"),        true,  2, false },
+	};
+
+	uint64 PixelShaderFetches = 0;
+	for (const FCase& Case : Cases)
+	{
+		Inputs.bTiledBlur = Case.bTiled;
+		Inputs.RecursiveBlur = Case.RecursiveMode;
+		Inputs.bComputeViewBlur = Case.bCompute;
+		Inputs.bComputeBloom = Case.bCompute;
+
+		const FToneMapFramePlan Plan = BuildValid(*this, Case.Name, *Settings, Inputs);
+
+		// Luma extraction, then Clarity, fine and coarse pairs
+		const int32 ExpectedLocalContrast = 1
+			+ NumBlurPairPasses(Inputs, ClaritySigma, Case.bCompute)
+			+ NumBlurPairPasses(Inputs, 2.0f, Case.bCompute)
+			+ NumBlurPairPasses(Inputs, 32.0f, Case.bCompute);
+		TestEqual(FString::Printf(TEXT("%s: local contrast pass count"), Case.Name),
+			NumPasses(Plan, EToneMapPlanStage::LocalContrast), ExpectedLocalContrast);
+
+		// Bright pass, the blur iterations, composite
+		TestEqual(FString::Printf(TEXT("%s: bloom pass count"), Case.Name),
+			NumPasses(Plan, EToneMapPlanStage::Bloom), 2 + BloomBlurs * NumBlurPairPasses(Inputs, BloomSigma, Case.bCompute));
+
+		// One causal scratch per recursive direction
+		int32 ExpectedScratch = 0;
+		for (const float Sigma : { ClaritySigma, 2.0f, 32.0f })
+		{
+			ExpectedScratch += Inputs.GetBlurMethod(Sigma, Case.bCompute) == EToneMapBlurMethod::Recursive ? 2 : 0;
+		}
+		ExpectedScratch += Inputs.GetBlurMethod(BloomSigma, Case.bCompute) == EToneMapBlurMethod::Recursive ? 2 * BloomBlurs : 0;
+		TestEqual(FString::Printf(TEXT("%s: recursive scratch textures"), Case.Name),
+			NumTextures(Plan, TEXT("ToneMap.RecursiveBlurCausal")), ExpectedScratch);
+
+		if (!Case.bTiled && Case.RecursiveMode == 0)
+		{
+			PixelShaderFetches = Plan.Stages[(int32)EToneMapPlanStage::LocalContrast].Fetches;
+		}
+		else if (Case.RecursiveMode == 0)
+		{
+			TestTrue(FString::Printf(TEXT("%s: fewer fetches than the pixel shader"), Case.Name),
+				Plan.Stages[(int32)EToneMapPlanStage::LocalContrast].Fetches < PixelShaderFetches);
+		}
+	}
+
+	// Known counts: every blur is 2 passes per pair, or 4 when recursive
+	Inputs.bComputeViewBlur = Inputs.bComputeBloom = true;
+	Inputs.bTiledBlur = true;
+	Inputs.RecursiveBlur = 0;
+	TestEqual(TEXT("Tiled: 1 + 3 x 2 local contrast passes"),
+		NumPasses(FToneMapFramePlanner::Build(*Settings, Inputs), EToneMapPlanStage::LocalContrast), 7);
+	Inputs.RecursiveBlur = 2;
+	TestEqual(TEXT("Recursive: 1 + 3 x 4 local contrast passes"),
+		NumPasses(FToneMapFramePlanner::Build(*Settings, Inputs), EToneMapPlanStage::LocalContrast), 13);
+
+	// Sigma 32 needs 96 texels — only the coarse blur is recursive under mode 1
+	Inputs.RecursiveBlur = 1;
+	TestTrue(TEXT("Mode 1 picks the recursive filter for sigma 32"), Inputs.GetBlurMethod(32.0f, true) == EToneMapBlurMethod::Recursive);
+	TestTrue(TEXT("Mode 1 keeps the tiled filter for sigma 2"), Inputs.GetBlurMethod(2.0f, true) == EToneMapBlurMethod::Tiled);
+	TestTrue(TEXT("No compute output falls back to the pixel shader"), Inputs.GetBlurMethod(32.0f, false) == EToneMapBlurMethod::PixelShader);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
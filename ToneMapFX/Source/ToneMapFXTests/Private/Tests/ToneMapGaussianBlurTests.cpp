@@ -0,0 +1,380 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapGaussianBlur.h"
+#include "ToneMapTransientTextures.h"
+#include "GlobalShader.h"
+#include "RenderGraphUtils.h"
+#include "RenderingThread.h"
+#include "RHICommandList.h"
+#include "Math/RandomStream.h"
+#include "Misc/App.h"
+#include "Misc/AutomationTest.h"
+#include <cmath>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static constexpr EAutomationTestFlags GToneMapBlurTestFlags =
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+// GPU timings need a real RHI and are noisy — run them with the perf tests
+static constexpr EAutomationTestFlags GToneMapBlurPerfTestFlags =
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter;
+
+// ---------------------------------------------------------------------------
+// Kernel — what the pixel shader and the tiled compute path evaluate
+// ---------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapBlurKernelTest, "ToneMapFX.Blur.Kernel", GToneMapBlurTestFlags)
+
+bool FToneMapBlurKernelTest::RunTest(const FString& Parameters)
+{
+	// Sigma, half size (ceil(3σ) capped at 48), bilinear fetches of the pixel shader
+	struct FCase { float Sigma; int32 HalfSize; int32 Fetches; };
+	const FCase Cases[] =
+	{
+		{  0.1f,  2,  3 },   // clamped to sigma 0.5
+		{  2.0f,  6,  7 },
+		{  8.0f, 24, 25 },
+		{ 16.0f, 48, 49 },
+		{ 32.0f, 48, 49 },   // truncated: same kernel footprint as sigma 16
+		{ 48.0f, 48, 49 },
+	};
+
+	for (const FCase& Case : Cases)
+	{
+		const FToneMapGaussianKernel Kernel = FToneMapGaussianKernel::Build(Case.Sigma);
+		const FString Name = FString::Printf(TEXT("Sigma %.1f"), Case.Sigma);
+
+		TestEqual(Name + TEXT(" half size"), Kernel.HalfSize, Case.HalfSize);
+		TestEqual(Name + TEXT(" pixel shader fetches"), 1 + 2 * Kernel.NumPairs, Case.Fetches);
+
+		// Normalised over the full 2h+1 taps, and the bilinear pairs carry the same weight
+		float TapTotal = Kernel.Weights[0];
+		for (int32 i = 1; i <= Kernel.HalfSize; ++i)
+		{
+			TapTotal += 2.0f * Kernel.Weights[i];
+		}
+		float PairTotal = Kernel.Weights[0];
+		for (int32 p = 0; p < Kernel.NumPairs; ++p)
+		{
+			PairTotal += 2.0f * Kernel.Pairs[p].Y;
+
+			// Each pair samples between its two taps
+			const float Tap = (float)(2 * p + 1);
+			TestTrue(FString::Printf(TEXT("%s pair %d offset %.3f within [%.0f, %.0f]"), *Name, p, Kernel.Pairs[p].X, Tap, Tap + 1.0f),
+				Kernel.Pairs[p].X >= Tap - KINDA_SMALL_NUMBER && Kernel.Pairs[p].X <= Tap + 1.0f + KINDA_SMALL_NUMBER);
+		}
+		TestEqual(Name + TEXT(" tap weights sum to 1"), TapTotal, 1.0f, 1.0e-5f);
+		TestEqual(Name + TEXT(" pair weights sum to 1"), PairTotal, 1.0f, 1.0e-5f);
+	}
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// Recursive filter against a true Gaussian
+//
+// FilterRecursive runs the same recursion and edge seeding as
+// ToneMapGaussianRecursive.usf.  Young–van Vliet is an approximation: the
+// bounds below are what the third-order fit and float coefficients reach,
+// with some margin.  Step and noise are compared away from the clamped edges,
+// which the scans only seed approximately.
+// ---------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapBlurRecursiveErrorTest, "ToneMapFX.Blur.RecursiveError", GToneMapBlurTestFlags)
+
+bool FToneMapBlurRecursiveErrorTest::RunTest(const FString& Parameters)
+{
+	struct FCase
+	{
+		float Sigma;
+		float MaxImpulseError;   // relative to the Gaussian's peak
+		float MaxStepError;      // absolute, unit step
+		float MaxNoiseError;     // absolute, uniform noise in [0, 1)
+	};
+	const FCase Cases[] =
+	{
+		{   2.0f, 0.060f, 0.020f, 0.025f },
+		{   8.0f, 0.035f, 0.015f, 0.006f },
+		{  32.0f, 0.020f, 0.008f, 0.004f },
+		{ 100.0f, 0.120f, 0.040f, 0.012f },
+	};
+
+	for (const FCase& Case : Cases)
+	{
+		const float Sigma = Case.Sigma;
+		const FString Name = FString::Printf(TEXT("Sigma %.0f"), Sigma);
+
+		// Long enough that the edges do not reach the middle of the line
+		const int32 Length = FMath::Max(256, FMath::CeilToInt32(16.0f * Sigma));
+		const int32 Center = Length / 2;
+		const int32 Margin = FMath::CeilToInt32(4.0f * Sigma);
+
+		TArray<float> Impulse, Step, Noise;
+		Impulse.SetNumZeroed(Length);
+		Step.SetNumZeroed(Length);
+		Noise.SetNumUninitialized(Length);
+		Impulse[Center] = 1.0f;
+		FRandomStream Random(1234);
+		for (int32 i = 0; i < Length; ++i)
+		{
+			Step[i] = (i >= Center) ? 1.0f : 0.0f;
+			Noise[i] = Random.GetFraction();
+		}
+
+		auto Filter = [Length, Sigma](const TArray<float>& Input)
+		{
+			TArray<float> Output;
+			Output.SetNumUninitialized(Length);
+			FToneMapGaussianBlur::FilterRecursive(Input, Output, Sigma);
+			return Output;
+		};
+		const TArray<float> ImpulseResponse = Filter(Impulse);
+		const TArray<float> StepResponse = Filter(Step);
+		const TArray<float> NoiseResponse = Filter(Noise);
+
+		// Impulse: the Gaussian density itself, and its gain, centre and width
+		const double Peak = 1.0 / (FMath::Sqrt(2.0 * UE_DOUBLE_PI) * Sigma);
+		double ImpulseError = 0.0, Gain = 0.0, Mean = 0.0;
+		for (int32 i = 0; i < Length; ++i)
+		{
+			const double X = (double)(i - Center);
+			const double Expected = Peak * FMath::Exp(-X * X / (2.0 * Sigma * Sigma));
+			ImpulseError = FMath::Max(ImpulseError, FMath::Abs(ImpulseResponse[i] - Expected) / Peak);
+			Gain += ImpulseResponse[i];
+			Mean += X * ImpulseResponse[i];
+		}
+		Mean /= Gain;
+		double Variance = 0.0;
+		for (int32 i = 0; i < Length; ++i)
+		{
+			Variance += FMath::Square((double)(i - Center) - Mean) * ImpulseResponse[i];
+		}
+		const double Width = FMath::Sqrt(Variance / Gain);
+
+		TestTrue(FString::Printf(TEXT("%s impulse error %.5f <= %.3f"), *Name, ImpulseError, Case.MaxImpulseError), ImpulseError <= Case.MaxImpulseError);
+		TestEqual(Name + TEXT(" DC gain"), (float)Gain, 1.0f, 0.005f);
+		TestEqual(Name + TEXT(" impulse centre"), (float)Mean, 0.0f, 0.5f);
+		TestEqual(Name + TEXT(" effective sigma / sigma"), (float)(Width / Sigma), 1.0f, 0.15f);
+
+		// Step: the Gaussian's cumulative distribution, through the texel centres
+		double StepError = 0.0;
+		for (int32 i = Margin; i < Length - Margin; ++i)
+		{
+			const double Expected = 0.5 * (1.0 + std::erf(((double)(i - Center) + 0.5) / (Sigma * UE_DOUBLE_SQRT_2)));
+			StepError = FMath::Max(StepError, FMath::Abs(StepResponse[i] - Expected));
+		}
+		TestTrue(FString::Printf(TEXT("%s step error %.5f <= %.3f"), *Name, StepError, Case.MaxStepError), StepError <= Case.MaxStepError);
+
+		// Noise: direct convolution with the sampled Gaussian
+		TArray<float> Reference;
+		Reference.SetNumUninitialized(Length);
+		FToneMapGaussianBlur::FilterGaussian(Noise, Reference, Sigma);
+		double NoiseError = 0.0;
+		for (int32 i = Margin; i < Length - Margin; ++i)
+		{
+			NoiseError = FMath::Max(NoiseError, (double)FMath::Abs(NoiseResponse[i] - Reference[i]));
+		}
+		TestTrue(FString::Printf(TEXT("%s noise error %.5f <= %.3f"), *Name, NoiseError, Case.MaxNoiseError), NoiseError <= Case.MaxNoiseError);
+	}
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// GPU cost — the pixel shader, tiled and recursive paths timed with
+// timestamp queries on a 1920x1080 RGBA16F image
+// ---------------------------------------------------------------------------
+
+namespace ToneMapBlurTests
+{
+	static const FIntPoint ImageSize(1920, 1080);
+	static const float CostSigmas[] = { 8.0f, 32.0f, 48.0f };
+	static const EToneMapBlurMethod CostMethods[] = { EToneMapBlurMethod::PixelShader, EToneMapBlurMethod::Tiled, EToneMapBlurMethod::Recursive };
+	static constexpr int32 NumSigmas = UE_ARRAY_COUNT(CostSigmas);
+	static constexpr int32 NumMethods = UE_ARRAY_COUNT(CostMethods);
+
+	// H+V pairs per timed block — averages out the timestamp resolution
+	static constexpr int32 NumRepeats = 8;
+
+	static const TCHAR* GetMethodName(EToneMapBlurMethod Method)
+	{
+		switch (Method)
+		{
+		case EToneMapBlurMethod::PixelShader: return TEXT("pixel shader");
+		case EToneMapBlurMethod::Tiled:       return TEXT("tiled CS");
+		case EToneMapBlurMethod::Recursive:   return TEXT("recursive CS");
+		default:                              return TEXT("unknown");
+		}
+	}
+
+	struct FCostResults
+	{
+		bool bComputeOutput = false;
+		bool bValid[NumSigmas][NumMethods] = {};
+		float Ms[NumSigmas][NumMethods] = {};   // one H+V blur
+	};
+
+	// As FToneMapStageTimer::AddTimestamp
+	static void AddTimestamp(FRDGBuilder& GraphBuilder, FRHIRenderQuery* Query)
+	{
+		GraphBuilder.AddPass(
+			RDG_EVENT_NAME("ToneMapFX_Timestamp"),
+			ERDGPassFlags::NeverCull,
+			[Query](FRHICommandListImmediate& RHICmdList)
+			{
+				RHICmdList.EndRenderQuery(Query);
+			});
+	}
+
+	static void MeasureCost_RenderThread(FRHICommandListImmediate& RHICmdList, FCostResults& Results)
+	{
+		const FGlobalShaderMap* ShaderMap = GetGlobalShaderMap(GMaxRHIFeatureLevel);
+		FRenderQueryPoolRHIRef QueryPool = RHICreateRenderQueryPool(RQT_AbsoluteTime);
+
+		Results.bComputeOutput = FToneMapGaussianBlur::SupportsComputeOutput(PF_FloatRGBA);
+
+		TArray<FRHIPooledRenderQuery> Queries;
+		Queries.SetNum(NumSigmas * NumMethods * 2);
+
+		{
+			FRDGBuilder GraphBuilder(RHICmdList, RDG_EVENT_NAME("ToneMapFX_BlurCost"));
+			FToneMapTransientTextures Transients(GraphBuilder);
+
+			// Ping-pong: every pass feeds the next and the last one is extracted,
+			// so RDG culls none of them
+			const FRDGTextureDesc Desc = FRDGTextureDesc::Create2D(ImageSize, PF_FloatRGBA, FClearValueBinding::Black,
+				TexCreate_ShaderResource | TexCreate_RenderTargetable | (Results.bComputeOutput ? TexCreate_UAV : TexCreate_None));
+			FRDGTextureRef Image = GraphBuilder.CreateTexture(Desc, TEXT("ToneMapFX.BlurCost.Image"));
+			FRDGTextureRef Temp = GraphBuilder.CreateTexture(Desc, TEXT("ToneMapFX.BlurCost.Temp"));
+			AddClearRenderTargetPass(GraphBuilder, Image, FLinearColor(0.5f, 0.25f, 0.125f, 1.0f));
+
+			const FIntRect Rect(FIntPoint::ZeroValue, ImageSize);
+
+			for (int32 SigmaIndex = 0; SigmaIndex < NumSigmas; ++SigmaIndex)
+			{
+				const FToneMapGaussianKernel Kernel = FToneMapGaussianKernel::Build(CostSigmas[SigmaIndex]);
+
+				for (int32 MethodIndex = 0; MethodIndex < NumMethods; ++MethodIndex)
+				{
+					const EToneMapBlurMethod Method = CostMethods[MethodIndex];
+					if (Method != EToneMapBlurMethod::PixelShader && !Results.bComputeOutput)
+					{
+						continue;
+					}
+
+					FRHIPooledRenderQuery& Begin = Queries[(SigmaIndex * NumMethods + MethodIndex) * 2];
+					FRHIPooledRenderQuery& End = Queries[(SigmaIndex * NumMethods + MethodIndex) * 2 + 1];
+					Begin = QueryPool->AllocateQuery();
+					End = QueryPool->AllocateQuery();
+
+					AddTimestamp(GraphBuilder, Begin.GetQuery());
+					for (int32 Repeat = 0; Repeat < NumRepeats; ++Repeat)
+					{
+						for (const bool bVertical : { false, true })
+						{
+							if (Method == EToneMapBlurMethod::PixelShader)
+							{
+								FToneMapGaussianBlur::AddPixelShaderPass(GraphBuilder, ShaderMap, RDG_EVENT_NAME("BlurCost_PS"),
+									Kernel, bVertical, Image, Rect, Temp, ImageSize);
+							}
+							else
+							{
+								FToneMapGaussianBlur::AddComputePass(GraphBuilder, ShaderMap, Transients, RDG_EVENT_NAME("BlurCost_CS"),
+									ERDGPassFlags::Compute, Method, Kernel, bVertical, Image, FIntPoint::ZeroValue, Temp, ImageSize);
+							}
+							Swap(Image, Temp);
+						}
+					}
+					AddTimestamp(GraphBuilder, End.GetQuery());
+				}
+			}
+
+			TRefCountPtr<IPooledRenderTarget> Extracted;
+			GraphBuilder.QueueTextureExtraction(Image, &Extracted);
+			GraphBuilder.Execute();
+		}
+
+		// Submit everything, then wait on the queries themselves
+		RHICmdList.ImmediateFlush(EImmediateFlushType::FlushRHIThread);
+
+		for (int32 SigmaIndex = 0; SigmaIndex < NumSigmas; ++SigmaIndex)
+		{
+			for (int32 MethodIndex = 0; MethodIndex < NumMethods; ++MethodIndex)
+			{
+				const FRHIPooledRenderQuery& Begin = Queries[(SigmaIndex * NumMethods + MethodIndex) * 2];
+				const FRHIPooledRenderQuery& End = Queries[(SigmaIndex * NumMethods + MethodIndex) * 2 + 1];
+
+				uint64 BeginMicroseconds = 0;
+				uint64 EndMicroseconds = 0;
+				if (Begin.IsValid() && End.IsValid()
+					&& RHIGetRenderQueryResult(Begin.GetQuery(), BeginMicroseconds, true)
+					&& RHIGetRenderQueryResult(End.GetQuery(), EndMicroseconds, true)
+					&& EndMicroseconds > BeginMicroseconds)
+				{
+					Results.bValid[SigmaIndex][MethodIndex] = true;
+					Results.Ms[SigmaIndex][MethodIndex] = (float)(EndMicroseconds - BeginMicroseconds) / 1000.0f / NumRepeats;
+				}
+			}
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapBlurGPUCostTest, "ToneMapFX.Blur.GPUCost", GToneMapBlurPerfTestFlags)
+
+bool FToneMapBlurGPUCostTest::RunTest(const FString& Parameters)
+{
+	using namespace ToneMapBlurTests;
+
+	if (!FApp::CanEverRender() || GUsingNullRHI)
+	{
+		AddInfo(TEXT("Needs a GPU — skipped under -nullrhi"));
+		return true;
+	}
+
+	FCostResults Results;
+	ENQUEUE_RENDER_COMMAND(ToneMapBlurGPUCost)([&Results](FRHICommandListImmediate& RHICmdList)
+	{
+		MeasureCost_RenderThread(RHICmdList, Results);
+	});
+	FlushRenderingCommands();
+
+	AddInfo(FString::Printf(TEXT("Gaussian blur, H+V on %dx%d RGBA16F, mean of %d:"), ImageSize.X, ImageSize.Y, NumRepeats));
+	for (int32 SigmaIndex = 0; SigmaIndex < NumSigmas; ++SigmaIndex)
+	{
+		FString Line = FString::Printf(TEXT("  sigma %2.0f"), CostSigmas[SigmaIndex]);
+		for (int32 MethodIndex = 0; MethodIndex < NumMethods; ++MethodIndex)
+		{
+			Line += Results.bValid[SigmaIndex][MethodIndex]
+				? FString::Printf(TEXT("  %s %.3f ms"), GetMethodName(CostMethods[MethodIndex]), Results.Ms[SigmaIndex][MethodIndex])
+				: FString::Printf(TEXT("  %s -"), GetMethodName(CostMethods[MethodIndex]));
+		}
+		AddInfo(Line);
+	}
+
+	// Every supported variant was timed
+	for (int32 SigmaIndex = 0; SigmaIndex < NumSigmas; ++SigmaIndex)
+	{
+		for (int32 MethodIndex = 0; MethodIndex < NumMethods; ++MethodIndex)
+		{
+			const bool bSupported = CostMethods[MethodIndex] == EToneMapBlurMethod::PixelShader || Results.bComputeOutput;
+			if (bSupported)
+			{
+				TestTrue(FString::Printf(TEXT("Sigma %.0f %s has a GPU time"), CostSigmas[SigmaIndex], GetMethodName(CostMethods[MethodIndex])),
+					Results.bValid[SigmaIndex][MethodIndex]);
+			}
+		}
+	}
+
+	// The recursive filter's cost does not depend on sigma: sigma 48 within
+	// 50 % (plus 0.05 ms of timer noise) of sigma 8
+	const int32 Recursive = 2;   // index in CostMethods
+	if (Results.bValid[0][Recursive] && Results.bValid[NumSigmas - 1][Recursive])
+	{
+		const float Small = Results.Ms[0][Recursive];
+		const float Large = Results.Ms[NumSigmas - 1][Recursive];
+		TestTrue(FString::Printf(TEXT("Recursive cost flat over sigma (%.3f ms at 8, %.3f ms at 48)"), Small, Large),
+			Large <= Small * 1.5f + 0.05f && Small <= Large * 1.5f + 0.05f);
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
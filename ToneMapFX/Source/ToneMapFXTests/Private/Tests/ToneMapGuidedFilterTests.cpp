@@ -0,0 +1,241 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapGuidedFilter.h"
+#include "ToneMapTransientTextures.h"
+#include "GlobalShader.h"
+#include "RenderGraphUtils.h"
+#include "RenderingThread.h"
+#include "RenderTargetPool.h"
+#include "RHICommandList.h"
+#include "RHIGPUReadback.h"
+#include "Math/RandomStream.h"
+#include "Misc/App.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// The guided-filter Clarity base from the GPU passes against the filter
+// evaluated on the CPU with every box summed texel by texel.  The image spans
+// two row tiles, so windows cross tile boundaries and image edges.
+
+static constexpr EAutomationTestFlags GToneMapGuidedFilterTestFlags =
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+namespace ToneMapGuidedFilterTests
+{
+	static const FIntPoint ImageSize(200, 120);
+	static const float Sigmas[] = { 0.8f, 4.0f, 14.0f };   // box radius 1, 6, 24
+	static constexpr float EdgeThreshold = 0.5f;
+
+	// Log luminance goes through an R16F intermediate; its rounding stays
+	// below 0.002 EV over the image's range
+	static constexpr double MaxErrorEV = 0.01;
+
+	static double GetLogLuma(const FLinearColor& Color)
+	{
+		const double Luma = 0.2126 * Color.R + 0.7152 * Color.G + 0.0722 * Color.B;
+		return FMath::Log2(FMath::Max(Luma, 1e-6));
+	}
+
+	// Noisy gradient, a +6 EV block whose edge sits in the second row tile,
+	// and tinted strips of the same luminance
+	static TArray<FLinearColor> MakeImage()
+	{
+		FRandomStream Random(2010);
+		TArray<FLinearColor> Pixels;
+		Pixels.SetNumUninitialized(ImageSize.X * ImageSize.Y);
+
+		const FLinearColor Warm(1.0f, 0.6f, 0.3f);
+		const float WarmLuma = 0.2126f * Warm.R + 0.7152f * Warm.G + 0.0722f * Warm.B;
+
+		for (int32 Y = 0; Y < ImageSize.Y; ++Y)
+		{
+			for (int32 X = 0; X < ImageSize.X; ++X)
+			{
+				float EV = -3.0f + 4.0f * X / ImageSize.X + Random.FRandRange(-0.3f, 0.3f);
+				if (X >= 120 && Y >= 30 && Y < 90)
+				{
+					EV += 6.0f;
+				}
+
+				const float Luminance = FMath::Pow(2.0f, EV);
+				const bool bWarm = (X / 16) % 3 == 0;
+				Pixels[Y * ImageSize.X + X] = bWarm
+					? FLinearColor(Warm.R * Luminance / WarmLuma, Warm.G * Luminance / WarmLuma, Warm.B * Luminance / WarmLuma, 1.0f)
+					: FLinearColor(Luminance, Luminance, Luminance, 1.0f);
+			}
+		}
+		return Pixels;
+	}
+
+	// Mean over the (2r+1)² window at (X, Y), edges replicated
+	static FVector2d BoxMean(const TArray<FVector2d>& Values, int32 X, int32 Y, int32 Radius)
+	{
+		FVector2d Sum(0.0, 0.0);
+		for (int32 DY = -Radius; DY <= Radius; ++DY)
+		{
+			const int32 SY = FMath::Clamp(Y + DY, 0, ImageSize.Y - 1);
+			for (int32 DX = -Radius; DX <= Radius; ++DX)
+			{
+				const int32 SX = FMath::Clamp(X + DX, 0, ImageSize.X - 1);
+				Sum += Values[SY * ImageSize.X + SX];
+			}
+		}
+		return Sum / FMath::Square(2.0 * Radius + 1.0);
+	}
+
+	// He et al.: (a, b) per window from the (I, I²) box, q = mean_a·I + mean_b
+	static TArray<FLinearColor> BruteForceBase(const TArray<FLinearColor>& Pixels, int32 Radius, double Epsilon)
+	{
+		const int32 NumPixels = Pixels.Num();
+
+		TArray<double> LogLuma;
+		TArray<FVector2d> Stats;
+		LogLuma.SetNumUninitialized(NumPixels);
+		Stats.SetNumUninitialized(NumPixels);
+		for (int32 Index = 0; Index < NumPixels; ++Index)
+		{
+			LogLuma[Index] = GetLogLuma(Pixels[Index]);
+			Stats[Index] = FVector2d(LogLuma[Index], LogLuma[Index] * LogLuma[Index]);
+		}
+
+		TArray<FVector2d> Coeffs;
+		Coeffs.SetNumUninitialized(NumPixels);
+		for (int32 Y = 0; Y < ImageSize.Y; ++Y)
+		{
+			for (int32 X = 0; X < ImageSize.X; ++X)
+			{
+				const FVector2d Mean = BoxMean(Stats, X, Y, Radius);
+				const double Variance = FMath::Max(Mean.Y - Mean.X * Mean.X, 0.0);
+				const double A = Variance / (Variance + Epsilon);
+				Coeffs[Y * ImageSize.X + X] = FVector2d(A, (1.0 - A) * Mean.X);
+			}
+		}
+
+		TArray<FLinearColor> Base;
+		Base.SetNumUninitialized(NumPixels);
+		for (int32 Y = 0; Y < ImageSize.Y; ++Y)
+		{
+			for (int32 X = 0; X < ImageSize.X; ++X)
+			{
+				const int32 Index = Y * ImageSize.X + X;
+				const FVector2d MeanAB = BoxMean(Coeffs, X, Y, Radius);
+				const double Q = MeanAB.X * LogLuma[Index] + MeanAB.Y;
+				const float Scale = (float)FMath::Pow(2.0, Q - LogLuma[Index]);
+				Base[Index] = FLinearColor(Pixels[Index].R * Scale, Pixels[Index].G * Scale, Pixels[Index].B * Scale, 1.0f);
+			}
+		}
+		return Base;
+	}
+
+	static bool RunGuidedFilter_RenderThread(FRHICommandListImmediate& RHICmdList, const TArray<FLinearColor>& Pixels, float Sigma, TArray<FLinearColor>& OutBase)
+	{
+		const FGlobalShaderMap* ShaderMap = GetGlobalShaderMap(GMaxRHIFeatureLevel);
+
+		const FRHITextureCreateDesc Desc = FRHITextureCreateDesc::Create2D(TEXT("ToneMapFX.GuidedTest.Source"), ImageSize, PF_A32B32G32R32F)
+			.SetFlags(ETextureCreateFlags::ShaderResource);
+		FTextureRHIRef SourceRHI = RHICreateTexture(Desc);
+		RHICmdList.UpdateTexture2D(SourceRHI, 0,
+			FUpdateTextureRegion2D(0, 0, 0, 0, ImageSize.X, ImageSize.Y), ImageSize.X * sizeof(FLinearColor), (const uint8*)Pixels.GetData());
+
+		FRHIGPUTextureReadback Readback(TEXT("ToneMapFX.GuidedTest.Base"));
+		{
+			FRDGBuilder GraphBuilder(RHICmdList, RDG_EVENT_NAME("ToneMapFX_GuidedTest"));
+			FToneMapTransientTextures Transients(GraphBuilder);
+
+			FRDGTextureRef Source = GraphBuilder.RegisterExternalTexture(CreateRenderTarget(SourceRHI, TEXT("ToneMapFX.GuidedTest.Source")));
+			FRDGTextureRef Base = FToneMapGuidedFilter::AddClarityBasePasses(GraphBuilder, ShaderMap, Transients,
+				Source, FIntRect(FIntPoint::ZeroValue, ImageSize), ImageSize, Sigma, EdgeThreshold);
+			AddEnqueueCopyPass(GraphBuilder, &Readback, Base);
+			GraphBuilder.Execute();
+		}
+
+		RHICmdList.SubmitCommandsAndFlushGPU();
+		RHICmdList.BlockUntilGPUIdle();
+		if (!Readback.IsReady())
+		{
+			return false;
+		}
+
+		// RGBA16F base, pitched rows
+		int32 RowPitchInPixels = 0;
+		const FFloat16Color* Data = static_cast<const FFloat16Color*>(Readback.Lock(RowPitchInPixels));
+		OutBase.SetNumUninitialized(ImageSize.X * ImageSize.Y);
+		for (int32 Y = 0; Y < ImageSize.Y; ++Y)
+		{
+			for (int32 X = 0; X < ImageSize.X; ++X)
+			{
+				OutBase[Y * ImageSize.X + X] = FLinearColor(Data[(int64)Y * RowPitchInPixels + X]);
+			}
+		}
+		Readback.Unlock();
+		return true;
+	}
+}
+
+// ---------------------------------------------------------------------------
+// GPU base against the brute-force guided filter
+// ---------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapGuidedFilterBruteForceTest, "ToneMapFX.GuidedFilter.BruteForce", GToneMapGuidedFilterTestFlags)
+
+bool FToneMapGuidedFilterBruteForceTest::RunTest(const FString& Parameters)
+{
+	using namespace ToneMapGuidedFilterTests;
+
+	if (!FApp::CanEverRender() || GUsingNullRHI)
+	{
+		AddInfo(TEXT("Needs a GPU — skipped under -nullrhi"));
+		return true;
+	}
+	if (!FToneMapGuidedFilter::IsSupported())
+	{
+		AddInfo(TEXT("No typed UAV stores for the guided filter formats — skipped"));
+		return true;
+	}
+
+	const TArray<FLinearColor> Pixels = MakeImage();
+	const double Epsilon = FMath::Max(EdgeThreshold * EdgeThreshold, 1e-4f);
+
+	for (const float Sigma : Sigmas)
+	{
+		const int32 Radius = FToneMapGuidedFilter::GetBoxRadius(Sigma);
+
+		TArray<FLinearColor> GPUBase;
+		bool bRan = false;
+		ENQUEUE_RENDER_COMMAND(ToneMapGuidedFilterTest)([&Pixels, Sigma, &GPUBase, &bRan](FRHICommandListImmediate& RHICmdList)
+		{
+			bRan = RunGuidedFilter_RenderThread(RHICmdList, Pixels, Sigma, GPUBase);
+		});
+		FlushRenderingCommands();
+
+		if (!TestTrue(FString::Printf(TEXT("r=%d: base read back"), Radius), bRan))
+		{
+			continue;
+		}
+
+		const TArray<FLinearColor> Reference = BruteForceBase(Pixels, Radius, Epsilon);
+
+		double WorstEV = 0.0;
+		FIntPoint WorstPixel = FIntPoint::ZeroValue;
+		for (int32 Y = 0; Y < ImageSize.Y; ++Y)
+		{
+			for (int32 X = 0; X < ImageSize.X; ++X)
+			{
+				const int32 Index = Y * ImageSize.X + X;
+				const double ErrorEV = FMath::Abs(GetLogLuma(GPUBase[Index]) - GetLogLuma(Reference[Index]));
+				if (ErrorEV > WorstEV)
+				{
+					WorstEV = ErrorEV;
+					WorstPixel = FIntPoint(X, Y);
+				}
+			}
+		}
+
+		TestTrue(FString::Printf(TEXT("r=%d: largest base error %.4f EV at (%d, %d)"), Radius, WorstEV, WorstPixel.X, WorstPixel.Y),
+			WorstEV <= MaxErrorEV);
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,238 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapHistogramMetering.h"
+#include "ToneMapComponent.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// FToneMapHistogramMetering's CPU reference of HistogramBuildCS /
+// HistogramResolveCS.  Luminances are compared in EV (log2): every sample is
+// metered at its bin centre, so a resolve can be off by half a bin.
+
+static constexpr EAutomationTestFlags GToneMapMeteringTestFlags =
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+namespace ToneMapMeteringTests
+{
+	static constexpr int32 NumSamples = 4096;
+
+	static constexpr float BinEV = (FToneMapHistogramMetering::MaxLog2Luminance - FToneMapHistogramMetering::MinLog2Luminance) / FToneMapHistogramMetering::NumBins;
+	static constexpr float HalfBinEV = 0.5f * BinEV;
+
+	static TArray<uint32> Build(const TArray<float>& Luminance, TConstArrayView<float> Weights = {})
+	{
+		TArray<uint32> Bins;
+		Bins.SetNumZeroed(FToneMapHistogramMetering::NumBins);
+		FToneMapHistogramMetering::BuildHistogram(Luminance, Weights, Bins);
+		return Bins;
+	}
+
+	// Same epsilon as LuminanceMeasurePS
+	static float GeometricMean(const TArray<float>& Luminance)
+	{
+		double SumLog = 0.0;
+		for (const float L : Luminance)
+		{
+			SumLog += FMath::Loge(FMath::Max(L, 0.0001f));
+		}
+		return (float)FMath::Exp(SumLog / FMath::Max(Luminance.Num(), 1));
+	}
+
+	// Signed distance in EV
+	static float GetEV(float Luminance, float Reference)
+	{
+		return FMath::Log2(Luminance / Reference);
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Build / resolve mechanics
+// ---------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapMeteringHistogramTest, "ToneMapFX.Metering.Histogram", GToneMapMeteringTestFlags)
+
+bool FToneMapMeteringHistogramTest::RunTest(const FString& Parameters)
+{
+	using namespace ToneMapMeteringTests;
+
+	const uint32 FullWeight = (uint32)FToneMapHistogramMetering::WeightScale;
+
+	// Every sample lands in exactly one bin with the fixed-point weight
+	TArray<float> Luminance;
+	Luminance.Init(0.18f, NumSamples);
+	const TArray<uint32> Flat = Build(Luminance);
+	uint64 Total = 0;
+	int32 NumUsedBins = 0;
+	for (const uint32 Count : Flat)
+	{
+		Total += Count;
+		NumUsedBins += Count > 0 ? 1 : 0;
+	}
+	TestEqual(TEXT("Total weight of a flat image"), Total, (uint64)NumSamples * FullWeight);
+	TestEqual(TEXT("Bins used by a flat image"), NumUsedBins, 1);
+
+	// Out-of-range luminance clamps into the end bins, black included
+	const TArray<float> Extremes = { 0.0f, 1.0e-9f, 1.0e9f };
+	const TArray<uint32> Clamped = Build(Extremes);
+	TestEqual(TEXT("Black and near-black in the first bin"), Clamped[0], 2 * FullWeight);
+	TestEqual(TEXT("Overbright in the last bin"), Clamped.Last(), FullWeight);
+
+	// Weights are quantised to 1/WeightScale; zero-weight samples are skipped
+	const TArray<float> Weights = { 0.5f, 0.0f, 2.0f };
+	const TArray<float> Three = { 1.0f, 1.0f, 1.0f };
+	uint64 WeightedTotal = 0;
+	for (const uint32 Count : Build(Three, Weights))
+	{
+		WeightedTotal += Count;
+	}
+	TestEqual(TEXT("Half, zero and clamped weights"), WeightedTotal, (uint64)(FullWeight / 2 + FullWeight));
+
+	// Nothing metered: the mid-grey fallback
+	TArray<uint32> Empty;
+	Empty.SetNumZeroed(FToneMapHistogramMetering::NumBins);
+	TestEqual(TEXT("Empty histogram resolves to mid grey"), FToneMapHistogramMetering::ResolveHistogram(Empty, 10.0f, 90.0f), 0.18f, KINDA_SMALL_NUMBER);
+
+	// A flat image reads its own luminance at every percentile range, up to half a bin
+	for (const FVector2f Range : { FVector2f(0.0f, 100.0f), FVector2f(10.0f, 90.0f), FVector2f(40.0f, 95.0f), FVector2f(50.0f, 50.0f) })
+	{
+		const float Resolved = FToneMapHistogramMetering::ResolveHistogram(Flat, Range.X, Range.Y);
+		TestTrue(FString::Printf(TEXT("Flat grey %.0f-%.0f reads %.4f"), Range.X, Range.Y, Resolved),
+			FMath::Abs(GetEV(Resolved, 0.18f)) <= HalfBinEV);
+	}
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// Synthetic scenes — trimmed histogram vs. geometric mean
+// ---------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapMeteringScenesTest, "ToneMapFX.Metering.Scenes", GToneMapMeteringTestFlags)
+
+bool FToneMapMeteringScenesTest::RunTest(const FString& Parameters)
+{
+	using namespace ToneMapMeteringTests;
+
+	FRandomStream Random(1234);
+	TArray<float> Luminance;
+	Luminance.SetNumUninitialized(NumSamples);
+
+	auto Resolve = [](const TArray<uint32>& Bins, float Low, float High)
+	{
+		return FToneMapHistogramMetering::ResolveHistogram(Bins, Low, High);
+	};
+
+	// The untrimmed histogram is the geometric mean, quantised to bin centres
+	auto TestUntrimmed = [&](const TCHAR* Scene, const TArray<uint32>& Bins, float GeoMean)
+	{
+		const float EV = GetEV(Resolve(Bins, 0.0f, 100.0f), GeoMean);
+		TestTrue(FString::Printf(TEXT("%s: 0-100 within half a bin of the geometric mean (%+.3f EV)"), Scene, EV), FMath::Abs(EV) <= HalfBinEV);
+	};
+
+	// Interior (0.05 +-1 EV) with 20 % sky at 50: trimming the top 10 % keeps
+	// half the sky out, so 10-90 meters the interior more than the geometric
+	// mean does; 40-95 exposes for the highlights
+	{
+		for (int32 i = 0; i < NumSamples; ++i)
+		{
+			Luminance[i] = (i < NumSamples / 5) ? 50.0f : 0.05f * FMath::Exp2(Random.FRandRange(-1.0f, 1.0f));
+		}
+		const TArray<uint32> Bins = Build(Luminance);
+		const float GeoMean = GeometricMean(Luminance);
+		const float Trimmed = Resolve(Bins, 10.0f, 90.0f);
+		const float Highlights = Resolve(Bins, 40.0f, 95.0f);
+
+		TestUntrimmed(TEXT("Interior + sky"), Bins, GeoMean);
+		TestTrue(FString::Printf(TEXT("Interior + sky: 10-90 %.4f at least 0.5 EV under the geometric mean %.4f"), Trimmed, GeoMean),
+			GetEV(Trimmed, GeoMean) <= -0.5f);
+		TestTrue(FString::Printf(TEXT("Interior + sky: 40-95 %.4f at least 1 EV over 10-90"), Highlights),
+			GetEV(Highlights, Trimmed) >= 1.0f);
+	}
+
+	// Dim room (0.02 +-1 EV) with a 1 % lamp at 5000: 10-90 ignores the lamp
+	// entirely, the geometric mean does not
+	{
+		for (int32 i = 0; i < NumSamples; ++i)
+		{
+			Luminance[i] = (i < NumSamples / 100) ? 5000.0f : 0.02f * FMath::Exp2(Random.FRandRange(-1.0f, 1.0f));
+		}
+		const TArray<uint32> Bins = Build(Luminance);
+		const float GeoMean = GeometricMean(Luminance);
+		const float Trimmed = Resolve(Bins, 10.0f, 90.0f);
+
+		TestUntrimmed(TEXT("Room + lamp"), Bins, GeoMean);
+		TestTrue(FString::Printf(TEXT("Room + lamp: 10-90 %.4f within 0.25 EV of the room"), Trimmed), FMath::Abs(GetEV(Trimmed, 0.02f)) <= 0.25f);
+		TestTrue(FString::Printf(TEXT("Room + lamp: 10-90 %.4f under the geometric mean %.4f"), Trimmed, GeoMean), Trimmed < GeoMean);
+	}
+
+	// Log-uniform over 12 EV around mid grey: symmetric ranges read mid grey,
+	// 40-95 sits at the mean of that slice, +2.1 EV
+	{
+		for (float& L : Luminance)
+		{
+			L = 0.18f * FMath::Exp2(Random.FRandRange(-6.0f, 6.0f));
+		}
+		const TArray<uint32> Bins = Build(Luminance);
+		const float GeoMean = GeometricMean(Luminance);
+		const float Trimmed = Resolve(Bins, 10.0f, 90.0f);
+		const float Highlights = Resolve(Bins, 40.0f, 95.0f);
+
+		TestUntrimmed(TEXT("Log-uniform"), Bins, GeoMean);
+		TestTrue(FString::Printf(TEXT("Log-uniform: geometric mean %.4f within 0.25 EV of mid grey"), GeoMean), FMath::Abs(GetEV(GeoMean, 0.18f)) <= 0.25f);
+		TestTrue(FString::Printf(TEXT("Log-uniform: 10-90 %.4f within 0.25 EV of mid grey"), Trimmed), FMath::Abs(GetEV(Trimmed, 0.18f)) <= 0.25f);
+		TestEqual(TEXT("Log-uniform: 40-95 in EV over mid grey"), GetEV(Highlights, 0.18f), 2.1f, 0.3f);
+	}
+
+	// Half the samples masked out (spot / mask metering): only the metered half counts
+	{
+		TArray<float> Weights;
+		Weights.SetNumUninitialized(NumSamples);
+		for (int32 i = 0; i < NumSamples; ++i)
+		{
+			Luminance[i] = (i & 1) ? 2.0f : 0.02f;
+			Weights[i] = (i & 1) ? 0.0f : 1.0f;
+		}
+		const float Metered = Resolve(Build(Luminance, Weights), 10.0f, 90.0f);
+		TestTrue(FString::Printf(TEXT("Masked: 10-90 %.4f within half a bin of the metered 0.02"), Metered),
+			FMath::Abs(GetEV(Metered, 0.02f)) <= HalfBinEV);
+	}
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// Defaults meter like the log-average of earlier versions
+// ---------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapMeteringDefaultsTest, "ToneMapFX.Metering.Defaults", GToneMapMeteringTestFlags)
+
+bool FToneMapMeteringDefaultsTest::RunTest(const FString& Parameters)
+{
+	using namespace ToneMapMeteringTests;
+
+	// Existing components pick up the metering properties at their defaults,
+	// so those must not move exposure
+	const UToneMapComponent* Component = GetDefault<UToneMapComponent>();
+	TestTrue(TEXT("Component: Average metering"), Component->MeteringMode == EToneMapMeteringMode::Average);
+	TestEqual(TEXT("Component: low percent"), Component->MeteringLowPercent, 0.0f);
+	TestEqual(TEXT("Component: high percent"), Component->MeteringHighPercent, 100.0f);
+
+	const FToneMapMeteringSettings Settings;
+	TestTrue(TEXT("Settings: Average metering"), Settings.Mode == (uint32)EToneMapMeteringMode::Average);
+
+	// Interior with a bright sky: the scene a trimmed default would darken
+	FRandomStream Random(4321);
+	TArray<float> Luminance;
+	Luminance.SetNumUninitialized(NumSamples);
+	for (int32 i = 0; i < NumSamples; ++i)
+	{
+		Luminance[i] = (i < NumSamples / 5) ? 50.0f : 0.05f * FMath::Exp2(Random.FRandRange(-1.0f, 1.0f));
+	}
+	const float GeoMean = GeometricMean(Luminance);
+	const float Resolved = FToneMapHistogramMetering::ResolveHistogram(Build(Luminance), Settings.LowPercent, Settings.HighPercent);
+	const float EV = GetEV(Resolved, GeoMean);
+	TestTrue(FString::Printf(TEXT("Defaults within half a bin of the geometric mean (%+.3f EV)"), EV), FMath::Abs(EV) <= HalfBinEV);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,251 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapScalability.h"
+#include "ToneMapFramePlan.h"
+#include "ToneMapComponent.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/Package.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// The compiled-in quality tiers (FToneMapScalability::GetDefaultTier) applied
+// to a preset that asks for the maximum of every capped setting, and the frame
+// plan FToneMapFramePlanner builds from each at 1920x1080.  Expected values
+// follow the tier table in ToneMapScalability.cpp and the pass layout in
+// ToneMapFramePlan.cpp; a change to either must update the table below.
+
+static constexpr EAutomationTestFlags GToneMapQualityTierTestFlags =
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+namespace ToneMapQualityTierTests
+{
+	static const FIntPoint ViewportSize(1920, 1080);
+
+	struct FExpectedTier
+	{
+		FToneMapResolvedQuality Quality;
+		FIntPoint BloomExtent;
+		int32 StandardBloomPasses;      // bright pass, BloomBlurPasses H/V pairs, composite
+		int32 KawaseBloomPasses;        // bright pass, M downsamples, M-1 upsamples, final upsample, composite
+		int32 GlareStreakFetches;       // 1 + 2 * GlareSamples
+		int32 FattalPasses;             // log, gradient, divergence, Jacobi iterations, reconstruct
+		FIntPoint LensExtent;
+		int32 CoronaFetches;            // 1 + 2 * (CoronaSpikeCount / 2) * spike length
+		int32 HaloFetches;              // 5 per angular sample
+		int32 ClarityFetches;           // one Gaussian direction, half width min(3σ, 48)
+	};
+
+	static FToneMapResolvedQuality MakeQuality(int32 Glare, int32 Kawase, int32 Fattal, int32 Spike, int32 Halo,
+		int32 BloomPasses, float Clarity, float BloomScale, float LensScale)
+	{
+		FToneMapResolvedQuality Q;
+		Q.GlareSamples = Glare;
+		Q.KawaseMipCount = Kawase;
+		Q.FattalIterations = Fattal;
+		Q.CoronaSpikeLength = Spike;
+		Q.HaloAngularSamples = Halo;
+		Q.BloomBlurPasses = BloomPasses;
+		Q.ClarityRadius = Clarity;
+		Q.BloomDownsampleScale = BloomScale;
+		Q.LensResolutionScale = LensScale;
+		return Q;
+	}
+
+	static FExpectedTier GetExpected(int32 QualityLevel)
+	{
+		switch (QualityLevel)
+		{
+		case 0:  return { MakeQuality( 8, 4,   8,  20,  8, 1,  4.0f, 0.5f, 0.5f),  FIntPoint(480, 270),   4, 10,  17,  12, FIntPoint(960, 540),   121,  40, 13 };
+		case 1:  return { MakeQuality(16, 5,  16,  40, 16, 2,  8.0f, 1.0f, 0.5f),  FIntPoint(960, 540),   6, 12,  33,  20, FIntPoint(960, 540),   241,  80, 25 };
+		case 2:  return { MakeQuality(32, 6,  30, 120, 24, 3, 16.0f, 1.0f, 0.75f), FIntPoint(960, 540),   8, 14,  65,  34, FIntPoint(1440, 810),  721, 120, 49 };
+		default: return { MakeQuality(64, 8, 200, 400, 32, 4, 50.0f, 2.0f, 1.0f),  FIntPoint(1920, 1080), 10, 18, 129, 204, FIntPoint(1920, 1080), 1201, 160, 49 };
+		}
+	}
+
+	// Every capped setting at its maximum, Fattal, both lens effects and Gaussian clarity
+	static UToneMapComponent* MakeMaxedSettings()
+	{
+		UToneMapComponent* Settings = NewObject<UToneMapComponent>(GetTransientPackage());
+		Settings->Mode = EToneMapMode::ReplaceTonemap;
+		Settings->FilmCurve = EToneMapFilmCurve::Fattal;
+		Settings->bEnableBloom = true;
+		Settings->BloomIntensity = 1.0f;
+		Settings->BloomMode = EBloomMode::Standard;
+		Settings->GlareSamples = 64;
+		Settings->KawaseMipCount = 8;
+		Settings->BlurPasses = 4;
+		Settings->DownsampleScale = 2.0f;
+		Settings->FattalJacobiIterations = 200;
+		Settings->bEnableCiliaryCorona = true;
+		Settings->CoronaSpikeCount = 6;
+		Settings->CoronaSpikeLength = 400;
+		Settings->bEnableLenticularHalo = true;
+		Settings->Clarity = 0.5f;
+		Settings->ClarityMode = EToneMapClarityMode::Gaussian;
+		Settings->ClarityRadius = 50.0f;
+		return Settings;
+	}
+
+	// Plan inputs without CVar or platform lookups — everything compiled, default precision
+	static FToneMapPlanInputs MakeInputs(const UToneMapComponent& Settings, int32 QualityLevel)
+	{
+		FToneMapPlanInputs Inputs;
+		Inputs.ViewportSize = ViewportSize;
+		Inputs.Quality = FToneMapScalability::Resolve(Settings, FToneMapScalability::GetDefaultTier(QualityLevel));
+		Inputs.bReplaceTonemap = true;
+		return Inputs;
+	}
+
+	static const FToneMapPlanPass* FindPass(const FToneMapFramePlan& Plan, const TCHAR* Name)
+	{
+		return Plan.Passes.FindByPredicate([Name](const FToneMapPlanPass& Pass) { return FCString::Strcmp(Pass.Name, Name) == 0; });
+	}
+
+	static int32 GetNumPasses(const FToneMapFramePlan& Plan, EToneMapPlanStage Stage)
+	{
+		return Plan.Stages[(int32)Stage].NumPasses;
+	}
+}
+
+static void TestExtent(FAutomationTestBase& Test, const FString& What, FIntPoint Actual, FIntPoint Expected)
+{
+	Test.TestTrue(FString::Printf(TEXT("%s is %s (expected %s)"), *What, *Actual.ToString(), *Expected.ToString()), Actual == Expected);
+}
+
+// ---------------------------------------------------------------------------
+// Tier tables — caps and monotonic ordering
+// ---------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapQualityTierTablesTest, "ToneMapFX.Scalability.Tiers", GToneMapQualityTierTestFlags)
+
+bool FToneMapQualityTierTablesTest::RunTest(const FString& Parameters)
+{
+	using namespace ToneMapQualityTierTests;
+
+	const UToneMapComponent* Maxed = MakeMaxedSettings();
+
+	for (int32 Level = 0; Level < FToneMapScalability::NumTiers; ++Level)
+	{
+		const FToneMapResolvedQuality Q = FToneMapScalability::Resolve(*Maxed, FToneMapScalability::GetDefaultTier(Level));
+		const FToneMapResolvedQuality E = GetExpected(Level).Quality;
+		const FString Tier = FString::Printf(TEXT("Quality %d"), Level);
+
+		TestEqual(Tier + TEXT(" glare samples"), Q.GlareSamples, E.GlareSamples);
+		TestEqual(Tier + TEXT(" Kawase mips"), Q.KawaseMipCount, E.KawaseMipCount);
+		TestEqual(Tier + TEXT(" Fattal iterations"), Q.FattalIterations, E.FattalIterations);
+		TestEqual(Tier + TEXT(" corona spike length"), Q.CoronaSpikeLength, E.CoronaSpikeLength);
+		TestEqual(Tier + TEXT(" halo samples"), Q.HaloAngularSamples, E.HaloAngularSamples);
+		TestEqual(Tier + TEXT(" bloom blur passes"), Q.BloomBlurPasses, E.BloomBlurPasses);
+		TestEqual(Tier + TEXT(" clarity radius"), Q.ClarityRadius, E.ClarityRadius, KINDA_SMALL_NUMBER);
+		TestEqual(Tier + TEXT(" bloom downsample scale"), Q.BloomDownsampleScale, E.BloomDownsampleScale, KINDA_SMALL_NUMBER);
+		TestEqual(Tier + TEXT(" lens resolution scale"), Q.LensResolutionScale, E.LensResolutionScale, KINDA_SMALL_NUMBER);
+	}
+
+	// Caps never raise a setting: the component defaults pass through Epic untouched
+	const UToneMapComponent& Defaults = *GetDefault<UToneMapComponent>();
+	const FToneMapResolvedQuality Epic = FToneMapScalability::Resolve(Defaults, FToneMapScalability::GetDefaultTier(3));
+	TestEqual(TEXT("Epic keeps the default glare samples"), Epic.GlareSamples, Defaults.GlareSamples);
+	TestEqual(TEXT("Epic keeps the default Fattal iterations"), Epic.FattalIterations, Defaults.FattalJacobiIterations);
+	TestEqual(TEXT("Epic keeps the default bloom blur passes"), Epic.BloomBlurPasses, Defaults.BlurPasses);
+
+	// The tables in effect, Scalability.ini overrides included, for both presets
+	TestTrue(TEXT("Active tiers are monotonic for the maxed preset"), FToneMapScalability::ValidateTiers(*Maxed));
+	TestTrue(TEXT("Active tiers are monotonic for the component defaults"), FToneMapScalability::ValidateTiers(Defaults));
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// Frame plan per tier
+// ---------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapQualityTierPassPlanTest, "ToneMapFX.Scalability.PassPlan", GToneMapQualityTierTestFlags)
+
+bool FToneMapQualityTierPassPlanTest::RunTest(const FString& Parameters)
+{
+	using namespace ToneMapQualityTierTests;
+
+	UToneMapComponent* Settings = MakeMaxedSettings();
+
+	uint64 PrevFetches = 0;
+	uint64 PrevPeak = 0;
+
+	for (int32 Level = 0; Level < FToneMapScalability::NumTiers; ++Level)
+	{
+		const FExpectedTier E = GetExpected(Level);
+		const FString Tier = FString::Printf(TEXT("Quality %d"), Level);
+
+		Settings->BloomMode = EBloomMode::Standard;
+		const FToneMapPlanInputs Inputs = MakeInputs(*Settings, Level);
+		const FToneMapFramePlan Plan = FToneMapFramePlanner::Build(*Settings, Inputs);
+
+		FString Error;
+		if (!Plan.Validate(&Error))
+		{
+			AddError(FString::Printf(TEXT("%s: invalid plan: %s"), *Tier, *Error));
+			continue;
+		}
+
+		// Bloom at the tier's downsample scale with its blur pass cap
+		TestEqual(Tier + TEXT(" Standard bloom passes"), GetNumPasses(Plan, EToneMapPlanStage::Bloom), E.StandardBloomPasses);
+		if (const FToneMapPlanPass* Pass = FindPass(Plan, TEXT("BrightPass")))
+		{
+			TestExtent(*this, Tier + TEXT(" bloom extent"), Pass->Extent, E.BloomExtent);
+		}
+		else
+		{
+			AddError(Tier + TEXT(": no bloom bright pass"));
+		}
+
+		// One Jacobi pass per capped iteration
+		TestEqual(Tier + TEXT(" Fattal passes"), GetNumPasses(Plan, EToneMapPlanStage::Fattal), E.FattalPasses);
+
+		// Lens buffer at the tier's resolution scale, spike length and halo samples capped
+		const FToneMapPlanPass* Corona = FindPass(Plan, TEXT("CoronaStreaks"));
+		const FToneMapPlanPass* Halo = FindPass(Plan, TEXT("HaloRing"));
+		if (TestNotNull(Tier + TEXT(" corona pass"), Corona) && TestNotNull(Tier + TEXT(" halo pass"), Halo))
+		{
+			TestExtent(*this, Tier + TEXT(" lens extent"), Corona->Extent, E.LensExtent);
+			TestEqual(Tier + TEXT(" corona fetches per pixel"), Corona->FetchesPerPixel, E.CoronaFetches);
+			TestEqual(Tier + TEXT(" halo fetches per pixel"), Halo->FetchesPerPixel, E.HaloFetches);
+		}
+
+		// Clarity blur sized by the capped radius
+		if (const FToneMapPlanPass* Clarity = FindPass(Plan, TEXT("ToneMap_HBlur")))
+		{
+			TestEqual(Tier + TEXT(" clarity fetches per pixel"), Clarity->FetchesPerPixel, E.ClarityFetches);
+		}
+		else
+		{
+			AddError(Tier + TEXT(": no clarity blur pass"));
+		}
+
+		// A higher tier never costs less
+		TestTrue(FString::Printf(TEXT("%s fetches %llu >= previous tier %llu"), *Tier, Plan.GetTotalFetches(), PrevFetches),
+			Plan.GetTotalFetches() >= PrevFetches);
+		TestTrue(FString::Printf(TEXT("%s peak %llu bytes >= previous tier %llu"), *Tier, Plan.PeakTransientBytes, PrevPeak),
+			Plan.PeakTransientBytes >= PrevPeak);
+		PrevFetches = Plan.GetTotalFetches();
+		PrevPeak = Plan.PeakTransientBytes;
+
+		// The other bloom modes, capped by the same tier
+		Settings->BloomMode = EBloomMode::Kawase;
+		const FToneMapFramePlan Kawase = FToneMapFramePlanner::Build(*Settings, Inputs);
+		TestTrue(Tier + TEXT(" Kawase plan is valid"), Kawase.Validate());
+		TestEqual(Tier + TEXT(" Kawase bloom passes"), GetNumPasses(Kawase, EToneMapPlanStage::Bloom), E.KawaseBloomPasses);
+
+		Settings->BloomMode = EBloomMode::DirectionalGlare;
+		const FToneMapFramePlan Glare = FToneMapFramePlanner::Build(*Settings, Inputs);
+		TestTrue(Tier + TEXT(" glare plan is valid"), Glare.Validate());
+		if (const FToneMapPlanPass* Streak = FindPass(Glare, TEXT("GlareStreak")))
+		{
+			TestEqual(Tier + TEXT(" glare streak fetches per pixel"), Streak->FetchesPerPixel, E.GlareStreakFetches);
+		}
+		else
+		{
+			AddError(Tier + TEXT(": no glare streak pass"));
+		}
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
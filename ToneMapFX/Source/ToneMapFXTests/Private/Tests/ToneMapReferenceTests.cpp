@@ -0,0 +1,122 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapReferencePipeline.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// CPU only — runs headless under -nullrhi:
+//   UnrealEditor-Cmd <Project>.uproject -nullrhi -ExecCmds="Automation RunTests ToneMapFX; Quit"
+
+static constexpr EAutomationTestFlags GToneMapReferenceTestFlags =
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+static bool LoadReferenceScenes(FAutomationTestBase& Test, TArray<FToneMapReferenceImage>& OutScenes)
+{
+	OutScenes.SetNum(FToneMapReferenceSuite::GetNumScenes());
+	for (int32 Scene = 0; Scene < OutScenes.Num(); ++Scene)
+	{
+		if (!FToneMapReferenceSuite::LoadScene(Scene, OutScenes[Scene]))
+		{
+			Test.AddError(FString::Printf(TEXT("Cannot read %s"), *FToneMapReferenceSuite::GetScenePath(Scene)));
+			return false;
+		}
+	}
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// Every case against Resources/ReferenceGolden.csv
+// ---------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapReferenceGoldenTest, "ToneMapFX.Reference.Golden", GToneMapReferenceTestFlags)
+
+bool FToneMapReferenceGoldenTest::RunTest(const FString& Parameters)
+{
+	using namespace ToneMapColorMath;
+
+	FToneMapReferenceSuite::FGolden Golden;
+	if (!TestTrue(TEXT("Golden table loads"), FToneMapReferenceSuite::LoadGolden(FToneMapReferenceSuite::GetGoldenPath(), Golden)))
+	{
+		return false;
+	}
+
+	TArray<FToneMapReferenceImage> Scenes;
+	if (!LoadReferenceScenes(*this, Scenes))
+	{
+		return false;
+	}
+
+	for (const FToneMapReferenceCase& Case : FToneMapReferenceSuite::GetCases())
+	{
+		for (int32 Scene = 0; Scene < Scenes.Num(); ++Scene)
+		{
+			const FString Key = FToneMapReferenceSuite::GetGoldenKey(Case, Scene);
+			const TArray<float3>* Expected = Golden.Find(Key);
+			if (!Expected)
+			{
+				AddError(FString::Printf(TEXT("%s: no golden entry"), *Key));
+				continue;
+			}
+
+			FToneMapReferenceImage Output, Thumb;
+			FToneMapReferencePipeline::Run(Scenes[Scene], Case.Settings, Output);
+			FToneMapReferenceSuite::MakeThumbnail(Output, Thumb);
+
+			const float3 Worst = FToneMapReferenceSuite::GetMaxError(Thumb, *Expected);
+			if (Worst.x > Case.Tolerance.x || Worst.y > Case.Tolerance.y || Worst.z > Case.Tolerance.z)
+			{
+				AddError(FString::Printf(TEXT("%s: max error (%.2e, %.2e, %.2e) exceeds (%.0e, %.0e, %.0e)"),
+					*Key, Worst.x, Worst.y, Worst.z, Case.Tolerance.x, Case.Tolerance.y, Case.Tolerance.z));
+			}
+		}
+	}
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// Half permutation end to end — the ReplaceTonemap tail (tone curve, sRGB)
+// is what TONEMAP_HALF_PRECISION changes in the reference chain
+// ---------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapReferenceHalfPrecisionTest, "ToneMapFX.Reference.HalfPrecision", GToneMapReferenceTestFlags)
+
+bool FToneMapReferenceHalfPrecisionTest::RunTest(const FString& Parameters)
+{
+	using namespace ToneMapColorMath;
+
+	// Measured worst case is 0.32 LSB at 8 bit (README, Half precision)
+	constexpr float Tolerance = 0.5f / 255.0f;
+
+	TArray<FToneMapReferenceImage> Scenes;
+	if (!LoadReferenceScenes(*this, Scenes))
+	{
+		return false;
+	}
+
+	for (const FToneMapReferenceCase& Case : FToneMapReferenceSuite::GetCases())
+	{
+		FToneMapReferenceSettings HalfSettings = Case.Settings;
+		HalfSettings.bHalfPrecision = true;
+
+		float Worst = 0.0f;
+		for (const FToneMapReferenceImage& Input : Scenes)
+		{
+			FToneMapReferenceImage Full, Half;
+			FToneMapReferencePipeline::Run(Input, Case.Settings, Full);
+			FToneMapReferencePipeline::Run(Input, HalfSettings, Half);
+
+			for (int32 i = 0; i < Full.Pixels.Num(); ++i)
+			{
+				const float3 Diff = abs(Half.Pixels[i] - Full.Pixels[i]);
+				Worst = FMath::Max(Worst, FMath::Max3(Diff.x, Diff.y, Diff.z));
+			}
+		}
+
+		AddInfo(FString::Printf(TEXT("%s: %.2f LSB at 8 bit"), Case.Name, Worst * 255.0f));
+		TestTrue(FString::Printf(TEXT("%s half-vs-fp32 error %.2e within %.2e"), Case.Name, Worst, Tolerance), Worst <= Tolerance);
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
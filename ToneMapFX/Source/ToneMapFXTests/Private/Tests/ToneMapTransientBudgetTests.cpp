@@ -0,0 +1,175 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapTransientTextures.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// FToneMapTransientTextures::StepBudget driven by a synthetic view: a fixed
+// full-resolution footprint plus bloom / lens buffers whose area quarters with
+// every level ApplyBudget takes.  Unlike the GPU governor, the peak is known
+// on the CPU when the frame is built, so each step sees the previous frame.
+
+static constexpr EAutomationTestFlags GToneMapTransientBudgetTestFlags =
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+namespace ToneMapTransientBudgetTests
+{
+	static constexpr uint64 MB = 1024 * 1024;
+
+	struct FView
+	{
+		uint64 FullResBytes = 0;        // results, Clarity, Durand — never lowered
+		uint64 BloomLensBytes = 0;      // at level 0
+
+		uint64 GetPeak(const FToneMapTransientBudgetState& State) const
+		{
+			return FullResBytes + BloomLensBytes / ((uint64)1 << (2 * State.Level));
+		}
+	};
+
+	struct FTrace
+	{
+		FToneMapTransientBudgetState State;
+		int32 NumDown = 0;
+		int32 NumUp = 0;
+		int32 LastChangeFrame = INDEX_NONE;
+
+		void Run(const FView& View, uint64 BudgetBytes, int32 NumFrames)
+		{
+			for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+			{
+				const int32 Before = State.Level;
+				State = FToneMapTransientTextures::StepBudget(State, View.GetPeak(State), BudgetBytes);
+				NumDown += State.Level > Before ? 1 : 0;
+				NumUp += State.Level < Before ? 1 : 0;
+				if (State.Level != Before)
+				{
+					LastChangeFrame = Frame;
+				}
+			}
+		}
+	};
+
+	// 4K: 64 MB of full-resolution targets and 48 MB of bloom / lens buffers
+	static const FView GView4K = { 64 * MB, 48 * MB };
+}
+
+// ---------------------------------------------------------------------------
+// Steps down until the peak fits, then holds
+// ---------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapTransientBudgetConvergenceTest, "ToneMapFX.TransientBudget.Convergence", GToneMapTransientBudgetTestFlags)
+
+bool FToneMapTransientBudgetConvergenceTest::RunTest(const FString& Parameters)
+{
+	using namespace ToneMapTransientBudgetTests;
+
+	// 112 MB at level 0, 76 MB at level 1, 67 MB at level 2
+	{
+		FTrace Trace;
+		Trace.Run(GView4K, 80 * MB, 200);
+		TestEqual(TEXT("80 MB budget: level"), Trace.State.Level, 1);
+		TestTrue(FString::Printf(TEXT("80 MB budget: peak %llu MB fits"), GView4K.GetPeak(Trace.State) / MB),
+			GView4K.GetPeak(Trace.State) <= 80 * MB);
+		TestEqual(TEXT("80 MB budget: steps back up"), Trace.NumUp, 0);
+		TestTrue(FString::Printf(TEXT("80 MB budget: settled by frame %d"), Trace.LastChangeFrame), Trace.LastChangeFrame < 2);
+	}
+	{
+		FTrace Trace;
+		Trace.Run(GView4K, 70 * MB, 200);
+		TestEqual(TEXT("70 MB budget: level"), Trace.State.Level, 2);
+		TestEqual(TEXT("70 MB budget: steps back up"), Trace.NumUp, 0);
+	}
+
+	// Below the full-resolution footprint the budget cannot be met: the view
+	// stops at MaxLevel instead of cycling
+	{
+		FTrace Trace;
+		Trace.Run(GView4K, 32 * MB, 200);
+		TestEqual(TEXT("Unreachable budget: level"), Trace.State.Level, FToneMapTransientBudgetState::MaxLevel);
+		TestEqual(TEXT("Unreachable budget: steps down"), Trace.NumDown, FToneMapTransientBudgetState::MaxLevel);
+		TestEqual(TEXT("Unreachable budget: steps back up"), Trace.NumUp, 0);
+	}
+
+	// No budget: nothing is lowered, and an earlier level is dropped
+	{
+		FTrace Trace;
+		Trace.State.Level = 2;
+		Trace.Run(GView4K, 0, 10);
+		TestEqual(TEXT("No budget: level"), Trace.State.Level, 0);
+	}
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// Climbs back once the saving fits again
+// ---------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapTransientBudgetRecoveryTest, "ToneMapFX.TransientBudget.Recovery", GToneMapTransientBudgetTestFlags)
+
+bool FToneMapTransientBudgetRecoveryTest::RunTest(const FString& Parameters)
+{
+	using namespace ToneMapTransientBudgetTests;
+
+	// Settle at level 2 under 70 MB, then raise the budget past the full cost
+	FTrace Trace;
+	Trace.Run(GView4K, 70 * MB, 50);
+	TestEqual(TEXT("Settled level"), Trace.State.Level, 2);
+
+	Trace.Run(GView4K, 128 * MB, 50);
+	TestEqual(TEXT("Raised budget: level"), Trace.State.Level, 0);
+
+	// A budget between two levels climbs to the one that fits and no further
+	Trace = FTrace();
+	Trace.Run(GView4K, 70 * MB, 50);
+	Trace.NumDown = Trace.NumUp = 0;
+	Trace.Run(GView4K, 80 * MB, 200);
+	TestEqual(TEXT("80 MB budget from level 2: level"), Trace.State.Level, 1);
+	TestEqual(TEXT("80 MB budget from level 2: steps up"), Trace.NumUp, 1);
+	TestEqual(TEXT("80 MB budget from level 2: steps down"), Trace.NumDown, 0);
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// ApplyBudget halves bloom and lens resolution per level
+// ---------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapTransientBudgetApplyTest, "ToneMapFX.TransientBudget.Apply", GToneMapTransientBudgetTestFlags)
+
+bool FToneMapTransientBudgetApplyTest::RunTest(const FString& Parameters)
+{
+	FToneMapResolvedQuality Base;
+	Base.BloomDownsampleScale = 1.0f;
+	Base.LensResolutionScale = 0.5f;
+	Base.KawaseMipCount = 6;
+	Base.CoronaSpikeLength = 64;
+
+	FToneMapTransientBudgetState State;
+	FToneMapResolvedQuality Quality = Base;
+	FToneMapTransientTextures::ApplyBudget(State, Quality);
+	TestEqual(TEXT("Level 0: bloom scale"), Quality.BloomDownsampleScale, Base.BloomDownsampleScale);
+	TestEqual(TEXT("Level 0: lens scale"), Quality.LensResolutionScale, Base.LensResolutionScale);
+	TestEqual(TEXT("Level 0: Kawase mips"), Quality.KawaseMipCount, Base.KawaseMipCount);
+
+	State.Level = 2;
+	Quality = Base;
+	FToneMapTransientTextures::ApplyBudget(State, Quality);
+	TestEqual(TEXT("Level 2: bloom scale"), Quality.BloomDownsampleScale, 0.25f);
+	TestEqual(TEXT("Level 2: lens scale"), Quality.LensResolutionScale, 0.125f);
+	TestEqual(TEXT("Level 2: Kawase mips keep the coarsest mip"), Quality.KawaseMipCount, 4);
+	TestEqual(TEXT("Level 2: spike length follows the lens buffer"), Quality.CoronaSpikeLength, 16);
+
+	// Floors keep the buffers from collapsing
+	State.Level = FToneMapTransientBudgetState::MaxLevel;
+	Quality = Base;
+	Quality.BloomDownsampleScale = 0.25f;
+	Quality.KawaseMipCount = 3;
+	FToneMapTransientTextures::ApplyBudget(State, Quality);
+	TestEqual(TEXT("Max level: bloom scale floor"), Quality.BloomDownsampleScale, 0.0625f);
+	TestEqual(TEXT("Max level: lens scale floor"), Quality.LensResolutionScale, 0.0625f);
+	TestEqual(TEXT("Max level: Kawase mip floor"), Quality.KawaseMipCount, 3);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,271 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapViewSetup.h"
+#include "HAL/PlatformTime.h"
+#include "RenderingThread.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static constexpr EAutomationTestFlags GToneMapViewSetupTestFlags =
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+// Wall-clock timings are noisy — run them with the perf tests
+static constexpr EAutomationTestFlags GToneMapViewSetupPerfTestFlags =
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter;
+
+namespace ToneMapViewSetupTests
+{
+	// A representative view: bloom at 1/4 with a 6-level Kawase chain, lens
+	// effects at half resolution.  Scene colour is padded and offset the way
+	// the engine hands it over with a shrunken editor viewport.
+	static FToneMapViewSetupKey MakeKey(FIntPoint Resolution)
+	{
+		FToneMapViewSetupKey Key;
+		Key.SceneColorExtent = Resolution + FIntPoint(64, 64);
+		Key.SceneColorRect = FIntRect(FIntPoint(8, 8), FIntPoint(8, 8) + Resolution);
+		Key.BloomDivisor = 4;
+		Key.KawaseMipCount = 6;
+		Key.LensResolutionScale = 0.5f;
+		return Key;
+	}
+
+	static FVector2f Apply(const FScreenTransform& Transform, FVector2f Position)
+	{
+		return Position * Transform.Scale + Transform.Bias;
+	}
+
+	static void TestExtent(FAutomationTestBase& Test, const TCHAR* What, FIntPoint Actual, FIntPoint Expected)
+	{
+		Test.TestTrue(FString::Printf(TEXT("%s is %dx%d (got %dx%d)"), What, Expected.X, Expected.Y, Actual.X, Actual.Y), Actual == Expected);
+	}
+
+	static void TestUV(FAutomationTestBase& Test, const TCHAR* What, FVector2f Actual, FVector2f Expected)
+	{
+		Test.TestTrue(FString::Printf(TEXT("%s maps to (%.6f, %.6f), got (%.6f, %.6f)"), What, Expected.X, Expected.Y, Actual.X, Actual.Y),
+			Actual.Equals(Expected, 1e-6f));
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Derived sizes and transforms
+// ---------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapViewSetupBuildTest, "ToneMapFX.ViewSetup.Build", GToneMapViewSetupTestFlags)
+
+bool FToneMapViewSetupBuildTest::RunTest(const FString& Parameters)
+{
+	using namespace ToneMapViewSetupTests;
+
+	const FToneMapViewSetupKey Key = MakeKey(FIntPoint(1920, 1080));
+	const FVector2f SceneColorExtent(Key.SceneColorExtent);
+
+	FToneMapViewSetup Setup;
+	Setup.Build(Key);
+
+	// Sizes
+	TestExtent(*this, TEXT("Bloom extent"), Setup.BloomExtent, FIntPoint(480, 270));
+	TestExtent(*this, TEXT("Working size"), Setup.WorkSize, FIntPoint(1920, 1080));
+	TestExtent(*this, TEXT("Lens size"), Setup.LensSize, FIntPoint(960, 540));
+
+	// Kawase pyramid: halved and rounded up per level
+	const FIntPoint MipExtents[] = { {240, 135}, {120, 68}, {60, 34}, {30, 17}, {15, 9}, {8, 5} };
+	if (TestEqual(TEXT("Kawase levels"), Setup.KawaseMips.Num(), (int32)UE_ARRAY_COUNT(MipExtents)))
+	{
+		for (int32 Level = 0; Level < Setup.KawaseMips.Num(); ++Level)
+		{
+			TestExtent(*this, *FString::Printf(TEXT("Kawase level %d"), Level), Setup.KawaseMips[Level].Extent, MipExtents[Level]);
+		}
+	}
+
+	// Transforms take texel centres to the matching point of the source
+	// viewport, including the (8, 8) offset of scene colour
+	TestUV(*this, TEXT("Bloom bright pass texel (0, 0)"), Apply(Setup.BloomBrightPassInputUV, FVector2f(0.5f)), FVector2f(10.0f) / SceneColorExtent);
+	TestUV(*this, TEXT("Bloom composite scene colour texel (10, 10)"), Apply(Setup.BloomCompositeBloomUV, FVector2f(10.0f)), FVector2f(0.5f / 480.0f, 0.5f / 270.0f));
+	TestUV(*this, TEXT("Kawase level 0 texel (0, 0)"), Apply(Setup.KawaseMips[0].SvPositionToSourceUV, FVector2f(0.5f)), FVector2f(12.0f) / SceneColorExtent);
+	TestUV(*this, TEXT("Kawase level 1 texel (0, 0)"), Apply(Setup.KawaseMips[1].SvPositionToSourceUV, FVector2f(0.5f)), FVector2f(1.0f / 240.0f, 1.0f / 135.0f));
+	TestUV(*this, TEXT("Working texel (0, 0)"), Apply(Setup.WorkSceneColorUV, FVector2f(0.5f)), FVector2f(8.5f) / SceneColorExtent);
+	TestUV(*this, TEXT("Lens texel (0, 0)"), Apply(Setup.LensBufferSceneColorUV, FVector2f(0.5f)), FVector2f(9.0f) / SceneColorExtent);
+
+	// Main pass into an offset output viewport (OverrideOutput)
+	const FIntRect OutputRect(FIntPoint(100, 50), FIntPoint(2020, 1130));
+	Setup.UpdateOutput(Key.SceneColorExtent, FIntPoint(2020, 1130), OutputRect);
+	TestUV(*this, TEXT("Output pixel (100, 50) into scene colour"), Apply(Setup.OutputSceneColorUV, FVector2f(100.5f, 50.5f)), FVector2f(8.5f) / SceneColorExtent);
+	TestUV(*this, TEXT("Output pixel (100, 50) into the working size"), Apply(Setup.OutputWorkUV, FVector2f(100.5f, 50.5f)), FVector2f(0.5f / 1920.0f, 0.5f / 1080.0f));
+
+	// Same output again keeps the transforms; a new one recomputes them
+	const uint32 OutputHash = Setup.OutputHash;
+	Setup.UpdateOutput(Key.SceneColorExtent, FIntPoint(2020, 1130), OutputRect);
+	TestTrue(TEXT("Unchanged output keeps its hash"), Setup.OutputHash == OutputHash);
+	Setup.UpdateOutput(Key.SceneColorExtent, FIntPoint(1920, 1080), FIntRect(FIntPoint::ZeroValue, FIntPoint(1920, 1080)));
+	TestTrue(TEXT("New output rehashes"), Setup.OutputHash != OutputHash);
+
+	// Key hash follows every input
+	FToneMapViewSetupKey Other = Key;
+	TestTrue(TEXT("Equal keys hash equally"), Other.GetHash() == Key.GetHash());
+	Other.KawaseMipCount = 5;
+	TestTrue(TEXT("Kawase level count changes the hash"), Other.GetHash() != Key.GetHash());
+	Other = Key;
+	Other.LensResolutionScale = 0.25f;
+	TestTrue(TEXT("Lens resolution changes the hash"), Other.GetHash() != Key.GetHash());
+
+	// Empty viewport: nothing is derived
+	FToneMapViewSetupKey EmptyKey = Key;
+	EmptyKey.SceneColorRect = FIntRect(FIntPoint(8, 8), FIntPoint(8, 8));
+	FToneMapViewSetup Empty;
+	Empty.Build(EmptyKey);
+	TestExtent(*this, TEXT("Empty viewport bloom extent"), Empty.BloomExtent, FIntPoint::ZeroValue);
+	TestExtent(*this, TEXT("Empty viewport working size"), Empty.WorkSize, FIntPoint::ZeroValue);
+	TestEqual(TEXT("Empty viewport Kawase levels"), Empty.KawaseMips.Num(), 0);
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// Cache — rebuilt only when the key changes; static indexed names
+// ---------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapViewSetupCacheTest, "ToneMapFX.ViewSetup.Cache", GToneMapViewSetupTestFlags)
+
+bool FToneMapViewSetupCacheTest::RunTest(const FString& Parameters)
+{
+	using namespace ToneMapViewSetupTests;
+
+	// Build() clears OutputHash, so a marker left in it shows whether the
+	// entry was rebuilt
+	constexpr uint32 Marker = 0xC0FFEEu;
+
+	struct FResults
+	{
+		bool bSameEntry = false;
+		bool bKeptOnSameKey = false;
+		bool bRebuiltOnNewKey = false;
+		bool bNewKeyApplied = false;
+		bool bViewsSeparate = false;
+	} Results;
+
+	ENQUEUE_RENDER_COMMAND(ToneMapViewSetupCache)([&Results](FRHICommandListImmediate&)
+	{
+		const FToneMapViewSetupKey Key = MakeKey(FIntPoint(1920, 1080));
+		FToneMapViewSetupCache Cache;
+
+		FToneMapViewSetup& First = Cache.Get_RenderThread(1, Key);
+		First.OutputHash = Marker;
+
+		FToneMapViewSetup& Second = Cache.Get_RenderThread(1, Key);
+		Results.bSameEntry = &First == &Second;
+		Results.bKeptOnSameKey = Second.OutputHash == Marker;
+
+		const FToneMapViewSetupKey Resized = MakeKey(FIntPoint(1280, 720));
+		FToneMapViewSetup& Rebuilt = Cache.Get_RenderThread(1, Resized);
+		Results.bRebuiltOnNewKey = Rebuilt.OutputHash != Marker;
+		Results.bNewKeyApplied = Rebuilt.WorkSize == FIntPoint(1280, 720);
+
+		FToneMapViewSetup& OtherView = Cache.Get_RenderThread(2, Key);
+		Results.bViewsSeparate = &OtherView != &Cache.Get_RenderThread(1, Resized) && OtherView.WorkSize == FIntPoint(1920, 1080);
+	});
+	FlushRenderingCommands();
+
+	TestTrue(TEXT("Same view and key returns the same entry"), Results.bSameEntry);
+	TestTrue(TEXT("Same key is not rebuilt"), Results.bKeptOnSameKey);
+	TestTrue(TEXT("Changed key is rebuilt"), Results.bRebuiltOnNewKey);
+	TestTrue(TEXT("Rebuilt entry follows the new key"), Results.bNewKeyApplied);
+	TestTrue(TEXT("Views have separate entries"), Results.bViewsSeparate);
+
+	// Names come from one table: stable pointers, RDG keeps them until execution
+	TestEqual(TEXT("Streak name"), FString(FToneMapPassNames::GetTextureName(EToneMapIndexedName::GlareStreak, 3)), FString(TEXT("ClassicBloom.Streak3")));
+	TestEqual(TEXT("Kawase upsample name"), FString(FToneMapPassNames::GetTextureName(EToneMapIndexedName::KawaseUpsample, 5)), FString(TEXT("ClassicBloom.KawaseUpsample5")));
+	TestTrue(TEXT("Names are not reformatted"),
+		FToneMapPassNames::GetTextureName(EToneMapIndexedName::KawaseMip, 2) == FToneMapPassNames::GetTextureName(EToneMapIndexedName::KawaseMip, 2));
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// Cost — rebuilt from scratch with per-frame name formatting, as before the
+// cache, versus served from the cache, in microseconds per view
+// ---------------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToneMapViewSetupCostTest, "ToneMapFX.ViewSetup.Cost", GToneMapViewSetupPerfTestFlags)
+
+bool FToneMapViewSetupCostTest::RunTest(const FString& Parameters)
+{
+	using namespace ToneMapViewSetupTests;
+
+	static const FIntPoint Resolutions[] = { {1280, 720}, {1920, 1080}, {2560, 1440}, {3840, 2160} };
+	constexpr int32 NumResolutions = UE_ARRAY_COUNT(Resolutions);
+	constexpr int32 Iterations = 10000;
+	constexpr int32 NumStreaks = 8;
+
+	struct FResults
+	{
+		double UncachedUs[NumResolutions] = {};
+		double CachedUs[NumResolutions] = {};
+		double Sink = 0.0;
+	} Results;
+
+	ENQUEUE_RENDER_COMMAND(ToneMapViewSetupCost)([&Results](FRHICommandListImmediate&)
+	{
+		for (int32 ResolutionIndex = 0; ResolutionIndex < NumResolutions; ++ResolutionIndex)
+		{
+			const FIntPoint Resolution = Resolutions[ResolutionIndex];
+			const FToneMapViewSetupKey Key = MakeKey(Resolution);
+			const FIntRect OutputRect(FIntPoint::ZeroValue, Resolution);
+
+			// Uncached: derive everything and format every indexed name
+			FToneMapViewSetup Scratch;
+			const uint64 UncachedStart = FPlatformTime::Cycles64();
+			for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+			{
+				Scratch.Build(Key);
+				Scratch.UpdateOutput(Key.SceneColorExtent, Resolution, OutputRect);
+				for (int32 i = 0; i < NumStreaks; ++i)
+				{
+					Results.Sink += FString::Printf(TEXT("ClassicBloom.Streak%d"), i).Len();
+				}
+				for (int32 i = 0; i < Key.KawaseMipCount; ++i)
+				{
+					Results.Sink += FString::Printf(TEXT("ClassicBloom.KawaseMip%d"), i).Len();
+					Results.Sink += FString::Printf(TEXT("ClassicBloom.KawaseUpsample%d"), i).Len();
+				}
+				Results.Sink += Scratch.OutputWorkUV.Scale.X;
+			}
+			Results.UncachedUs[ResolutionIndex] = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - UncachedStart) * 1.0e6 / Iterations;
+
+			// Cached: hash, lookup and static names
+			FToneMapViewSetupCache Cache;
+			const uint64 CachedStart = FPlatformTime::Cycles64();
+			for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+			{
+				FToneMapViewSetup& Setup = Cache.Get_RenderThread(0, Key);
+				Setup.UpdateOutput(Key.SceneColorExtent, Resolution, OutputRect);
+				for (int32 i = 0; i < NumStreaks; ++i)
+				{
+					Results.Sink += *FToneMapPassNames::GetTextureName(EToneMapIndexedName::GlareStreak, i);
+				}
+				for (int32 i = 0; i < Key.KawaseMipCount; ++i)
+				{
+					Results.Sink += *FToneMapPassNames::GetTextureName(EToneMapIndexedName::KawaseMip, i);
+					Results.Sink += *FToneMapPassNames::GetTextureName(EToneMapIndexedName::KawaseUpsample, i);
+				}
+				Results.Sink += Setup.OutputWorkUV.Scale.X;
+			}
+			Results.CachedUs[ResolutionIndex] = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - CachedStart) * 1.0e6 / Iterations;
+		}
+	});
+	FlushRenderingCommands();
+
+	AddInfo(FString::Printf(TEXT("Pass setup on the render thread, mean of %d (checksum %.0f):"), Iterations, Results.Sink));
+	for (int32 ResolutionIndex = 0; ResolutionIndex < NumResolutions; ++ResolutionIndex)
+	{
+		const FIntPoint Resolution = Resolutions[ResolutionIndex];
+		const double Uncached = Results.UncachedUs[ResolutionIndex];
+		const double Cached = Results.CachedUs[ResolutionIndex];
+		AddInfo(FString::Printf(TEXT("  %4dx%-4d  uncached %6.3f us/view, cached %6.3f us/view"), Resolution.X, Resolution.Y, Uncached, Cached));
+
+		// The cache skips the transforms and all the formatting
+		TestTrue(FString::Printf(TEXT("%dx%d cached setup (%.3f us) cheaper than rebuilding (%.3f us)"), Resolution.X, Resolution.Y, Cached, Uncached),
+			Cached < Uncached);
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
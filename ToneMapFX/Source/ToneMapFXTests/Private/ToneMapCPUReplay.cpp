@@ -0,0 +1,261 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapCPUReplay.h"
+#include "ToneMapComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+FToneMapReferenceSettings FToneMapCPUReplay::MakeReferenceSettings(const UToneMapComponent& Settings, const FToneMapCaptureView& View)
+{
+	using namespace ToneMapColorMath;
+
+	// Parameters as the bloom, Durand, Fattal, lens and process stages bind them
+	const FToneMapResolvedQuality& Quality = View.Quality;
+	FToneMapReferenceSettings S;
+
+	S.FilmCurve = (int32)Settings.FilmCurve;
+	S.HableParams1 = float4(Settings.HableShoulderStrength, Settings.HableLinearStrength, Settings.HableLinearAngle, Settings.HableToeStrength);
+	S.HableParams2 = float4(Settings.HableToeNumerator, Settings.HableToeDenominator, Settings.HableWhitePoint, 0.0f);
+	S.ReinhardWhitePoint = Settings.ReinhardWhitePoint;
+	S.AgXParams = float4(Settings.AgXMinEV, Settings.AgXMaxEV, (float)static_cast<uint8>(Settings.AgXLook), 0.0f);
+
+	S.Temperature = Settings.bEnableWhiteBalance ? Settings.Temperature : 0.0f;
+	S.Tint = Settings.bEnableWhiteBalance ? Settings.Tint : 0.0f;
+	S.Exposure = Settings.Exposure;
+	if (Settings.bUseCameraExposure)
+	{
+		const float N = FMath::Max(Settings.Aperture, 1.0f);
+		const float T = 1.0f / FMath::Max(Settings.ShutterSpeedDenominator, 1.0f);
+		const float ISO = FMath::Max(Settings.CameraISO, 1.0f);
+		const float EV100 = FMath::Log2(N * N / T) + FMath::Log2(100.0f / ISO);
+		const float ReferenceEV = FMath::Log2(5.6f * 5.6f / (1.0f / 125.0f));
+		S.Exposure += ReferenceEV - EV100;
+	}
+	S.Contrast = Settings.Contrast;
+	S.ContrastMidpoint = Settings.ContrastMidpoint;
+	S.Highlights = Settings.bEnableToneAdjustments ? Settings.Highlights : 0.0f;
+	S.Shadows = Settings.bEnableToneAdjustments ? Settings.Shadows : 0.0f;
+	S.Whites = Settings.bEnableToneAdjustments ? Settings.Whites : 0.0f;
+	S.Blacks = Settings.bEnableToneAdjustments ? Settings.Blacks : 0.0f;
+	S.ToneSmoothing = Settings.ToneSmoothing;
+	S.Vibrance = Settings.Vibrance;
+	S.Saturation = Settings.Saturation;
+	S.HDRSaturation = Settings.HDRSaturation;
+	S.HDRColorBalance = float3(Settings.HDRColorBalance.R, Settings.HDRColorBalance.G, Settings.HDRColorBalance.B);
+	S.bEnableCurves = Settings.IsAnyCurveActive();
+	S.ToneCurveParams = float4(Settings.CurveHighlights, Settings.CurveLights, Settings.CurveDarks, Settings.CurveShadows);
+	S.bHalfPrecision = View.bHalfPrecision;
+
+	S.Bloom = Settings.bEnableBloom ? (EToneMapReferenceBloom)((int32)Settings.BloomMode + 1) : EToneMapReferenceBloom::None;
+	S.BloomIntensity = Settings.BloomIntensity;
+	S.BloomThreshold = Settings.BloomThreshold;
+	S.BloomThresholdSoftness = Settings.BloomThresholdSoftness;
+	S.BloomMaxBrightness = Settings.BloomMaxBrightness;
+	S.BloomSize = Settings.BloomSize;
+	S.BloomBlendMode = (int32)Settings.BloomBlendMode;
+	S.BloomSaturation = Settings.BloomSaturation;
+	S.BloomDownsampleDivisor = FMath::Max(1, FMath::RoundToInt(2.0f / FMath::Max(Quality.BloomDownsampleScale, 0.01f)));
+	S.BloomBlurPasses = Quality.BloomBlurPasses;
+	S.SoftFocusParams = float4(Settings.SoftFocusOverlayMultiplier, Settings.SoftFocusBlendStrength,
+		Settings.SoftFocusSoftLightMultiplier, Settings.SoftFocusFinalBlend);
+	S.GlareStreakCount = FMath::Clamp(Settings.GlareStreakCount, 2, 16);
+	S.GlareStreakLength = FMath::Clamp((float)Settings.GlareStreakLength, 5.0f, 200.0f);
+	S.GlareFalloff = Settings.GlareFalloff;
+	S.GlareSamples = Quality.GlareSamples;
+	S.KawaseMipCount = Quality.KawaseMipCount;
+	S.KawaseFilterRadius = Settings.KawaseFilterRadius;
+	S.KawaseThresholdKnee = Settings.bKawaseSoftThreshold ? FMath::Clamp(Settings.KawaseThresholdKnee, 0.0f, 1.0f) : 0.0f;
+
+	S.DurandSpatialSigma = Settings.DurandSpatialSigma;
+	S.DurandRangeSigma = Settings.DurandRangeSigma;
+	S.DurandBaseCompression = Settings.DurandBaseCompression;
+	S.DurandDetailBoost = Settings.DurandDetailBoost;
+
+	S.FattalAlpha = Settings.FattalAlpha;
+	S.FattalBeta = Settings.FattalBeta;
+	S.FattalSaturation = Settings.FattalSaturation;
+	S.FattalNoise = Settings.FattalNoise;
+	S.FattalIterations = Quality.FattalIterations;
+
+	S.bEnableCorona = Settings.bEnableCiliaryCorona;
+	S.CoronaIntensity = Settings.CoronaIntensity;
+	S.CoronaSpikeCount = Settings.CoronaSpikeCount;
+	S.CoronaSpikeLength = Quality.CoronaSpikeLength;
+	S.CoronaThreshold = Settings.CoronaThreshold;
+	S.bEnableHalo = Settings.bEnableLenticularHalo;
+	S.HaloIntensity = Settings.HaloIntensity;
+	S.HaloRadius = Settings.HaloRadius;
+	S.HaloThickness = Settings.HaloThickness;
+	S.HaloThreshold = Settings.HaloThreshold;
+	S.HaloTint = float3(Settings.HaloTint.R, Settings.HaloTint.G, Settings.HaloTint.B);
+	S.HaloAngularSamples = Quality.HaloAngularSamples;
+	S.LensResolutionScale = Quality.LensResolutionScale;
+
+	return S;
+}
+
+void FToneMapCPUReplay::PrepareInput(const FToneMapCaptureData& Capture, FToneMapReferenceImage& OutSceneColor)
+{
+	using namespace ToneMapColorMath;
+
+	const UToneMapComponent& Settings = *Capture.Settings;
+	const FToneMapCaptureView& View = Capture.View;
+
+	// ToneMapProcess.usf steps 1-3.  The reference pipeline works on exposed
+	// scene-linear colour throughout, so exposure is applied before bloom and
+	// Durand / Fattal here, where the GPU only removes pre-exposure.
+	float AutoExposure = 1.0f;
+	if (Settings.AutoExposureMode == EToneMapAutoExposure::Krawczyk && View.AdaptedLuminance >= 0.0f)
+	{
+		const float SceneKey = 1.03f - 2.0f / (2.0f + FMath::Log2(View.AdaptedLuminance + 1.0f));
+		AutoExposure = FMath::Clamp(SceneKey / FMath::Max(View.AdaptedLuminance, 0.0001f), Settings.MinAutoExposure, Settings.MaxAutoExposure);
+	}
+	else if (Settings.AutoExposureMode == EToneMapAutoExposure::EngineDefault)
+	{
+		AutoExposure = FMath::Max(View.EyeAdaptationExposure, 0.001f);
+	}
+	const float Scale = AutoExposure / FMath::Max(View.PreExposure, 0.001f);
+
+	OutSceneColor = Capture.SceneColor;
+	for (int32 i = 0; i < OutSceneColor.Pixels.Num(); ++i)
+	{
+		float3 Color = OutSceneColor.Pixels[i];
+		if (View.bEngineBloom)
+		{
+			Color += Capture.Bloom.Pixels[i];
+		}
+		OutSceneColor.Pixels[i] = Color * Scale;
+	}
+}
+
+bool FToneMapCPUReplay::Run(const FString& Directory, int32 Iterations)
+{
+	using namespace ToneMapColorMath;
+
+	FToneMapCaptureData Capture;
+	if (!FToneMapReplay::Load(Directory, Capture))
+	{
+		return false;
+	}
+	if (!Capture.View.bReplaceTonemap)
+	{
+		// Post Process mode grades the engine's tonemapped output — not what the reference models
+		UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: %s was captured in Post Process mode; the CPU reference replays Replace Tonemapper captures only"), *Directory);
+		return false;
+	}
+
+	const FToneMapReferenceSettings Settings = MakeReferenceSettings(*Capture.Settings, Capture.View);
+	const bool bDurand = Settings.FilmCurve == 4;
+	const bool bFattal = Settings.FilmCurve == 5;
+
+	FToneMapReferenceImage Input;
+	PrepareInput(Capture, Input);
+
+	// Same order as FToneMapReferencePipeline::Run, timed per stage
+	enum EReplayStage { Bloom, PreToneMap, Lens, Grading, NumStages };
+	static const TCHAR* const StageNames[NumStages] = { TEXT("Bloom"), TEXT("PreToneMap"), TEXT("Lens"), TEXT("Grading") };
+	double StageSeconds[NumStages] = {};
+
+	Iterations = FMath::Max(Iterations, 1);
+	FToneMapReferenceImage Output;
+	for (int32 It = 0; It < Iterations; ++It)
+	{
+		double Time = FPlatformTime::Seconds();
+		auto Lap = [&Time, &StageSeconds](EReplayStage Stage)
+		{
+			const double Now = FPlatformTime::Seconds();
+			StageSeconds[Stage] += Now - Time;
+			Time = Now;
+		};
+
+		FToneMapReferenceImage Scene = Input;
+		FToneMapReferencePipeline::ApplyBloom(Scene, Settings);
+		Lap(Bloom);
+
+		FToneMapReferenceImage PreToneMapped;
+		if (bDurand)
+		{
+			FToneMapReferencePipeline::RenderDurand(Scene, Settings, PreToneMapped);
+		}
+		else if (bFattal)
+		{
+			FToneMapReferencePipeline::RenderFattal(Scene, Settings, PreToneMapped);
+		}
+		Lap(PreToneMap);
+
+		FToneMapReferencePipeline::ApplyLensEffects(Scene, Settings);
+		Lap(Lens);
+
+		FToneMapReferencePipeline::ApplyGrading(Scene, (bDurand || bFattal) ? &PreToneMapped : nullptr, Settings, Output);
+		Lap(Grading);
+	}
+
+	// Outputs that depend only on the capture — byte-identical between runs
+	bool bWritten = Output.SaveToFile(FPaths::Combine(Directory, TEXT("Replay.exr")));
+
+	FToneMapReferenceImage Thumb;
+	FToneMapReferenceSuite::MakeThumbnail(Output, Thumb);
+	TArray<FString> Lines;
+	Lines.Add(FString::Printf(TEXT("# ToneMapFX replay: %dx%d capture, %dx%d thumbnail"),
+		Capture.View.ViewSize.X, Capture.View.ViewSize.Y, Thumb.Width, Thumb.Height));
+	Lines.Add(TEXT("X,Y,R,G,B"));
+	for (int32 Y = 0; Y < Thumb.Height; ++Y)
+	{
+		for (int32 X = 0; X < Thumb.Width; ++X)
+		{
+			const float3& C = Thumb.At(X, Y);
+			Lines.Add(FString::Printf(TEXT("%d,%d,%.6f,%.6f,%.6f"), X, Y, C.x, C.y, C.z));
+		}
+	}
+	bWritten &= FFileHelper::SaveStringArrayToFile(Lines, *FPaths::Combine(Directory, TEXT("Replay.csv")));
+
+	// Timings vary run to run, so they live in their own file
+	const double MegaPixels = (double)Input.Pixels.Num() / 1.0e6;
+	double TotalMs = 0.0;
+	TArray<FString> Entries;
+	UE_LOG(LogTemp, Log, TEXT("ToneMapFX: CPU replay of %s, %dx%d, %d iteration(s)"),
+		*Directory, Capture.View.ViewSize.X, Capture.View.ViewSize.Y, Iterations);
+	for (int32 Stage = 0; Stage < NumStages; ++Stage)
+	{
+		const double Ms = StageSeconds[Stage] * 1000.0 / (double)Iterations;
+		TotalMs += Ms;
+		UE_LOG(LogTemp, Log, TEXT("ToneMapFX:   %-12s %9.2f ms"), StageNames[Stage], Ms);
+		Entries.Add(FString::Printf(TEXT("    \"%s\": %.4f"), StageNames[Stage], Ms));
+	}
+	UE_LOG(LogTemp, Log, TEXT("ToneMapFX:   %-12s %9.2f ms  %6.2f Mpix/s"), TEXT("Total"), TotalMs, MegaPixels / FMath::Max(TotalMs / 1000.0, 1e-9));
+
+	const FString Json = FString::Printf(TEXT("{\n  \"width\": %d,\n  \"height\": %d,\n  \"iterations\": %d,\n  \"totalMs\": %.4f,\n  \"cpuMs\": {\n%s\n  }\n}\n"),
+		Capture.View.ViewSize.X, Capture.View.ViewSize.Y, Iterations, TotalMs, *FString::Join(Entries, TEXT(",\n")));
+	bWritten &= FFileHelper::SaveStringToFile(Json, *FPaths::Combine(Directory, TEXT("ReplayTimings.json")));
+
+	return bWritten;
+}
+
+static FAutoConsoleCommand CmdToneMapReplay(
+	TEXT("r.ToneMapFX.Replay"),
+	TEXT("Replay a r.ToneMapFX.Capture (name or directory).\n")
+	TEXT("  r.ToneMapFX.Replay <capture> [iterations]  CPU reference pipeline, writes Replay.exr / Replay.csv and ReplayTimings.json\n")
+	TEXT("  r.ToneMapFX.Replay <capture> gpu [frames]  feed the capture into the live view (same size) and log GPU stage timings"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if (Args.Num() == 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: usage: r.ToneMapFX.Replay <capture> [iterations | gpu [frames]]"));
+			return;
+		}
+
+		const FString Directory = FToneMapReplay::ResolveCaptureDirectory(Args[0]);
+		if (Args.Num() > 1 && Args[1] == TEXT("gpu"))
+		{
+			FToneMapReplay::RequestGPU(Directory, Args.Num() > 2 ? FCString::Atoi(*Args[2]) : 60);
+			return;
+		}
+
+		const int32 Iterations = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 3;
+		if (!FToneMapCPUReplay::Run(Directory, Iterations))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: CPU replay of %s failed"), *Directory);
+		}
+	}));
@@ -0,0 +1,118 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapColorMathGolden.h"
+#include "HAL/IConsoleManager.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+FString FToneMapColorMathGolden::GetPath()
+{
+	return FPaths::Combine(
+		IPluginManager::Get().FindPlugin(TEXT("ToneMapFX"))->GetBaseDir(),
+		TEXT("Source"), TEXT("ToneMapFXTests"), TEXT("Resources"), TEXT("ColorMathGolden.csv"));
+}
+
+bool FToneMapColorMathGolden::Write(const FString& Path)
+{
+	using namespace ToneMapColorMath;
+
+	const int32 NumOperators = FToneMapColorMath::GetNumOperators();
+	constexpr int32 LatticeSize = FToneMapColorMath::LatticeSize;
+
+	TArray<FString> Lines;
+	Lines.Reserve(NumOperators * LatticeSize + 2);
+	Lines.Add(FString::Printf(TEXT("# ToneMapColorMath.ush golden table: %d operators x %d lattice colours"), NumOperators, LatticeSize));
+	Lines.Add(TEXT("Operator,Index,R,G,B"));
+
+	for (int32 Operator = 0; Operator < NumOperators; ++Operator)
+	{
+		for (int32 Index = 0; Index < LatticeSize; ++Index)
+		{
+			const float3 Out = FToneMapColorMath::EvaluateOperator(Operator, FToneMapColorMath::GetLatticeColor(Index));
+			Lines.Add(FString::Printf(TEXT("%s,%d,%.7g,%.7g,%.7g"), FToneMapColorMath::GetOperatorName(Operator), Index, Out.x, Out.y, Out.z));
+		}
+	}
+
+	return FFileHelper::SaveStringArrayToFile(Lines, *Path);
+}
+
+bool FToneMapColorMathGolden::Load(const FString& Path, TArray<ToneMapColorMath::float3>& OutExpected)
+{
+	using namespace ToneMapColorMath;
+
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *Path))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: colour math golden %s not found"), *Path);
+		return false;
+	}
+
+	const int32 NumOperators = FToneMapColorMath::GetNumOperators();
+	constexpr int32 LatticeSize = FToneMapColorMath::LatticeSize;
+
+	TMap<FString, int32> OperatorIndex;
+	for (int32 Operator = 0; Operator < NumOperators; ++Operator)
+	{
+		OperatorIndex.Add(FToneMapColorMath::GetOperatorName(Operator), Operator);
+	}
+
+	OutExpected.Reset();
+	OutExpected.SetNumZeroed(NumOperators * LatticeSize);
+	TBitArray<> Seen(false, OutExpected.Num());
+
+	for (const FString& Line : Lines)
+	{
+		if (Line.IsEmpty() || Line.StartsWith(TEXT("#")) || Line.StartsWith(TEXT("Operator")))
+		{
+			continue;
+		}
+
+		TArray<FString> Fields;
+		Line.ParseIntoArray(Fields, TEXT(","));
+		const int32* Operator = Fields.Num() == 5 ? OperatorIndex.Find(Fields[0]) : nullptr;
+		const int32 Index = Fields.Num() == 5 ? FCString::Atoi(*Fields[1]) : -1;
+		if (!Operator || Index < 0 || Index >= LatticeSize)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: malformed colour math golden row '%s'"), *Line);
+			return false;
+		}
+
+		const int32 Row = *Operator * LatticeSize + Index;
+		OutExpected[Row] = float3(FCString::Atof(*Fields[2]), FCString::Atof(*Fields[3]), FCString::Atof(*Fields[4]));
+		Seen[Row] = true;
+	}
+
+	const int32 NumMissing = Seen.Num() - Seen.CountSetBits();
+	if (NumMissing != 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: colour math golden misses %d of %d rows — regenerate it"), NumMissing, Seen.Num());
+		return false;
+	}
+	return true;
+}
+
+float FToneMapColorMathGolden::GetError(const ToneMapColorMath::float3& Actual, const ToneMapColorMath::float3& Expected)
+{
+	using namespace ToneMapColorMath;
+
+	const float3 Diff = abs(Actual - Expected) / max(abs(Expected), 1.0f);
+	return FMath::Max3(Diff.x, Diff.y, Diff.z);
+}
+
+static FAutoConsoleCommand CmdToneMapColorMathGolden(
+	TEXT("r.ToneMapFX.ColorMathGolden"),
+	TEXT("'r.ToneMapFX.ColorMathGolden write' regenerates Resources/ColorMathGolden.csv of ToneMapFXTests from\n")
+	TEXT("the current ToneMapColorMath.ush operators.  The ToneMapFX.ColorMath automation tests check against it."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if (Args.Num() == 0 || Args[0] != TEXT("write"))
+		{
+			UE_LOG(LogTemp, Log, TEXT("ToneMapFX: run 'Automation RunTests ToneMapFX.ColorMath' to check the colour math, 'r.ToneMapFX.ColorMathGolden write' to regenerate"));
+			return;
+		}
+
+		const FString Path = FToneMapColorMathGolden::GetPath();
+		const bool bWritten = FToneMapColorMathGolden::Write(Path);
+		UE_LOG(LogTemp, Log, TEXT("ToneMapFX: %s colour math golden %s"), bWritten ? TEXT("wrote") : TEXT("could not write"), *Path);
+	}));
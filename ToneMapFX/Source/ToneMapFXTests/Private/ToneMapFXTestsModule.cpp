@@ -0,0 +1,5 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "Modules/ModuleManager.h"
+
+IMPLEMENT_MODULE(FDefaultModuleImpl, ToneMapFXTests)
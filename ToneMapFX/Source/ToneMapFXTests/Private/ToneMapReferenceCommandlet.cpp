@@ -0,0 +1,44 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapReferenceCommandlet.h"
+#include "ToneMapReferencePipeline.h"
+
+UToneMapFXReferenceCommandlet::UToneMapFXReferenceCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UToneMapFXReferenceCommandlet::Main(const FString& Params)
+{
+	FString GoldenPath = FToneMapReferenceSuite::GetGoldenPath();
+	FString PerfPath = FToneMapReferenceSuite::GetPerfPath();
+	int32 Iterations = 5;
+
+	FParse::Value(*Params, TEXT("golden="), GoldenPath);
+	FParse::Value(*Params, TEXT("perf="), PerfPath);
+	FParse::Value(*Params, TEXT("iterations="), Iterations);
+
+	if (FParse::Param(*Params, TEXT("write")))
+	{
+		if (!FToneMapReferenceSuite::WriteGolden(GoldenPath))
+		{
+			UE_LOG(LogTemp, Error, TEXT("ToneMapFX: could not write reference golden %s"), *GoldenPath);
+			return 1;
+		}
+		UE_LOG(LogTemp, Display, TEXT("ToneMapFX: wrote reference golden %s"), *GoldenPath);
+		return 0;
+	}
+
+	const int32 NumFailures = FToneMapReferenceSuite::Run(GoldenPath, PerfPath, Iterations);
+	if (NumFailures != 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("ToneMapFX: CPU reference suite FAILED (%d)"), NumFailures);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("ToneMapFX: CPU reference suite passed, throughput in %s"), *PerfPath);
+	return 0;
+}
@@ -0,0 +1,1062 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapReferencePipeline.h"
+#include "ToneMapGaussianBlur.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+// ---------------------------------------------------------------------------
+// Shader helpers that are not part of ToneMapColorMath.ush
+// ---------------------------------------------------------------------------
+
+static float ReferenceMax3(const ToneMapColorMath::float3& C)
+{
+	return FMath::Max3(C.x, C.y, C.z);
+}
+
+// ClassicBloom / Kawase luma weights
+static float ReferenceBloomLuma(const ToneMapColorMath::float3& C)
+{
+	return C.x * 0.299f + C.y * 0.587f + C.z * 0.114f;
+}
+
+static ToneMapColorMath::float3 ReferenceStep(float Edge, const ToneMapColorMath::float3& X)
+{
+	return ToneMapColorMath::float3(X.x >= Edge ? 1.0f : 0.0f, X.y >= Edge ? 1.0f : 0.0f, X.z >= Edge ? 1.0f : 0.0f);
+}
+
+// SoftKneeThreshold (ClassicBloomShaders.usf) and SoftThreshold (ClassicBloomKawase.usf)
+static ToneMapColorMath::float3 ReferenceSoftKnee(const ToneMapColorMath::float3& Color, float Threshold, float Knee)
+{
+	const float Brightness = ReferenceMax3(Color);
+	float Soft = FMath::Clamp(Brightness - Threshold + Knee, 0.0f, 2.0f * Knee);
+	Soft = Soft * Soft / (4.0f * Knee + 0.00001f);
+	const float Contribution = FMath::Max(Soft, Brightness - Threshold) / FMath::Max(Brightness, 0.00001f);
+	return Color * FMath::Max(Contribution, 0.0f);
+}
+
+// ApplyBloomBlendMode (ClassicBloomComposite.usf)
+static ToneMapColorMath::float3 ReferenceBloomBlend(const ToneMapColorMath::float3& Base, const ToneMapColorMath::float3& Blend, int32 Mode)
+{
+	using namespace ToneMapColorMath;
+
+	if (Mode == 0)
+	{
+		return Base + Blend * max(1.0f - Base, 0.0f);
+	}
+
+	const float3 BaseLDR = saturate(Base);
+	const float3 BlendLDR = saturate(Blend);
+	const float3 BaseHDRExcess = max(Base - 1.0f, 0.0f);
+
+	switch (Mode)
+	{
+	case 1:
+		return lerp(2.0f * BaseLDR * BlendLDR, 1.0f - 2.0f * (1.0f - BaseLDR) * (1.0f - BlendLDR), ReferenceStep(0.5f, BaseLDR)) + BaseHDRExcess;
+	case 2:
+	{
+		const float3 SqrtBase(FMath::Sqrt(BaseLDR.x), FMath::Sqrt(BaseLDR.y), FMath::Sqrt(BaseLDR.z));
+		return lerp(2.0f * BaseLDR * BlendLDR + BaseLDR * BaseLDR * (1.0f - 2.0f * BlendLDR),
+			SqrtBase * (2.0f * BlendLDR - 1.0f) + 2.0f * BaseLDR * (1.0f - BlendLDR),
+			ReferenceStep(0.5f, BlendLDR)) + BaseHDRExcess;
+	}
+	case 3:
+		return lerp(2.0f * BaseLDR * BlendLDR, 1.0f - 2.0f * (1.0f - BaseLDR) * (1.0f - BlendLDR), ReferenceStep(0.5f, BlendLDR)) + BaseHDRExcess;
+	case 4:
+		return max(Base, Blend);
+	case 5:
+		return Base * Blend;
+	default:
+		return Base + Blend;
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Bloom — bright pass, Gaussian / glare / Kawase, composite
+// ---------------------------------------------------------------------------
+
+void FToneMapReferencePipeline::GaussianBlur(FToneMapReferenceImage& Image, float Sigma)
+{
+	using namespace ToneMapColorMath;
+
+	const FToneMapGaussianKernel Kernel = FToneMapGaussianKernel::Build(Sigma);
+	FToneMapReferenceImage Temp;
+	Temp.Init(Image.Width, Image.Height);
+
+	for (int32 Y = 0; Y < Image.Height; ++Y)
+	{
+		for (int32 X = 0; X < Image.Width; ++X)
+		{
+			float3 Sum = Image.At(X, Y) * Kernel.Weights[0];
+			for (int32 i = 1; i <= Kernel.HalfSize; ++i)
+			{
+				Sum += (Image.Load(X - i, Y) + Image.Load(X + i, Y)) * Kernel.Weights[i];
+			}
+			Temp.At(X, Y) = Sum;
+		}
+	}
+	for (int32 Y = 0; Y < Image.Height; ++Y)
+	{
+		for (int32 X = 0; X < Image.Width; ++X)
+		{
+			float3 Sum = Temp.At(X, Y) * Kernel.Weights[0];
+			for (int32 i = 1; i <= Kernel.HalfSize; ++i)
+			{
+				Sum += (Temp.Load(X, Y - i) + Temp.Load(X, Y + i)) * Kernel.Weights[i];
+			}
+			Image.At(X, Y) = Sum;
+		}
+	}
+}
+
+// GlareStreakPS + GlareAccumulatePS, then the light glare blur
+static void ReferenceGlare(const FToneMapReferenceImage& Bright, const FToneMapReferenceSettings& Settings, FToneMapReferenceImage& OutGlare)
+{
+	using namespace ToneMapColorMath;
+
+	const int32 NumStreaks = FMath::Clamp(Settings.GlareStreakCount, 2, 4);
+	const float StreakLength = FMath::Clamp(Settings.GlareStreakLength, 5.0f, 200.0f) / (float)Settings.BloomDownsampleDivisor;
+	const float Falloff = FMath::Clamp(Settings.GlareFalloff, 0.5f, 10.0f);
+	const int32 NumSamples = FMath::Clamp(Settings.GlareSamples, 4, 64);
+
+	OutGlare.Init(Bright.Width, Bright.Height);
+	for (int32 Streak = 0; Streak < NumStreaks; ++Streak)
+	{
+		const float Angle = FMath::DegreesToRadians(360.0f / (float)NumStreaks * (float)Streak);
+		const float StepU = FMath::Cos(Angle) / (float)Bright.Width * (StreakLength / (float)NumSamples);
+		const float StepV = FMath::Sin(Angle) / (float)Bright.Height * (StreakLength / (float)NumSamples);
+
+		for (int32 Y = 0; Y < Bright.Height; ++Y)
+		{
+			for (int32 X = 0; X < Bright.Width; ++X)
+			{
+				const float U = Bright.GetU(X);
+				const float V = Bright.GetV(Y);
+
+				float3 Result = Bright.Sample(U, V);
+				float TotalWeight = 1.0f;
+				for (float Sign = 1.0f; Sign >= -1.0f; Sign -= 2.0f)
+				{
+					for (int32 i = 1; i <= NumSamples; ++i)
+					{
+						const float Weight = FMath::Exp(-(float)i / (float)NumSamples * Falloff);
+						if (Weight < 0.001f) break;
+						Result += Bright.Sample(saturate(U + Sign * StepU * (float)i), saturate(V + Sign * StepV * (float)i)) * Weight;
+						TotalWeight += Weight;
+					}
+				}
+				OutGlare.At(X, Y) += Result / TotalWeight / (float)NumStreaks;
+			}
+		}
+	}
+
+	FToneMapReferencePipeline::GaussianBlur(OutGlare, Settings.BloomSize * 0.05f);
+}
+
+// KawaseDownsamplePS / KawaseUpsamplePS pyramid, straight from scene colour
+static void ReferenceKawase(const FToneMapReferenceImage& SceneColor, const FToneMapReferenceSettings& Settings, int32 Width, int32 Height, FToneMapReferenceImage& OutBloom)
+{
+	using namespace ToneMapColorMath;
+
+	const int32 MipCount = FMath::Max(Settings.KawaseMipCount, 1);
+	const float FilterRadius = FMath::Clamp(Settings.KawaseFilterRadius, 0.0001f, 0.01f);
+	const float Knee = FMath::Clamp(Settings.KawaseThresholdKnee, 0.0f, 1.0f);
+
+	auto KarisWeight = [](const float3& C)
+	{
+		const float3 Encoded = pow(max(C, 0.0001f), 1.0f / 2.2f);
+		return 1.0f / (1.0f + Luma(Encoded) * 0.25f);
+	};
+
+	TArray<FToneMapReferenceImage> Mips;
+	Mips.SetNum(MipCount);
+	int32 MipWidth = Width;
+	int32 MipHeight = Height;
+	const FToneMapReferenceImage* Source = &SceneColor;
+	for (int32 Mip = 0; Mip < MipCount; ++Mip)
+	{
+		MipWidth = FMath::Max(FMath::DivideAndRoundUp(MipWidth, 2), 1);
+		MipHeight = FMath::Max(FMath::DivideAndRoundUp(MipHeight, 2), 1);
+		Mips[Mip].Init(MipWidth, MipHeight);
+
+		const float TX = 1.0f / (float)Source->Width;
+		const float TY = 1.0f / (float)Source->Height;
+		for (int32 Y = 0; Y < MipHeight; ++Y)
+		{
+			for (int32 X = 0; X < MipWidth; ++X)
+			{
+				const float U = Mips[Mip].GetU(X);
+				const float V = Mips[Mip].GetV(Y);
+				auto Tap = [&](float DX, float DY) { return Source->Sample(U + DX * TX, V + DY * TY); };
+
+				const float3 a = Tap(-2,  2), b = Tap(0,  2), c = Tap(2,  2);
+				const float3 d = Tap(-2,  0), e = Tap(0,  0), f = Tap(2,  0);
+				const float3 g = Tap(-2, -2), h = Tap(0, -2), i = Tap(2, -2);
+				const float3 j = Tap(-1,  1), k = Tap(1,  1), l = Tap(-1, -1), m = Tap(1, -1);
+
+				float3 Down;
+				if (Mip == 0)
+				{
+					float3 Groups[5] =
+					{
+						(a + b + d + e) * 0.03125f, (b + c + e + f) * 0.03125f,
+						(d + e + g + h) * 0.03125f, (e + f + h + i) * 0.03125f,
+						(j + k + l + m) * 0.125f,
+					};
+					Down = float3(0.0f);
+					for (const float3& Group : Groups)
+					{
+						Down += Group * KarisWeight(Group);
+					}
+
+					if (Settings.BloomThreshold > 0.0f)
+					{
+						Down = (Knee > 0.0f)
+							? ReferenceSoftKnee(Down, Settings.BloomThreshold, Settings.BloomThreshold * Knee)
+							: Down * (ReferenceMax3(Down) >= Settings.BloomThreshold ? 1.0f : 0.0f);
+					}
+				}
+				else
+				{
+					Down = e * 0.125f + (a + c + g + i) * 0.03125f + (b + d + f + h) * 0.0625f + (j + k + l + m) * 0.125f;
+				}
+				Mips[Mip].At(X, Y) = max(Down, 0.0001f);
+			}
+		}
+		Source = &Mips[Mip];
+	}
+
+	if (MipCount == 1)
+	{
+		OutBloom = Mips[0];
+		return;
+	}
+
+	auto Upsample = [FilterRadius](const FToneMapReferenceImage& Src, const FToneMapReferenceImage& Previous, FToneMapReferenceImage& Out)
+	{
+		for (int32 Y = 0; Y < Out.Height; ++Y)
+		{
+			for (int32 X = 0; X < Out.Width; ++X)
+			{
+				const float U = Out.GetU(X);
+				const float V = Out.GetV(Y);
+				auto Tap = [&](float DX, float DY) { return Src.Sample(U + DX * FilterRadius, V + DY * FilterRadius); };
+
+				float3 Up = Tap(0, 0) * 4.0f;
+				Up += (Tap(0, 1) + Tap(-1, 0) + Tap(1, 0) + Tap(0, -1)) * 2.0f;
+				Up += Tap(-1, 1) + Tap(1, 1) + Tap(-1, -1) + Tap(1, -1);
+				Out.At(X, Y) = Previous.Sample(U, V) + Up * (1.0f / 16.0f);
+			}
+		}
+	};
+
+	FToneMapReferenceImage Current = Mips[MipCount - 1];
+	for (int32 Mip = MipCount - 2; Mip >= 0; --Mip)
+	{
+		FToneMapReferenceImage Next;
+		Next.Init(Mips[Mip].Width, Mips[Mip].Height);
+		Upsample(Current, Mips[Mip], Next);
+		Current = MoveTemp(Next);
+	}
+
+	// Final upsample to the bloom resolution adds mip 0 once more, as on the GPU
+	OutBloom.Init(Width, Height);
+	Upsample(Current, Mips[0], OutBloom);
+}
+
+void FToneMapReferencePipeline::ApplyBloom(FToneMapReferenceImage& SceneColor, const FToneMapReferenceSettings& Settings)
+{
+	using namespace ToneMapColorMath;
+
+	if (Settings.Bloom == EToneMapReferenceBloom::None || Settings.BloomIntensity <= 0.0f)
+	{
+		return;
+	}
+
+	const int32 Divisor = FMath::Max(Settings.BloomDownsampleDivisor, 1);
+	const int32 BloomWidth = FMath::DivideAndRoundUp(SceneColor.Width, Divisor);
+	const int32 BloomHeight = FMath::DivideAndRoundUp(SceneColor.Height, Divisor);
+	const bool bSoftFocus = Settings.Bloom == EToneMapReferenceBloom::SoftFocus;
+
+	FToneMapReferenceImage Bloom;
+	if (Settings.Bloom == EToneMapReferenceBloom::Kawase)
+	{
+		ReferenceKawase(SceneColor, Settings, BloomWidth, BloomHeight, Bloom);
+	}
+	else
+	{
+		// BrightPassPS
+		const float Threshold = bSoftFocus ? 0.01f : Settings.BloomThreshold;
+		const float Softness = FMath::Clamp(Settings.BloomThresholdSoftness, 0.0f, 1.0f);
+		const float MaxBrightness = FMath::Max(Settings.BloomMaxBrightness, 0.0f);
+
+		FToneMapReferenceImage Bright;
+		Bright.Init(BloomWidth, BloomHeight);
+		for (int32 Y = 0; Y < BloomHeight; ++Y)
+		{
+			for (int32 X = 0; X < BloomWidth; ++X)
+			{
+				const float3 Color = SceneColor.Sample(Bright.GetU(X), Bright.GetV(Y));
+				float3 Out;
+				if (Threshold < 0.02f)
+				{
+					Out = Color;
+				}
+				else if (Softness > 0.001f)
+				{
+					Out = ReferenceSoftKnee(Color, Threshold, Threshold * Softness);
+				}
+				else
+				{
+					Out = Color * (ReferenceMax3(Color) >= Threshold ? 1.0f : 0.0f);
+				}
+
+				const float Lum = ReferenceBloomLuma(Out);
+				if (MaxBrightness > 0.0f && Lum > MaxBrightness)
+				{
+					Out = Out * (MaxBrightness / Lum);
+				}
+				Bright.At(X, Y) = Out;
+			}
+		}
+
+		if (Settings.Bloom == EToneMapReferenceBloom::DirectionalGlare)
+		{
+			ReferenceGlare(Bright, Settings, Bloom);
+		}
+		else
+		{
+			Bloom = MoveTemp(Bright);
+			for (int32 Pass = 0; Pass < Settings.BloomBlurPasses; ++Pass)
+			{
+				GaussianBlur(Bloom, Settings.BloomSize * 0.1f);
+			}
+		}
+	}
+
+	// CompositeBloomPS — Soft Focus and Bloom share one branch when only one is active
+	for (int32 Y = 0; Y < SceneColor.Height; ++Y)
+	{
+		for (int32 X = 0; X < SceneColor.Width; ++X)
+		{
+			const float3 Sample = Bloom.Sample(SceneColor.GetU(X), SceneColor.GetV(Y));
+			const float Lum = ReferenceBloomLuma(Sample);
+			const float3 Effect = lerp(float3(Lum), Sample, Settings.BloomSaturation) * Settings.BloomIntensity;
+			SceneColor.At(X, Y) = ReferenceBloomBlend(SceneColor.At(X, Y), Effect, Settings.BloomBlendMode);
+		}
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Durand & Dorsey 2002 (ToneMapDurand.usf)
+// ---------------------------------------------------------------------------
+
+void FToneMapReferencePipeline::RenderDurand(const FToneMapReferenceImage& SceneColor, const FToneMapReferenceSettings& Settings, FToneMapReferenceImage& OutColor)
+{
+	using namespace ToneMapColorMath;
+
+	const int32 W = SceneColor.Width;
+	const int32 H = SceneColor.Height;
+	auto LoadScalar = [W, H](const TArray<float>& Field, int32 X, int32 Y)
+	{
+		return Field[FMath::Clamp(Y, 0, H - 1) * W + FMath::Clamp(X, 0, W - 1)];
+	};
+
+	// Pass 1 — log10 luminance
+	TArray<float> LogLum;
+	LogLum.SetNumUninitialized(W * H);
+	for (int32 i = 0; i < W * H; ++i)
+	{
+		LogLum[i] = FMath::LogX(10.0f, FMath::Max(Luma(max(SceneColor.Pixels[i], 0.0f)), 1e-6f));
+	}
+
+	// Pass 2 — cross-bilateral H (guide = log-lum) then V
+	const float InvSigmaS2 = 0.5f / (Settings.DurandSpatialSigma * Settings.DurandSpatialSigma);
+	const float InvSigmaR2 = 0.5f / (Settings.DurandRangeSigma * Settings.DurandRangeSigma);
+	const int32 HalfK = FMath::Clamp((int32)(3.0f * Settings.DurandSpatialSigma + 0.5f), 1, 32);
+
+	auto Bilateral = [&](const TArray<float>& Input, TArray<float>& Output, int32 DX, int32 DY)
+	{
+		Output.SetNumUninitialized(W * H);
+		for (int32 Y = 0; Y < H; ++Y)
+		{
+			for (int32 X = 0; X < W; ++X)
+			{
+				const float CenterL = Input[Y * W + X];
+				float SumW = 0.0f;
+				float SumL = 0.0f;
+				for (int32 i = -HalfK; i <= HalfK; ++i)
+				{
+					const float SampleL = LoadScalar(Input, X + i * DX, Y + i * DY);
+					const float DRange = CenterL - LoadScalar(LogLum, X + i * DX, Y + i * DY);
+					const float Weight = FMath::Exp(-(float)(i * i) * InvSigmaS2) * FMath::Exp(-DRange * DRange * InvSigmaR2);
+					SumW += Weight;
+					SumL += Weight * SampleL;
+				}
+				Output[Y * W + X] = SumL / FMath::Max(SumW, 1e-8f);
+			}
+		}
+	};
+
+	TArray<float> BasePing;
+	TArray<float> BasePong;
+	Bilateral(LogLum, BasePing, 1, 0);
+	Bilateral(BasePing, BasePong, 0, 1);
+
+	// Pass 3 — compress base, keep detail, restore chroma
+	const float TargetMidGrey = FMath::LogX(10.0f, 0.18f);
+	OutColor.Init(W, H);
+	for (int32 i = 0; i < W * H; ++i)
+	{
+		const float3 HDR = max(SceneColor.Pixels[i], 0.0f);
+		const float LumIn = FMath::Max(Luma(HDR), 1e-6f);
+		const float Base = BasePong[i];
+		const float Detail = FMath::LogX(10.0f, LumIn) - Base;
+		const float NewLogL = Base * Settings.DurandBaseCompression + Detail * Settings.DurandDetailBoost;
+		const float OutputLogL = NewLogL + TargetMidGrey - (Base * Settings.DurandBaseCompression + TargetMidGrey * (1.0f - Settings.DurandBaseCompression));
+		const float LumOut = FMath::Max(FMath::Pow(10.0f, OutputLogL), 0.0f);
+		OutColor.Pixels[i] = saturate(HDR * (LumOut / LumIn));
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Fattal et al. 2002 (ToneMapFattal*.usf)
+// ---------------------------------------------------------------------------
+
+void FToneMapReferencePipeline::RenderFattal(const FToneMapReferenceImage& SceneColor, const FToneMapReferenceSettings& Settings, FToneMapReferenceImage& OutColor)
+{
+	using namespace ToneMapColorMath;
+
+	constexpr float LN10 = 2.302585093f;
+	const int32 W = SceneColor.Width;
+	const int32 H = SceneColor.Height;
+	auto LoadScalar = [W, H](const TArray<float>& Field, int32 X, int32 Y)
+	{
+		return Field[FMath::Clamp(Y, 0, H - 1) * W + FMath::Clamp(X, 0, W - 1)];
+	};
+
+	// Pass 0 — natural-log luminance, also the Jacobi seed
+	TArray<float> LogLum;
+	LogLum.SetNumUninitialized(W * H);
+	for (int32 i = 0; i < W * H; ++i)
+	{
+		LogLum[i] = FMath::Loge(FMath::Max(Luma(max(SceneColor.Pixels[i], 0.0f)), 1e-6f));
+	}
+
+	// Pass 1 — attenuated gradient (scene colour is fetched at texel centres, so bilinear == point)
+	TArray<float> Hx;
+	TArray<float> Hy;
+	Hx.SetNumUninitialized(W * H);
+	Hy.SetNumUninitialized(W * H);
+	const float Noise2 = Settings.FattalNoise * Settings.FattalNoise;
+	for (int32 Y = 0; Y < H; ++Y)
+	{
+		for (int32 X = 0; X < W; ++X)
+		{
+			auto LogAt = [&](int32 SX, int32 SY) { return FMath::Loge(FMath::Max(Luma(SceneColor.Load(SX, SY)), 1e-6f)); };
+			const float LogC = LogAt(X, Y);
+			const float DLdx = LogAt(X + 1, Y) - LogC;
+			const float DLdy = LogAt(X, Y + 1) - LogC;
+			const float DLdxBack = LogC - LogAt(X - 1, Y);
+			const float DLdyBack = LogC - LogAt(X, Y - 1);
+
+			const float Mag = 0.5f * (FMath::Sqrt(DLdx * DLdx + DLdy * DLdy + Noise2) + FMath::Sqrt(DLdxBack * DLdxBack + DLdyBack * DLdyBack + Noise2));
+			const float GA = FMath::Max(Mag, Settings.FattalNoise) / LN10;
+			const float Phi = FMath::Pow(Settings.FattalAlpha / GA, Settings.FattalBeta);
+			Hx[Y * W + X] = Phi * DLdx;
+			Hy[Y * W + X] = Phi * DLdy;
+		}
+	}
+
+	// Pass 2 — backward divergence
+	TArray<float> DivH;
+	DivH.SetNumUninitialized(W * H);
+	for (int32 Y = 0; Y < H; ++Y)
+	{
+		for (int32 X = 0; X < W; ++X)
+		{
+			DivH[Y * W + X] = (Hx[Y * W + X] - LoadScalar(Hx, X - 1, Y)) + (Hy[Y * W + X] - LoadScalar(Hy, X, Y - 1));
+		}
+	}
+
+	// Pass 3 — Jacobi, ping-pong
+	TArray<float> Current = LogLum;
+	TArray<float> Next;
+	Next.SetNumUninitialized(W * H);
+	for (int32 It = 0; It < Settings.FattalIterations; ++It)
+	{
+		for (int32 Y = 0; Y < H; ++Y)
+		{
+			for (int32 X = 0; X < W; ++X)
+			{
+				Next[Y * W + X] = (LoadScalar(Current, X + 1, Y) + LoadScalar(Current, X - 1, Y)
+					+ LoadScalar(Current, X, Y + 1) + LoadScalar(Current, X, Y - 1) - DivH[Y * W + X]) * 0.25f;
+			}
+		}
+		Swap(Current, Next);
+	}
+
+	// Pass 4 — reconstruct around mid grey
+	OutColor.Init(W, H);
+	for (int32 i = 0; i < W * H; ++i)
+	{
+		const float3 HDR = max(SceneColor.Pixels[i], 0.0f);
+		const float LumIn = FMath::Max(Luma(HDR), 1e-6f);
+		const float LumOut = FMath::Max(FMath::Exp(Current[i] - FMath::Loge(LumIn) + FMath::Loge(0.18f)), 0.0f);
+		const float Ratio = LumOut / LumIn;
+
+		const float3 Result = (Settings.FattalSaturation >= 1.0f)
+			? HDR * Ratio
+			: lerp(float3(LumOut), HDR * Ratio, Settings.FattalSaturation);
+		OutColor.Pixels[i] = saturate(Result);
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Lens effects — bright pass, corona, halo, composite (ToneMapLens*.usf)
+// ---------------------------------------------------------------------------
+
+void FToneMapReferencePipeline::ApplyLensEffects(FToneMapReferenceImage& SceneColor, const FToneMapReferenceSettings& Settings)
+{
+	using namespace ToneMapColorMath;
+
+	if (!Settings.bEnableCorona && !Settings.bEnableHalo)
+	{
+		return;
+	}
+
+	const int32 LW = FMath::Max(1, FMath::RoundToInt32(SceneColor.Width * Settings.LensResolutionScale));
+	const int32 LH = FMath::Max(1, FMath::RoundToInt32(SceneColor.Height * Settings.LensResolutionScale));
+	const float Threshold = (Settings.bEnableCorona && Settings.bEnableHalo)
+		? FMath::Min(Settings.CoronaThreshold, Settings.HaloThreshold)
+		: (Settings.bEnableCorona ? Settings.CoronaThreshold : Settings.HaloThreshold);
+
+	FToneMapReferenceImage Bright;
+	Bright.Init(LW, LH);
+	for (int32 Y = 0; Y < LH; ++Y)
+	{
+		for (int32 X = 0; X < LW; ++X)
+		{
+			const float3 Color = SceneColor.Sample(Bright.GetU(X), Bright.GetV(Y));
+			const float Knee = Threshold * 0.5f;
+			Bright.At(X, Y) = Color * saturate((Luma(Color) - Threshold + Knee) / FMath::Max(Knee, 0.001f));
+		}
+	}
+
+	FToneMapReferenceImage Corona;
+	if (Settings.bEnableCorona)
+	{
+		Corona.Init(LW, LH);
+		const int32 HalfSpikes = FMath::Max(Settings.CoronaSpikeCount / 2, 1);
+		const int32 SpikeLength = FMath::Max(Settings.CoronaSpikeLength, 1);
+		for (int32 Y = 0; Y < LH; ++Y)
+		{
+			for (int32 X = 0; X < LW; ++X)
+			{
+				const float U = Bright.GetU(X);
+				const float V = Bright.GetV(Y);
+				float3 Accum(0.0f);
+				float TotalW = 0.0f;
+				for (int32 Arm = 0; Arm < HalfSpikes && Arm < 16; ++Arm)
+				{
+					const float Theta = (float)Arm * PI / (float)HalfSpikes;
+					const float DU = FMath::Cos(Theta) / (float)LW;
+					const float DV = FMath::Sin(Theta) / (float)LH;
+					for (int32 s = 1; s <= SpikeLength && s <= 200; ++s)
+					{
+						const float T = (float)s / (float)SpikeLength;
+						const float Weight = 0.5f * (1.0f - FMath::Cos(PI * (1.0f - T))) * FMath::Exp(-5.0f * T);
+						Accum += (Bright.Sample(U + s * DU, V + s * DV) + Bright.Sample(U - s * DU, V - s * DV)) * Weight;
+						TotalW += 2.0f * Weight;
+					}
+				}
+				Corona.At(X, Y) = Accum * ((TotalW > 0.001f) ? (Settings.CoronaIntensity / TotalW) : 0.0f);
+			}
+		}
+	}
+
+	FToneMapReferenceImage Halo;
+	if (Settings.bEnableHalo)
+	{
+		Halo.Init(LW, LH);
+		const float AspectRatio = (float)LW / FMath::Max((float)LH, 1.0f);
+		const int32 NumAngles = FMath::Clamp(Settings.HaloAngularSamples, 4, 32);
+		const float ChromaShift = Settings.HaloThickness * 0.6f;
+		const float Sigma = FMath::Max(Settings.HaloThickness * 0.5f, 1e-5f);
+		const float InvSig2 = -0.5f / (Sigma * Sigma);
+		const float HalfThick = Settings.HaloThickness * 0.5f;
+		const float Radii[3] = { Settings.HaloRadius + ChromaShift, Settings.HaloRadius, Settings.HaloRadius - ChromaShift };
+
+		for (int32 Y = 0; Y < LH; ++Y)
+		{
+			for (int32 X = 0; X < LW; ++X)
+			{
+				const float U = Bright.GetU(X);
+				const float V = Bright.GetV(Y);
+				float3 Accum(0.0f);
+				float TotalW = 0.0f;
+				for (int32 a = 0; a < NumAngles; ++a)
+				{
+					const float Theta = (float)a * (2.0f * PI / (float)NumAngles);
+					const float DirU = FMath::Cos(Theta) / AspectRatio;
+					const float DirV = FMath::Sin(Theta);
+					for (int32 r = 0; r < 5; ++r)
+					{
+						const float T = ((float)r / 4.0f) * 2.0f - 1.0f;
+						const float Weight = FMath::Exp(T * T * InvSig2);
+						// Red from the outer radius, green from the nominal one, blue from the inner
+						Accum.x += Bright.Sample(U + DirU * (Radii[0] + T * HalfThick), V + DirV * (Radii[0] + T * HalfThick)).x * Weight;
+						Accum.y += Bright.Sample(U + DirU * (Radii[1] + T * HalfThick), V + DirV * (Radii[1] + T * HalfThick)).y * Weight;
+						Accum.z += Bright.Sample(U + DirU * (Radii[2] + T * HalfThick), V + DirV * (Radii[2] + T * HalfThick)).z * Weight;
+						TotalW += Weight;
+					}
+				}
+				Halo.At(X, Y) = Accum * ((TotalW > 1e-6f) ? (1.0f / TotalW) : 0.0f) * Settings.HaloIntensity * Settings.HaloTint;
+			}
+		}
+	}
+
+	// LensCompositePS — screen blend, layers upsampled bilinearly
+	for (int32 Y = 0; Y < SceneColor.Height; ++Y)
+	{
+		for (int32 X = 0; X < SceneColor.Width; ++X)
+		{
+			const float U = SceneColor.GetU(X);
+			const float V = SceneColor.GetV(Y);
+			float3 Result = SceneColor.At(X, Y);
+			if (Settings.bEnableCorona)
+			{
+				Result = Result + Corona.Sample(U, V) * max(1.0f - Result, 0.0f);
+			}
+			if (Settings.bEnableHalo)
+			{
+				Result = Result + Halo.Sample(U, V) * max(1.0f - Result, 0.0f);
+			}
+			SceneColor.At(X, Y) = Result;
+		}
+	}
+}
+
+// ---------------------------------------------------------------------------
+// ToneMapProcessPS, ReplaceTonemap branch (no auto-exposure, no dithering)
+// ---------------------------------------------------------------------------
+
+void FToneMapReferencePipeline::ApplyGrading(const FToneMapReferenceImage& SceneColor, const FToneMapReferenceImage* PreToneMapped,
+	const FToneMapReferenceSettings& S, FToneMapReferenceImage& OutColor)
+{
+	using namespace ToneMapColorMath;
+
+	OutColor.Init(SceneColor.Width, SceneColor.Height);
+	for (int32 i = 0; i < SceneColor.Pixels.Num(); ++i)
+	{
+		const float3 Original = SceneColor.Pixels[i];
+		float3 Color = ApplyWhiteBalance(Original, S.Temperature, S.Tint);
+		if (FMath::Abs(S.Exposure) > 0.001f)
+		{
+			Color = ApplyExposure(Color, S.Exposure);
+		}
+		Color = ApplyToneAdjustments(Color, S.Highlights, S.Shadows, S.Whites, S.Blacks, S.ToneSmoothing);
+		Color = ApplyContrast(Color, S.Contrast, S.ContrastMidpoint);
+		Color = ApplyVibrance(Color, S.Vibrance);
+		Color = ApplySaturation(Color, S.Saturation);
+		Color = lerp(float3(Luma(Color)), Color, S.HDRSaturation);
+		Color = max(Color * S.HDRColorBalance, 0.0f);
+
+		if (PreToneMapped)
+		{
+			const float GradeScale = FMath::Max(Luma(Color), 1e-6f) / FMath::Max(Luma(Original), 1e-6f);
+			Color = saturate(PreToneMapped->Pixels[i] * GradeScale);
+		}
+		else
+		{
+			Color = ApplyFilmCurve(Color, (float)S.FilmCurve, S.HableParams1, S.HableParams2, S.ReinhardWhitePoint, S.AgXParams);
+		}
+
+		if (S.bHalfPrecision)
+		{
+			// The half permutation's display-referred tail (ToneMapProcess.usf)
+			Half::half3 Ldr(Color);
+			if (S.bEnableCurves)
+			{
+				Ldr = ApplyToneCurve(Ldr, Half::half4(S.ToneCurveParams));
+			}
+			OutColor.Pixels[i] = saturate(LinearToSRGB(saturate(Ldr)).ToFloat());
+			continue;
+		}
+
+		if (S.bEnableCurves)
+		{
+			Color = ApplyToneCurve(Color, S.ToneCurveParams);
+		}
+		OutColor.Pixels[i] = saturate(LinearToSRGB(saturate(Color)));
+	}
+}
+
+void FToneMapReferencePipeline::Run(const FToneMapReferenceImage& SceneColor, const FToneMapReferenceSettings& Settings, FToneMapReferenceImage& OutColor)
+{
+	// Same order as PostProcessPass_RenderThread: bloom composite, pre-tonemap
+	// operator, lens effects, then the main pass
+	FToneMapReferenceImage Scene = SceneColor;
+	ApplyBloom(Scene, Settings);
+
+	FToneMapReferenceImage PreToneMapped;
+	const bool bPreToneMapped = Settings.FilmCurve == 4 || Settings.FilmCurve == 5;
+	if (Settings.FilmCurve == 4)
+	{
+		RenderDurand(Scene, Settings, PreToneMapped);
+	}
+	else if (Settings.FilmCurve == 5)
+	{
+		RenderFattal(Scene, Settings, PreToneMapped);
+	}
+
+	ApplyLensEffects(Scene, Settings);
+	ApplyGrading(Scene, bPreToneMapped ? &PreToneMapped : nullptr, Settings, OutColor);
+}
+
+// ---------------------------------------------------------------------------
+// Suite — scenes and cases
+// ---------------------------------------------------------------------------
+
+static const TCHAR* GReferenceSceneNames[] = { TEXT("Gradient"), TEXT("Sunset"), TEXT("Interior") };
+
+int32 FToneMapReferenceSuite::GetNumScenes()
+{
+	return UE_ARRAY_COUNT(GReferenceSceneNames);
+}
+
+const TCHAR* FToneMapReferenceSuite::GetSceneName(int32 Scene)
+{
+	return (Scene >= 0 && Scene < GetNumScenes()) ? GReferenceSceneNames[Scene] : TEXT("?");
+}
+
+FString FToneMapReferenceSuite::GetScenePath(int32 Scene)
+{
+	return FPaths::Combine(
+		IPluginManager::Get().FindPlugin(TEXT("ToneMapFX"))->GetBaseDir(),
+		TEXT("Source"), TEXT("ToneMapFXTests"), TEXT("Resources"), TEXT("Scenes"),
+		FString(GetSceneName(Scene)) + TEXT(".exr"));
+}
+
+bool FToneMapReferenceSuite::LoadScene(int32 Scene, FToneMapReferenceImage& OutScene)
+{
+	return OutScene.LoadFromFile(GetScenePath(Scene));
+}
+
+TArray<FToneMapReferenceCase> FToneMapReferenceSuite::GetCases()
+{
+	using namespace ToneMapColorMath;
+
+	TArray<FToneMapReferenceCase> Cases;
+	auto Add = [&Cases](const TCHAR* Name) -> FToneMapReferenceCase&
+	{
+		FToneMapReferenceCase& Case = Cases.AddDefaulted_GetRef();
+		Case.Name = Name;
+		return Case;
+	};
+
+	Add(TEXT("Hable"));
+	Add(TEXT("ReinhardLuminance")).Settings.FilmCurve = 1;
+	Add(TEXT("ReinhardJodie")).Settings.FilmCurve = 2;
+	Add(TEXT("ReinhardStandard")).Settings.FilmCurve = 3;
+	Add(TEXT("AgX")).Settings.FilmCurve = 6;
+	{
+		FToneMapReferenceCase& Case = Add(TEXT("AgXPunchy"));
+		Case.Settings.FilmCurve = 6;
+		Case.Settings.AgXParams.z = 1.0f;
+	}
+	{
+		FToneMapReferenceCase& Case = Add(TEXT("AgXGolden"));
+		Case.Settings.FilmCurve = 6;
+		Case.Settings.AgXParams.z = 2.0f;
+	}
+	{
+		// Iterative, edge-aware — exp/log differences across libm builds accumulate
+		FToneMapReferenceCase& Case = Add(TEXT("Durand"));
+		Case.Settings.FilmCurve = 4;
+		Case.Tolerance = float3(2e-3f);
+	}
+	{
+		FToneMapReferenceCase& Case = Add(TEXT("Fattal"));
+		Case.Settings.FilmCurve = 5;
+		Case.Tolerance = float3(2e-3f);
+	}
+	{
+		FToneMapReferenceCase& Case = Add(TEXT("Graded"));
+		FToneMapReferenceSettings& S = Case.Settings;
+		S.Temperature = 25.0f;
+		S.Tint = -10.0f;
+		S.Exposure = 0.5f;
+		S.Contrast = 20.0f;
+		S.Highlights = -30.0f;
+		S.Shadows = 25.0f;
+		S.Vibrance = 30.0f;
+		S.Saturation = -10.0f;
+		S.HDRSaturation = 1.1f;
+		S.HDRColorBalance = float3(1.0f, 0.97f, 0.92f);
+		S.bEnableCurves = true;
+		S.ToneCurveParams = float4(-10.0f, 5.0f, 10.0f, -5.0f);
+	}
+	{
+		FToneMapReferenceCase& Case = Add(TEXT("BloomStandard"));
+		Case.Settings.Bloom = EToneMapReferenceBloom::Standard;
+	}
+	{
+		FToneMapReferenceCase& Case = Add(TEXT("BloomGlare"));
+		Case.Settings.Bloom = EToneMapReferenceBloom::DirectionalGlare;
+		Case.Settings.BloomBlendMode = 0;
+	}
+	{
+		FToneMapReferenceCase& Case = Add(TEXT("BloomKawase"));
+		Case.Settings.Bloom = EToneMapReferenceBloom::Kawase;
+		Case.Settings.BloomBlendMode = 6;
+		Case.Settings.BloomIntensity = 0.5f;
+		Case.Tolerance = float3(2e-3f);
+	}
+	{
+		FToneMapReferenceCase& Case = Add(TEXT("SoftFocus"));
+		Case.Settings.Bloom = EToneMapReferenceBloom::SoftFocus;
+		Case.Settings.BloomIntensity = 0.5f;
+	}
+	{
+		FToneMapReferenceCase& Case = Add(TEXT("LensEffects"));
+		Case.Settings.bEnableCorona = true;
+		Case.Settings.bEnableHalo = true;
+	}
+
+	return Cases;
+}
+
+void FToneMapReferenceSuite::MakeThumbnail(const FToneMapReferenceImage& Image, FToneMapReferenceImage& OutThumb)
+{
+	using namespace ToneMapColorMath;
+
+	OutThumb.Init(ThumbWidth, ThumbHeight);
+	for (int32 TY = 0; TY < ThumbHeight; ++TY)
+	{
+		for (int32 TX = 0; TX < ThumbWidth; ++TX)
+		{
+			const int32 X0 = TX * Image.Width / ThumbWidth;
+			const int32 X1 = (TX + 1) * Image.Width / ThumbWidth;
+			const int32 Y0 = TY * Image.Height / ThumbHeight;
+			const int32 Y1 = (TY + 1) * Image.Height / ThumbHeight;
+
+			float3 Sum(0.0f);
+			for (int32 Y = Y0; Y < Y1; ++Y)
+			{
+				for (int32 X = X0; X < X1; ++X)
+				{
+					Sum += Image.At(X, Y);
+				}
+			}
+			OutThumb.At(TX, TY) = Sum / (float)FMath::Max((X1 - X0) * (Y1 - Y0), 1);
+		}
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Suite — golden table, throughput report
+// ---------------------------------------------------------------------------
+
+FString FToneMapReferenceSuite::GetGoldenPath()
+{
+	return FPaths::Combine(
+		IPluginManager::Get().FindPlugin(TEXT("ToneMapFX"))->GetBaseDir(),
+		TEXT("Source"), TEXT("ToneMapFXTests"), TEXT("Resources"), TEXT("ReferenceGolden.csv"));
+}
+
+FString FToneMapReferenceSuite::GetPerfPath()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ToneMapFX"), TEXT("ReferencePerf.json"));
+}
+
+FString FToneMapReferenceSuite::GetGoldenKey(const FToneMapReferenceCase& Case, int32 Scene)
+{
+	return FString(Case.Name) + TEXT("/") + GetSceneName(Scene);
+}
+
+bool FToneMapReferenceSuite::LoadGolden(const FString& Path, FGolden& OutGolden)
+{
+	using namespace ToneMapColorMath;
+
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *Path))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: reference golden %s not found"), *Path);
+		return false;
+	}
+
+	OutGolden.Reset();
+	for (const FString& Line : Lines)
+	{
+		if (Line.IsEmpty() || Line.StartsWith(TEXT("#")) || Line.StartsWith(TEXT("Case")))
+		{
+			continue;
+		}
+		TArray<FString> Fields;
+		Line.ParseIntoArray(Fields, TEXT(","));
+		const int32 X = Fields.Num() == 7 ? FCString::Atoi(*Fields[2]) : -1;
+		const int32 Y = Fields.Num() == 7 ? FCString::Atoi(*Fields[3]) : -1;
+		if (X < 0 || X >= ThumbWidth || Y < 0 || Y >= ThumbHeight)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: malformed reference golden row '%s'"), *Line);
+			return false;
+		}
+		TArray<float3>& Thumb = OutGolden.FindOrAdd(Fields[0] + TEXT("/") + Fields[1]);
+		Thumb.SetNumZeroed(ThumbWidth * ThumbHeight);
+		Thumb[Y * ThumbWidth + X] = float3(FCString::Atof(*Fields[4]), FCString::Atof(*Fields[5]), FCString::Atof(*Fields[6]));
+	}
+	return true;
+}
+
+ToneMapColorMath::float3 FToneMapReferenceSuite::GetMaxError(const FToneMapReferenceImage& Thumb, const TArray<ToneMapColorMath::float3>& Expected)
+{
+	using namespace ToneMapColorMath;
+
+	float3 Worst(0.0f);
+	for (int32 i = 0; i < FMath::Min(Thumb.Pixels.Num(), Expected.Num()); ++i)
+	{
+		Worst = max(Worst, abs(Thumb.Pixels[i] - Expected[i]));
+	}
+	return Worst;
+}
+
+bool FToneMapReferenceSuite::WriteGolden(const FString& Path)
+{
+	const TArray<FToneMapReferenceCase> Cases = GetCases();
+
+	TArray<FString> Lines;
+	Lines.Add(FString::Printf(TEXT("# ToneMapFX CPU reference golden: %d cases x %d scenes, %dx%d thumbnails of Resources/Scenes/*.exr"),
+		Cases.Num(), GetNumScenes(), ThumbWidth, ThumbHeight));
+	Lines.Add(TEXT("Case,Scene,X,Y,R,G,B"));
+
+	for (const FToneMapReferenceCase& Case : Cases)
+	{
+		for (int32 Scene = 0; Scene < GetNumScenes(); ++Scene)
+		{
+			FToneMapReferenceImage Input, Output, Thumb;
+			if (!LoadScene(Scene, Input))
+			{
+				return false;
+			}
+			FToneMapReferencePipeline::Run(Input, Case.Settings, Output);
+			MakeThumbnail(Output, Thumb);
+
+			for (int32 Y = 0; Y < ThumbHeight; ++Y)
+			{
+				for (int32 X = 0; X < ThumbWidth; ++X)
+				{
+					const ToneMapColorMath::float3& C = Thumb.At(X, Y);
+					Lines.Add(FString::Printf(TEXT("%s,%s,%d,%d,%.7g,%.7g,%.7g"), Case.Name, GetSceneName(Scene), X, Y, C.x, C.y, C.z));
+				}
+			}
+		}
+	}
+
+	return FFileHelper::SaveStringArrayToFile(Lines, *Path);
+}
+
+int32 FToneMapReferenceSuite::Run(const FString& GoldenPath, const FString& PerfPath, int32 Iterations)
+{
+	using namespace ToneMapColorMath;
+
+	FGolden Golden;
+	if (!LoadGolden(GoldenPath, Golden))
+	{
+		return -1;
+	}
+
+	TArray<FToneMapReferenceImage> Scenes;
+	Scenes.SetNum(GetNumScenes());
+	for (int32 Scene = 0; Scene < GetNumScenes(); ++Scene)
+	{
+		if (!LoadScene(Scene, Scenes[Scene]))
+		{
+			return -1;
+		}
+	}
+
+	Iterations = FMath::Max(Iterations, 1);
+	int32 NumFailures = 0;
+
+	TArray<FString> PerfEntries;
+	UE_LOG(LogTemp, Log, TEXT("ToneMapFX: CPU reference suite, %d scenes, %d iteration(s)"), GetNumScenes(), Iterations);
+
+	for (const FToneMapReferenceCase& Case : GetCases())
+	{
+		for (int32 Scene = 0; Scene < GetNumScenes(); ++Scene)
+		{
+			const FToneMapReferenceImage& Input = Scenes[Scene];
+			const double MegaPixels = (double)Input.Pixels.Num() / 1.0e6;
+			FToneMapReferenceImage Output, Thumb;
+
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 It = 0; It < Iterations; ++It)
+			{
+				FToneMapReferencePipeline::Run(Input, Case.Settings, Output);
+			}
+			const double Ms = (FPlatformTime::Seconds() - StartTime) * 1000.0 / (double)Iterations;
+			MakeThumbnail(Output, Thumb);
+
+			float3 Worst(0.0f);
+			bool bPassed = false;
+			if (const TArray<float3>* Expected = Golden.Find(GetGoldenKey(Case, Scene)))
+			{
+				Worst = GetMaxError(Thumb, *Expected);
+				bPassed = Worst.x <= Case.Tolerance.x && Worst.y <= Case.Tolerance.y && Worst.z <= Case.Tolerance.z;
+			}
+			NumFailures += bPassed ? 0 : 1;
+
+			UE_LOG(LogTemp, Log, TEXT("ToneMapFX:   %-18s %-9s max error (%.1e, %.1e, %.1e)  %7.2f ms  %6.2f Mpix/s  %s"),
+				Case.Name, GetSceneName(Scene), Worst.x, Worst.y, Worst.z, Ms, MegaPixels / FMath::Max(Ms / 1000.0, 1e-9),
+				bPassed ? TEXT("ok") : TEXT("FAILED"));
+
+			PerfEntries.Add(FString::Printf(
+				TEXT("    { \"case\": \"%s\", \"scene\": \"%s\", \"width\": %d, \"height\": %d, \"ms\": %.4f, \"mpixPerSec\": %.3f, \"maxError\": [%.3e, %.3e, %.3e], \"passed\": %s }"),
+				Case.Name, GetSceneName(Scene), Input.Width, Input.Height, Ms, MegaPixels / FMath::Max(Ms / 1000.0, 1e-9),
+				Worst.x, Worst.y, Worst.z, bPassed ? TEXT("true") : TEXT("false")));
+		}
+	}
+
+	if (!PerfPath.IsEmpty())
+	{
+		const FString Json = FString::Printf(TEXT("{\n  \"iterations\": %d,\n  \"failures\": %d,\n  \"results\": [\n%s\n  ]\n}\n"),
+			Iterations, NumFailures, *FString::Join(PerfEntries, TEXT(",\n")));
+		if (!FFileHelper::SaveStringToFile(Json, *PerfPath))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("ToneMapFX: could not write %s"), *PerfPath);
+		}
+	}
+
+	return NumFailures;
+}
+
+static FAutoConsoleCommand CmdToneMapReferenceSuite(
+	TEXT("r.ToneMapFX.ReferenceSuite"),
+	TEXT("Run the CPU reference pipeline over the HDR test frames, compare against ReferenceGolden.csv\n")
+	TEXT("and write throughput to Saved/ToneMapFX/ReferencePerf.json.  Optional iteration count (default 3);\n")
+	TEXT("'r.ToneMapFX.ReferenceSuite write' regenerates the golden table."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if (Args.Num() > 0 && Args[0] == TEXT("write"))
+		{
+			const FString Path = FToneMapReferenceSuite::GetGoldenPath();
+			const bool bWritten = FToneMapReferenceSuite::WriteGolden(Path);
+			UE_LOG(LogTemp, Log, TEXT("ToneMapFX: %s reference golden %s"), bWritten ? TEXT("wrote") : TEXT("could not write"), *Path);
+			return;
+		}
+
+		const int32 Iterations = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 3;
+		const int32 NumFailures = FToneMapReferenceSuite::Run(FToneMapReferenceSuite::GetGoldenPath(), FToneMapReferenceSuite::GetPerfPath(), Iterations);
+		if (NumFailures != 0)
+		{
+			UE_LOG(LogTemp, Error, TEXT("ToneMapFX: CPU reference suite FAILED (%d)"), NumFailures);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Log, TEXT("ToneMapFX: CPU reference suite passed"));
+		}
+	}));
@@ -0,0 +1,37 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#include "ToneMapReplayCommandlet.h"
+#include "ToneMapCPUReplay.h"
+
+UToneMapFXReplayCommandlet::UToneMapFXReplayCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UToneMapFXReplayCommandlet::Main(const FString& Params)
+{
+	FString Capture;
+	int32 Iterations = 5;
+
+	FParse::Value(*Params, TEXT("capture="), Capture);
+	FParse::Value(*Params, TEXT("iterations="), Iterations);
+
+	if (Capture.IsEmpty())
+	{
+		UE_LOG(LogTemp, Error, TEXT("ToneMapFX: -capture=<name or folder> is required"));
+		return 1;
+	}
+
+	const FString Directory = FToneMapReplay::ResolveCaptureDirectory(Capture);
+	if (!FToneMapCPUReplay::Run(Directory, Iterations))
+	{
+		UE_LOG(LogTemp, Error, TEXT("ToneMapFX: replay of %s FAILED"), *Directory);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("ToneMapFX: replayed %s"), *Directory);
+	return 0;
+}
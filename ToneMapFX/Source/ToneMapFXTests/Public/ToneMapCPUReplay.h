@@ -0,0 +1,32 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ToneMapCapture.h"
+#include "ToneMapReferencePipeline.h"
+
+// =============================================================================
+// CPU replay of a ToneMapFX capture (r.ToneMapFX.Replay, -run=ToneMapFXReplay)
+//
+// Runs a capture (ToneMapCapture.h) through the CPU reference pipeline stage
+// by stage.  Replay.exr and the 16x9 Replay.csv thumbnail depend on nothing
+// but the capture, so two replays of one capture diff clean; the per-stage
+// timings go to ReplayTimings.json.  'r.ToneMapFX.Replay <capture> gpu'
+// hands the capture to the runtime's GPU replay instead.
+// =============================================================================
+
+class TONEMAPFXTESTS_API FToneMapCPUReplay
+{
+public:
+	// The reference pipeline's view of Settings, with the captured quality caps
+	static FToneMapReferenceSettings MakeReferenceSettings(const UToneMapComponent& Settings, const FToneMapCaptureView& View);
+
+	// What the main pass sees before grading: pre-exposure removed, auto
+	// exposure applied and the engine's bloom composited
+	static void PrepareInput(const FToneMapCaptureData& Capture, FToneMapReferenceImage& OutSceneColor);
+
+	// Render the capture Iterations times; writes Replay.exr, Replay.csv and
+	// ReplayTimings.json next to it.  ReplaceTonemap only.
+	static bool Run(const FString& Directory, int32 Iterations);
+};
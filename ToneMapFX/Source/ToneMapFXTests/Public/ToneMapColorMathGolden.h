@@ -0,0 +1,33 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ToneMapColorMath.h"
+
+// =============================================================================
+// Golden table of the shared colour math (ToneMapFX.ColorMath automation
+// tests, 'r.ToneMapFX.ColorMathGolden write')
+//
+// Every FToneMapColorMath operator evaluated on the 6x6x6 RGB lattice, one
+// "Operator,Index,R,G,B" row each, in Resources/ColorMathGolden.csv of this
+// module.  The test compares the C++ build of ToneMapColorMath.ush against
+// it; regenerate it only after an intentional change to an operator.
+// =============================================================================
+
+class TONEMAPFXTESTS_API FToneMapColorMathGolden
+{
+public:
+	// Expected output per operator and lattice colour, at
+	// Operator * FToneMapColorMath::LatticeSize + Index.  False when the file
+	// is missing, malformed or does not cover every operator / colour.
+	static bool Load(const FString& Path, TArray<ToneMapColorMath::float3>& OutExpected);
+
+	// Regenerate the table from the current operators
+	static bool Write(const FString& Path);
+
+	// Absolute up to 1, relative above, so HDR outputs are not held to an absolute bound
+	static float GetError(const ToneMapColorMath::float3& Actual, const ToneMapColorMath::float3& Expected);
+
+	static FString GetPath();
+};
@@ -0,0 +1,30 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ToneMapReferenceCommandlet.generated.h"
+
+// ============================================================================
+// Headless CI entry point for the CPU reference suite
+//
+//   UnrealEditor-Cmd <Project>.uproject -run=ToneMapFXReference -nullrhi
+//       [-iterations=N] [-golden=<csv>] [-perf=<json>] [-write]
+//
+// Runs FToneMapReferenceSuite against Resources/ReferenceGolden.csv of this
+// module and returns 0 when every case is within tolerance, 1 otherwise.
+// -write regenerates the golden table instead.  The same comparison runs as
+// the ToneMapFX.Reference automation tests.
+// ============================================================================
+
+UCLASS()
+class TONEMAPFXTESTS_API UToneMapFXReferenceCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UToneMapFXReferenceCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
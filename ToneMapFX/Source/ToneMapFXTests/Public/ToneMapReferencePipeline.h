@@ -0,0 +1,184 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ToneMapReferenceImage.h"
+
+// =============================================================================
+// CPU reference pipeline — golden-image and throughput suite
+// (ToneMapFX.Reference automation tests, r.ToneMapFX.ReferenceSuite,
+// -run=ToneMapFXReference)
+//
+// A CPU mirror of the ReplaceTonemap chain as the subsystem schedules it:
+//
+//   bloom (Standard / Directional Glare / Kawase / Soft Focus) → composite
+//   → Durand or Fattal pre-pass → lens corona / halo → grading → film curve
+//   → tone curve → sRGB
+//
+// Every stage follows its shader tap for tap (clamped bilinear fetches at
+// the same UVs); the per-pixel grading and film curves are the shared
+// ToneMapColorMath.ush functions themselves.  Parameters are the component
+// defaults at the Epic quality tier; spatial Clarity / Dynamic Contrast and
+// HSL are covered operator by operator by ToneMapFX.ColorMath.Golden.
+//
+// The suite renders the HDR frames in Resources/Scenes/*.exr of this module
+// through one case per operator and compares a 16x9 box-filtered thumbnail
+// of each output against Resources/ReferenceGolden.csv, per channel.
+// Throughput per case is written to Saved/ToneMapFX/ReferencePerf.json for
+// CI trend tracking.
+// =============================================================================
+
+/** Bloom path — EBloomMode plus "off" */
+enum class EToneMapReferenceBloom : uint8
+{
+	None,
+	Standard,
+	DirectionalGlare,
+	Kawase,
+	SoftFocus,
+};
+
+/** The part of UToneMapComponent the reference models; defaults match the component */
+struct FToneMapReferenceSettings
+{
+	// ---- Film curve (EToneMapFilmCurve order: 0 Hable … 4 Durand, 5 Fattal, 6 AgX) ----
+	int32 FilmCurve = 0;
+	ToneMapColorMath::float4 HableParams1 = ToneMapColorMath::float4(0.15f, 0.50f, 0.10f, 0.20f);
+	ToneMapColorMath::float4 HableParams2 = ToneMapColorMath::float4(0.02f, 0.30f, 11.2f, 0.0f);
+	float ReinhardWhitePoint = 100.0f;
+	ToneMapColorMath::float4 AgXParams = ToneMapColorMath::float4(-10.0f, 6.5f, 0.0f, 0.0f);  // MinEV, MaxEV, Look
+
+	// ---- Grading ----
+	float Temperature = 0.0f;
+	float Tint = 0.0f;
+	float Exposure = 0.0f;
+	float Contrast = 0.0f;
+	float ContrastMidpoint = 0.18f;
+	float Highlights = 0.0f;
+	float Shadows = 0.0f;
+	float Whites = 0.0f;
+	float Blacks = 0.0f;
+	float ToneSmoothing = 100.0f;
+	float Vibrance = 0.0f;
+	float Saturation = 0.0f;
+	float HDRSaturation = 1.0f;
+	ToneMapColorMath::float3 HDRColorBalance = ToneMapColorMath::float3(1.0f);
+	bool bEnableCurves = false;
+	ToneMapColorMath::float4 ToneCurveParams = ToneMapColorMath::float4(0.0f);
+	bool bHalfPrecision = false;          // TONEMAP_HALF_PRECISION: tone curve and sRGB in emulated fp16
+
+	// ---- Bloom ----
+	EToneMapReferenceBloom Bloom = EToneMapReferenceBloom::None;
+	float BloomIntensity = 1.0f;
+	float BloomThreshold = 0.8f;
+	float BloomThresholdSoftness = 0.5f;
+	float BloomMaxBrightness = 1.0f;
+	float BloomSize = 16.0f;
+	int32 BloomBlendMode = 2;             // EBloomBlendMode::SoftLight
+	float BloomSaturation = 1.0f;
+	int32 BloomDownsampleDivisor = 2;
+	int32 BloomBlurPasses = 3;
+	ToneMapColorMath::float4 SoftFocusParams = ToneMapColorMath::float4(0.5f, 0.33f, 0.4f, 0.25f);
+	int32 GlareStreakCount = 4;           // one accumulate pass; the GPU batches more streaks in threes
+	float GlareStreakLength = 40.0f;
+	float GlareFalloff = 3.0f;
+	int32 GlareSamples = 16;
+	int32 KawaseMipCount = 5;
+	float KawaseFilterRadius = 0.002f;
+	float KawaseThresholdKnee = 0.5f;
+
+	// ---- Durand ----
+	float DurandSpatialSigma = 16.0f;
+	float DurandRangeSigma = 0.35f;
+	float DurandBaseCompression = 0.5f;
+	float DurandDetailBoost = 1.0f;
+
+	// ---- Fattal ----
+	float FattalAlpha = 0.1f;
+	float FattalBeta = 0.9f;
+	float FattalSaturation = 0.8f;
+	float FattalNoise = 0.0001f;
+	int32 FattalIterations = 30;
+
+	// ---- Lens effects ----
+	bool bEnableCorona = false;
+	float CoronaIntensity = 0.5f;
+	int32 CoronaSpikeCount = 6;
+	int32 CoronaSpikeLength = 80;
+	float CoronaThreshold = 0.8f;
+	bool bEnableHalo = false;
+	float HaloIntensity = 0.3f;
+	float HaloRadius = 0.15f;
+	float HaloThickness = 0.03f;
+	float HaloThreshold = 0.9f;
+	ToneMapColorMath::float3 HaloTint = ToneMapColorMath::float3(0.85f, 0.90f, 1.0f);
+	int32 HaloAngularSamples = 24;
+	float LensResolutionScale = 0.75f;
+};
+
+class TONEMAPFXTESTS_API FToneMapReferencePipeline
+{
+public:
+	// Whole chain: linear HDR scene colour in, display sRGB [0, 1] out
+	static void Run(const FToneMapReferenceImage& SceneColor, const FToneMapReferenceSettings& Settings, FToneMapReferenceImage& OutColor);
+
+	// ---- Stages (ClassicBloom*, ToneMapDurand, ToneMapFattal*, ToneMapLens*, ToneMapProcess) ----
+	static void ApplyBloom(FToneMapReferenceImage& SceneColor, const FToneMapReferenceSettings& Settings);
+	static void RenderDurand(const FToneMapReferenceImage& SceneColor, const FToneMapReferenceSettings& Settings, FToneMapReferenceImage& OutColor);
+	static void RenderFattal(const FToneMapReferenceImage& SceneColor, const FToneMapReferenceSettings& Settings, FToneMapReferenceImage& OutColor);
+	static void ApplyLensEffects(FToneMapReferenceImage& SceneColor, const FToneMapReferenceSettings& Settings);
+	static void ApplyGrading(const FToneMapReferenceImage& SceneColor, const FToneMapReferenceImage* PreToneMapped,
+		const FToneMapReferenceSettings& Settings, FToneMapReferenceImage& OutColor);
+
+	// Horizontal then vertical pass of FToneMapGaussianKernel::Build(Sigma), edges clamped
+	static void GaussianBlur(FToneMapReferenceImage& Image, float Sigma);
+};
+
+/** One golden case: a pipeline configuration and its per-channel tolerance */
+struct FToneMapReferenceCase
+{
+	const TCHAR* Name = nullptr;
+	FToneMapReferenceSettings Settings;
+	ToneMapColorMath::float3 Tolerance = ToneMapColorMath::float3(1e-3f);
+};
+
+class TONEMAPFXTESTS_API FToneMapReferenceSuite
+{
+public:
+	static constexpr int32 ThumbWidth = 16;
+	static constexpr int32 ThumbHeight = 9;
+
+	// "Case/Scene" → ThumbWidth x ThumbHeight thumbnail
+	using FGolden = TMap<FString, TArray<ToneMapColorMath::float3>>;
+
+	// HDR input frames, Resources/Scenes/<Name>.exr (linear, 32-bit float)
+	static int32 GetNumScenes();
+	static const TCHAR* GetSceneName(int32 Scene);
+	static FString GetScenePath(int32 Scene);
+	static bool LoadScene(int32 Scene, FToneMapReferenceImage& OutScene);
+
+	static TArray<FToneMapReferenceCase> GetCases();
+
+	// Box-filtered ThumbWidth x ThumbHeight copy of a pipeline output
+	static void MakeThumbnail(const FToneMapReferenceImage& Image, FToneMapReferenceImage& OutThumb);
+
+	// Resources/ReferenceGolden.csv ("Case,Scene,X,Y,R,G,B").  False when the
+	// file is missing or malformed.
+	static bool LoadGolden(const FString& Path, FGolden& OutGolden);
+	static FString GetGoldenKey(const FToneMapReferenceCase& Case, int32 Scene);
+
+	// Per-channel worst difference between a thumbnail and its golden entry
+	static ToneMapColorMath::float3 GetMaxError(const FToneMapReferenceImage& Thumb, const TArray<ToneMapColorMath::float3>& Expected);
+
+	// Regenerate the golden table from the current pipeline
+	static bool WriteGolden(const FString& Path);
+
+	// Render every case Iterations times, compare with the golden table and
+	// write throughput JSON to PerfPath (skipped when empty).  Returns the
+	// number of failing case / scene pairs, or -1 when the golden is unusable.
+	static int32 Run(const FString& GoldenPath, const FString& PerfPath, int32 Iterations);
+
+	static FString GetGoldenPath();
+	static FString GetPerfPath();
+};
@@ -0,0 +1,30 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ToneMapReplayCommandlet.generated.h"
+
+// ============================================================================
+// Headless replay of a ToneMapFX capture
+//
+//   UnrealEditor-Cmd <Project>.uproject -run=ToneMapFXReplay -nullrhi
+//       -capture=<name or folder> [-iterations=N]
+//
+// Runs the capture (r.ToneMapFX.Capture) through the CPU reference pipeline
+// and writes Replay.exr, Replay.csv and ReplayTimings.json next to it.
+// Returns 1 when the capture cannot be loaded or replayed.  The GPU replay
+// needs a live view — use 'r.ToneMapFX.Replay <capture> gpu' in the editor.
+// ============================================================================
+
+UCLASS()
+class TONEMAPFXTESTS_API UToneMapFXReplayCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UToneMapFXReplayCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
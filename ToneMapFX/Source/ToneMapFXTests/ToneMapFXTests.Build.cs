@@ -0,0 +1,33 @@
+// Licensed under the zlib License. See LICENSE file in the project root.
+
+using UnrealBuildTool;
+
+// CPU reference pipeline, golden suites, capture replay and automation tests.
+// Editor and development builds only — nothing here ships with a game.
+public class ToneMapFXTests : ModuleRules
+{
+	public ToneMapFXTests(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"CoreUObject",
+				"Engine",
+				"ToneMapFX"
+			}
+		);
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"RenderCore",
+				"Renderer",
+				"RHI",
+				"Projects"
+			}
+		);
+	}
+}